@@ -32,10 +32,10 @@ See LICENSE.txt or http://www.mitk.org for details.
 
 // forward declarations
 class vtkPoints;
-class vtkKdTreePointLocator;
 
 namespace mitk
 {
+  class PointLocator;
   class Surface;
   class WeightedPointTransform;
 
@@ -188,11 +188,13 @@ namespace mitk
       * the help of a kd tree. The correspondences are searched in a given radius
       * in the euklidian space. Every correspondence found in this radius is
       * weighted based on the covariance matrices and the best weighting will be
-      * used as a correspondence.
+      * used as a correspondence. The radius searches of all points are done in one
+      * batched query.
       *
       * @param X The moving point set.
       * @param Z The returned correspondences from the fixed point set.
-      * @param Y The fixed point set saved in a kd tree.
+      * @param Y The fixed point set.
+      * @param locator The kd tree of the fixed point set.
       * @param sigma_X Covariance matrices belonging to the moving point set.
       * @param sigma_Y Covariance matrices belonging to the fixed point set.
       * @param sigma_Z Covariance matrices belonging to the correspondences found.
@@ -203,7 +205,8 @@ namespace mitk
       */
     void ComputeCorrespondences(vtkPoints *X,
                                 vtkPoints *Z,
-                                vtkKdTreePointLocator *Y,
+                                vtkPoints *Y,
+                                PointLocator *locator,
                                 const CovarianceMatrixList &sigma_X,
                                 const CovarianceMatrixList &sigma_Y,
                                 CovarianceMatrixList &sigma_Z,
@@ -24,6 +24,9 @@ See LICENSE.txt or http://www.mitk.org for details.
 
 #include <vtkPoints.h>
 
+#include <memory>
+#include <vector>
+
 // forward declarations
 class vtkPointSet;
 class ANNkd_tree;
@@ -35,8 +38,9 @@ namespace mitk
    * Usage: set your points via SetPoints( vtkPointSet* Points ) or SetPoints(mitk::PointSet*).
    * Then, you may query the closest point to an arbitrary coordinate by FindClosestPoint().
    * There is no further call to update etc. needed.
-   * Currently only calls for 1 nearest neighbour are supported. Feel free to add functions
-   * for K nearest neighbours.
+   * Many query points can be passed at once to FindClosestNPoints() and FindPointsWithinRadius().
+   * These batched queries run in parallel on a separate, read-only kd tree which is built on the
+   * first batched query after the points have been set.
    * NOTE: At least 1 point must be contained in the point set.
    */
 
@@ -134,11 +138,40 @@ namespace mitk
     */
     bool FindClosestPointAndDistance(mitk::PointSet::PointType point, IdType *id, DistanceType *dist);
 
-  protected:
-    //
-    // Definition of a vector of ids
-    //
     typedef std::vector<IdType> IdVectorType;
+    typedef std::vector<mitk::Point3D> QueryPointsType;
+
+    /**
+    * Finds the k nearest neighbours of each query point in parallel.
+    * @param queryPoints the query points
+    * @param k the number of neighbours per query point
+    * @param ids returns k ids per query point, sorted by distance. The ids of query point i start at
+    * position i*k. If the point set contains less than k points, the remaining ids are -1.
+    * @param squaredDistances returns the squared distances belonging to ids
+    */
+    void FindClosestNPoints(const QueryPointsType &queryPoints,
+                            unsigned int k,
+                            IdVectorType &ids,
+                            std::vector<DistanceType> &squaredDistances);
+
+    /**
+    * Finds all points within the radius of each query point in parallel.
+    * @param queryPoints the query points
+    * @param radius the search radius in world coordinates
+    * @param ids returns the ids of all points within the radius for each query point, in no particular order
+    */
+    void FindPointsWithinRadius(const QueryPointsType &queryPoints, DistanceType radius, std::vector<IdVectorType> &ids);
+
+    /**
+    * Convenience function, converts the points to query points.
+    */
+    static QueryPointsType ToQueryPoints(vtkPoints *points);
+
+  protected:
+    /**
+    * Balanced kd tree stored in flat arrays, which can be searched by several threads at once.
+    */
+    struct SearchTree;
 
     //
     // ANN related typedefs, to prevent ANN from being in the global include path.
@@ -173,6 +206,11 @@ namespace mitk
      */
     void DestroyANN();
 
+    /**
+     * Builds the search tree for batched queries from the ANN data points, if needed
+     */
+    void InitSearchTree();
+
     /**
      * Finds the nearest neighbour in the point set previously defined by SetPoints().
      * The Id of the point is returned. Please note, that there is no case, in which
@@ -214,6 +252,8 @@ namespace mitk
     MyANNidxArray m_ANNPointIndexes;
     MyANNdistArray m_ANNDistances;
     ANNkd_tree *m_ANNTree;
+
+    std::unique_ptr<SearchTree> m_SearchTree;
   };
 }
 
@@ -17,13 +17,11 @@ See LICENSE.txt or http://www.mitk.org for details.
 // MITK
 #include "mitkAnisotropicIterativeClosestPointRegistration.h"
 #include "mitkAnisotropicRegistrationCommon.h"
+#include "mitkPointLocator.h"
 #include "mitkWeightedPointTransform.h"
 #include <mitkProgressBar.h>
 #include <mitkSurface.h>
 // VTK
-#include <vtkIdList.h>
-#include <vtkKdTree.h>
-#include <vtkKdTreePointLocator.h>
 #include <vtkPoints.h>
 #include <vtkPolyData.h>
 // STL pair
@@ -60,7 +58,8 @@ mitk::AnisotropicIterativeClosestPointRegistration::~AnisotropicIterativeClosest
 
 void mitk::AnisotropicIterativeClosestPointRegistration::ComputeCorrespondences(vtkPoints *X,
                                                                                 vtkPoints *Z,
-                                                                                vtkKdTreePointLocator *Y,
+                                                                                vtkPoints *Y,
+                                                                                PointLocator *locator,
                                                                                 const CovarianceMatrixList &sigma_X,
                                                                                 const CovarianceMatrixList &sigma_Y,
                                                                                 CovarianceMatrixList &sigma_Z,
@@ -69,6 +68,39 @@ void mitk::AnisotropicIterativeClosestPointRegistration::ComputeCorrespondences(
 {
   typedef itk::Matrix<double, 3, 3> WeightMatrix;
 
+  const mitk::PointLocator::QueryPointsType queryPoints = mitk::PointLocator::ToQueryPoints(X);
+  std::vector<mitk::PointLocator::IdVectorType> ids;
+  locator->FindPointsWithinRadius(queryPoints, radius, ids);
+
+  // double the radius for the points without any neighbour till we find at least one point
+  std::vector<int> emptyQueries;
+  for (std::size_t i = 0; i < ids.size(); ++i)
+  {
+    if (ids[i].empty())
+      emptyQueries.push_back(static_cast<int>(i));
+  }
+  double r = radius;
+  while (!emptyQueries.empty())
+  {
+    r *= 2.0;
+    mitk::PointLocator::QueryPointsType emptyQueryPoints;
+    for (int i : emptyQueries)
+      emptyQueryPoints.push_back(queryPoints[i]);
+
+    std::vector<mitk::PointLocator::IdVectorType> emptyQueryIds;
+    locator->FindPointsWithinRadius(emptyQueryPoints, r, emptyQueryIds);
+
+    std::vector<int> stillEmptyQueries;
+    for (std::size_t i = 0; i < emptyQueries.size(); ++i)
+    {
+      if (emptyQueryIds[i].empty())
+        stillEmptyQueries.push_back(emptyQueries[i]);
+      else
+        ids[emptyQueries[i]].swap(emptyQueryIds[i]);
+    }
+    emptyQueries.swap(stillEmptyQueries);
+  }
+
 #pragma omp parallel for
   for (int i = 0; i < X->GetNumberOfPoints(); ++i)
   {
@@ -76,33 +108,20 @@ void mitk::AnisotropicIterativeClosestPointRegistration::ComputeCorrespondences(
     mitk::Vector3D x;
     mitk::Vector3D y;
     double bestDist = std::numeric_limits<double>::max();
-    vtkIdList *ids = vtkIdList::New();
-    double r = radius;
     double p[3];
-    // get point
-    X->GetPoint(i, p);
     // fill vector
-    x[0] = p[0];
-    x[1] = p[1];
-    x[2] = p[2];
-
-    // double the radius till we find at least one point
-    while (ids->GetNumberOfIds() <= 0)
-    {
-      Y->FindPointsWithinRadius(r, p, ids);
-      r *= 2.0;
-    }
+    x[0] = queryPoints[i][0];
+    x[1] = queryPoints[i][1];
+    x[2] = queryPoints[i][2];
 
     // loop over the points in the sphere and find the point with the
     // minimal weighted squared distance
-    for (vtkIdType j = 0; j < ids->GetNumberOfIds(); ++j)
+    for (const auto id : ids[i])
     {
-      // get id
-      const vtkIdType id = ids->GetId(j);
       // compute weightmatrix
       WeightMatrix m = mitk::AnisotropicRegistrationCommon::CalculateWeightMatrix(sigma_X[i], sigma_Y[id]);
       // point of the fixed data set
-      Y->GetDataSet()->GetPoint(id, p);
+      Y->GetPoint(id, p);
 
       // fill mitk vector
       y[0] = p[0];
@@ -121,14 +140,12 @@ void mitk::AnisotropicIterativeClosestPointRegistration::ComputeCorrespondences(
     }
 
     // save correspondences of the fixed point set
-    Y->GetDataSet()->GetPoint(bestIdx, p);
+    Y->GetPoint(bestIdx, p);
     Z->SetPoint(i, p);
     sigma_Z[i] = sigma_Y[bestIdx];
 
     Correspondence _pair(i, bestDist);
     correspondences[i] = _pair;
-
-    ids->Delete();
   }
 }
 
@@ -160,9 +177,9 @@ void mitk::AnisotropicIterativeClosestPointRegistration::Update()
   CovarianceMatrixList Sigma_Z_sorted;
 
   // create kdtree for correspondence search
-  vtkKdTreePointLocator *Y = vtkKdTreePointLocator::New();
-  Y->SetDataSet(m_FixedSurface->GetVtkPolyData());
-  Y->BuildLocator();
+  vtkPoints *Y = m_FixedSurface->GetVtkPolyData()->GetPoints();
+  mitk::PointLocator::Pointer locator = mitk::PointLocator::New();
+  locator->SetPoints(m_FixedSurface->GetVtkPolyData());
 
   // initialize local variables
   // copy the moving pointset to prevent to modify it
@@ -212,7 +229,7 @@ void mitk::AnisotropicIterativeClosestPointRegistration::Update()
     do
     {
       // search correspondences
-      ComputeCorrespondences(X, Z, Y, Sigma_X, Sigma_Y, Sigma_Z, distanceList, currSearchRadius);
+      ComputeCorrespondences(X, Z, Y, locator, Sigma_X, Sigma_Y, Sigma_Z, distanceList, currSearchRadius);
 
       // tmp pointers
       vtkPoints *X_k = X;
@@ -302,7 +319,6 @@ void mitk::AnisotropicIterativeClosestPointRegistration::Update()
     mitk::ProgressBar::GetInstance()->Progress(steps);
 
   // free memory
-  Y->Delete();
   Z->Delete();
   X->Delete();
   X_sorted->Delete();
@@ -18,6 +18,117 @@ See LICENSE.txt or http://www.mitk.org for details.
 #include <ANN/ANN.h>
 #include <vtkPointSet.h>
 
+#include <algorithm>
+#include <array>
+#include <limits>
+#include <utility>
+
+struct mitk::PointLocator::SearchTree
+{
+  typedef std::pair<DistanceType, int> NeighbourType;
+
+  // coordinates of the points in tree order, the node of the range [begin, end) is stored at (begin + end) / 2
+  std::vector<double> Coordinates;
+  std::vector<int> Indices;
+  std::vector<unsigned char> SplitAxes;
+
+  SearchTree(const double *const *points, int numberOfPoints)
+    : Coordinates(3 * numberOfPoints), Indices(numberOfPoints), SplitAxes(numberOfPoints, 0)
+  {
+    for (int i = 0; i < numberOfPoints; ++i)
+      Indices[i] = i;
+    Build(points, 0, numberOfPoints);
+    for (int i = 0; i < numberOfPoints; ++i)
+    {
+      for (int d = 0; d < 3; ++d)
+        Coordinates[3 * i + d] = points[Indices[i]][d];
+    }
+  }
+
+  void Build(const double *const *points, int begin, int end)
+  {
+    if (end - begin < 2)
+      return;
+
+    // split along the axis of the largest extent
+    std::array<double, 3> minimum = {{points[Indices[begin]][0], points[Indices[begin]][1], points[Indices[begin]][2]}};
+    std::array<double, 3> maximum = minimum;
+    for (int i = begin + 1; i < end; ++i)
+    {
+      for (int d = 0; d < 3; ++d)
+      {
+        minimum[d] = std::min(minimum[d], points[Indices[i]][d]);
+        maximum[d] = std::max(maximum[d], points[Indices[i]][d]);
+      }
+    }
+    unsigned char axis = 0;
+    for (unsigned char d = 1; d < 3; ++d)
+    {
+      if (maximum[d] - minimum[d] > maximum[axis] - minimum[axis])
+        axis = d;
+    }
+
+    const int middle = (begin + end) / 2;
+    std::nth_element(Indices.begin() + begin,
+                     Indices.begin() + middle,
+                     Indices.begin() + end,
+                     [points, axis](int a, int b) { return points[a][axis] < points[b][axis]; });
+    SplitAxes[middle] = axis;
+    Build(points, begin, middle);
+    Build(points, middle + 1, end);
+  }
+
+  DistanceType SquaredDistance(const double *query, int node) const
+  {
+    const double *point = &Coordinates[3 * node];
+    return (query[0] - point[0]) * (query[0] - point[0]) + (query[1] - point[1]) * (query[1] - point[1]) +
+           (query[2] - point[2]) * (query[2] - point[2]);
+  }
+
+  /** Keeps the k closest nodes as max heap in neighbours */
+  void SearchNearest(const double *query, unsigned int k, int begin, int end, std::vector<NeighbourType> &neighbours) const
+  {
+    if (begin >= end)
+      return;
+
+    const int middle = (begin + end) / 2;
+    const DistanceType distance = SquaredDistance(query, middle);
+    if (neighbours.size() < k)
+    {
+      neighbours.push_back(std::make_pair(distance, middle));
+      std::push_heap(neighbours.begin(), neighbours.end());
+    }
+    else if (distance < neighbours.front().first)
+    {
+      std::pop_heap(neighbours.begin(), neighbours.end());
+      neighbours.back() = std::make_pair(distance, middle);
+      std::push_heap(neighbours.begin(), neighbours.end());
+    }
+
+    const double difference = query[SplitAxes[middle]] - Coordinates[3 * middle + SplitAxes[middle]];
+    const bool lowerFirst = difference < 0;
+    SearchNearest(query, k, lowerFirst ? begin : middle + 1, lowerFirst ? middle : end, neighbours);
+    if (neighbours.size() < k || difference * difference < neighbours.front().first)
+      SearchNearest(query, k, lowerFirst ? middle + 1 : begin, lowerFirst ? end : middle, neighbours);
+  }
+
+  void SearchRadius(const double *query, DistanceType squaredRadius, int begin, int end, std::vector<int> &nodes) const
+  {
+    if (begin >= end)
+      return;
+
+    const int middle = (begin + end) / 2;
+    if (SquaredDistance(query, middle) <= squaredRadius)
+      nodes.push_back(middle);
+
+    const double difference = query[SplitAxes[middle]] - Coordinates[3 * middle + SplitAxes[middle]];
+    if (difference <= 0 || difference * difference <= squaredRadius)
+      SearchRadius(query, squaredRadius, begin, middle, nodes);
+    if (difference >= 0 || difference * difference <= squaredRadius)
+      SearchRadius(query, squaredRadius, middle + 1, end, nodes);
+  }
+};
+
 mitk::PointLocator::PointLocator()
   : m_SearchTreeInitialized(false),
     m_VtkPoints(nullptr),
@@ -59,8 +170,8 @@ void mitk::PointLocator::SetPoints(vtkPointSet *pointSet)
   m_VtkPoints = points;
 
   size_t size = points->GetNumberOfPoints();
-  if (m_ANNDataPoints != nullptr)
-    delete[] m_ANNDataPoints;
+  if (m_SearchTreeInitialized)
+    DestroyANN();
   m_ANNDataPoints = annAllocPts(size, m_ANNDimension);
   m_IndexToPointIdContainer.clear();
   m_IndexToPointIdContainer.resize(size);
@@ -93,8 +204,8 @@ void mitk::PointLocator::SetPoints(mitk::PointSet *points)
   m_MitkPoints = points;
 
   size_t size = points->GetSize();
-  if (m_ANNDataPoints != nullptr)
-    delete[] m_ANNDataPoints;
+  if (m_SearchTreeInitialized)
+    DestroyANN();
   m_ANNDataPoints = annAllocPts(size, m_ANNDimension);
   m_IndexToPointIdContainer.clear();
   m_IndexToPointIdContainer.resize(size);
@@ -133,8 +244,8 @@ void mitk::PointLocator::SetPoints(ITKPointSet *pointSet)
   m_ItkPoints = pointSet;
 
   size_t size = pointSet->GetNumberOfPoints();
-  if (m_ANNDataPoints != nullptr)
-    delete[] m_ANNDataPoints;
+  if (m_SearchTreeInitialized)
+    DestroyANN();
   m_ANNDataPoints = annAllocPts(size, m_ANNDimension);
   m_IndexToPointIdContainer.clear();
   m_IndexToPointIdContainer.resize(size);
@@ -205,9 +316,6 @@ mitk::PointLocator::DistanceType mitk::PointLocator::GetMinimalDistance(const AN
 
 void mitk::PointLocator::InitANN()
 {
-  if (m_SearchTreeInitialized)
-    DestroyANN();
-
   m_ANNQueryPoint = annAllocPt(m_ANNDimension);
   m_ANNPointIndexes = new ANNidx[m_ANNK];
   m_ANNDistances = new ANNdist[m_ANNK];
@@ -229,6 +337,91 @@ void mitk::PointLocator::DestroyANN()
     delete[] m_ANNDistances;
   if (m_ANNTree != nullptr)
     delete m_ANNTree;
+  m_ANNQueryPoint = nullptr;
+  m_ANNDataPoints = nullptr;
+  m_ANNPointIndexes = nullptr;
+  m_ANNDistances = nullptr;
+  m_ANNTree = nullptr;
+  m_SearchTree.reset();
+}
+
+void mitk::PointLocator::InitSearchTree()
+{
+  if (m_SearchTree == nullptr)
+    m_SearchTree.reset(new SearchTree(m_ANNDataPoints, static_cast<int>(m_IndexToPointIdContainer.size())));
+}
+
+void mitk::PointLocator::FindClosestNPoints(const QueryPointsType &queryPoints,
+                                            unsigned int k,
+                                            IdVectorType &ids,
+                                            std::vector<DistanceType> &squaredDistances)
+{
+  const auto numberOfQueries = static_cast<int>(queryPoints.size());
+  ids.assign(queryPoints.size() * k, -1);
+  squaredDistances.assign(queryPoints.size() * k, std::numeric_limits<DistanceType>::max());
+  if (!m_SearchTreeInitialized || k == 0)
+    return;
+
+  InitSearchTree();
+  const int numberOfPoints = static_cast<int>(m_IndexToPointIdContainer.size());
+
+#pragma omp parallel
+  {
+    std::vector<SearchTree::NeighbourType> neighbours;
+    neighbours.reserve(k);
+#pragma omp for
+    for (int i = 0; i < numberOfQueries; ++i)
+    {
+      neighbours.clear();
+      m_SearchTree->SearchNearest(queryPoints[i].GetDataPointer(), k, 0, numberOfPoints, neighbours);
+      std::sort_heap(neighbours.begin(), neighbours.end());
+      for (std::size_t n = 0; n < neighbours.size(); ++n)
+      {
+        ids[i * k + n] = m_IndexToPointIdContainer[m_SearchTree->Indices[neighbours[n].second]];
+        squaredDistances[i * k + n] = neighbours[n].first;
+      }
+    }
+  }
+}
+
+void mitk::PointLocator::FindPointsWithinRadius(const QueryPointsType &queryPoints,
+                                                DistanceType radius,
+                                                std::vector<IdVectorType> &ids)
+{
+  const auto numberOfQueries = static_cast<int>(queryPoints.size());
+  ids.clear();
+  ids.resize(queryPoints.size());
+  if (!m_SearchTreeInitialized)
+    return;
+
+  InitSearchTree();
+  const int numberOfPoints = static_cast<int>(m_IndexToPointIdContainer.size());
+
+#pragma omp parallel
+  {
+    std::vector<int> nodes;
+#pragma omp for
+    for (int i = 0; i < numberOfQueries; ++i)
+    {
+      nodes.clear();
+      m_SearchTree->SearchRadius(queryPoints[i].GetDataPointer(), radius * radius, 0, numberOfPoints, nodes);
+      ids[i].resize(nodes.size());
+      for (std::size_t n = 0; n < nodes.size(); ++n)
+      {
+        ids[i][n] = m_IndexToPointIdContainer[m_SearchTree->Indices[nodes[n]]];
+      }
+    }
+  }
+}
+
+mitk::PointLocator::QueryPointsType mitk::PointLocator::ToQueryPoints(vtkPoints *points)
+{
+  QueryPointsType queryPoints(points->GetNumberOfPoints());
+  for (vtkIdType i = 0; i < points->GetNumberOfPoints(); ++i)
+  {
+    points->GetPoint(i, queryPoints[i].GetDataPointer());
+  }
+  return queryPoints;
 }
 
 bool mitk::PointLocator::FindClosestPointAndDistance(mitk::PointSet::PointType point, IdType *id, DistanceType *dist)
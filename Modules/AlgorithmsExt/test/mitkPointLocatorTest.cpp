@@ -0,0 +1,152 @@
+/*===================================================================
+
+The Medical Imaging Interaction Toolkit (MITK)
+
+Copyright (c) German Cancer Research Center,
+Division of Medical and Biological Informatics.
+All rights reserved.
+
+This software is distributed WITHOUT ANY WARRANTY; without
+even the implied warranty of MERCHANTABILITY or FITNESS FOR
+A PARTICULAR PURPOSE.
+
+See LICENSE.txt or http://www.mitk.org for details.
+
+===================================================================*/
+
+#include <mitkPointLocator.h>
+#include <mitkTestFixture.h>
+#include <mitkTestingMacros.h>
+
+#include <vtkPoints.h>
+#include <vtkPolyData.h>
+#include <vtkSmartPointer.h>
+
+#include <algorithm>
+#include <random>
+
+/**
+ * Compares the batched queries of the point locator with a brute force search.
+ */
+class mitkPointLocatorTestSuite : public mitk::TestFixture
+{
+  CPPUNIT_TEST_SUITE(mitkPointLocatorTestSuite);
+  MITK_TEST(FindClosestNPoints_MatchesBruteForce);
+  MITK_TEST(FindPointsWithinRadius_MatchesBruteForce);
+  MITK_TEST(FindClosestNPoints_MatchesSingleQueries);
+  CPPUNIT_TEST_SUITE_END();
+
+private:
+  vtkSmartPointer<vtkPolyData> m_PolyData;
+  mitk::PointLocator::QueryPointsType m_QueryPoints;
+  mitk::PointLocator::Pointer m_Locator;
+
+  double SquaredDistance(const mitk::Point3D &query, vtkIdType id)
+  {
+    double p[3];
+    m_PolyData->GetPoints()->GetPoint(id, p);
+    return (query[0] - p[0]) * (query[0] - p[0]) + (query[1] - p[1]) * (query[1] - p[1]) +
+           (query[2] - p[2]) * (query[2] - p[2]);
+  }
+
+public:
+  void setUp() override
+  {
+    std::mt19937 generator(42);
+    std::uniform_real_distribution<double> distribution(-50.0, 50.0);
+
+    auto points = vtkSmartPointer<vtkPoints>::New();
+    for (int i = 0; i < 2000; ++i)
+    {
+      points->InsertNextPoint(distribution(generator), distribution(generator), distribution(generator));
+    }
+    m_PolyData = vtkSmartPointer<vtkPolyData>::New();
+    m_PolyData->SetPoints(points);
+
+    m_QueryPoints.resize(500);
+    for (auto &query : m_QueryPoints)
+    {
+      query[0] = distribution(generator);
+      query[1] = distribution(generator);
+      query[2] = distribution(generator);
+    }
+
+    m_Locator = mitk::PointLocator::New();
+    m_Locator->SetPoints(m_PolyData.GetPointer());
+  }
+
+  void tearDown() override
+  {
+    m_Locator = nullptr;
+    m_PolyData = nullptr;
+    m_QueryPoints.clear();
+  }
+
+  void FindClosestNPoints_MatchesBruteForce()
+  {
+    const unsigned int k = 5;
+    mitk::PointLocator::IdVectorType ids;
+    std::vector<mitk::PointLocator::DistanceType> distances;
+    m_Locator->FindClosestNPoints(m_QueryPoints, k, ids, distances);
+
+    CPPUNIT_ASSERT_EQUAL(m_QueryPoints.size() * k, ids.size());
+    for (std::size_t i = 0; i < m_QueryPoints.size(); ++i)
+    {
+      std::vector<double> expected;
+      for (vtkIdType id = 0; id < m_PolyData->GetNumberOfPoints(); ++id)
+      {
+        expected.push_back(SquaredDistance(m_QueryPoints[i], id));
+      }
+      std::sort(expected.begin(), expected.end());
+
+      for (unsigned int n = 0; n < k; ++n)
+      {
+        CPPUNIT_ASSERT_DOUBLES_EQUAL(expected[n], distances[i * k + n], 1e-9);
+        CPPUNIT_ASSERT_DOUBLES_EQUAL(expected[n], SquaredDistance(m_QueryPoints[i], ids[i * k + n]), 1e-9);
+      }
+    }
+  }
+
+  void FindPointsWithinRadius_MatchesBruteForce()
+  {
+    const double radius = 8.0;
+    std::vector<mitk::PointLocator::IdVectorType> ids;
+    m_Locator->FindPointsWithinRadius(m_QueryPoints, radius, ids);
+
+    CPPUNIT_ASSERT_EQUAL(m_QueryPoints.size(), ids.size());
+    for (std::size_t i = 0; i < m_QueryPoints.size(); ++i)
+    {
+      mitk::PointLocator::IdVectorType expected;
+      for (vtkIdType id = 0; id < m_PolyData->GetNumberOfPoints(); ++id)
+      {
+        if (SquaredDistance(m_QueryPoints[i], id) <= radius * radius)
+          expected.push_back(static_cast<mitk::PointLocator::IdType>(id));
+      }
+      std::sort(ids[i].begin(), ids[i].end());
+      CPPUNIT_ASSERT_MESSAGE("Radius search should find all points within the radius", expected == ids[i]);
+    }
+  }
+
+  void FindClosestNPoints_MatchesSingleQueries()
+  {
+    mitk::PointLocator::IdVectorType singleIds;
+    for (const auto &query : m_QueryPoints)
+    {
+      singleIds.push_back(m_Locator->FindClosestPoint(query));
+    }
+
+    mitk::PointLocator::IdVectorType ids;
+    std::vector<mitk::PointLocator::DistanceType> distances;
+    m_Locator->FindClosestNPoints(m_QueryPoints, 1, ids, distances);
+
+    CPPUNIT_ASSERT_EQUAL(m_QueryPoints.size(), ids.size());
+    CPPUNIT_ASSERT_EQUAL(m_QueryPoints.size(), distances.size());
+    for (std::size_t i = 0; i < m_QueryPoints.size(); ++i)
+    {
+      CPPUNIT_ASSERT_DOUBLES_EQUAL(SquaredDistance(m_QueryPoints[i], singleIds[i]), distances[i], 1e-9);
+      CPPUNIT_ASSERT_DOUBLES_EQUAL(distances[i], SquaredDistance(m_QueryPoints[i], ids[i]), 1e-9);
+    }
+  }
+};
+
+MITK_TEST_SUITE_REGISTRATION(mitkPointLocator)
@@ -5,6 +5,7 @@ set(CPP_FILES
   mitkAbstractClassifier.cpp
   mitkAbstractGlobalImageFeature.cpp
   mitkIntensityQuantifier.cpp
+  mitkTextureMatrixSession.cpp
 )
 
 set( TOOL_FILES
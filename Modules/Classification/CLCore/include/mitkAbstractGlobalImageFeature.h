@@ -26,6 +26,7 @@ See LICENSE.txt or http://www.mitk.org for details.
 #include <mitkCommandLineParser.h>
 
 #include <mitkIntensityQuantifier.h>
+#include <mitkTextureMatrixSession.h>
 
 // STD Includes
 
@@ -239,6 +240,21 @@ public:
   void InitializeQuantifier(const Image::Pointer & feature, const Image::Pointer &mask, unsigned int defaultBins = 256);
   std::string QuantifierParameterString();
 
+  /**
+  * \brief Session shared with other features, so that their texture matrices are computed together.
+  *
+  * Features which do not use texture matrices ignore the session. If no session is set, each feature
+  * computes its matrices on its own.
+  */
+  itkSetMacro(TextureMatrixSession, TextureMatrixSession::Pointer);
+  itkGetMacro(TextureMatrixSession, TextureMatrixSession::Pointer);
+
+  /**
+  * \brief Announces the texture matrices CalculateFeaturesUsingParameters() will need with the current
+  * parameters to the given session. Does nothing for features without texture matrices.
+  */
+  virtual void AddTextureMatrixRequests(TextureMatrixSession * /*session*/) {};
+
 public:
 
 //#ifndef DOXYGEN_SKIP
@@ -269,6 +285,7 @@ private:
 
   bool m_UseQuantifier = false;
   IntensityQuantifier::Pointer m_Quantifier;
+  TextureMatrixSession::Pointer m_TextureMatrixSession;
 
   double m_MinimumIntensity = 0;
   bool m_UseMinimumIntensity = false;
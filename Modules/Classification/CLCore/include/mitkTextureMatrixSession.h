@@ -0,0 +1,168 @@
+/*===================================================================
+
+The Medical Imaging Interaction Toolkit (MITK)
+
+Copyright (c) German Cancer Research Center,
+Division of Medical and Biological Informatics.
+All rights reserved.
+
+This software is distributed WITHOUT ANY WARRANTY; without
+even the implied warranty of MERCHANTABILITY or FITNESS FOR
+A PARTICULAR PURPOSE.
+
+See LICENSE.txt or http://www.mitk.org for details.
+
+===================================================================*/
+
+
+#ifndef mitkTextureMatrixSession_h
+#define mitkTextureMatrixSession_h
+
+#include <MitkCLCoreExports.h>
+
+#include <mitkCommon.h>
+#include <mitkImage.h>
+#include <mitkIntensityQuantifier.h>
+
+#include <itkObject.h>
+
+// STD Includes
+#include <array>
+#include <list>
+#include <map>
+#include <memory>
+#include <set>
+#include <vector>
+
+// Eigen
+#include <Eigen/Dense>
+
+namespace mitk
+{
+  /**
+  * \brief Shares the binned image and the texture matrices between several global image features.
+  *
+  * Texture features like the co-occurence, the neighbouring grey level dependence and the size zone
+  * based features all bin the masked image and walk through the neighbourhood of every masked voxel.
+  * If these features are calculated for the same image and mask, the session bins the image only once
+  * for each quantization and keeps the list of masked voxels. All matrices which have been announced
+  * with AddRequest() are computed together in a single multi-threaded traversal of the masked voxels
+  * as soon as the first of them is requested with GetResult().
+  *
+  * The cached data is dropped as soon as another (or a modified) image or mask is passed.
+  *
+  * The session is used by all features that got it via AbstractGlobalImageFeature::SetTextureMatrixSession().
+  */
+  class MITKCLCORE_EXPORT TextureMatrixSession : public itk::Object
+  {
+  public:
+    mitkClassMacroItkParent(TextureMatrixSession, itk::Object);
+    itkFactorylessNewMacro(Self);
+
+    enum MatrixType
+    {
+      Cooccurence,
+      Dependence,
+      SizeZone
+    };
+
+    typedef std::array<int, 3> OffsetType;
+
+    /**
+    * \brief Description of a matrix. Range and direction have the meaning of the respective feature
+    * options, alpha is the coarseness parameter of the dependence matrix.
+    */
+    struct Request
+    {
+      Request(MatrixType type = Cooccurence, int range = 1, int direction = 0, int alpha = 0);
+      bool operator<(const Request &other) const;
+
+      MatrixType Type;
+      int Range;
+      int Direction;
+      int Alpha;
+    };
+
+    struct Result
+    {
+      Result();
+
+      /**
+      * \brief One bins x bins matrix for each offset of a co-occurence request, a single bins x
+      * (neighbourhood size + 1) matrix for dependence and a bins x largest zone matrix for size zone requests.
+      */
+      std::vector<Eigen::MatrixXd> Matrices;
+
+      // neighbourhood statistics of dependence requests
+      int NeighbourhoodSize;
+      unsigned long NumberOfNeighbourVoxels;
+      unsigned long NumberOfDependenceNeighbourVoxels;
+      unsigned long NumberOfNeighbourhoods;
+      unsigned long NumberOfCompleteNeighbourhoods;
+    };
+
+    /**
+    * \brief Announces a matrix which will be requested later on, so that it is computed together with
+    * all other announced matrices.
+    */
+    void AddRequest(const Request &request);
+
+    /**
+    * \brief Returns the requested matrix for the image binned by the given quantifier. Voxels which
+    * are not masked or not a number are ignored.
+    *
+    * The result stays valid after the session dropped its cached data, e.g. because another image was passed.
+    */
+    std::shared_ptr<const Result> GetResult(const Image::Pointer &image, const Image::Pointer &mask, IntensityQuantifier *quantifier, const Request &request);
+
+    /**
+    * \brief Drops all cached images and matrices, the announced requests are kept.
+    */
+    void Clear();
+
+    /**
+    * \brief Returns the directions of a half neighbourhood with the given range, skipping the
+    * axis direction - 2 for direction > 1, or only the z-axis for direction 1.
+    */
+    static std::vector<OffsetType> GetHalfNeighbourhoodOffsets(unsigned int dimension, int range, int direction);
+
+    itkGetConstMacro(NumberOfQuantizations, unsigned int);
+    itkGetConstMacro(NumberOfTraversals, unsigned int);
+
+  protected:
+    TextureMatrixSession();
+    ~TextureMatrixSession() override;
+
+    struct QuantizedImage
+    {
+      double Minimum;
+      double Binsize;
+      unsigned int Bins;
+
+      /** bin of each voxel, -1 for voxels outside of the mask */
+      std::vector<int> BinIndices;
+      std::vector<std::size_t> MaskedVoxels;
+      std::map<Request, std::shared_ptr<const Result> > Results;
+    };
+
+    std::shared_ptr<QuantizedImage> GetQuantizedImage(const Image::Pointer &image, const Image::Pointer &mask, IntensityQuantifier *quantifier);
+
+    void ComputeResults(QuantizedImage &quantizedImage, const std::vector<Request> &requests);
+    void ComputeSizeZoneResult(QuantizedImage &quantizedImage, const Request &request, Result &result);
+
+    std::set<Request> m_Requests;
+    std::list<std::shared_ptr<QuantizedImage> > m_QuantizedImages;
+
+    Image::Pointer m_Image;
+    Image::Pointer m_Mask;
+    unsigned long m_ImageMTime;
+    unsigned long m_MaskMTime;
+    unsigned int m_Dimension;
+    int m_Size[3];
+
+    unsigned int m_NumberOfQuantizations;
+    unsigned int m_NumberOfTraversals;
+  };
+}
+
+#endif //mitkTextureMatrixSession_h
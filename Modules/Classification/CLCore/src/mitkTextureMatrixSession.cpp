@@ -0,0 +1,444 @@
+/*===================================================================
+
+The Medical Imaging Interaction Toolkit (MITK)
+
+Copyright (c) German Cancer Research Center,
+Division of Medical and Biological Informatics.
+All rights reserved.
+
+This software is distributed WITHOUT ANY WARRANTY; without
+even the implied warranty of MERCHANTABILITY or FITNESS FOR
+A PARTICULAR PURPOSE.
+
+See LICENSE.txt or http://www.mitk.org for details.
+
+===================================================================*/
+
+#include <mitkTextureMatrixSession.h>
+
+// MITK
+#include <mitkExceptionMacro.h>
+#include <mitkImageAccessByItk.h>
+#include <mitkImageCast.h>
+
+// STL
+#include <algorithm>
+#include <cstdlib>
+
+template<typename TPixel, unsigned int VImageDimension>
+static void
+QuantizeImage(itk::Image<TPixel, VImageDimension>* itkImage, mitk::Image::Pointer mask, mitk::IntensityQuantifier* quantifier, std::vector<int> &binIndices)
+{
+  typedef itk::Image<unsigned short, VImageDimension> MaskImageType;
+
+  typename MaskImageType::Pointer itkMask = MaskImageType::New();
+  mitk::CastToItkImage(mask, itkMask);
+
+  const TPixel *pixels = itkImage->GetBufferPointer();
+  const unsigned short *maskPixels = itkMask->GetBufferPointer();
+  const auto numberOfPixels = static_cast<std::ptrdiff_t>(itkImage->GetLargestPossibleRegion().GetNumberOfPixels());
+
+  binIndices.resize(numberOfPixels);
+
+#pragma omp parallel for
+  for (std::ptrdiff_t i = 0; i < numberOfPixels; ++i)
+  {
+    const double value = pixels[i];
+    binIndices[i] = (maskPixels[i] > 0 && value == value) ? static_cast<int>(quantifier->IntensityToIndex(value)) : -1;
+  }
+}
+
+static std::size_t FindZone(std::vector<std::size_t> &parents, std::size_t voxel)
+{
+  while (parents[voxel] != voxel)
+  {
+    parents[voxel] = parents[parents[voxel]];
+    voxel = parents[voxel];
+  }
+  return voxel;
+}
+
+mitk::TextureMatrixSession::Request::Request(MatrixType type, int range, int direction, int alpha) :
+  Type(type),
+  Range(range),
+  Direction(direction),
+  Alpha(alpha)
+{
+}
+
+bool mitk::TextureMatrixSession::Request::operator<(const Request &other) const
+{
+  if (Type != other.Type)
+    return Type < other.Type;
+  if (Range != other.Range)
+    return Range < other.Range;
+  if (Direction != other.Direction)
+    return Direction < other.Direction;
+  return Alpha < other.Alpha;
+}
+
+mitk::TextureMatrixSession::Result::Result() :
+  NeighbourhoodSize(0),
+  NumberOfNeighbourVoxels(0),
+  NumberOfDependenceNeighbourVoxels(0),
+  NumberOfNeighbourhoods(0),
+  NumberOfCompleteNeighbourhoods(0)
+{
+}
+
+mitk::TextureMatrixSession::TextureMatrixSession() :
+  m_ImageMTime(0),
+  m_MaskMTime(0),
+  m_Dimension(0),
+  m_NumberOfQuantizations(0),
+  m_NumberOfTraversals(0)
+{
+  m_Size[0] = m_Size[1] = m_Size[2] = 0;
+}
+
+mitk::TextureMatrixSession::~TextureMatrixSession()
+{
+}
+
+void mitk::TextureMatrixSession::AddRequest(const Request &request)
+{
+  m_Requests.insert(request);
+}
+
+void mitk::TextureMatrixSession::Clear()
+{
+  m_QuantizedImages.clear();
+  m_Image = nullptr;
+  m_Mask = nullptr;
+}
+
+std::vector<mitk::TextureMatrixSession::OffsetType>
+mitk::TextureMatrixSession::GetHalfNeighbourhoodOffsets(unsigned int dimension, int range, int direction)
+{
+  std::vector<OffsetType> offsets;
+  if (direction == 1)
+  {
+    OffsetType offset = { { 0, 0, range } };
+    offsets.push_back(offset);
+    return offsets;
+  }
+
+  // the first half of a 3x3(x3) neighbourhood, in the order of itk::Neighborhood
+  unsigned int numberOfOffsets = 1;
+  for (unsigned int i = 0; i < dimension; ++i)
+    numberOfOffsets *= 3;
+  numberOfOffsets /= 2;
+
+  for (unsigned int d = 0; d < numberOfOffsets; ++d)
+  {
+    OffsetType offset = { { 0, 0, 0 } };
+    unsigned int position = d;
+    bool useOffset = true;
+    for (unsigned int i = 0; i < dimension; ++i)
+    {
+      offset[i] = (static_cast<int>(position % 3) - 1) * range;
+      position /= 3;
+      if (direction == static_cast<int>(i) + 2 && offset[i] != 0)
+      {
+        useOffset = false;
+      }
+    }
+    if (useOffset)
+    {
+      offsets.push_back(offset);
+    }
+  }
+  return offsets;
+}
+
+std::shared_ptr<mitk::TextureMatrixSession::QuantizedImage>
+mitk::TextureMatrixSession::GetQuantizedImage(const Image::Pointer &image, const Image::Pointer &mask, IntensityQuantifier *quantifier)
+{
+  if (image != m_Image || mask != m_Mask || image->GetMTime() != m_ImageMTime || mask->GetMTime() != m_MaskMTime)
+  {
+    m_QuantizedImages.clear();
+    m_Image = image;
+    m_Mask = mask;
+    m_ImageMTime = image->GetMTime();
+    m_MaskMTime = mask->GetMTime();
+    m_Dimension = image->GetDimension();
+    for (unsigned int i = 0; i < 3; ++i)
+    {
+      m_Size[i] = i < m_Dimension ? static_cast<int>(image->GetDimension(i)) : 1;
+    }
+  }
+
+  for (const auto &quantizedImage : m_QuantizedImages)
+  {
+    if (quantizedImage->Minimum == quantifier->GetMinimum() && quantizedImage->Binsize == quantifier->GetBinsize() &&
+        quantizedImage->Bins == quantifier->GetBins())
+    {
+      return quantizedImage;
+    }
+  }
+
+  auto quantizedImage = std::make_shared<QuantizedImage>();
+  quantizedImage->Minimum = quantifier->GetMinimum();
+  quantizedImage->Binsize = quantifier->GetBinsize();
+  quantizedImage->Bins = quantifier->GetBins();
+  AccessByItk_3(image, QuantizeImage, mask, quantifier, quantizedImage->BinIndices);
+
+  for (std::size_t i = 0; i < quantizedImage->BinIndices.size(); ++i)
+  {
+    if (quantizedImage->BinIndices[i] >= 0)
+      quantizedImage->MaskedVoxels.push_back(i);
+  }
+
+  ++m_NumberOfQuantizations;
+  m_QuantizedImages.push_back(quantizedImage);
+  return quantizedImage;
+}
+
+std::shared_ptr<const mitk::TextureMatrixSession::Result>
+mitk::TextureMatrixSession::GetResult(const Image::Pointer &image, const Image::Pointer &mask, IntensityQuantifier *quantifier, const Request &request)
+{
+  if (image->GetDimension() > 3)
+  {
+    mitkThrow() << "Texture matrices can only be computed for 2D and 3D images.";
+  }
+
+  std::shared_ptr<QuantizedImage> quantizedImage = this->GetQuantizedImage(image, mask, quantifier);
+
+  auto resultIter = quantizedImage->Results.find(request);
+  if (resultIter != quantizedImage->Results.end())
+  {
+    return resultIter->second;
+  }
+
+  // compute the requested matrix together with all announced ones that are still missing
+  m_Requests.insert(request);
+  std::vector<Request> missingRequests;
+  for (const auto &announcedRequest : m_Requests)
+  {
+    if (quantizedImage->Results.count(announcedRequest) == 0)
+      missingRequests.push_back(announcedRequest);
+  }
+  this->ComputeResults(*quantizedImage, missingRequests);
+
+  return quantizedImage->Results[request];
+}
+
+void mitk::TextureMatrixSession::ComputeResults(QuantizedImage &quantizedImage, const std::vector<Request> &requests)
+{
+  const int bins = static_cast<int>(quantizedImage.Bins);
+  const int sizeX = m_Size[0];
+  const int sizeY = m_Size[1];
+  const int sizeZ = m_Size[2];
+
+  // offsets and empty matrices of all requests which are computed in the common traversal
+  std::vector<Request> neighbourhoodRequests;
+  std::vector<std::vector<OffsetType> > neighbourhoodOffsets;
+  std::vector<Result> results;
+
+  for (const auto &request : requests)
+  {
+    if (request.Type == SizeZone)
+    {
+      auto result = std::make_shared<Result>();
+      this->ComputeSizeZoneResult(quantizedImage, request, *result);
+      quantizedImage.Results[request] = result;
+      continue;
+    }
+
+    Result result;
+    std::vector<OffsetType> offsets;
+    if (request.Type == Cooccurence)
+    {
+      offsets = GetHalfNeighbourhoodOffsets(m_Dimension, request.Range, request.Direction);
+      result.Matrices.assign(offsets.size(), Eigen::MatrixXd::Zero(bins, bins));
+    }
+    else
+    {
+      // complete box around the voxel, flat in the ignored direction
+      int radius[3] = { 0, 0, 0 };
+      for (unsigned int i = 0; i < m_Dimension; ++i)
+      {
+        radius[i] = (request.Direction > 1 && request.Direction - 2 == static_cast<int>(i)) ? 0 : request.Range;
+      }
+      for (int z = -radius[2]; z <= radius[2]; ++z)
+        for (int y = -radius[1]; y <= radius[1]; ++y)
+          for (int x = -radius[0]; x <= radius[0]; ++x)
+          {
+            if (x != 0 || y != 0 || z != 0)
+            {
+              OffsetType offset = { { x, y, z } };
+              offsets.push_back(offset);
+            }
+          }
+      result.NeighbourhoodSize = static_cast<int>(offsets.size());
+      result.Matrices.assign(1, Eigen::MatrixXd::Zero(bins, offsets.size() + 1));
+    }
+    neighbourhoodRequests.push_back(request);
+    neighbourhoodOffsets.push_back(offsets);
+    results.push_back(result);
+  }
+
+  if (neighbourhoodRequests.empty())
+  {
+    return;
+  }
+
+  const std::vector<int> &binIndices = quantizedImage.BinIndices;
+  const std::vector<std::size_t> &maskedVoxels = quantizedImage.MaskedVoxels;
+  const auto numberOfMaskedVoxels = static_cast<std::ptrdiff_t>(maskedVoxels.size());
+  const std::size_t sliceSize = static_cast<std::size_t>(sizeX) * sizeY;
+
+#pragma omp parallel
+  {
+    std::vector<Result> localResults(results);
+
+#pragma omp for schedule(static)
+    for (std::ptrdiff_t v = 0; v < numberOfMaskedVoxels; ++v)
+    {
+      const std::size_t voxel = maskedVoxels[v];
+      const int x = static_cast<int>(voxel % sizeX);
+      const int y = static_cast<int>((voxel / sizeX) % sizeY);
+      const int z = static_cast<int>(voxel / sliceSize);
+      const int i = binIndices[voxel];
+
+      for (std::size_t r = 0; r < neighbourhoodRequests.size(); ++r)
+      {
+        const std::vector<OffsetType> &offsets = neighbourhoodOffsets[r];
+        Result &result = localResults[r];
+
+        int dependentNeighbours = 0;
+        bool completeNeighbourhood = true;
+
+        for (std::size_t k = 0; k < offsets.size(); ++k)
+        {
+          const int nx = x + offsets[k][0];
+          const int ny = y + offsets[k][1];
+          const int nz = z + offsets[k][2];
+          if (nx < 0 || ny < 0 || nz < 0 || nx >= sizeX || ny >= sizeY || nz >= sizeZ)
+          {
+            completeNeighbourhood = false;
+            continue;
+          }
+
+          const int j = binIndices[static_cast<std::size_t>(nz) * sliceSize + static_cast<std::size_t>(ny) * sizeX + nx];
+          if (j < 0)
+          {
+            completeNeighbourhood = false;
+            continue;
+          }
+
+          if (neighbourhoodRequests[r].Type == Cooccurence)
+          {
+            result.Matrices[k](i, j) += 1;
+            result.Matrices[k](j, i) += 1;
+          }
+          else
+          {
+            result.NumberOfNeighbourVoxels += 1;
+            if (std::abs(i - j) <= neighbourhoodRequests[r].Alpha)
+            {
+              result.NumberOfDependenceNeighbourVoxels += 1;
+              ++dependentNeighbours;
+            }
+          }
+        }
+
+        if (neighbourhoodRequests[r].Type == Dependence)
+        {
+          result.Matrices[0](i, dependentNeighbours) += 1;
+          result.NumberOfNeighbourhoods += 1;
+          if (completeNeighbourhood)
+          {
+            result.NumberOfCompleteNeighbourhoods += 1;
+          }
+        }
+      }
+    }
+
+#pragma omp critical
+    {
+      for (std::size_t r = 0; r < results.size(); ++r)
+      {
+        for (std::size_t k = 0; k < results[r].Matrices.size(); ++k)
+        {
+          results[r].Matrices[k] += localResults[r].Matrices[k];
+        }
+        results[r].NumberOfNeighbourVoxels += localResults[r].NumberOfNeighbourVoxels;
+        results[r].NumberOfDependenceNeighbourVoxels += localResults[r].NumberOfDependenceNeighbourVoxels;
+        results[r].NumberOfNeighbourhoods += localResults[r].NumberOfNeighbourhoods;
+        results[r].NumberOfCompleteNeighbourhoods += localResults[r].NumberOfCompleteNeighbourhoods;
+      }
+    }
+  }
+
+  for (std::size_t r = 0; r < neighbourhoodRequests.size(); ++r)
+  {
+    quantizedImage.Results[neighbourhoodRequests[r]] = std::make_shared<const Result>(std::move(results[r]));
+  }
+  ++m_NumberOfTraversals;
+}
+
+void mitk::TextureMatrixSession::ComputeSizeZoneResult(QuantizedImage &quantizedImage, const Request &request, Result &result)
+{
+  const int sizeX = m_Size[0];
+  const int sizeY = m_Size[1];
+  const int sizeZ = m_Size[2];
+  const std::size_t sliceSize = static_cast<std::size_t>(sizeX) * sizeY;
+  const std::vector<int> &binIndices = quantizedImage.BinIndices;
+  const std::vector<std::size_t> &maskedVoxels = quantizedImage.MaskedVoxels;
+
+  // zones are the connected components of equally binned voxels, joined with a union find on the masked
+  // voxels instead of a flood fill for each zone. The half neighbourhood is sufficient as joining is symmetric.
+  const std::vector<OffsetType> offsets = GetHalfNeighbourhoodOffsets(m_Dimension, 1, request.Direction);
+
+  std::vector<std::size_t> maskedVoxelIds(binIndices.size(), 0);
+  std::vector<std::size_t> parents(maskedVoxels.size());
+  for (std::size_t v = 0; v < maskedVoxels.size(); ++v)
+  {
+    maskedVoxelIds[maskedVoxels[v]] = v;
+    parents[v] = v;
+  }
+
+  for (std::size_t v = 0; v < maskedVoxels.size(); ++v)
+  {
+    const std::size_t voxel = maskedVoxels[v];
+    const int x = static_cast<int>(voxel % sizeX);
+    const int y = static_cast<int>((voxel / sizeX) % sizeY);
+    const int z = static_cast<int>(voxel / sliceSize);
+
+    for (const auto &offset : offsets)
+    {
+      const int nx = x + offset[0];
+      const int ny = y + offset[1];
+      const int nz = z + offset[2];
+      if (nx < 0 || ny < 0 || nz < 0 || nx >= sizeX || ny >= sizeY || nz >= sizeZ)
+        continue;
+
+      const std::size_t neighbour = static_cast<std::size_t>(nz) * sliceSize + static_cast<std::size_t>(ny) * sizeX + nx;
+      if (binIndices[neighbour] != binIndices[voxel])
+        continue;
+
+      const std::size_t zone = FindZone(parents, v);
+      const std::size_t neighbourZone = FindZone(parents, maskedVoxelIds[neighbour]);
+      if (zone != neighbourZone)
+        parents[std::max(zone, neighbourZone)] = std::min(zone, neighbourZone);
+    }
+  }
+
+  std::vector<std::size_t> zoneSizes(maskedVoxels.size(), 0);
+  std::size_t largestZone = 0;
+  for (std::size_t v = 0; v < maskedVoxels.size(); ++v)
+  {
+    const std::size_t zone = FindZone(parents, v);
+    largestZone = std::max(largestZone, ++zoneSizes[zone]);
+  }
+
+  result.Matrices.assign(1, Eigen::MatrixXd::Zero(quantizedImage.Bins, largestZone));
+  for (std::size_t v = 0; v < maskedVoxels.size(); ++v)
+  {
+    if (zoneSizes[v] > 0)
+    {
+      result.Matrices[0](binIndices[maskedVoxels[v]], zoneSizes[v] - 1) += 1;
+    }
+  }
+}
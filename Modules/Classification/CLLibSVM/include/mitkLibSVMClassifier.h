@@ -45,6 +45,13 @@ namespace mitk
     void Train(const Eigen::MatrixXd &X, const Eigen::MatrixXi &Y) override;
     Eigen::MatrixXi Predict(const Eigen::MatrixXd &X) override;
 
+    /**
+    * \brief Returns the values of the decision functions for each sample, as computed by svm_predict_values.
+    *
+    * Classification models have one column for each pair of classes, one-class and regression models a single column.
+    */
+    Eigen::MatrixXd PredictDecisionValues(const Eigen::MatrixXd &X);
+
     bool SupportsPointWiseWeight() override{return true;}
     bool SupportsPointWiseProbability() override{return false;}
 
@@ -71,9 +78,22 @@ namespace mitk
     void ReadYValues(LibSVM::svm_problem * problem, const Eigen::MatrixXi &Y);
     void ReadWValues(LibSVM::svm_problem * problem);
 
+    /**
+    * \brief Copies the support vectors of the trained model to a dense matrix, which allows to
+    * evaluate the kernel for a block of samples at once.
+    */
+    void UpdateDenseModel(int noOfFeatures);
+    int GetNumberOfDecisionValues() const;
+    Eigen::MatrixXd ComputeDenseDecisionValues(const Eigen::MatrixXd &samples) const;
+    void PredictDenseBlock(const Eigen::MatrixXd &X, Eigen::MatrixXi &result, int startRow, int noOfRows) const;
+
     LibSVM::svm_model* m_Model;
     LibSVM::svm_parameter * m_Parameter;
 
+    // one row for each support vector, empty if the kernel can not be evaluated densely
+    Eigen::MatrixXd m_SupportVectors;
+    Eigen::VectorXd m_SupportVectorSquaredNorms;
+
   };
 }
 
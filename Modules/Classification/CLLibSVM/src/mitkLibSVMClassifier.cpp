@@ -23,6 +23,16 @@ namespace LibSVM
 }
 #include <mitkExceptionMacro.h>
 
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+namespace
+{
+  // number of samples whose kernel values are computed together in one matrix product
+  const int PredictionBlockSize = 256;
+}
+
 mitk::LibSVMClassifier::LibSVMClassifier():
   m_Model(nullptr),m_Parameter(nullptr)
 {
@@ -63,7 +73,12 @@ void mitk::LibSVMClassifier::Train(const Eigen::MatrixXd &X, const Eigen::Matrix
     mitkThrow() << "Error: " << error_msg;
   }
 
+  if (m_Model)
+  {
+    LibSVM::svm_free_and_destroy_model(&m_Model);
+  }
   m_Model = LibSVM::svm_train(&problem, m_Parameter);
+  UpdateDenseModel(static_cast<int>(X.cols()));
 
   // free(problem.y);
   // free(problem.x);
@@ -81,22 +96,218 @@ Eigen::MatrixXi mitk::LibSVMClassifier::Predict(const Eigen::MatrixXd &X)
 
   Eigen::MatrixXi result(noOfPoints,1);
 
-  auto * xVector = static_cast<LibSVM::svm_node *>(malloc(sizeof(LibSVM::svm_node) * (noOfFeatures+1)));
-  for (int point = 0; point < noOfPoints; ++point)
+  if (m_SupportVectors.rows() > 0 && m_SupportVectors.cols() == noOfFeatures)
+  {
+    const int noOfBlocks = (noOfPoints + PredictionBlockSize - 1) / PredictionBlockSize;
+#pragma omp parallel for
+    for (int block = 0; block < noOfBlocks; ++block)
+    {
+      int startRow = block * PredictionBlockSize;
+      PredictDenseBlock(X, result, startRow, std::min(PredictionBlockSize, noOfPoints - startRow));
+    }
+    return result;
+  }
+
+#pragma omp parallel
+  {
+    auto * xVector = static_cast<LibSVM::svm_node *>(malloc(sizeof(LibSVM::svm_node) * (noOfFeatures+1)));
+#pragma omp for
+    for (int point = 0; point < noOfPoints; ++point)
+    {
+      for (int feature = 0; feature < noOfFeatures; ++feature)
+      {
+        xVector[feature].index = feature+1;
+        xVector[feature].value = X(point, feature);
+      }
+      xVector[noOfFeatures].index = -1;
+      result(point,0) = LibSVM::svm_predict(m_Model,xVector);
+    }
+    free(xVector);
+  }
+  return result;
+}
+
+Eigen::MatrixXd mitk::LibSVMClassifier::PredictDecisionValues(const Eigen::MatrixXd &X)
+{
+  if ( ! m_Model)
+  {
+    mitkThrow() << "No Model is trained. Train or load a model before predicting new values.";
+  }
+  auto noOfPoints = static_cast<int>(X.rows());
+  auto noOfFeatures = static_cast<int>(X.cols());
+
+  Eigen::MatrixXd result(noOfPoints, GetNumberOfDecisionValues());
+
+  if (m_SupportVectors.rows() > 0 && m_SupportVectors.cols() == noOfFeatures)
   {
-    for (int feature = 0; feature < noOfFeatures; ++feature)
+    const int noOfBlocks = (noOfPoints + PredictionBlockSize - 1) / PredictionBlockSize;
+#pragma omp parallel for
+    for (int block = 0; block < noOfBlocks; ++block)
     {
-      xVector[feature].index = feature+1;
-      xVector[feature].value = X(point, feature);
+      int startRow = block * PredictionBlockSize;
+      int noOfRows = std::min(PredictionBlockSize, noOfPoints - startRow);
+      result.middleRows(startRow, noOfRows) = ComputeDenseDecisionValues(X.middleRows(startRow, noOfRows));
     }
-    xVector[noOfFeatures].index = -1;
-    result(point,0) = LibSVM::svm_predict(m_Model,xVector);
+    return result;
   }
 
-  free(xVector);
+#pragma omp parallel
+  {
+    auto * xVector = static_cast<LibSVM::svm_node *>(malloc(sizeof(LibSVM::svm_node) * (noOfFeatures+1)));
+    std::vector<double> decisionValues(result.cols());
+#pragma omp for
+    for (int point = 0; point < noOfPoints; ++point)
+    {
+      for (int feature = 0; feature < noOfFeatures; ++feature)
+      {
+        xVector[feature].index = feature+1;
+        xVector[feature].value = X(point, feature);
+      }
+      xVector[noOfFeatures].index = -1;
+      LibSVM::svm_predict_values(m_Model, xVector, decisionValues.data());
+      for (int i = 0; i < result.cols(); ++i)
+        result(point, i) = decisionValues[i];
+    }
+    free(xVector);
+  }
   return result;
 }
 
+int mitk::LibSVMClassifier::GetNumberOfDecisionValues() const
+{
+  const int svmType = m_Model->param.svm_type;
+  if (svmType == LibSVM::ONE_CLASS || svmType == LibSVM::EPSILON_SVR || svmType == LibSVM::NU_SVR)
+    return 1;
+  return m_Model->nr_class * (m_Model->nr_class - 1) / 2;
+}
+
+void mitk::LibSVMClassifier::UpdateDenseModel(int noOfFeatures)
+{
+  m_SupportVectors.resize(0, 0);
+  m_SupportVectorSquaredNorms.resize(0);
+  if (m_Model == nullptr || m_Model->param.kernel_type == LibSVM::PRECOMPUTED)
+    return;
+
+  m_SupportVectors = Eigen::MatrixXd::Zero(m_Model->l, noOfFeatures);
+  for (int sv = 0; sv < m_Model->l; ++sv)
+  {
+    for (const LibSVM::svm_node *node = m_Model->SV[sv]; node->index != -1; ++node)
+    {
+      if (node->index < 1 || node->index > noOfFeatures)
+      {
+        // Model contains features which are not part of the dense samples
+        m_SupportVectors.resize(0, 0);
+        return;
+      }
+      m_SupportVectors(sv, node->index - 1) = node->value;
+    }
+  }
+  m_SupportVectorSquaredNorms = m_SupportVectors.rowwise().squaredNorm();
+}
+
+Eigen::MatrixXd mitk::LibSVMClassifier::ComputeDenseDecisionValues(const Eigen::MatrixXd &samples) const
+{
+  const LibSVM::svm_parameter &param = m_Model->param;
+  const int l = m_Model->l;
+
+  // Kernel values of all samples with all support vectors
+  Eigen::MatrixXd kernel = samples * m_SupportVectors.transpose();
+  switch (param.kernel_type)
+  {
+  case LibSVM::POLY:
+    kernel = kernel.unaryExpr([&param](double dot) { return std::pow(param.gamma * dot + param.coef0, param.degree); });
+    break;
+  case LibSVM::RBF:
+  {
+    Eigen::VectorXd sampleSquaredNorms = samples.rowwise().squaredNorm();
+    for (int sv = 0; sv < l; ++sv)
+    {
+      kernel.col(sv) = (-param.gamma * (sampleSquaredNorms.array() + m_SupportVectorSquaredNorms(sv) - 2 * kernel.col(sv).array())).exp();
+    }
+    break;
+  }
+  case LibSVM::SIGMOID:
+    kernel = kernel.unaryExpr([&param](double dot) { return std::tanh(param.gamma * dot + param.coef0); });
+    break;
+  default:
+    break;
+  }
+
+  Eigen::MatrixXd decisionValues(samples.rows(), GetNumberOfDecisionValues());
+  if (param.svm_type == LibSVM::ONE_CLASS || param.svm_type == LibSVM::EPSILON_SVR || param.svm_type == LibSVM::NU_SVR)
+  {
+    Eigen::Map<const Eigen::VectorXd> coefficients(m_Model->sv_coef[0], l);
+    decisionValues.col(0) = (kernel * coefficients).array() - m_Model->rho[0];
+    return decisionValues;
+  }
+
+  // One decision function for each pair of classes, ordered as in svm_predict_values
+  const int nrClass = m_Model->nr_class;
+  std::vector<int> start(nrClass, 0);
+  for (int i = 1; i < nrClass; ++i)
+    start[i] = start[i - 1] + m_Model->nSV[i - 1];
+
+  int p = 0;
+  for (int i = 0; i < nrClass; ++i)
+  {
+    for (int j = i + 1; j < nrClass; ++j)
+    {
+      const int ci = m_Model->nSV[i];
+      const int cj = m_Model->nSV[j];
+      Eigen::Map<const Eigen::VectorXd> coef1(m_Model->sv_coef[j - 1] + start[i], ci);
+      Eigen::Map<const Eigen::VectorXd> coef2(m_Model->sv_coef[i] + start[j], cj);
+      Eigen::VectorXd decision = kernel.middleCols(start[i], ci) * coef1 + kernel.middleCols(start[j], cj) * coef2;
+      decisionValues.col(p) = decision.array() - m_Model->rho[p];
+      ++p;
+    }
+  }
+  return decisionValues;
+}
+
+void mitk::LibSVMClassifier::PredictDenseBlock(const Eigen::MatrixXd &X, Eigen::MatrixXi &result, int startRow, int noOfRows) const
+{
+  const LibSVM::svm_parameter &param = m_Model->param;
+  Eigen::MatrixXd decisionValues = ComputeDenseDecisionValues(X.middleRows(startRow, noOfRows));
+
+  if (param.svm_type == LibSVM::ONE_CLASS || param.svm_type == LibSVM::EPSILON_SVR || param.svm_type == LibSVM::NU_SVR)
+  {
+    for (int row = 0; row < noOfRows; ++row)
+    {
+      if (param.svm_type == LibSVM::ONE_CLASS)
+        result(startRow + row, 0) = (decisionValues(row, 0) > 0) ? 1 : -1;
+      else
+        result(startRow + row, 0) = static_cast<int>(decisionValues(row, 0));
+    }
+    return;
+  }
+
+  // One-against-one voting as done by svm_predict_values
+  const int nrClass = m_Model->nr_class;
+  std::vector<int> votes(nrClass);
+  for (int row = 0; row < noOfRows; ++row)
+  {
+    std::fill(votes.begin(), votes.end(), 0);
+    int p = 0;
+    for (int i = 0; i < nrClass; ++i)
+    {
+      for (int j = i + 1; j < nrClass; ++j)
+      {
+        if (decisionValues(row, p) > 0)
+          ++votes[i];
+        else
+          ++votes[j];
+        ++p;
+      }
+    }
+
+    int voteMaxIndex = 0;
+    for (int i = 1; i < nrClass; ++i)
+      if (votes[i] > votes[voteMaxIndex])
+        voteMaxIndex = i;
+    result(startRow + row, 0) = m_Model->label[voteMaxIndex];
+  }
+}
+
 void  mitk::LibSVMClassifier::ConvertParameter()
 {
   // Get the proerty                                                                      // Some defaults
@@ -297,16 +508,19 @@ void mitk::LibSVMClassifier::ReadXValues(LibSVM::svm_problem * problem, LibSVM::
   problem->x = static_cast<LibSVM::svm_node **>(malloc(sizeof(LibSVM::svm_node *)  * noOfPoints));
   (*xSpace) = static_cast<LibSVM::svm_node *> (malloc(sizeof(LibSVM::svm_node) * noOfPoints * (features+1)));
 
+  // Each sample uses features+1 nodes including the terminating one. The indices
+  // start at 1, as expected by libsvm and as used by Predict().
   for (int row = 0; row < noOfPoints; ++row)
   {
+    LibSVM::svm_node *rowSpace = (*xSpace) + static_cast<std::size_t>(row) * (features+1);
     for (int col = 0; col < features; ++col)
     {
-      (*xSpace)[row*features + col].index = col;
-      (*xSpace)[row*features + col].value = X(row,col);
+      rowSpace[col].index = col+1;
+      rowSpace[col].value = X(row,col);
     }
-    (*xSpace)[row*features + features].index = -1;
+    rowSpace[features].index = -1;
 
-    problem->x[row] = &((*xSpace)[row*features]);
+    problem->x[row] = rowSpace;
   }
 }
 
@@ -89,6 +89,8 @@ static inline double powi(double base, int times)
 #define INF HUGE_VAL
 #define TAU 1e-12
 #define Malloc(type,n) (type *)malloc((n)*sizeof(type))
+// minimum number of kernel evaluations of a Q column which are split between threads
+#define KERNEL_PARALLEL_MINIMUM 512
 
 static void print_string_stdout(const char *s)
 {
@@ -263,6 +265,7 @@ public:
   void swap_index(int i, int j) const override // no so const...
   {
     swap(x[i],x[j]);
+    if(x_dense_rows) swap(x_dense_rows[i],x_dense_rows[j]);
     if(x_square) swap(x_square[i],x_square[j]);
   }
 protected:
@@ -273,6 +276,11 @@ private:
   const svm_node **x;
   double *x_square;
 
+  // dense copy of x, if all vectors contain the same consecutive indices
+  double *x_dense;
+  const double **x_dense_rows;
+  int dense_dimension;
+
   // svm_parameter
   const int kernel_type;
   const int degree;
@@ -280,21 +288,34 @@ private:
   const double coef0;
 
   static double dot(const svm_node *px, const svm_node *py);
-  double kernel_linear(int i, int j) const
+  double dot(int i, int j) const
   {
+    if(x_dense_rows)
+    {
+      const double *px = x_dense_rows[i];
+      const double *py = x_dense_rows[j];
+      double sum = 0;
+      for(int k=0;k<dense_dimension;k++)
+        sum += px[k] * py[k];
+      return sum;
+    }
     return dot(x[i],x[j]);
   }
+  double kernel_linear(int i, int j) const
+  {
+    return dot(i,j);
+  }
   double kernel_poly(int i, int j) const
   {
-    return powi(gamma*dot(x[i],x[j])+coef0,degree);
+    return powi(gamma*dot(i,j)+coef0,degree);
   }
   double kernel_rbf(int i, int j) const
   {
-    return exp(-gamma*(x_square[i]+x_square[j]-2*dot(x[i],x[j])));
+    return exp(-gamma*(x_square[i]+x_square[j]-2*dot(i,j)));
   }
   double kernel_sigmoid(int i, int j) const
   {
-    return tanh(gamma*dot(x[i],x[j])+coef0);
+    return tanh(gamma*dot(i,j)+coef0);
   }
   double kernel_precomputed(int i, int j) const
   {
@@ -327,11 +348,40 @@ Kernel::Kernel(int l, svm_node * const * x_, const svm_parameter& param)
 
   clone(x,x_,l);
 
+  // Vectors which store all features with consecutive indices are copied to
+  // dense rows, so that the kernel evaluation does not need to match indices.
+  x_dense = nullptr;
+  x_dense_rows = nullptr;
+  dense_dimension = 0;
+  if(kernel_type != PRECOMPUTED && l > 0)
+  {
+    while(x[0][dense_dimension].index == dense_dimension+1)
+      ++dense_dimension;
+    bool isDense = (x[0][dense_dimension].index == -1);
+    for(int i=1;i<l && isDense;i++)
+    {
+      for(int k=0;k<dense_dimension && isDense;k++)
+        isDense = (x[i][k].index == k+1);
+      isDense = isDense && (x[i][dense_dimension].index == -1);
+    }
+    if(isDense)
+    {
+      x_dense = new double[(size_t)l*dense_dimension];
+      x_dense_rows = new const double*[l];
+      for(int i=0;i<l;i++)
+      {
+        for(int k=0;k<dense_dimension;k++)
+          x_dense[(size_t)i*dense_dimension+k] = x[i][k].value;
+        x_dense_rows[i] = x_dense + (size_t)i*dense_dimension;
+      }
+    }
+  }
+
   if(kernel_type == RBF)
   {
     x_square = new double[l];
     for(int i=0;i<l;i++)
-      x_square[i] = dot(x[i],x[i]);
+      x_square[i] = dot(i,i);
   }
   else
     x_square = nullptr;
@@ -341,6 +391,8 @@ Kernel::~Kernel()
 {
   delete[] x;
   delete[] x_square;
+  delete[] x_dense;
+  delete[] x_dense_rows;
 }
 
 double Kernel::dot(const svm_node *px, const svm_node *py)
@@ -1325,6 +1377,7 @@ public:
     clone(y,y_,prob.l);
     cache = new Cache(prob.l,(long int)(param.cache_size*(1<<20)));
     QD = new double[prob.l];
+#pragma omp parallel for if(prob.l > KERNEL_PARALLEL_MINIMUM)
     for(int i=0;i<prob.l;i++)
       QD[i] = (this->*kernel_function)(i,i);
   }
@@ -1335,6 +1388,7 @@ public:
     int start, j;
     if((start = cache->get_data(i,&data,len)) < len)
     {
+#pragma omp parallel for if(len - start > KERNEL_PARALLEL_MINIMUM)
       for(j=start;j<len;j++)
         data[j] = (Qfloat)(y[i]*y[j]*(this->*kernel_function)(i,j));
     }
@@ -1374,6 +1428,7 @@ public:
   {
     cache = new Cache(prob.l,(long int)(param.cache_size*(1<<20)));
     QD = new double[prob.l];
+#pragma omp parallel for if(prob.l > KERNEL_PARALLEL_MINIMUM)
     for(int i=0;i<prob.l;i++)
       QD[i] = (this->*kernel_function)(i,i);
   }
@@ -1384,6 +1439,7 @@ public:
     int start, j;
     if((start = cache->get_data(i,&data,len)) < len)
     {
+#pragma omp parallel for if(len - start > KERNEL_PARALLEL_MINIMUM)
       for(j=start;j<len;j++)
         data[j] = (Qfloat)(this->*kernel_function)(i,j);
     }
@@ -1450,6 +1506,7 @@ public:
     int j, real_i = index[i];
     if(cache->get_data(real_i,&data,l) < l)
     {
+#pragma omp parallel for if(l > KERNEL_PARALLEL_MINIMUM)
       for(j=0;j<l;j++)
         data[j] = (Qfloat)(this->*kernel_function)(real_i,j);
     }
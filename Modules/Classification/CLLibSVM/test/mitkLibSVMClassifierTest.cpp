@@ -27,6 +27,14 @@ See LICENSE.txt or http://www.mitk.org for details.
 #include <itkCSVArray2DDataObject.h>
 #include <itkCSVNumericObjectFileWriter.h>
 
+#include <cmath>
+#include <vector>
+
+namespace LibSVM
+{
+#include "svm.h"
+}
+
 //#include <boost/algorithm/string.hpp>
 
 class mitkLibSVMClassifierTestSuite : public mitk::TestFixture
@@ -34,6 +42,8 @@ class mitkLibSVMClassifierTestSuite : public mitk::TestFixture
   CPPUNIT_TEST_SUITE(mitkLibSVMClassifierTestSuite);
   MITK_TEST(TrainSVMClassifier_MatlabDataSet_shouldReturnTrue);
   MITK_TEST(TrainSVMClassifier_BreastCancerDataSet_shouldReturnTrue);
+  MITK_TEST(PredictSVMClassifier_LinearKernel_MatchesLibSVM);
+  MITK_TEST(PredictSVMClassifier_RBFKernel_MatchesLibSVM);
   CPPUNIT_TEST_SUITE_END();
 
 private:
@@ -306,6 +316,131 @@ public:
     MITK_TEST_CONDITION(isIntervall<int>(m_TestYPredict,classes,75,100),"Testvalue is in range.");
   }
 
+  /*
+  Trains a model with libsvm directly and predicts every sample with svm_predict_values, passing
+  it as svm_node vector as LibSVMClassifier::Predict did before evaluating the kernel densely. The
+  parameters match the defaults of LibSVMClassifier::ConvertParameter.
+  */
+  void predictWithLibSVM(const MatrixDoubleType &trainingX, const MatrixIntType &trainingY, const MatrixDoubleType &samples,
+    int kernelType, MatrixIntType &classes, MatrixDoubleType &decisionValues)
+  {
+    const int noOfPoints = static_cast<int>(trainingX.rows());
+    const int noOfFeatures = static_cast<int>(trainingX.cols());
+
+    std::vector<LibSVM::svm_node> xSpace(static_cast<std::size_t>(noOfPoints) * (noOfFeatures + 1));
+    std::vector<LibSVM::svm_node *> x(noOfPoints);
+    std::vector<double> y(noOfPoints);
+    std::vector<double> w(noOfPoints, 1.0);
+    for (int row = 0; row < noOfPoints; ++row)
+    {
+      x[row] = &xSpace[static_cast<std::size_t>(row) * (noOfFeatures + 1)];
+      for (int col = 0; col < noOfFeatures; ++col)
+      {
+        x[row][col].index = col + 1;
+        x[row][col].value = trainingX(row, col);
+      }
+      x[row][noOfFeatures].index = -1;
+      y[row] = trainingY(row, 0);
+    }
+
+    LibSVM::svm_problem problem;
+    problem.l = noOfPoints;
+    problem.x = x.data();
+    problem.y = y.data();
+    problem.W = w.data();
+
+    LibSVM::svm_parameter parameter = LibSVM::svm_parameter();
+    parameter.svm_type = LibSVM::C_SVC;
+    parameter.kernel_type = kernelType;
+    parameter.degree = 3;
+    parameter.gamma = 1 / (double)(noOfFeatures);
+    parameter.coef0 = 0;
+    parameter.nu = 0.5;
+    parameter.cache_size = 100.0;
+    parameter.C = 1.0;
+    parameter.eps = 1e-3;
+    parameter.p = 0.1;
+    parameter.shrinking = 1;
+    parameter.probability = 0;
+    parameter.nr_weight = 0;
+
+    LibSVM::svm_model *model = LibSVM::svm_train(&problem, &parameter);
+    const int noOfDecisionValues = model->nr_class * (model->nr_class - 1) / 2;
+
+    classes.resize(samples.rows(), 1);
+    decisionValues.resize(samples.rows(), noOfDecisionValues);
+    std::vector<LibSVM::svm_node> xVector(noOfFeatures + 1);
+    std::vector<double> sampleDecisionValues(noOfDecisionValues);
+    for (int point = 0; point < samples.rows(); ++point)
+    {
+      for (int feature = 0; feature < noOfFeatures; ++feature)
+      {
+        xVector[feature].index = feature + 1;
+        xVector[feature].value = samples(point, feature);
+      }
+      xVector[noOfFeatures].index = -1;
+      classes(point, 0) = static_cast<int>(LibSVM::svm_predict_values(model, xVector.data(), sampleDecisionValues.data()));
+      for (int i = 0; i < noOfDecisionValues; ++i)
+        decisionValues(point, i) = sampleDecisionValues[i];
+    }
+
+    LibSVM::svm_free_and_destroy_model(&model);
+  }
+
+  /*
+  Predicting with the dense kernel evaluation must give the same decision values and classes as
+  libsvm's own prediction. Samples whose decision value is almost zero may be assigned to either
+  class, since the dense kernel rounds differently.
+  */
+  void predictSVMClassifier_MatchesLibSVM(int kernelType)
+  {
+    std::pair<MatrixDoubleType,MatrixDoubleType> matrixDouble;
+    matrixDouble = convertCSVToMatrix<double>(GetTestDataFilePath("Classification/FeaturematrixBreastcancer.csv"),';',0.5,true);
+    std::pair<MatrixIntType,MatrixIntType> matrixInt;
+    matrixInt = convertCSVToMatrix<int>(GetTestDataFilePath("Classification/LabelmatrixBreastcancer.csv"),';',0.5,false);
+
+    classifier = mitk::LibSVMClassifier::New();
+    classifier->SetGamma(1/(double)(matrixDouble.first.cols()));
+    classifier->SetSvmType(0);
+    classifier->SetKernelType(kernelType);
+    classifier->Train(matrixDouble.first, matrixInt.first);
+
+    MatrixIntType expectedClasses;
+    MatrixDoubleType expectedDecisionValues;
+    predictWithLibSVM(matrixDouble.first, matrixInt.first, matrixDouble.second, kernelType, expectedClasses, expectedDecisionValues);
+
+    MatrixIntType classes = classifier->Predict(matrixDouble.second);
+    MatrixDoubleType decisionValues = classifier->PredictDecisionValues(matrixDouble.second);
+
+    const double tolerance = 1e-6;
+    CPPUNIT_ASSERT_EQUAL(expectedClasses.rows(), classes.rows());
+    CPPUNIT_ASSERT_EQUAL(expectedDecisionValues.rows(), decisionValues.rows());
+    CPPUNIT_ASSERT_EQUAL(expectedDecisionValues.cols(), decisionValues.cols());
+    for (int i = 0; i < classes.rows(); ++i)
+    {
+      bool isAmbiguous = false;
+      for (int j = 0; j < decisionValues.cols(); ++j)
+      {
+        CPPUNIT_ASSERT_DOUBLES_EQUAL(expectedDecisionValues(i, j), decisionValues(i, j), tolerance * (1 + std::abs(expectedDecisionValues(i, j))));
+        isAmbiguous = isAmbiguous || std::abs(expectedDecisionValues(i, j)) < tolerance;
+      }
+      if (!isAmbiguous)
+      {
+        CPPUNIT_ASSERT_EQUAL(expectedClasses(i, 0), classes(i, 0));
+      }
+    }
+  }
+
+  void PredictSVMClassifier_LinearKernel_MatchesLibSVM()
+  {
+    predictSVMClassifier_MatchesLibSVM(LibSVM::LINEAR);
+  }
+
+  void PredictSVMClassifier_RBFKernel_MatchesLibSVM()
+  {
+    predictSVMClassifier_MatchesLibSVM(LibSVM::RBF);
+  }
+
   void TestThreadedDecisionForest()
   {
   }
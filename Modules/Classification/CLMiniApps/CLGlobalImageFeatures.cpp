@@ -42,6 +42,7 @@ See LICENSE.txt or http://www.mitk.org for details.
 #include <mitkGIFIntensityVolumeHistogramFeatures.h>
 #include <mitkGIFNeighbourhoodGreyToneDifferenceFeatures.h>
 #include <mitkGIFNeighbouringGreyLevelDependenceFeatures.h>
+#include <mitkTextureMatrixSession.h>
 #include <mitkImageAccessByItk.h>
 #include <mitkImageCast.h>
 #include <mitkITKImageImport.h>
@@ -604,6 +605,14 @@ int main(int argc, char* argv[])
     cFeature->SetEncodeParameters(param.encodeParameter);
   }
 
+  // Texture features working on the same image and mask share the binned image and their matrices
+  mitk::TextureMatrixSession::Pointer textureMatrixSession = mitk::TextureMatrixSession::New();
+  for (auto cFeature : features)
+  {
+    cFeature->SetTextureMatrixSession(textureMatrixSession);
+    cFeature->AddTextureMatrixRequests(textureMatrixSession);
+  }
+
   bool addDescription = parsedArgs.count("description");
   mitk::cl::FeatureResultWritter writer(param.outputPath, writeDirection);
 
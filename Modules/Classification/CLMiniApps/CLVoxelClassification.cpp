@@ -29,6 +29,7 @@ See LICENSE.txt or http://www.mitk.org for details.
 #include <mitkIOUtil.h>
 
 #include <mitkDataCollectionUtilities.h>
+#include <mitkDataCollectionImageIterator.h>
 #include <mitkRandomForestIO.h>
 
 // ----------------------- Forest Handling ----------------------
@@ -359,15 +360,8 @@ int main(int argc, char* argv[])
     //////////////////////////////////////////////////////////////////////////////
     // If required do test
     //////////////////////////////////////////////////////////////////////////////
-    MITK_INFO << "Convert Test data";
-    auto testDataX = mitk::DCUtilities::DC3dDToMatrixXd(testCollection,modalities, testMask);
-
     MITK_INFO << "Predict Test Data";
-    auto testDataNewY = forest->Predict(testDataX);
-    auto testDataNewProb = forest->GetPointWiseProbabilities();
-    //MITK_INFO << testDataNewY;
-
-    auto maxClassValue = testDataNewProb.cols();
+    auto maxClassValue = forest->GetRandomForest().class_count();
     std::vector<std::string> names;
     for (int i = 0; i < maxClassValue; ++i)
     {
@@ -375,11 +369,78 @@ int main(int argc, char* argv[])
       MITK_INFO << name;
       names.push_back(name);
     }
-    //names.push_back("prob-1");
-    //names.push_back("prob-2");
 
-    mitk::DCUtilities::MatrixToDC3d(testDataNewY, testCollection, resultMask, testMask);
-    mitk::DCUtilities::MatrixToDC3d(testDataNewProb, testCollection, names, testMask);
+    // The test data is predicted block by block directly from the collection images,
+    // without converting all masked voxels into a single feature matrix
+    typedef mitk::DataCollectionImageIterator<double, 3> DataIterType;
+    typedef mitk::DataCollectionImageIterator<unsigned char, 3> MaskIterType;
+
+    mitk::DCUtilities::EnsureUCharImageInDC(testCollection, resultMask, testMask);
+    for (const auto &name : names)
+    {
+      mitk::DCUtilities::EnsureDoubleImageInDC(testCollection, name, testMask);
+    }
+
+    MaskIterType featureMaskIter(testCollection, testMask);
+    std::vector<DataIterType> featureIter;
+    for (const auto &modality : modalities)
+    {
+      featureIter.push_back(DataIterType(testCollection, modality));
+    }
+
+    MaskIterType resultMaskIter(testCollection, testMask);
+    MaskIterType labelIter(testCollection, resultMask);
+    std::vector<DataIterType> probabilityIter;
+    for (const auto &name : names)
+    {
+      probabilityIter.push_back(DataIterType(testCollection, name));
+    }
+
+    auto readFeatures = [&](std::size_t, Eigen::MatrixXd &block)
+    {
+      Eigen::Index row = 0;
+      while (row < block.rows() && !featureMaskIter.IsAtEnd())
+      {
+        if (featureMaskIter.GetVoxel() > 0)
+        {
+          for (std::size_t col = 0; col < featureIter.size(); ++col)
+          {
+            block(row, col) = featureIter[col].GetVoxel();
+          }
+          ++row;
+        }
+        for (auto &iter : featureIter)
+        {
+          ++iter;
+        }
+        ++featureMaskIter;
+      }
+    };
+
+    auto writeResults = [&](std::size_t, const Eigen::MatrixXi &labels, const Eigen::MatrixXd &probabilities)
+    {
+      Eigen::Index row = 0;
+      while (row < labels.rows() && !resultMaskIter.IsAtEnd())
+      {
+        if (resultMaskIter.GetVoxel() > 0)
+        {
+          labelIter.SetVoxel(labels(row, 0));
+          for (std::size_t col = 0; col < probabilityIter.size(); ++col)
+          {
+            probabilityIter[col].SetVoxel(probabilities(row, col));
+          }
+          ++row;
+        }
+        ++labelIter;
+        for (auto &iter : probabilityIter)
+        {
+          ++iter;
+        }
+        ++resultMaskIter;
+      }
+    };
+
+    forest->PredictBlockwise(mitk::DCUtilities::VoxelInMask(testCollection, testMask), modalities.size(), readFeatures, writeResults);
     MITK_INFO << "Converted predicted data";
     //forest.SetMaskName(testMask);
     //forest.SetCollection(testCollection);
@@ -2,12 +2,15 @@
 #define itkLocalStatisticFilter_cpp
 
 #include <itkLocalStatisticFilter.h>
+#include <itkSlidingWindowBuffer.h>
 
 #include <itkNeighborhoodIterator.h>
 #include <itkImageRegionIterator.h>
 #include <itkImageIterator.h>
 #include "itkMinimumMaximumImageCalculator.h"
 
+#include <algorithm>
+#include <cmath>
 #include <limits>
 
 template< class TInputImageType, class TOuputImageType>
@@ -38,8 +41,7 @@ template< class TInputImageType, class TOuputImageType>
 void
 itk::LocalStatisticFilter<TInputImageType, TOuputImageType>::ThreadedGenerateData(const OutputImageRegionType & outputRegionForThread, ThreadIdType /*threadId*/)
 {
-  typedef itk::ImageRegionIterator<TInputImageType> IteratorType;
-  typedef itk::ConstNeighborhoodIterator<TInputImageType> ConstIteratorType;
+  typedef itk::SlidingWindowBuffer<TInputImageType::ImageDimension> BufferType;
 
   typename TInputImageType::SizeType size; size.Fill(m_Size);
   InputImagePointer input = this->GetInput(0);
@@ -49,48 +51,45 @@ itk::LocalStatisticFilter<TInputImageType, TOuputImageType>::ThreadedGenerateDat
     size[2] = 0;
   }
 
-//  MITK_INFO << "Creating output iterator";
-  std::vector<IteratorType> iterVector;
-  for (int i = 0; i < m_Bins; ++i)
+  // The statistics are updated incrementally while the neighbourhood slides along each axis,
+  // instead of visiting all neighbours of each voxel.
+  auto imageRegion = input->GetLargestPossibleRegion();
+  auto inputRegion = outputRegionForThread;
+  inputRegion.PadByRadius(size);
+  inputRegion.Crop(imageRegion);
+
+  double numberOfNeighbours = 1;
+  for (unsigned int i = 0; i < TInputImageType::ImageDimension; ++i)
   {
-    IteratorType iter(this->GetOutput(i), outputRegionForThread);
-    iterVector.push_back(iter);
+    numberOfNeighbours *= 2 * size[i] + 1;
   }
 
-  ConstIteratorType inputIter(size, input, outputRegionForThread);
-  while (!inputIter.IsAtEnd())
+  auto values = BufferType::FromImage(input.GetPointer(), inputRegion, [](double value) { return value; });
+  auto squaredValues = BufferType::FromImage(input.GetPointer(), inputRegion, [](double value) { return value * value; });
+
+  auto minimum = values.Apply(size, imageRegion, outputRegionForThread, BufferType::Minimum);
+  auto maximum = values.Apply(size, imageRegion, outputRegionForThread, BufferType::Maximum);
+  auto sum = values.Apply(size, imageRegion, outputRegionForThread, BufferType::Sum);
+  auto squaredSum = squaredValues.Apply(size, imageRegion, outputRegionForThread, BufferType::Sum);
+
+  auto range = maximum;
+  auto &meanValues = sum.GetValues();
+  auto &stdValues = squaredSum.GetValues();
+  for (std::size_t i = 0; i < meanValues.size(); ++i)
   {
-    for (int i = 0; i < m_Bins; ++i)
-    {
-      iterVector[i].Set(0);
-    }
-
-    double min = std::numeric_limits<double>::max();
-    double max = std::numeric_limits<double>::lowest();
-    double mean = 0;
-    double std = 0;
-
-    for (unsigned int i = 0; i < inputIter.Size(); ++i)
-    {
-      double value = inputIter.GetPixel(i);
-      min = std::min<double>(min, value);
-      max = std::max<double>(max, value);
-      mean += value / inputIter.Size();
-      std += (value*value) / inputIter.Size();
-    }
-
-    iterVector[0].Value() = min;
-    iterVector[1].Value() = max;
-    iterVector[2].Value() = mean;
-    iterVector[3].Value() = std::sqrt(std - mean*mean);
-    iterVector[4].Value() = max-min;
-
-    for (int i = 0; i < m_Bins; ++i)
-    {
-      ++(iterVector[i]);
-    }
-    ++inputIter;
+    double mean = meanValues[i] / numberOfNeighbours;
+    double squaredMean = stdValues[i] / numberOfNeighbours;
+    meanValues[i] = mean;
+    // rounding can make the variance of (nearly) constant neighbourhoods slightly negative
+    stdValues[i] = std::sqrt(std::max(0.0, squaredMean - mean*mean));
+    range.GetValues()[i] -= minimum.GetValues()[i];
   }
+
+  minimum.CopyTo(this->GetOutput(0));
+  maximum.CopyTo(this->GetOutput(1));
+  sum.CopyTo(this->GetOutput(2));
+  squaredSum.CopyTo(this->GetOutput(3));
+  range.CopyTo(this->GetOutput(4));
 }
 
 template< class TInputImageType, class TOuputImageType>
@@ -2,6 +2,7 @@
 #define itkMultiHistogramFilter_cpp
 
 #include <itkMultiHistogramFilter.h>
+#include <itkSlidingWindowBuffer.h>
 
 #include <itkNeighborhoodIterator.h>
 #include <itkImageRegionIterator.h>
@@ -52,43 +53,37 @@ itk::MultiHistogramFilter<TInputImageType, TOuputImageType>::ThreadedGenerateDat
   double offset = m_Offset;// -3.0;
   double delta = m_Delta;// 0.6;
 
-  typedef itk::ImageRegionIterator<TInputImageType> IteratorType;
-  typedef itk::ConstNeighborhoodIterator<TInputImageType> ConstIteratorType;
+  typedef itk::SlidingWindowBuffer<TInputImageType::ImageDimension> BufferType;
 
   typename TInputImageType::SizeType size; size.Fill(m_Size);
   InputImagePointer input = this->GetInput(0);
 
-//  MITK_INFO << "Creating output iterator";
-  std::vector<IteratorType> iterVector;
-  for (int i = 0; i < m_Bins; ++i)
-  {
-    IteratorType iter(this->GetOutput(i), outputRegionForThread);
-    iterVector.push_back(iter);
-  }
+  // Each histogram bin is the neighbourhood sum of an indicator image, which is updated
+  // incrementally while the neighbourhood slides along each axis.
+  auto imageRegion = input->GetLargestPossibleRegion();
+  auto inputRegion = outputRegionForThread;
+  inputRegion.PadByRadius(size);
+  inputRegion.Crop(imageRegion);
 
-  ConstIteratorType inputIter(size, input, outputRegionForThread);
-  while (!inputIter.IsAtEnd())
+  const int bins = m_Bins;
+  auto binIndices = BufferType::FromImage(input.GetPointer(), inputRegion, [offset, delta, bins](double value)
   {
-    for (int i = 0; i < m_Bins; ++i)
-    {
-      iterVector[i].Set(0);
-    }
+    value -= offset;
+    value /= delta;
+    auto pos = (int)(value);
+    return static_cast<double>(std::max(0, std::min(bins - 1, pos)));
+  });
 
-    for (unsigned int i = 0; i < inputIter.Size(); ++i)
-    {
-      double value = inputIter.GetPixel(i);
-      value -=  offset;
-      value /= delta;
-      auto pos = (int)(value);
-      pos = std::max(0, std::min(m_Bins-1, pos));
-      iterVector[pos].Value() += 1;// (iterVector[pos].GetCenterPixel() + 1);
-    }
-
-    for (int i = 0; i < m_Bins; ++i)
+  BufferType indicator(inputRegion);
+  for (int i = 0; i < m_Bins; ++i)
+  {
+    const auto &binValues = binIndices.GetValues();
+    auto &indicatorValues = indicator.GetValues();
+    for (std::size_t j = 0; j < binValues.size(); ++j)
     {
-      ++(iterVector[i]);
+      indicatorValues[j] = (binValues[j] == i) ? 1.0 : 0.0;
     }
-    ++inputIter;
+    indicator.Apply(size, imageRegion, outputRegionForThread, BufferType::Sum).CopyTo(this->GetOutput(i));
   }
 }
 
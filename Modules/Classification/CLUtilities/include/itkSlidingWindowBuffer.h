@@ -0,0 +1,199 @@
+/*===================================================================
+
+The Medical Imaging Interaction Toolkit (MITK)
+
+Copyright (c) German Cancer Research Center,
+Division of Medical and Biological Informatics.
+All rights reserved.
+
+This software is distributed WITHOUT ANY WARRANTY; without
+even the implied warranty of MERCHANTABILITY or FITNESS FOR
+A PARTICULAR PURPOSE.
+
+See LICENSE.txt or http://www.mitk.org for details.
+
+===================================================================*/
+
+#ifndef itkSlidingWindowBuffer_h
+#define itkSlidingWindowBuffer_h
+
+#include <itkImageRegion.h>
+#include <itkImageRegionConstIterator.h>
+#include <itkImageRegionIterator.h>
+
+#include <algorithm>
+#include <deque>
+#include <vector>
+
+namespace itk
+{
+  /**
+  * \brief Dense buffer of a image region which supports separable box operations.
+  *
+  * The sum, minimum and maximum of a box shaped neighbourhood are separable, so they can be
+  * computed by one sliding window pass along each axis. Each pass adds the value entering and
+  * removes the value leaving the window, which makes the cost independent of the window size.
+  * Neighbours outside of the image bounds are replaced by the nearest value inside the image,
+  * which gives the same result as a neighborhood iterator with the default
+  * ZeroFluxNeumannBoundaryCondition.
+  */
+  template <unsigned int VDimension>
+  class SlidingWindowBuffer
+  {
+  public:
+    typedef ImageRegion<VDimension> RegionType;
+    typedef Size<VDimension> RadiusType;
+
+    enum OperationType
+    {
+      Sum,
+      Minimum,
+      Maximum
+    };
+
+    explicit SlidingWindowBuffer(const RegionType &region) :
+      m_Region(region), m_Values(region.GetNumberOfPixels(), 0.0)
+    {
+    }
+
+    /** \brief Copies the region of the image, transforming each value by the given functor. */
+    template <typename TImage, typename TFunctor>
+    static SlidingWindowBuffer FromImage(const TImage *image, const RegionType &region, TFunctor functor)
+    {
+      SlidingWindowBuffer buffer(region);
+      ImageRegionConstIterator<TImage> iter(image, region);
+      for (auto &value : buffer.m_Values)
+      {
+        value = functor(static_cast<double>(iter.Get()));
+        ++iter;
+      }
+      return buffer;
+    }
+
+    /**
+    * \brief Applies the operation over a box of the given radius for each index of outputRegion.
+    * The buffer must cover outputRegion, padded by the radius and cropped to imageRegion.
+    */
+    SlidingWindowBuffer Apply(const RadiusType &radius, const RegionType &imageRegion, const RegionType &outputRegion, OperationType operation) const
+    {
+      SlidingWindowBuffer result = *this;
+      for (unsigned int axis = 0; axis < VDimension; ++axis)
+      {
+        result = result.ApplyAlongAxis(axis, radius[axis], imageRegion, outputRegion.GetIndex()[axis], outputRegion.GetSize()[axis], operation);
+      }
+      return result;
+    }
+
+    /** \brief Writes the buffer to the image, the buffer order matches a region iterator. */
+    template <typename TImage>
+    void CopyTo(TImage *image) const
+    {
+      ImageRegionIterator<TImage> iter(image, m_Region);
+      for (const auto &value : m_Values)
+      {
+        iter.Set(value);
+        ++iter;
+      }
+    }
+
+    const RegionType &GetRegion() const { return m_Region; }
+    std::vector<double> &GetValues() { return m_Values; }
+    const std::vector<double> &GetValues() const { return m_Values; }
+
+  private:
+    SlidingWindowBuffer ApplyAlongAxis(unsigned int axis, SizeValueType radius, const RegionType &imageRegion,
+                                       IndexValueType start, SizeValueType length, OperationType operation) const
+    {
+      RegionType region = m_Region;
+      region.SetIndex(axis, start);
+      region.SetSize(axis, length);
+      SlidingWindowBuffer result(region);
+
+      const long r = static_cast<long>(radius);
+      const IndexValueType lowerBound = imageRegion.GetIndex()[axis];
+      const IndexValueType upperBound = lowerBound + static_cast<IndexValueType>(imageRegion.GetSize()[axis]) - 1;
+      const IndexValueType bufferStart = m_Region.GetIndex()[axis];
+      const SizeValueType bufferLength = m_Region.GetSize()[axis];
+
+      SizeValueType inner = 1;
+      for (unsigned int d = 0; d < axis; ++d)
+      {
+        inner *= m_Region.GetSize()[d];
+      }
+      SizeValueType outer = 1;
+      for (unsigned int d = axis + 1; d < VDimension; ++d)
+      {
+        outer *= m_Region.GetSize()[d];
+      }
+
+      // buffer position of every value that passes through the window, clamped to the image bounds
+      std::vector<SizeValueType> positions(length + 2 * r);
+      for (std::size_t k = 0; k < positions.size(); ++k)
+      {
+        IndexValueType index = start - r + static_cast<IndexValueType>(k);
+        index = std::max(lowerBound, std::min(upperBound, index));
+        positions[k] = static_cast<SizeValueType>(index - bufferStart);
+      }
+
+      const SizeValueType window = 2 * r + 1;
+      std::vector<double> line(positions.size());
+      std::deque<SizeValueType> candidates;
+      for (SizeValueType o = 0; o < outer; ++o)
+      {
+        for (SizeValueType i = 0; i < inner; ++i)
+        {
+          const double *source = m_Values.data() + o * bufferLength * inner + i;
+          double *target = result.m_Values.data() + o * length * inner + i;
+          for (std::size_t k = 0; k < positions.size(); ++k)
+          {
+            line[k] = source[positions[k] * inner];
+          }
+
+          if (operation == Sum)
+          {
+            double sum = 0;
+            for (SizeValueType k = 0; k < window; ++k)
+            {
+              sum += line[k];
+            }
+            target[0] = sum;
+            for (SizeValueType x = 1; x < length; ++x)
+            {
+              sum += line[x + window - 1] - line[x - 1];
+              target[x * inner] = sum;
+            }
+          }
+          else
+          {
+            // monotonic queue of the indices which can still become the extremum of a window
+            candidates.clear();
+            for (SizeValueType k = 0; k < line.size(); ++k)
+            {
+              while (!candidates.empty() &&
+                     ((operation == Minimum) ? line[candidates.back()] >= line[k] : line[candidates.back()] <= line[k]))
+              {
+                candidates.pop_back();
+              }
+              candidates.push_back(k);
+              if (k + 1 >= window)
+              {
+                const SizeValueType x = k + 1 - window;
+                while (candidates.front() < x)
+                {
+                  candidates.pop_front();
+                }
+                target[x * inner] = line[candidates.front()];
+              }
+            }
+          }
+        }
+      }
+      return result;
+    }
+
+    RegionType m_Region;
+    std::vector<double> m_Values;
+  };
+}
+
+#endif // itkSlidingWindowBuffer_h
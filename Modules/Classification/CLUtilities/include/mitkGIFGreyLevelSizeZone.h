@@ -98,6 +98,7 @@ namespace mitk
 
       void CalculateFeaturesUsingParameters(const Image::Pointer & feature, const Image::Pointer &mask, const Image::Pointer &maskNoNAN, FeatureListType &featureList) override;
       void AddArguments(mitkCommandLineParser &parser) override;
+      void AddTextureMatrixRequests(TextureMatrixSession *session) override;
       std::string GetCurrentFeatureEncoding() override;
 
       struct GIFGreyLevelSizeZoneConfiguration
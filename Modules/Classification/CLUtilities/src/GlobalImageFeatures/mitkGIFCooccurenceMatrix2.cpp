@@ -118,6 +118,10 @@ void CalculateMeanAndStdDevFeatures(std::vector<mitk::CoocurenceMatrixFeatures>
 static
 void NormalizeMatrixFeature(mitk::CoocurenceMatrixFeatures &features,
                             std::size_t number);
+static void
+CalculateCoocurenceFeaturesFromMatrices(const std::vector<Eigen::MatrixXd> &matrices,
+                                        mitk::GIFCooccurenceMatrix2::FeatureListType & featureList,
+                                        mitk::GIFCooccurenceMatrix2::GIFCooccurenceMatrix2Configuration config);
 
 
 
@@ -408,9 +412,7 @@ CalculateCoocurenceFeatures(itk::Image<TPixel, VImageDimension>* itkImage, mitk:
     offset[2] = 1;
   }
 
-  std::vector<mitk::CoocurenceMatrixFeatures> resultVector;
-  mitk::CoocurenceMatrixHolder holderOverall(rangeMin, rangeMax, numberOfBins);
-  mitk::CoocurenceMatrixFeatures overallFeature;
+  std::vector<Eigen::MatrixXd> matrices;
   for (std::size_t i = 0; i < offsetVector.size(); ++i)
   {
     if (config.direction > 1)
@@ -424,8 +426,24 @@ CalculateCoocurenceFeatures(itk::Image<TPixel, VImageDimension>* itkImage, mitk:
 
     offset = offsetVector[i];
     mitk::CoocurenceMatrixHolder holder(rangeMin, rangeMax, numberOfBins);
-    mitk::CoocurenceMatrixFeatures coocResults;
     CalculateCoOcMatrix<TPixel, VImageDimension>(itkImage, maskImage, offset, config.range, holder);
+    matrices.push_back(holder.m_Matrix);
+  }
+
+  CalculateCoocurenceFeaturesFromMatrices(matrices, featureList, config);
+}
+
+static void
+CalculateCoocurenceFeaturesFromMatrices(const std::vector<Eigen::MatrixXd> &matrices, mitk::GIFCooccurenceMatrix2::FeatureListType & featureList, mitk::GIFCooccurenceMatrix2::GIFCooccurenceMatrix2Configuration config)
+{
+  std::vector<mitk::CoocurenceMatrixFeatures> resultVector;
+  mitk::CoocurenceMatrixHolder holderOverall(config.MinimumIntensity, config.MaximumIntensity, config.Bins);
+  mitk::CoocurenceMatrixFeatures overallFeature;
+  for (const auto &matrix : matrices)
+  {
+    mitk::CoocurenceMatrixHolder holder(config.MinimumIntensity, config.MaximumIntensity, config.Bins);
+    mitk::CoocurenceMatrixFeatures coocResults;
+    holder.m_Matrix = matrix;
     holderOverall.m_Matrix += holder.m_Matrix;
     CalculateFeatures(holder, coocResults);
     resultVector.push_back(coocResults);
@@ -438,10 +456,6 @@ CalculateCoocurenceFeatures(itk::Image<TPixel, VImageDimension>* itkImage, mitk:
   mitk::CoocurenceMatrixFeatures featureStd;
   CalculateMeanAndStdDevFeatures(resultVector, featureMean, featureStd);
 
-  std::ostringstream  ss;
-  ss << config.range;
-  std::string strRange = ss.str();
-
   MatrixFeaturesTo(overallFeature, config.prefix + "Overall ", featureList);
   MatrixFeaturesTo(featureMean, config.prefix + "Mean ", featureList);
   MatrixFeaturesTo(featureStd, config.prefix + "Std.Dev. ", featureList);
@@ -629,7 +643,17 @@ mitk::GIFCooccurenceMatrix2::FeatureListType mitk::GIFCooccurenceMatrix2::Calcul
   config.Bins = GetQuantifier()->GetBins();
   config.prefix = FeatureDescriptionPrefix();
 
-  AccessByItk_3(image, CalculateCoocurenceFeatures, mask, featureList,config);
+  auto session = GetTextureMatrixSession();
+  if (session.IsNotNull() && image->GetDimension() < 4)
+  {
+    TextureMatrixSession::Request request(TextureMatrixSession::Cooccurence, static_cast<int>(m_Range), GetDirection());
+    auto result = session->GetResult(image, mask, GetQuantifier(), request);
+    CalculateCoocurenceFeaturesFromMatrices(result->Matrices, featureList, config);
+  }
+  else
+  {
+    AccessByItk_3(image, CalculateCoocurenceFeatures, mask, featureList, config);
+  }
 
   return featureList;
 }
@@ -684,6 +708,30 @@ mitk::GIFCooccurenceMatrix2::CalculateFeaturesUsingParameters(const Image::Point
 }
 
 
+void mitk::GIFCooccurenceMatrix2::AddTextureMatrixRequests(TextureMatrixSession *session)
+{
+  auto parsedArgs = GetParameter();
+  std::string name = GetOptionPrefix();
+
+  if (parsedArgs.count(GetLongName()))
+  {
+    std::vector<double> ranges;
+    if (parsedArgs.count(name + "::range"))
+    {
+      ranges = SplitDouble(parsedArgs[name + "::range"].ToString(), ';');
+    }
+    else
+    {
+      ranges.push_back(1);
+    }
+
+    for (double range : ranges)
+    {
+      session->AddRequest(TextureMatrixSession::Request(TextureMatrixSession::Cooccurence, static_cast<int>(range), GetDirection()));
+    }
+  }
+}
+
 std::string mitk::GIFCooccurenceMatrix2::GetCurrentFeatureEncoding()
 {
   std::ostringstream  ss;
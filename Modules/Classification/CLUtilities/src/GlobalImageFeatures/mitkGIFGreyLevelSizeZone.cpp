@@ -391,7 +391,24 @@ mitk::GIFGreyLevelSizeZone::FeatureListType mitk::GIFGreyLevelSizeZone::Calculat
   config.Bins = GetQuantifier()->GetBins();
   config.prefix = FeatureDescriptionPrefix();
 
-  AccessByItk_3(image, CalculateGreyLevelSizeZoneFeatures, mask, featureList, config);
+  auto session = GetTextureMatrixSession();
+  if (session.IsNotNull() && image->GetDimension() < 4)
+  {
+    TextureMatrixSession::Request request(TextureMatrixSession::SizeZone, 1, GetDirection());
+    auto result = session->GetResult(image, mask, GetQuantifier(), request);
+    const auto &matrix = result->Matrices.front();
+
+    mitk::GreyLevelSizeZoneMatrixHolder holderOverall(config.MinimumIntensity, config.MaximumIntensity, config.Bins, matrix.cols());
+    holderOverall.m_Matrix = matrix;
+    mitk::GreyLevelSizeZoneFeatures overallFeature;
+    ::CalculateFeatures(holderOverall, overallFeature);
+
+    MatrixFeaturesTo(overallFeature, config.prefix, featureList);
+  }
+  else
+  {
+    AccessByItk_3(image, CalculateGreyLevelSizeZoneFeatures, mask, featureList, config);
+  }
 
   return featureList;
 }
@@ -431,6 +448,16 @@ mitk::GIFGreyLevelSizeZone::CalculateFeaturesUsingParameters(const Image::Pointe
 
 }
 
+void mitk::GIFGreyLevelSizeZone::AddTextureMatrixRequests(TextureMatrixSession *session)
+{
+  auto parsedArgs = GetParameter();
+
+  if (parsedArgs.count(GetLongName()))
+  {
+    session->AddRequest(TextureMatrixSession::Request(TextureMatrixSession::SizeZone, 1, GetDirection()));
+  }
+}
+
 std::string mitk::GIFGreyLevelSizeZone::GetCurrentFeatureEncoding()
 {
   return QuantifierParameterString();
@@ -12,6 +12,7 @@
 #include <itkImageRegionConstIterator.h>
 
 // STL
+#include <algorithm>
 #include <sstream>
 
 namespace mitk
@@ -423,7 +424,31 @@ mitk::GIFNeighbouringGreyLevelDependenceFeature::FeatureListType mitk::GIFNeighb
 
   config.FeatureEncoding = FeatureDescriptionPrefix();
 
-  AccessByItk_3(image, CalculateCoocurenceFeatures, mask, featureList,config);
+  auto session = GetTextureMatrixSession();
+  if (session.IsNotNull() && image->GetDimension() < 4)
+  {
+    TextureMatrixSession::Request request(TextureMatrixSession::Dependence, static_cast<int>(m_Range), GetDirection(), config.alpha);
+    auto result = session->GetResult(image, mask, GetQuantifier(), request);
+    const auto &matrix = result->Matrices.front();
+
+    // Keep the dependence columns of the matrix holder, the session only computes the columns that can occur
+    int numberofDependency = std::max<int>(37, matrix.cols());
+    mitk::NGLDMMatrixHolder holder(config.MinimumIntensity, config.MaximumIntensity, config.Bins, numberofDependency);
+    holder.m_Matrix.leftCols(matrix.cols()) = matrix;
+    holder.m_NeighbourhoodSize = result->NeighbourhoodSize;
+    holder.m_NumberOfNeighbourVoxels = result->NumberOfNeighbourVoxels;
+    holder.m_NumberOfDependenceNeighbourVoxels = result->NumberOfDependenceNeighbourVoxels;
+    holder.m_NumberOfNeighbourhoods = result->NumberOfNeighbourhoods;
+    holder.m_NumberOfCompleteNeighbourhoods = result->NumberOfCompleteNeighbourhoods;
+
+    mitk::NGLDMMatrixFeatures overallFeature;
+    LocalCalculateFeatures(holder, overallFeature);
+    MatrixFeaturesTo(overallFeature, config.FeatureEncoding, featureList);
+  }
+  else
+  {
+    AccessByItk_3(image, CalculateCoocurenceFeatures, mask, featureList, config);
+  }
 
   return featureList;
 }
@@ -476,6 +501,30 @@ mitk::GIFNeighbouringGreyLevelDependenceFeature::CalculateFeaturesUsingParameter
   }
 }
 
+void mitk::GIFNeighbouringGreyLevelDependenceFeature::AddTextureMatrixRequests(TextureMatrixSession *session)
+{
+  auto parsedArgs = GetParameter();
+  std::string name = GetOptionPrefix();
+
+  if (parsedArgs.count(GetLongName()))
+  {
+    std::vector<double> ranges;
+    if (parsedArgs.count(name + "::range"))
+    {
+      ranges = SplitDouble(parsedArgs[name + "::range"].ToString(), ';');
+    }
+    else
+    {
+      ranges.push_back(1);
+    }
+
+    for (double range : ranges)
+    {
+      session->AddRequest(TextureMatrixSession::Request(TextureMatrixSession::Dependence, static_cast<int>(range), GetDirection(), 0));
+    }
+  }
+}
+
 std::string mitk::GIFNeighbouringGreyLevelDependenceFeature::GetCurrentFeatureEncoding()
 {
   std::ostringstream  ss;
@@ -11,8 +11,10 @@ set(MODULE_TESTS
   mitkGIFLocalIntensityTest
   mitkGIFNeighbourhoodGreyToneDifferenceFeaturesTest
   mitkGIFNeighbouringGreyLevelDependenceFeatureTest
+  mitkGIFTextureMatrixSessionTest
   mitkGIFVolumetricDensityStatisticsTest
   mitkGIFVolumetricStatisticsTest
+  mitkLocalStatisticFilterTest
   #mitkSmoothedClassProbabilitesTest.cpp
   #mitkGlobalFeaturesTest.cpp
 )
@@ -0,0 +1,181 @@
+/*===================================================================
+
+The Medical Imaging Interaction Toolkit (MITK)
+
+Copyright (c) German Cancer Research Center,
+Division of Medical and Biological Informatics.
+All rights reserved.
+
+This software is distributed WITHOUT ANY WARRANTY; without
+even the implied warranty of MERCHANTABILITY or FITNESS FOR
+A PARTICULAR PURPOSE.
+
+See LICENSE.txt or http://www.mitk.org for details.
+
+===================================================================*/
+
+#include <mitkTestingMacros.h>
+#include <mitkTestFixture.h>
+#include "mitkIOUtil.h"
+#include <cmath>
+
+#include <mitkGIFCooccurenceMatrix2.h>
+#include <mitkGIFGreyLevelSizeZone.h>
+#include <mitkGIFNeighbouringGreyLevelDependenceFeatures.h>
+#include <mitkTextureMatrixSession.h>
+
+class mitkGIFTextureMatrixSessionTestSuite : public mitk::TestFixture
+{
+  CPPUNIT_TEST_SUITE(mitkGIFTextureMatrixSessionTestSuite);
+
+  MITK_TEST(SharedSession_SameFeatures);
+  MITK_TEST(SharedSession_SingleQuantizationAndTraversal);
+  MITK_TEST(SharedSession_ResultOutlivesCache);
+
+  CPPUNIT_TEST_SUITE_END();
+
+private:
+  mitk::Image::Pointer m_IBSI_Phantom_Image_Large;
+  mitk::Image::Pointer m_IBSI_Phantom_Mask_Large;
+
+  void ConfigureQuantifier(mitk::AbstractGlobalImageFeature *featureCalculator)
+  {
+    featureCalculator->SetUseBinsize(true);
+    featureCalculator->SetBinsize(1.0);
+    featureCalculator->SetUseMinimumIntensity(true);
+    featureCalculator->SetUseMaximumIntensity(true);
+    featureCalculator->SetMinimumIntensity(0.5);
+    featureCalculator->SetMaximumIntensity(6.5);
+  }
+
+  std::vector<mitk::AbstractGlobalImageFeature::Pointer> CreateFeatures()
+  {
+    std::vector<mitk::AbstractGlobalImageFeature::Pointer> features;
+    features.push_back(mitk::GIFCooccurenceMatrix2::New().GetPointer());
+    features.push_back(mitk::GIFNeighbouringGreyLevelDependenceFeature::New().GetPointer());
+    features.push_back(mitk::GIFGreyLevelSizeZone::New().GetPointer());
+    for (auto feature : features)
+    {
+      ConfigureQuantifier(feature);
+    }
+    return features;
+  }
+
+  void AddRequests(mitk::TextureMatrixSession *session)
+  {
+    session->AddRequest(mitk::TextureMatrixSession::Request(mitk::TextureMatrixSession::Cooccurence, 1, 0));
+    session->AddRequest(mitk::TextureMatrixSession::Request(mitk::TextureMatrixSession::Dependence, 1, 0, 0));
+    session->AddRequest(mitk::TextureMatrixSession::Request(mitk::TextureMatrixSession::SizeZone, 1, 0));
+  }
+
+public:
+
+  void setUp(void) override
+  {
+    m_IBSI_Phantom_Image_Large = mitk::IOUtil::Load<mitk::Image>(GetTestDataFilePath("Radiomics/IBSI_Phantom_Image_Large.nrrd"));
+    m_IBSI_Phantom_Mask_Large = mitk::IOUtil::Load<mitk::Image>(GetTestDataFilePath("Radiomics/IBSI_Phantom_Mask_Large.nrrd"));
+  }
+
+  void SharedSession_SameFeatures()
+  {
+    auto referenceFeatures = CreateFeatures();
+    auto sessionFeatures = CreateFeatures();
+
+    mitk::TextureMatrixSession::Pointer session = mitk::TextureMatrixSession::New();
+    AddRequests(session);
+    for (auto feature : sessionFeatures)
+    {
+      feature->SetTextureMatrixSession(session);
+    }
+
+    std::vector<mitk::AbstractGlobalImageFeature::FeatureListType> referenceResults;
+    for (auto feature : referenceFeatures)
+    {
+      referenceResults.push_back(feature->CalculateFeatures(m_IBSI_Phantom_Image_Large, m_IBSI_Phantom_Mask_Large));
+    }
+    std::vector<mitk::AbstractGlobalImageFeature::FeatureListType> sessionResults;
+    for (auto feature : sessionFeatures)
+    {
+      sessionResults.push_back(feature->CalculateFeatures(m_IBSI_Phantom_Image_Large, m_IBSI_Phantom_Mask_Large));
+    }
+
+    for (std::size_t i = 0; i < referenceResults.size(); ++i)
+    {
+      CPPUNIT_ASSERT_EQUAL_MESSAGE("Shared session should calculate the same number of features", referenceResults[i].size(), sessionResults[i].size());
+      for (std::size_t j = 0; j < referenceResults[i].size(); ++j)
+      {
+        CPPUNIT_ASSERT_EQUAL(referenceResults[i][j].first, sessionResults[i][j].first);
+        double reference = referenceResults[i][j].second;
+        double value = sessionResults[i][j].second;
+        if (std::isnan(reference))
+        {
+          CPPUNIT_ASSERT_MESSAGE(referenceResults[i][j].first + " should be NaN", std::isnan(value));
+        }
+        else
+        {
+          CPPUNIT_ASSERT_DOUBLES_EQUAL_MESSAGE(referenceResults[i][j].first, reference, value, 0.0001 * std::max(1.0, std::abs(reference)));
+        }
+      }
+    }
+  }
+
+  void SharedSession_SingleQuantizationAndTraversal()
+  {
+    auto features = CreateFeatures();
+
+    mitk::TextureMatrixSession::Pointer session = mitk::TextureMatrixSession::New();
+    AddRequests(session);
+    for (auto feature : features)
+    {
+      feature->SetTextureMatrixSession(session);
+      feature->CalculateFeatures(m_IBSI_Phantom_Image_Large, m_IBSI_Phantom_Mask_Large);
+    }
+
+    CPPUNIT_ASSERT_EQUAL_MESSAGE("Image should be binned only once", 1u, session->GetNumberOfQuantizations());
+    CPPUNIT_ASSERT_EQUAL_MESSAGE("Masked voxels should be visited only once", 1u, session->GetNumberOfTraversals());
+
+    // A modified mask invalidates the cached matrices
+    m_IBSI_Phantom_Mask_Large->Modified();
+    features[0]->CalculateFeatures(m_IBSI_Phantom_Image_Large, m_IBSI_Phantom_Mask_Large);
+    CPPUNIT_ASSERT_EQUAL_MESSAGE("Modified mask should be binned again", 2u, session->GetNumberOfQuantizations());
+  }
+
+  void SharedSession_ResultOutlivesCache()
+  {
+    mitk::TextureMatrixSession::Pointer session = mitk::TextureMatrixSession::New();
+    AddRequests(session);
+
+    mitk::IntensityQuantifier::Pointer quantifier = mitk::IntensityQuantifier::New();
+    quantifier->InitializeByBinsizeAndMaximum(0.5, 6.5, 1.0);
+    mitk::IntensityQuantifier::Pointer otherQuantifier = mitk::IntensityQuantifier::New();
+    otherQuantifier->InitializeByBinsizeAndMaximum(0.5, 6.5, 2.0);
+
+    mitk::TextureMatrixSession::Request request(mitk::TextureMatrixSession::Cooccurence, 1, 0);
+    auto result = session->GetResult(m_IBSI_Phantom_Image_Large, m_IBSI_Phantom_Mask_Large, quantifier, request);
+    CPPUNIT_ASSERT(result != nullptr);
+    const std::vector<Eigen::MatrixXd> matrices = result->Matrices;
+
+    // binning with other quantifiers and dropping the cache must not touch a result that is still used
+    for (int i = 0; i < 3; ++i)
+    {
+      session->GetResult(m_IBSI_Phantom_Image_Large, m_IBSI_Phantom_Mask_Large, otherQuantifier, request);
+      otherQuantifier->InitializeByBinsizeAndMaximum(0.5, 6.5, 3.0 + i);
+    }
+    session->Clear();
+
+    CPPUNIT_ASSERT_EQUAL(matrices.size(), result->Matrices.size());
+    for (std::size_t i = 0; i < matrices.size(); ++i)
+    {
+      CPPUNIT_ASSERT_MESSAGE("Result changed after the cache was dropped", matrices[i] == result->Matrices[i]);
+    }
+
+    auto recomputed = session->GetResult(m_IBSI_Phantom_Image_Large, m_IBSI_Phantom_Mask_Large, quantifier, request);
+    CPPUNIT_ASSERT_EQUAL(matrices.size(), recomputed->Matrices.size());
+    for (std::size_t i = 0; i < matrices.size(); ++i)
+    {
+      CPPUNIT_ASSERT_MESSAGE("Recomputed result differs", matrices[i].isApprox(recomputed->Matrices[i]));
+    }
+  }
+};
+
+MITK_TEST_SUITE_REGISTRATION(mitkGIFTextureMatrixSession)
@@ -0,0 +1,164 @@
+/*===================================================================
+
+The Medical Imaging Interaction Toolkit (MITK)
+
+Copyright (c) German Cancer Research Center,
+Division of Medical and Biological Informatics.
+All rights reserved.
+
+This software is distributed WITHOUT ANY WARRANTY; without
+even the implied warranty of MERCHANTABILITY or FITNESS FOR
+A PARTICULAR PURPOSE.
+
+See LICENSE.txt or http://www.mitk.org for details.
+
+===================================================================*/
+
+#include <mitkTestingMacros.h>
+#include <mitkTestFixture.h>
+#include <cmath>
+#include <limits>
+
+#include <itkImage.h>
+#include <itkImageRegionIterator.h>
+#include <itkConstNeighborhoodIterator.h>
+#include <itkMersenneTwisterRandomVariateGenerator.h>
+#include <itkLocalStatisticFilter.h>
+#include <itkMultiHistogramFilter.h>
+
+class mitkLocalStatisticFilterTestSuite : public mitk::TestFixture
+{
+  CPPUNIT_TEST_SUITE(mitkLocalStatisticFilterTestSuite);
+
+  MITK_TEST(LocalStatistic_MatchesNeighbourhood);
+  MITK_TEST(LocalStatistic_ConstantImage_ZeroDeviation);
+  MITK_TEST(MultiHistogram_MatchesNeighbourhood);
+
+  CPPUNIT_TEST_SUITE_END();
+
+private:
+  typedef itk::Image<double, 3> ImageType;
+  typedef itk::ConstNeighborhoodIterator<ImageType> NeighborhoodIteratorType;
+
+  ImageType::Pointer m_Image;
+
+public:
+
+  void setUp(void) override
+  {
+    ImageType::SizeType size;
+    size[0] = 23;
+    size[1] = 17;
+    size[2] = 11;
+    ImageType::RegionType region;
+    region.SetSize(size);
+
+    m_Image = ImageType::New();
+    m_Image->SetRegions(region);
+    m_Image->Allocate();
+
+    auto random = itk::Statistics::MersenneTwisterRandomVariateGenerator::New();
+    random->SetSeed(42);
+    itk::ImageRegionIterator<ImageType> iter(m_Image, region);
+    while (!iter.IsAtEnd())
+    {
+      iter.Set(random->GetNormalVariate(0.0, 2.0));
+      ++iter;
+    }
+  }
+
+  void tearDown(void) override
+  {
+    m_Image = nullptr;
+  }
+
+  void LocalStatistic_MatchesNeighbourhood()
+  {
+    typedef itk::LocalStatisticFilter<ImageType, ImageType> FilterType;
+    FilterType::Pointer filter = FilterType::New();
+    filter->SetInput(m_Image);
+    filter->SetSize(3);
+    filter->Update();
+
+    ImageType::SizeType radius;
+    radius.Fill(3);
+    radius[2] = 0;
+    NeighborhoodIteratorType inputIter(radius, m_Image, m_Image->GetLargestPossibleRegion());
+    while (!inputIter.IsAtEnd())
+    {
+      double min = std::numeric_limits<double>::max();
+      double max = std::numeric_limits<double>::lowest();
+      double mean = 0;
+      double squaredMean = 0;
+      for (unsigned int i = 0; i < inputIter.Size(); ++i)
+      {
+        double value = inputIter.GetPixel(i);
+        min = std::min<double>(min, value);
+        max = std::max<double>(max, value);
+        mean += value / inputIter.Size();
+        squaredMean += (value*value) / inputIter.Size();
+      }
+
+      auto index = inputIter.GetIndex();
+      CPPUNIT_ASSERT_DOUBLES_EQUAL(min, filter->GetOutput(0)->GetPixel(index), 1e-12);
+      CPPUNIT_ASSERT_DOUBLES_EQUAL(max, filter->GetOutput(1)->GetPixel(index), 1e-12);
+      CPPUNIT_ASSERT_DOUBLES_EQUAL(mean, filter->GetOutput(2)->GetPixel(index), 1e-9);
+      CPPUNIT_ASSERT_DOUBLES_EQUAL(std::sqrt(std::max(0.0, squaredMean - mean*mean)), filter->GetOutput(3)->GetPixel(index), 1e-9);
+      CPPUNIT_ASSERT_DOUBLES_EQUAL(max - min, filter->GetOutput(4)->GetPixel(index), 1e-12);
+      ++inputIter;
+    }
+  }
+
+  void LocalStatistic_ConstantImage_ZeroDeviation()
+  {
+    // a value which is not exactly representable, so the squared sums do not cancel exactly
+    m_Image->FillBuffer(1000.1);
+
+    typedef itk::LocalStatisticFilter<ImageType, ImageType> FilterType;
+    FilterType::Pointer filter = FilterType::New();
+    filter->SetInput(m_Image);
+    filter->SetSize(3);
+    filter->Update();
+
+    itk::ImageRegionConstIterator<ImageType> iter(filter->GetOutput(3), filter->GetOutput(3)->GetLargestPossibleRegion());
+    while (!iter.IsAtEnd())
+    {
+      CPPUNIT_ASSERT_MESSAGE("Standard deviation must not be NaN", !std::isnan(iter.Get()));
+      CPPUNIT_ASSERT_DOUBLES_EQUAL(0.0, iter.Get(), 1e-3);
+      ++iter;
+    }
+  }
+
+  void MultiHistogram_MatchesNeighbourhood()
+  {
+    typedef itk::MultiHistogramFilter<ImageType, ImageType> FilterType;
+    FilterType::Pointer filter = FilterType::New();
+    filter->SetInput(m_Image);
+    filter->SetSize(2);
+    filter->Update();
+
+    const int bins = filter->GetBins();
+    ImageType::SizeType radius;
+    radius.Fill(2);
+    NeighborhoodIteratorType inputIter(radius, m_Image, m_Image->GetLargestPossibleRegion());
+    while (!inputIter.IsAtEnd())
+    {
+      std::vector<double> histogram(bins, 0);
+      for (unsigned int i = 0; i < inputIter.Size(); ++i)
+      {
+        double value = (inputIter.GetPixel(i) - filter->GetOffset()) / filter->GetDelta();
+        auto pos = std::max(0, std::min(bins - 1, (int)(value)));
+        histogram[pos] += 1;
+      }
+
+      auto index = inputIter.GetIndex();
+      for (int i = 0; i < bins; ++i)
+      {
+        CPPUNIT_ASSERT_EQUAL(histogram[i], filter->GetOutput(i)->GetPixel(index));
+      }
+      ++inputIter;
+    }
+  }
+};
+
+MITK_TEST_SUITE_REGISTRATION(mitkLocalStatisticFilter)
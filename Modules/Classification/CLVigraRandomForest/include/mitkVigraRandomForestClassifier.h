@@ -25,6 +25,9 @@ See LICENSE.txt or http://www.mitk.org for details.
 
 #include <mitkBaseData.h>
 
+#include <functional>
+#include <memory>
+
 namespace mitk
 {
   class MITKCLVIGRARANDOMFOREST_EXPORT VigraRandomForestClassifier : public AbstractClassifier
@@ -44,6 +47,22 @@ namespace mitk
     Eigen::MatrixXi Predict(const Eigen::MatrixXd &X) override;
     Eigen::MatrixXi PredictWeighted(const Eigen::MatrixXd &X);
 
+    /// @brief Fills the rows of the block with the features of the samples [firstSample, firstSample + block.rows()).
+    typedef std::function<void(std::size_t firstSample, Eigen::MatrixXd &block)> FeatureBlockFunctionType;
+    /// @brief Receives the labels and class probabilities of the samples [firstSample, firstSample + labels.rows()).
+    typedef std::function<void(std::size_t firstSample, const Eigen::MatrixXi &labels, const Eigen::MatrixXd &probabilities)> ResultBlockFunctionType;
+
+    ///
+    /// @brief Predicts a large number of samples block by block, e.g. all voxels of a feature image.
+    ///
+    /// Only a single block of samples is kept as dense feature matrix. The blocks are requested and
+    /// returned in ascending order, so the callbacks may iterate through image buffers. The result is
+    /// the same as calling Predict() with the complete feature matrix, GetPointWiseProbabilities() and
+    /// GetLabels() are not changed.
+    ///
+    void PredictBlockwise(std::size_t numberOfSamples, std::size_t numberOfFeatures,
+                          const FeatureBlockFunctionType &features, const ResultBlockFunctionType &results,
+                          std::size_t blockSize = 16384);
 
     bool SupportsPointWiseWeight() override;
     bool SupportsPointWiseProbability() override;
@@ -77,6 +96,8 @@ namespace mitk
     struct PredictionData;
     struct EigenToVigraTransform;
     struct Parameter;
+    struct CompiledForest;
+    struct CompiledPredictionData;
 
     vigra::MultiArrayView<2, double> m_Probabilities;
     Eigen::MatrixXd m_TreeWeights;
@@ -84,9 +105,15 @@ namespace mitk
     Parameter * m_Parameter;
     vigra::RandomForest<int> m_RandomForest;
 
+    /// Flattened copy of m_RandomForest used for prediction, created on demand
+    std::shared_ptr<CompiledForest> m_CompiledForest;
+    const CompiledForest *GetCompiledForest();
+    void PredictCompiled(const CompiledForest &forest, const Eigen::MatrixXd &X, bool weighted, Eigen::MatrixXi &Y, Eigen::MatrixXd &P);
+
     static ITK_THREAD_RETURN_TYPE TrainTreesCallback(void *);
     static ITK_THREAD_RETURN_TYPE PredictCallback(void *);
     static ITK_THREAD_RETURN_TYPE PredictWeightedCallback(void *);
+    static ITK_THREAD_RETURN_TYPE PredictCompiledCallback(void *);
     static void VigraPredictWeighted(PredictionData *data, vigra::MultiArrayView<2, double> & X, vigra::MultiArrayView<2, int> & Y, vigra::MultiArrayView<2, double> & P);
   };
 }
@@ -30,6 +30,11 @@ See LICENSE.txt or http://www.mitk.org for details.
 #include <itkMultiThreader.h>
 #include <itkCommand.h>
 
+// STL includes
+#include <algorithm>
+#include <cmath>
+#include <deque>
+
 typedef mitk::ThresholdSplit<mitk::LinearSplitting< mitk::ImpurityLoss<> >,int,vigra::ClassificationTag> DefaultSplitType;
 
 struct mitk::VigraRandomForestClassifier::Parameter
@@ -97,6 +102,193 @@ struct mitk::VigraRandomForestClassifier::PredictionData
   vigra::MultiArrayView<2, double> m_TreeWeights;
 };
 
+struct mitk::VigraRandomForestClassifier::CompiledForest
+{
+  /// Split nodes keep the feature column and the threshold, their two children are stored next to each
+  /// other at Next and Next + 1. Leaves have a negative column and Next points to their values.
+  struct Node
+  {
+    double Threshold;
+    int Column;
+    int Next;
+  };
+
+  CompiledForest(const vigra::RandomForest<int> &rf)
+    : ClassCount(rf.ext_param_.class_count_),
+    SampleWeightedLeaves(rf.options_.predict_weighted_),
+    Valid(true)
+  {
+    for (int c = 0; c < ClassCount; ++c)
+    {
+      int label;
+      rf.ext_param_.to_classlabel(c, label);
+      ClassLabels.push_back(label);
+    }
+    for (int k = 0; k < rf.options_.tree_count_ && Valid; ++k)
+    {
+      Valid = AddTree(rf.trees_[k]);
+    }
+  }
+
+  bool AddTree(const vigra::RandomForest<int>::DecisionTree_t &tree)
+  {
+    // breadth first, so that the nodes close to the root share the same cache lines
+    std::deque<std::pair<int, int> > openNodes;
+    Roots.push_back(static_cast<int>(Nodes.size()));
+    Nodes.push_back(Node());
+    openNodes.push_back(std::make_pair(2, Roots.back()));
+    while (!openNodes.empty())
+    {
+      int treeIndex = openNodes.front().first;
+      int nodeIndex = openNodes.front().second;
+      openNodes.pop_front();
+
+      if (tree.topology_[treeIndex] == vigra::e_ConstProbNode)
+      {
+        vigra::Node<vigra::e_ConstProbNode> leaf(tree.topology_, tree.parameters_, treeIndex);
+        Nodes[nodeIndex].Threshold = 0;
+        Nodes[nodeIndex].Column = -1;
+        Nodes[nodeIndex].Next = static_cast<int>(LeafValues.size());
+        LeafValues.push_back(leaf.weights());
+        for (int c = 0; c < ClassCount; ++c)
+        {
+          LeafValues.push_back(leaf.prob_begin()[c]);
+        }
+      }
+      else if (tree.topology_[treeIndex] == vigra::i_ThresholdNode)
+      {
+        vigra::Node<vigra::i_ThresholdNode> split(tree.topology_, tree.parameters_, treeIndex);
+        int next = static_cast<int>(Nodes.size());
+        Nodes[nodeIndex].Threshold = split.threshold();
+        Nodes[nodeIndex].Column = split.column();
+        Nodes[nodeIndex].Next = next;
+        Nodes.resize(next + 2);
+        openNodes.push_back(std::make_pair(split.child(0), next));
+        openNodes.push_back(std::make_pair(split.child(1), next + 1));
+      }
+      else
+      {
+        // Other split types are left to vigra
+        return false;
+      }
+    }
+    return true;
+  }
+
+  /// Predicts the rows [begin, end), equal to vigra::RandomForest::predictProbabilities() and predictLabels(),
+  /// or to VigraPredictWeighted() if tree weights are given.
+  void Predict(const Eigen::MatrixXd &X, Eigen::Index begin, Eigen::Index end, const Eigen::MatrixXd *treeWeights,
+               Eigen::MatrixXi &Y, Eigen::MatrixXd &P) const
+  {
+    // The rows are processed in small tiles, tree after tree, so that each tree is loaded only once per tile
+    const Eigen::Index tileSize = 64;
+    const Eigen::Index numberOfColumns = X.cols();
+    const double sampleWeighted = SampleWeightedLeaves ? 1.0 : 0.0;
+    std::vector<double> tile(tileSize * numberOfColumns);
+    std::vector<double> totalWeights(tileSize);
+    std::vector<bool> containsNaN(tileSize);
+
+    for (Eigen::Index tileBegin = begin; tileBegin < end; tileBegin += tileSize)
+    {
+      const Eigen::Index rows = std::min(tileSize, end - tileBegin);
+      for (Eigen::Index r = 0; r < rows; ++r)
+      {
+        containsNaN[r] = false;
+        totalWeights[r] = 0;
+        for (Eigen::Index c = 0; c < numberOfColumns; ++c)
+        {
+          tile[r * numberOfColumns + c] = X(tileBegin + r, c);
+          containsNaN[r] = containsNaN[r] || std::isnan(X(tileBegin + r, c));
+        }
+      }
+
+      for (std::size_t k = 0; k < Roots.size(); ++k)
+      {
+        for (Eigen::Index r = 0; r < rows; ++r)
+        {
+          if (containsNaN[r] && treeWeights == nullptr)
+            continue;
+
+          const double *row = &tile[r * numberOfColumns];
+          int index = Roots[k];
+          while (Nodes[index].Column >= 0)
+          {
+            index = Nodes[index].Next + ((row[Nodes[index].Column] < Nodes[index].Threshold) ? 0 : 1);
+          }
+
+          const double *leaf = &LeafValues[Nodes[index].Next];
+          const double leafWeight = sampleWeighted * leaf[0] + (1 - sampleWeighted);
+          for (int l = 0; l < ClassCount; ++l)
+          {
+            double currentWeight = leaf[l + 1] * leafWeight;
+            if (treeWeights != nullptr)
+            {
+              currentWeight = currentWeight * (*treeWeights)(k, 0);
+              P(tileBegin + r, l) += (int)currentWeight;
+            }
+            else
+            {
+              P(tileBegin + r, l) += currentWeight;
+            }
+            totalWeights[r] += currentWeight;
+          }
+        }
+      }
+
+      for (Eigen::Index r = 0; r < rows; ++r)
+      {
+        const Eigen::Index row = tileBegin + r;
+        if (containsNaN[r] && treeWeights == nullptr)
+        {
+          P.row(row).setZero();
+        }
+        else
+        {
+          P.row(row) /= totalWeights[r];
+        }
+
+        int maxCol = 0;
+        for (int col = 0; col < ClassCount; ++col)
+        {
+          if (P(row, col) > P(row, maxCol))
+            maxCol = col;
+        }
+        Y(row, 0) = ClassLabels[maxCol];
+      }
+    }
+  }
+
+  std::vector<Node> Nodes;
+  std::vector<int> Roots;
+  /// Number of leaf observations followed by the class probabilities of each leaf
+  std::vector<double> LeafValues;
+  std::vector<int> ClassLabels;
+  int ClassCount;
+  bool SampleWeightedLeaves;
+  bool Valid;
+};
+
+struct mitk::VigraRandomForestClassifier::CompiledPredictionData
+{
+  CompiledPredictionData(const CompiledForest &forest,
+    const Eigen::MatrixXd &feature,
+    const Eigen::MatrixXd *treeWeights,
+    Eigen::MatrixXi &label,
+    Eigen::MatrixXd &probabilities)
+    : m_Forest(forest),
+    m_Feature(feature),
+    m_TreeWeights(treeWeights),
+    m_Label(label),
+    m_Probabilities(probabilities)
+  {
+  }
+  const CompiledForest &m_Forest;
+  const Eigen::MatrixXd &m_Feature;
+  const Eigen::MatrixXd *m_TreeWeights;
+  Eigen::MatrixXi &m_Label;
+  Eigen::MatrixXd &m_Probabilities;
+};
+
 mitk::VigraRandomForestClassifier::VigraRandomForestClassifier()
   :m_Parameter(nullptr)
 {
@@ -124,6 +316,7 @@ void mitk::VigraRandomForestClassifier::OnlineTrain(const Eigen::MatrixXd & X_in
   vigra::MultiArrayView<2, double> X(vigra::Shape2(X_in.rows(),X_in.cols()),X_in.data());
   vigra::MultiArrayView<2, int> Y(vigra::Shape2(Y_in.rows(),Y_in.cols()),Y_in.data());
   m_RandomForest.onlineLearn(X,Y,0,true);
+  m_CompiledForest.reset();
 }
 
 void mitk::VigraRandomForestClassifier::Train(const Eigen::MatrixXd & X_in, const Eigen::MatrixXi &Y_in)
@@ -168,6 +361,7 @@ void mitk::VigraRandomForestClassifier::Train(const Eigen::MatrixXd & X_in, cons
   m_RandomForest.set_options().tree_count(m_Parameter->TreeCount);
   m_RandomForest.ext_param_.class_count_ = data->m_ClassCount;
   m_RandomForest.trees_ = data->trees_;
+  m_CompiledForest.reset();
 
   // Set Tree Weights to default
   m_TreeWeights = Eigen::MatrixXd(m_Parameter->TreeCount,1);
@@ -195,6 +389,13 @@ Eigen::MatrixXi mitk::VigraRandomForestClassifier::Predict(const Eigen::MatrixXd
   vigra::MultiArrayView<2, double> X(vigra::Shape2(X_in.rows(),X_in.cols()),X_in.data());
   vigra::MultiArrayView<2, double> TW(vigra::Shape2(m_RandomForest.tree_count(),1),m_TreeWeights.data());
 
+  if (auto forest = this->GetCompiledForest())
+  {
+    this->PredictCompiled(*forest, X_in, false, m_OutLabel, m_OutProbability);
+    m_Probabilities = P;
+    return m_OutLabel;
+  }
+
   std::unique_ptr<PredictionData> data;
   data.reset(new PredictionData(m_RandomForest, X, Y, P, TW));
 
@@ -227,6 +428,12 @@ Eigen::MatrixXi mitk::VigraRandomForestClassifier::PredictWeighted(const Eigen::
   vigra::MultiArrayView<2, double> X(vigra::Shape2(X_in.rows(),X_in.cols()),X_in.data());
   vigra::MultiArrayView<2, double> TW(vigra::Shape2(m_RandomForest.tree_count(),1),m_TreeWeights.data());
 
+  if (auto forest = this->GetCompiledForest())
+  {
+    this->PredictCompiled(*forest, X_in, true, m_OutLabel, m_OutProbability);
+    return m_OutLabel;
+  }
+
   std::unique_ptr<PredictionData> data;
   data.reset( new PredictionData(m_RandomForest,X,Y,P,TW));
 
@@ -239,6 +446,68 @@ Eigen::MatrixXi mitk::VigraRandomForestClassifier::PredictWeighted(const Eigen::
 
 
 
+void mitk::VigraRandomForestClassifier::PredictBlockwise(std::size_t numberOfSamples, std::size_t numberOfFeatures,
+                                                         const FeatureBlockFunctionType &features, const ResultBlockFunctionType &results,
+                                                         std::size_t blockSize)
+{
+  auto forest = this->GetCompiledForest();
+  blockSize = std::max<std::size_t>(blockSize, 1);
+
+  Eigen::MatrixXd block;
+  Eigen::MatrixXi labels;
+  Eigen::MatrixXd probabilities;
+  for (std::size_t firstSample = 0; firstSample < numberOfSamples; firstSample += blockSize)
+  {
+    const std::size_t rows = std::min(blockSize, numberOfSamples - firstSample);
+    block.resize(rows, numberOfFeatures);
+    features(firstSample, block);
+
+    labels.setZero(rows, 1);
+    probabilities.setZero(rows, m_RandomForest.class_count());
+    if (forest != nullptr)
+    {
+      this->PredictCompiled(*forest, block, false, labels, probabilities);
+    }
+    else
+    {
+      vigra::MultiArrayView<2, double> P(vigra::Shape2(probabilities.rows(), probabilities.cols()), probabilities.data());
+      vigra::MultiArrayView<2, int> Y(vigra::Shape2(labels.rows(), labels.cols()), labels.data());
+      vigra::MultiArrayView<2, double> X(vigra::Shape2(block.rows(), block.cols()), block.data());
+      vigra::MultiArrayView<2, double> TW(vigra::Shape2(m_TreeWeights.rows(), 1), m_TreeWeights.data());
+
+      std::unique_ptr<PredictionData> data(new PredictionData(m_RandomForest, X, Y, P, TW));
+      itk::MultiThreader::Pointer threader = itk::MultiThreader::New();
+      threader->SetSingleMethod(this->PredictCallback, data.get());
+      threader->SingleMethodExecute();
+    }
+    results(firstSample, labels, probabilities);
+  }
+}
+
+const mitk::VigraRandomForestClassifier::CompiledForest * mitk::VigraRandomForestClassifier::GetCompiledForest()
+{
+  if (m_CompiledForest == nullptr || m_CompiledForest->Roots.size() != static_cast<std::size_t>(m_RandomForest.tree_count()))
+  {
+    m_CompiledForest = std::make_shared<CompiledForest>(m_RandomForest);
+  }
+  return m_CompiledForest->Valid ? m_CompiledForest.get() : nullptr;
+}
+
+void mitk::VigraRandomForestClassifier::PredictCompiled(const CompiledForest &forest, const Eigen::MatrixXd &X, bool weighted, Eigen::MatrixXi &Y, Eigen::MatrixXd &P)
+{
+  if (weighted && m_TreeWeights.rows() != m_RandomForest.tree_count())
+  {
+    m_TreeWeights = Eigen::MatrixXd(m_RandomForest.tree_count(), 1);
+    m_TreeWeights.fill(1);
+  }
+
+  std::unique_ptr<CompiledPredictionData> data(new CompiledPredictionData(forest, X, weighted ? &m_TreeWeights : nullptr, Y, P));
+
+  itk::MultiThreader::Pointer threader = itk::MultiThreader::New();
+  threader->SetSingleMethod(this->PredictCompiledCallback, data.get());
+  threader->SingleMethodExecute();
+}
+
 void mitk::VigraRandomForestClassifier::SetTreeWeights(Eigen::MatrixXd weights)
 {
   m_TreeWeights = weights;
@@ -401,6 +670,28 @@ ITK_THREAD_RETURN_TYPE mitk::VigraRandomForestClassifier::PredictWeightedCallbac
 }
 
 
+ITK_THREAD_RETURN_TYPE mitk::VigraRandomForestClassifier::PredictCompiledCallback(void * arg)
+{
+  // Get the ThreadInfoStruct
+  typedef itk::MultiThreader::ThreadInfoStruct  ThreadInfoType;
+  ThreadInfoType * infoStruct = static_cast< ThreadInfoType * >( arg );
+  const unsigned int threadId = infoStruct->ThreadID;
+
+  CompiledPredictionData * data = (CompiledPredictionData *)(infoStruct->UserData);
+
+  // Get number of rows to calculate, the last thread takes the residuals
+  Eigen::Index numberOfRowsToCalculate = data->m_Feature.rows() / infoStruct->NumberOfThreads;
+  Eigen::Index start_index = numberOfRowsToCalculate * threadId;
+  Eigen::Index end_index = numberOfRowsToCalculate * (threadId+1);
+  if(threadId == infoStruct->NumberOfThreads-1) {
+    end_index += data->m_Feature.rows() % infoStruct->NumberOfThreads;
+  }
+
+  data->m_Forest.Predict(data->m_Feature, start_index, end_index, data->m_TreeWeights, data->m_Label, data->m_Probabilities);
+
+  return ITK_THREAD_RETURN_VALUE;
+}
+
 void mitk::VigraRandomForestClassifier::VigraPredictWeighted(PredictionData * data, vigra::MultiArrayView<2, double> & X, vigra::MultiArrayView<2, int> & Y, vigra::MultiArrayView<2, double> & P)
 {
 
@@ -585,6 +876,7 @@ void mitk::VigraRandomForestClassifier::SetRandomForest(const vigra::RandomFores
   this->SetSamplesPerTree(rf.options().training_set_proportion_);
   this->UseSampleWithReplacement(rf.options().sample_with_replacement_);
   this->m_RandomForest = rf;
+  this->m_CompiledForest.reset();
 }
 
 const vigra::RandomForest<int> & mitk::VigraRandomForestClassifier::GetRandomForest() const
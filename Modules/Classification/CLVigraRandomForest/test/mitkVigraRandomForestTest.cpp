@@ -27,6 +27,8 @@ See LICENSE.txt or http://www.mitk.org for details.
 #include <mitkImageCast.h>
 #include <mitkStandaloneDataStorage.h>
 
+#include <chrono>
+
 class mitkVigraRandomForestTestSuite : public mitk::TestFixture
 {
   CPPUNIT_TEST_SUITE(mitkVigraRandomForestTestSuite  );
@@ -39,6 +41,7 @@ class mitkVigraRandomForestTestSuite : public mitk::TestFixture
   MITK_TEST(TrainThreadedDecisionForest_MatlabDataSet_shouldReturnTrue);
   MITK_TEST(PredictWeightedDecisionForest_SetWeightsToZero_shouldReturnTrue);
   MITK_TEST(TrainThreadedDecisionForest_BreastCancerDataSet_shouldReturnTrue);
+  MITK_TEST(PredictBlockwise_BreastCancerDataSet_shouldMatchVigraPrediction);
   CPPUNIT_TEST_SUITE_END();
 
 private:
@@ -140,6 +143,69 @@ public:
     MITK_TEST_CONDITION(isIntervall<int>(Labels_Testing,classes,98,99),"Testvalue of cancer data set is in range.");
   }
 
+  // ------------------------------------------------------------------------------------------------------
+  // ------------------------------------------------------------------------------------------------------
+  /*
+  Compare the flattened forest, used by Predict and PredictBlockwise, with the prediction of the vigra forest
+  and report the number of predicted samples per second.
+  */
+  void PredictBlockwise_BreastCancerDataSet_shouldMatchVigraPrediction()
+  {
+    auto & Features_Training = FeatureData_Cancer.first;
+    auto & Features_Testing = FeatureData_Cancer.second;
+    auto & Labels_Training = LabelData_Cancer.first;
+
+    classifier->Train(Features_Training,Labels_Training);
+
+    // Reference result of the vigra forest
+    const auto & rf = classifier->GetRandomForest();
+    MatrixDoubleType referenceProbabilities(Features_Testing.rows(), rf.class_count());
+    referenceProbabilities.fill(0);
+    MatrixIntType referenceLabels(Features_Testing.rows(), 1);
+    vigra::MultiArrayView<2, double> X(vigra::Shape2(Features_Testing.rows(), Features_Testing.cols()), Features_Testing.data());
+    vigra::MultiArrayView<2, double> P(vigra::Shape2(referenceProbabilities.rows(), referenceProbabilities.cols()), referenceProbabilities.data());
+    vigra::MultiArrayView<2, int> Y(vigra::Shape2(referenceLabels.rows(), referenceLabels.cols()), referenceLabels.data());
+    auto startVigra = std::chrono::steady_clock::now();
+    rf.predictLabels(X, Y);
+    rf.predictProbabilities(X, P);
+    auto endVigra = std::chrono::steady_clock::now();
+
+    auto startPredict = std::chrono::steady_clock::now();
+    Eigen::MatrixXi classes = classifier->Predict(Features_Testing);
+    auto endPredict = std::chrono::steady_clock::now();
+    Eigen::MatrixXd probabilities = classifier->GetPointWiseProbabilities();
+
+    CPPUNIT_ASSERT_MESSAGE("Predicted labels are equal to vigra", classes == referenceLabels);
+    CPPUNIT_ASSERT_MESSAGE("Predicted probabilities are equal to vigra", probabilities.isApprox(referenceProbabilities));
+
+    // Small blocks, so that the last one is incomplete
+    Eigen::MatrixXi blockClasses(Features_Testing.rows(), 1);
+    Eigen::MatrixXd blockProbabilities(Features_Testing.rows(), rf.class_count());
+    std::size_t expectedFirstSample = 0;
+    classifier->PredictBlockwise(Features_Testing.rows(), Features_Testing.cols(),
+      [&](std::size_t firstSample, Eigen::MatrixXd & block)
+      {
+        CPPUNIT_ASSERT_EQUAL(expectedFirstSample, firstSample);
+        block = Features_Testing.middleRows(firstSample, block.rows());
+        expectedFirstSample += block.rows();
+      },
+      [&](std::size_t firstSample, const Eigen::MatrixXi & labels, const Eigen::MatrixXd & probs)
+      {
+        blockClasses.middleRows(firstSample, labels.rows()) = labels;
+        blockProbabilities.middleRows(firstSample, probs.rows()) = probs;
+      },
+      17);
+
+    CPPUNIT_ASSERT_EQUAL(std::size_t(Features_Testing.rows()), expectedFirstSample);
+    CPPUNIT_ASSERT_MESSAGE("Blockwise labels are equal to Predict", blockClasses == classes);
+    CPPUNIT_ASSERT_MESSAGE("Blockwise probabilities are equal to Predict", blockProbabilities == probabilities);
+
+    double vigraSeconds = std::chrono::duration<double>(endVigra - startVigra).count();
+    double predictSeconds = std::chrono::duration<double>(endPredict - startPredict).count();
+    MITK_INFO << "Vigra prediction: " << Features_Testing.rows() / vigraSeconds << " samples per second";
+    MITK_INFO << "Flattened forest prediction: " << Features_Testing.rows() / predictSeconds << " samples per second";
+  }
+
   // ------------------------------------------------------------------------------------------------------
   // ------------------------------------------------------------------------------------------------------
 
@@ -24,6 +24,11 @@ See LICENSE.txt or http://www.mitk.org for details.
 
 #include <MitkTestingHelperExports.h>
 
+#include <map>
+#include <ostream>
+#include <string>
+#include <vector>
+
 class vtkRenderWindow;
 class vtkRenderer;
 
@@ -43,6 +48,9 @@ namespace mitk
    * InteractionTestHelper::AddNodeToStorage.
     * Use InteractionTestHelper::PlaybackInteraction to execute. The result can afterwards be compared to a reference
    * object.
+    *
+    * Use InteractionTestHelper::BenchmarkInteraction instead to measure how long it takes from an event until
+    * the render windows show its result, e.g. to compare the performance of interactors and mappers between revisions.
     *
     * Make sure to destroy the test helper instance after each test, since all render windows and its renderers have to
    * be
@@ -80,6 +88,48 @@ namespace mitk
      */
     void PlaybackInteraction();
 
+    /**
+     * @brief Timings of a single event played back by BenchmarkInteraction, in milliseconds.
+     */
+    struct EventTiming
+    {
+      std::string EventClass;
+      std::string RendererName;
+      /** time spent in Dispatcher::ProcessEvent */
+      double ProcessingTime;
+      /** time spent rendering the windows for which an update was requested while processing the event */
+      double RenderTime;
+      /** time from passing the event to the dispatcher until all render windows have finished rendering */
+      double Latency;
+      /** render time per render window, by name of its renderer; windows which were not rendered are missing */
+      std::map<std::string, double> RenderTimePerWindow;
+      /** time spent by each mapper in Mapper::Update() and its render passes, by "renderer/node (mapper class)";
+       * mappers which were not rendered are missing */
+      std::map<std::string, double> RenderTimePerMapper;
+    };
+
+    typedef std::vector<EventTiming> EventTimingListType;
+
+    /**
+     * @brief BenchmarkInteraction plays back the loaded interaction like PlaybackInteraction, but executes the
+     * pending rendering requests after each event and measures the time needed for both.
+     *
+     * The render windows are not visible, so the result covers the MITK and VTK side of interaction and rendering,
+     * but not the presentation of the frame by a window system.
+     *
+     * The time spent by each mapper is taken from the rendering statistics of the renderers, see
+     * BaseRenderer::GetMapperRenderingStatistics. They are enabled while the interaction is played back.
+     *
+     * \sa PrintBenchmarkReport
+     */
+    EventTimingListType BenchmarkInteraction();
+
+    /**
+     * @brief PrintBenchmarkReport prints the mean processing and render times and the latency percentiles per event
+     * class, as well as the render time per render window and per mapper.
+     */
+    static void PrintBenchmarkReport(const EventTimingListType &timings, std::ostream &os);
+
     /**
      * @brief SetTimeStep Sets timesteps of all SliceNavigationControllers to given timestep.
      * @param newTimeStep new timestep
@@ -135,6 +185,12 @@ namespace mitk
      */
     void LoadInteraction();
 
+    /**
+     * @brief PrepareRenderWindows initializes the views to the data and renders all windows once, so that the
+     * played back events find the geometries they were recorded with.
+     */
+    void PrepareRenderWindows();
+
     mitk::XML2EventParser::EventContainerType m_Events; // List with loaded interaction events
 
     std::string m_InteractionFilePath;
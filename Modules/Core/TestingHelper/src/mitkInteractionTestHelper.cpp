@@ -22,14 +22,147 @@ See LICENSE.txt or http://www.mitk.org for details.
 #include <mitkStandaloneDataStorage.h>
 
 // VTK
+#include <vtkCallbackCommand.h>
 #include <vtkCamera.h>
+#include <vtkRenderWindow.h>
 #include <vtkRenderWindowInteractor.h>
+#include <vtkSmartPointer.h>
 
 // us
 #include <usGetModuleContext.h>
 
 #include <tinyxml.h>
 
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <iomanip>
+
+namespace
+{
+  typedef std::chrono::steady_clock Clock;
+
+  double ElapsedMilliseconds(const Clock::time_point &start, const Clock::time_point &end)
+  {
+    return std::chrono::duration<double, std::milli>(end - start).count();
+  }
+
+  // Measures the time between the start and end event of a vtkRenderWindow
+  struct RenderTimer
+  {
+    Clock::time_point Start;
+    double Elapsed;
+    bool Rendered;
+  };
+
+  void RenderStartCallback(vtkObject *, unsigned long, void *clientData, void *)
+  {
+    static_cast<RenderTimer *>(clientData)->Start = Clock::now();
+  }
+
+  void RenderEndCallback(vtkObject *, unsigned long, void *clientData, void *)
+  {
+    auto timer = static_cast<RenderTimer *>(clientData);
+    timer->Elapsed += ElapsedMilliseconds(timer->Start, Clock::now());
+    timer->Rendered = true;
+  }
+
+  // Number of update and render time samples per mapper, to find the mappers which took part in a frame
+  typedef std::map<const mitk::Mapper *, std::pair<unsigned long, unsigned long>> SampleCountMapType;
+
+  SampleCountMapType GetSampleCounts(const mitk::BaseRenderer *renderer)
+  {
+    SampleCountMapType sampleCounts;
+    for (const auto &statistics : renderer->GetMapperRenderingStatistics())
+    {
+      sampleCounts[statistics.first] = std::make_pair(statistics.second.UpdateTime.GetNumberOfSamples(),
+                                                      statistics.second.RenderTime.GetNumberOfSamples());
+    }
+    return sampleCounts;
+  }
+
+  // Adds the times of the mappers with new samples since sampleCounts were taken
+  void AddMapperTimes(const mitk::BaseRenderer *renderer,
+                      const SampleCountMapType &sampleCounts,
+                      std::map<std::string, double> &renderTimePerMapper)
+  {
+    for (const auto &statistics : renderer->GetMapperRenderingStatistics())
+    {
+      const mitk::MapperRenderingStatistics &mapperStatistics = statistics.second;
+      auto previousCounts = sampleCounts.find(statistics.first);
+      const bool isNew = previousCounts == sampleCounts.end();
+
+      double time = 0.0;
+      bool rendered = false;
+      if (isNew || previousCounts->second.first != mapperStatistics.UpdateTime.GetNumberOfSamples())
+      {
+        time += mapperStatistics.UpdateTime.GetLast();
+        rendered = true;
+      }
+      if (isNew || previousCounts->second.second != mapperStatistics.RenderTime.GetNumberOfSamples())
+      {
+        time += mapperStatistics.RenderTime.GetLast();
+        rendered = true;
+      }
+
+      if (rendered)
+      {
+        const std::string name = std::string(renderer->GetName()) + "/" + mapperStatistics.NodeName + " (" +
+                                 mapperStatistics.MapperClassName + ")";
+        renderTimePerMapper[name] += time;
+      }
+    }
+  }
+
+  void PrintRenderTimeTable(const std::string &title,
+                            const std::map<std::string, std::pair<double, unsigned int>> &renderTimes,
+                            int nameWidth,
+                            std::ostream &os)
+  {
+    os << std::endl << std::left << std::setw(nameWidth) << title << std::right << std::setw(7) << "Frames"
+       << std::setw(12) << "Mean" << std::setw(12) << "Total" << std::endl;
+    for (const auto &renderTime : renderTimes)
+    {
+      os << std::left << std::setw(nameWidth) << renderTime.first << std::right << std::setw(7)
+         << renderTime.second.second << std::fixed << std::setprecision(3) << std::setw(12)
+         << renderTime.second.first / renderTime.second.second << std::setw(12) << renderTime.second.first
+         << std::endl;
+    }
+  }
+
+  // nearest-rank percentile of sorted values
+  double Percentile(const std::vector<double> &sortedValues, double percent)
+  {
+    if (sortedValues.empty())
+      return 0.0;
+
+    auto rank = static_cast<std::size_t>(std::ceil(percent / 100.0 * sortedValues.size()));
+    return sortedValues[std::min(std::max<std::size_t>(rank, 1), sortedValues.size()) - 1];
+  }
+
+  void PrintTimingRow(const std::string &name,
+                      const std::vector<const mitk::InteractionTestHelper::EventTiming *> &timings,
+                      std::ostream &os)
+  {
+    double processingTime = 0.0;
+    double renderTime = 0.0;
+    std::vector<double> latencies;
+    for (auto timing : timings)
+    {
+      processingTime += timing->ProcessingTime;
+      renderTime += timing->RenderTime;
+      latencies.push_back(timing->Latency);
+    }
+    std::sort(latencies.begin(), latencies.end());
+
+    const double count = static_cast<double>(timings.size());
+    os << std::left << std::setw(28) << name << std::right << std::setw(7) << timings.size() << std::fixed
+       << std::setprecision(3) << std::setw(12) << processingTime / count << std::setw(12) << renderTime / count
+       << std::setw(10) << Percentile(latencies, 50) << std::setw(10) << Percentile(latencies, 90) << std::setw(10)
+       << Percentile(latencies, 99) << std::setw(10) << latencies.back() << std::endl;
+  }
+}
+
 mitk::InteractionTestHelper::InteractionTestHelper(const std::string &interactionXmlFilePath)
   : m_InteractionFilePath(interactionXmlFilePath)
 {
@@ -211,6 +344,145 @@ void mitk::InteractionTestHelper::AddNodeToStorage(mitk::DataNode::Pointer node)
 }
 
 void mitk::InteractionTestHelper::PlaybackInteraction()
+{
+  this->PrepareRenderWindows();
+
+  // mitk::RenderingManager::GetInstance()->ForceImmediateUpdateAll();
+  // playback all events in queue
+  for (unsigned long i = 0; i < m_Events.size(); ++i)
+  {
+    // let dispatcher of sending renderer process the event
+    m_Events.at(i)->GetSender()->GetDispatcher()->ProcessEvent(m_Events.at(i));
+  }
+}
+
+mitk::InteractionTestHelper::EventTimingListType mitk::InteractionTestHelper::BenchmarkInteraction()
+{
+  this->PrepareRenderWindows();
+
+  auto renderingManager = mitk::RenderingManager::GetInstance();
+
+  // requests issued while preparing must not be attributed to the first event
+  renderingManager->ExecutePendingRequests();
+
+  std::vector<RenderTimer> renderTimers(m_RenderWindowList.size());
+  std::vector<std::pair<unsigned long, unsigned long>> observerTags;
+  for (std::size_t i = 0; i < m_RenderWindowList.size(); ++i)
+  {
+    vtkSmartPointer<vtkCallbackCommand> startCommand = vtkSmartPointer<vtkCallbackCommand>::New();
+    startCommand->SetCallback(RenderStartCallback);
+    startCommand->SetClientData(&renderTimers[i]);
+
+    vtkSmartPointer<vtkCallbackCommand> endCommand = vtkSmartPointer<vtkCallbackCommand>::New();
+    endCommand->SetCallback(RenderEndCallback);
+    endCommand->SetClientData(&renderTimers[i]);
+
+    vtkRenderWindow *renderWindow = m_RenderWindowList[i]->GetVtkRenderWindow();
+    observerTags.push_back(std::make_pair(renderWindow->AddObserver(vtkCommand::StartEvent, startCommand),
+                                          renderWindow->AddObserver(vtkCommand::EndEvent, endCommand)));
+  }
+
+  std::vector<bool> renderingStatisticsEnabled;
+  for (auto renderWindow : m_RenderWindowList)
+  {
+    renderingStatisticsEnabled.push_back(renderWindow->GetRenderer()->GetRenderingStatisticsEnabled());
+    renderWindow->GetRenderer()->RenderingStatisticsEnabledOn();
+  }
+
+  EventTimingListType timings;
+  std::vector<SampleCountMapType> sampleCounts(m_RenderWindowList.size());
+  for (auto event : m_Events)
+  {
+    for (std::size_t i = 0; i < m_RenderWindowList.size(); ++i)
+    {
+      renderTimers[i].Elapsed = 0.0;
+      renderTimers[i].Rendered = false;
+      sampleCounts[i] = GetSampleCounts(m_RenderWindowList[i]->GetRenderer());
+    }
+
+    const Clock::time_point start = Clock::now();
+    event->GetSender()->GetDispatcher()->ProcessEvent(event);
+    const Clock::time_point processed = Clock::now();
+
+    // this is what the application's event loop does after the event has been handled
+    renderingManager->ExecutePendingRequests();
+    for (auto renderWindow : m_RenderWindowList)
+    {
+      renderWindow->GetVtkRenderWindow()->WaitForCompletion();
+    }
+    const Clock::time_point rendered = Clock::now();
+
+    EventTiming timing;
+    timing.EventClass = event->GetNameOfClass();
+    timing.RendererName = event->GetSender()->GetName();
+    timing.ProcessingTime = ElapsedMilliseconds(start, processed);
+    timing.RenderTime = ElapsedMilliseconds(processed, rendered);
+    timing.Latency = ElapsedMilliseconds(start, rendered);
+    for (std::size_t i = 0; i < m_RenderWindowList.size(); ++i)
+    {
+      if (renderTimers[i].Rendered)
+      {
+        timing.RenderTimePerWindow[m_RenderWindowList[i]->GetRenderer()->GetName()] = renderTimers[i].Elapsed;
+        AddMapperTimes(m_RenderWindowList[i]->GetRenderer(), sampleCounts[i], timing.RenderTimePerMapper);
+      }
+    }
+    timings.push_back(timing);
+  }
+
+  for (std::size_t i = 0; i < m_RenderWindowList.size(); ++i)
+  {
+    vtkRenderWindow *renderWindow = m_RenderWindowList[i]->GetVtkRenderWindow();
+    renderWindow->RemoveObserver(observerTags[i].first);
+    renderWindow->RemoveObserver(observerTags[i].second);
+    m_RenderWindowList[i]->GetRenderer()->SetRenderingStatisticsEnabled(renderingStatisticsEnabled[i]);
+  }
+
+  return timings;
+}
+
+void mitk::InteractionTestHelper::PrintBenchmarkReport(const EventTimingListType &timings, std::ostream &os)
+{
+  if (timings.empty())
+  {
+    os << "No events have been played back." << std::endl;
+    return;
+  }
+
+  std::map<std::string, std::vector<const EventTiming *>> timingsPerClass;
+  std::vector<const EventTiming *> allTimings;
+  std::map<std::string, std::pair<double, unsigned int>> renderTimePerWindow;
+  std::map<std::string, std::pair<double, unsigned int>> renderTimePerMapper;
+  for (const auto &timing : timings)
+  {
+    timingsPerClass[timing.EventClass].push_back(&timing);
+    allTimings.push_back(&timing);
+    for (const auto &windowTime : timing.RenderTimePerWindow)
+    {
+      renderTimePerWindow[windowTime.first].first += windowTime.second;
+      ++renderTimePerWindow[windowTime.first].second;
+    }
+    for (const auto &mapperTime : timing.RenderTimePerMapper)
+    {
+      renderTimePerMapper[mapperTime.first].first += mapperTime.second;
+      ++renderTimePerMapper[mapperTime.first].second;
+    }
+  }
+
+  os << std::left << std::setw(28) << "Event class" << std::right << std::setw(7) << "Count" << std::setw(12)
+     << "Process" << std::setw(12) << "Render" << std::setw(10) << "p50" << std::setw(10) << "p90" << std::setw(10)
+     << "p99" << std::setw(10) << "Max" << std::endl;
+  for (const auto &classTimings : timingsPerClass)
+  {
+    PrintTimingRow(classTimings.first, classTimings.second, os);
+  }
+  PrintTimingRow("All events", allTimings, os);
+  os << "(mean processing and render time, latency percentiles; all times in ms)" << std::endl;
+
+  PrintRenderTimeTable("Render window", renderTimePerWindow, 28, os);
+  PrintRenderTimeTable("Mapper", renderTimePerMapper, 60, os);
+}
+
+void mitk::InteractionTestHelper::PrepareRenderWindows()
 {
   mitk::RenderingManager::GetInstance()->InitializeViewsByBoundingObjects(m_DataStorage);
   // load events if not loaded yet
@@ -234,19 +506,6 @@ void mitk::InteractionTestHelper::PlaybackInteraction()
     (*it)->GetVtkRenderWindow()->Render();
     (*it)->GetVtkRenderWindow()->WaitForCompletion();
   }
-
-  // mitk::RenderingManager::GetInstance()->ForceImmediateUpdateAll();
-  // playback all events in queue
-  for (unsigned long i = 0; i < m_Events.size(); ++i)
-  {
-    // let dispatcher of sending renderer process the event
-    m_Events.at(i)->GetSender()->GetDispatcher()->ProcessEvent(m_Events.at(i));
-  }
-  if (false)
-  {
-    it--;
-    (*it)->GetVtkRenderWindow()->GetInteractor()->Start();
-  }
 }
 
 void mitk::InteractionTestHelper::LoadInteraction()
@@ -26,10 +26,12 @@ See LICENSE.txt or http://www.mitk.org for details.
 
 #include "mitkBindDispatcherInteractor.h"
 #include "mitkDispatcher.h"
+#include "mitkRenderingStatistics.h"
 
 #include <vtkRenderWindow.h>
 #include <vtkRenderer.h>
 
+#include <chrono>
 #include <map>
 #include <set>
 
@@ -81,6 +83,9 @@ namespace mitk
 
 #pragma GCC visibility push(default)
     itkEventMacro(RendererResetEvent, itk::AnyEvent);
+
+    /** Invoked after each frame if rendering statistics are enabled, see SetRenderingStatisticsEnabled(). */
+    itkEventMacro(RenderingStatisticsEvent, itk::AnyEvent);
 #pragma GCC visibility pop
 
     /** Standard class typedefs. */
@@ -355,6 +360,28 @@ namespace mitk
     * rendering enabled */
     unsigned int GetNumberOfVisibleLODEnabledMappers() const;
 
+    typedef std::map<const Mapper *, MapperRenderingStatistics> MapperRenderingStatisticsMapType;
+
+    /** En-/Disable recording the time spent by each mapper (disabled by default).
+    * If enabled, a RenderingStatisticsEvent is invoked after each frame. */
+    itkSetMacro(RenderingStatisticsEnabled, bool);
+    itkGetConstMacro(RenderingStatisticsEnabled, bool);
+    itkBooleanMacro(RenderingStatisticsEnabled);
+
+    /** Returns the time spent by the mappers which took part in the last frame,
+    * recorded while rendering statistics are enabled */
+    const MapperRenderingStatisticsMapType &GetMapperRenderingStatistics() const;
+
+    /** Returns the durations of the frames rendered by this renderer, from
+    * the start to the end of rendering its render window. Always recorded. */
+    const RollingTimeStatistics &GetFrameTimeStatistics() const;
+
+    void ResetRenderingStatistics();
+
+    /** Called by the RenderingManager when the render window starts and ends rendering a frame. */
+    void StartFrameTiming();
+    void StopFrameTiming();
+
     //##Documentation
     //## @brief This method converts a display point to the 3D world index
     //## using the geometry of the renderWindow.
@@ -519,6 +546,26 @@ namespace mitk
     * rendering enabled */
     unsigned int m_NumberOfVisibleLODEnabledMappers;
 
+    /** Adds the duration of Mapper::Update() to the statistics of the mapper */
+    void AddMapperUpdateTime(const Mapper *mapper, double milliseconds);
+
+    /** Adds the duration of a render pass of the mapper to its render time of the current frame */
+    void AddMapperRenderTime(const Mapper *mapper, double milliseconds);
+
+    /** Removes the statistics of all mappers which are not contained in the given set */
+    void RemoveMapperRenderingStatistics(const std::set<const Mapper *> &remainingMappers);
+
+    bool m_RenderingStatisticsEnabled;
+
+    MapperRenderingStatisticsMapType m_MapperRenderingStatistics;
+
+    /** render time of the mappers in the current frame, summed up over all render passes */
+    std::map<const Mapper *, double> m_MapperFrameRenderTimes;
+
+    RollingTimeStatistics m_FrameTimeStatistics;
+
+    std::chrono::steady_clock::time_point m_FrameStartTime;
+
     // Local Storage Handling for mappers
 
   protected:
@@ -25,7 +25,9 @@
 #include "usServiceTracker.h"
 #include <MitkCoreExports.h>
 #include <list>
+#include <memory>
 #include <mitkWeakPointer.h>
+#include <vector>
 
 namespace mitk
 {
@@ -40,7 +42,8 @@ namespace mitk
   * Receives Events (Mouse-,Key-, ... Events) and dispatches them to the registered DataInteractor Objects.
   * The order in which DataInteractors are offered to handle an event is determined by layer of their associated
   * DataNode.
-  * Higher layers are preferred.
+  * Higher layers are preferred. The layer order and the list of InteractionEventObservers are cached and only
+  * updated if interactors are added or removed, a layer changes or an observer is (un)registered.
   *
   * \ingroup Interaction
   */
@@ -96,9 +99,29 @@ namespace mitk
     ~Dispatcher() override;
 
   private:
+    struct LayeredInteractor
+    {
+      mitk::WeakPointer<DataInteractor> Interactor;
+      int Layer;
+    };
+
+    typedef std::vector<LayeredInteractor> LayeredInteractorVectorType;
+
     ListInteractorType m_Interactors;
     ListEventsType m_QueuedEvents;
 
+    /**
+     * Interactors sorted by layer (descending). Events are offered to the interactors of this snapshot,
+     * so executing actions in HandleEvent() can add or remove interactors without invalidating it.
+     * Reset whenever m_Interactors changes.
+     */
+    std::shared_ptr<const LayeredInteractorVectorType> m_SortedInteractors;
+
+    /**
+     * Returns m_SortedInteractors, after sorting the interactors again if any layer has changed.
+     */
+    std::shared_ptr<const LayeredInteractorVectorType> GetSortedInteractors();
+
     /**
      * Removes all Interactors without a DataNode pointing to them, this is necessary especially when a DataNode is
      * assigned to a new Interactor
@@ -125,6 +148,14 @@ namespace mitk
      * InteractionEvents
      */
     us::ServiceTracker<InteractionEventObserver> *m_EventObserverTracker;
+
+    /**
+     * Observers tracked by m_EventObserverTracker, refreshed if its tracking count changes.
+     */
+    const std::vector<InteractionEventObserver *> &GetEventObservers();
+
+    std::vector<InteractionEventObserver *> m_EventObservers;
+    int m_EventObserverTrackingCount;
   };
 
 } /* namespace mitk */
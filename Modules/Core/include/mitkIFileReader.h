@@ -126,6 +126,15 @@ namespace mitk
      * @return A list of files that were loaded during the last call of Read.
      */
     virtual std::vector< std::string > GetReadFiles() = 0;
+
+    /**
+     * \brief Returns true, if several instances of this reader may read different files concurrently.
+     *
+     * If several files are loaded, mitk::IOUtil reads the files of thread-safe readers in parallel.
+     * Read() or Read(DataStorage&) is then called from a worker thread, with a DataStorage which is
+     * private to this reader. The default implementation returns false.
+     */
+    virtual bool IsThreadSafe() const;
   };
 
 } // namespace mitk
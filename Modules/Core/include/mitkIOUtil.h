@@ -60,6 +60,9 @@ namespace mitk
 
       FileReaderSelector m_ReaderSelector;
       bool m_Cancel;
+
+      /// time in milliseconds which was needed to read the file
+      double m_ReadTime;
     };
 
     /**Struct that is the base class for option callbacks used in load operations. The callback is used by IOUtil, if
@@ -261,6 +261,17 @@ namespace mitk
                                   int n = 0,
                                   ImportMemoryManagementType importMemoryManagement = CopyMemory);
 
+    //##Documentation
+    //## @brief Makes this image share the pixel data of another image.
+    //##
+    //## The image is re-initialized with the header and geometry of @a data and
+    //## then references the same data items instead of a copy of the pixels, so
+    //## writing to one image changes the other one as well. The data stays
+    //## alive as long as either image references it.
+    //## @throw mitk::Exception if @a data is not an initialized image.
+    //## @sa itk::ProcessObject::GraftNthOutput
+    void Graft(const itk::DataObject *data) override;
+
     //##Documentation
     //## initialize new (or re-initialize) image information
     //## @warning Initialize() by pic assumes a plane, evenly spaced geometry starting at (0,0,0).
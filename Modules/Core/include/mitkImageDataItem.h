@@ -115,6 +115,15 @@ namespace mitk
     }
 
     ImageDataItem::ConstPointer GetParent() const { return m_Parent; }
+
+    /**
+     * @brief Keeps the given object alive as long as this item exists.
+     *
+     * Used for referenced memory (manage memory off) which is owned by another object, e.g. the
+     * mitk::MemoryMappedFile an image has been read from. Sub-items keep their parent and thereby the owner alive.
+     */
+    void SetMemoryOwner(itk::LightObject *owner) { m_MemoryOwner = owner; }
+    const itk::LightObject *GetMemoryOwner() const { return m_MemoryOwner; }
     /**
      * @brief GetVtkImageAccessor Returns a vtkImageDataItem, if none is present, a new one is constructed by the
      * ConstructVtkImageData method.
@@ -155,6 +164,8 @@ namespace mitk
 
     ImageDataItem::ConstPointer m_Parent;
 
+    itk::LightObject::Pointer m_MemoryOwner;
+
     unsigned int m_Dimension;
 
     unsigned int m_Dimensions[MAX_IMAGE_DIMENSIONS];
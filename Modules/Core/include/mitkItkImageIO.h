@@ -30,6 +30,11 @@ namespace mitk
    * Instantiating this class with a given itk::ImageIOBase instance
    * will register corresponding MITK reader/writer services for that
    * ITK ImageIO object.
+   *
+   * The writers for NRRD and MetaImage files provide the option "Compression level" (int, default 6).
+   * 0 writes uncompressed files. Levels from 1 (fastest) to 9 (smallest) are applied to .nrrd and
+   * .mha files, whose pixel data is gzip compressed by several threads; other files are compressed
+   * by ITK.
    */
   class MITKCORE_EXPORT ItkImageIO : public AbstractFileIO
   {
@@ -44,6 +49,9 @@ namespace mitk
 
     ConfidenceLevel GetReaderConfidenceLevel() const override;
 
+    /** Each instance reads with its own clone of the ITK ImageIO object. */
+    bool IsThreadSafe() const override;
+
     // -------------- AbstractFileWriter -------------
 
     void Write() override;
@@ -24,10 +24,18 @@ namespace mitk
 {
   /*!
     \brief mbilog backend implementation for mitk
+
+    By default, messages are written asynchronously: ProcessMessage() only puts the message into a
+    bounded lock-free queue, which is written to the console, the log file and the output window by a
+    separate thread. Logging threads therefore neither wait for each other nor for I/O. Messages which
+    do not fit into the queue are dropped and counted. Errors and fatal errors are written before
+    ProcessMessage() returns.
    */
   class MITKCORE_EXPORT LoggingBackend : public mbilog::TextBackendBase
   {
   public:
+    ~LoggingBackend() override;
+
     /** \brief overloaded method for receiving log message from mbilog
      */
     void ProcessMessage(const mbilog::LogMessage &) override;
@@ -95,6 +103,21 @@ namespace mitk
      */
     static void CatchLogFileCommandLineParameter(int &argc, char **argv);
 
+    /** \brief Enables or disables asynchronous writing of log messages (enabled by default).
+     *         Disabling writes all queued messages and stops the writer thread.
+     */
+    static void SetAsynchronous(bool enable);
+
+    static bool GetAsynchronous();
+
+    /** \brief Blocks until all queued messages have been written.
+     */
+    static void Flush();
+
+    /** \brief Returns the number of messages which have been dropped because the queue was full.
+     */
+    static unsigned long GetNumberOfDroppedMessages();
+
     mbilog::OutputType GetOutputType() const override;
 
   protected:
@@ -102,6 +125,14 @@ namespace mitk
      *  @return Returns true if the file exists, false if not.
      */
     static bool CheckIfFileExists(const std::string &filename);
+
+  private:
+    void WriteMessage(const mbilog::LogMessage &l, int threadID);
+    unsigned long WriteQueuedMessages();
+    void WriteQueuedMessagesOfStoppedWriter();
+    void RunWriterThread();
+    void StartWriterThread();
+    static void StopWriterThread();
   };
 }
 
@@ -0,0 +1,84 @@
+/*===================================================================
+
+The Medical Imaging Interaction Toolkit (MITK)
+
+Copyright (c) German Cancer Research Center,
+Division of Medical and Biological Informatics.
+All rights reserved.
+
+This software is distributed WITHOUT ANY WARRANTY; without
+even the implied warranty of MERCHANTABILITY or FITNESS FOR
+A PARTICULAR PURPOSE.
+
+See LICENSE.txt or http://www.mitk.org for details.
+
+===================================================================*/
+
+#ifndef mitkMemoryMappedFile_h
+#define mitkMemoryMappedFile_h
+
+#include <MitkCoreExports.h>
+#include <mitkCommon.h>
+
+#include <itkLightObject.h>
+
+#include <cstddef>
+#include <string>
+
+namespace mitk
+{
+  /**
+    \brief Private (copy-on-write) memory mapping of a whole file.
+
+    The pages of the file are loaded on first access and are shared with the page cache of
+    the operating system. Writing to the mapped memory creates private copies of the touched
+    pages, the file itself is never modified. The file must not be truncated or overwritten while it is
+    mapped, but it can be replaced by renaming another file to its name.
+
+    The mapping is released when the object is destroyed. Since it is reference counted, it
+    can be used to keep the memory of an image alive, see ImageDataItem::SetMemoryOwner().
+
+    \code
+    mitk::MemoryMappedFile::Pointer file = mitk::MemoryMappedFile::New();
+    file->Open("/path/to/volume.raw");
+    unsigned char *data = file->GetData();
+    \endcode
+  */
+  class MITKCORE_EXPORT MemoryMappedFile : public itk::LightObject
+  {
+  public:
+    mitkClassMacroItkParent(MemoryMappedFile, itk::LightObject);
+    itkFactorylessNewMacro(Self);
+
+    /**
+     * \brief Maps the given file into memory, a previous mapping is released.
+     * \throws mitk::Exception if the file cannot be opened or mapped.
+     */
+    void Open(const std::string &path);
+
+    /** \brief Releases the mapping. */
+    void Close();
+
+    bool IsOpen() const { return m_Data != nullptr; }
+    unsigned char *GetData() const { return m_Data; }
+    std::size_t GetSize() const { return m_Size; }
+
+  protected:
+    MemoryMappedFile();
+    ~MemoryMappedFile() override;
+
+  private:
+    MemoryMappedFile(const MemoryMappedFile &) = delete;
+    MemoryMappedFile &operator=(const MemoryMappedFile &) = delete;
+
+    unsigned char *m_Data;
+    std::size_t m_Size;
+
+#ifdef _WIN32
+    void *m_FileHandle;
+    void *m_MappingHandle;
+#endif
+  };
+}
+
+#endif
@@ -225,6 +225,14 @@ namespace mitk
     /** En-/Disable LOD abort mechanism. */
     itkBooleanMacro(LODAbortMechanismEnabled);
 
+    /** Frame time in milliseconds up to which renderers with LOD-enabled mappers keep rendering at the
+     * highest level of detail, instead of rendering at low resolution first. Decided per renderer, based on
+     * the measured duration of its last high resolution frame. 0 (default) disables it. */
+    itkSetMacro(LODFrameTimeBudget, double);
+
+    /** Frame time in milliseconds up to which renderers keep rendering at the highest level of detail. */
+    itkGetMacro(LODFrameTimeBudget, double);
+
     /** Force a sub-class to start a timer for a pending hires-rendering request */
     virtual void StartOrResetTimer(){};
 
@@ -328,6 +336,8 @@ namespace mitk
 
     bool m_LODAbortMechanismEnabled;
 
+    double m_LODFrameTimeBudget;
+
     BoolVector m_ShadingEnabled;
 
     bool m_ClippingPlaneEnabled;
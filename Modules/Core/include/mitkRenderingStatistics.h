@@ -0,0 +1,80 @@
+/*===================================================================
+
+The Medical Imaging Interaction Toolkit (MITK)
+
+Copyright (c) German Cancer Research Center,
+Division of Medical and Biological Informatics.
+All rights reserved.
+
+This software is distributed WITHOUT ANY WARRANTY; without
+even the implied warranty of MERCHANTABILITY or FITNESS FOR
+A PARTICULAR PURPOSE.
+
+See LICENSE.txt or http://www.mitk.org for details.
+
+===================================================================*/
+
+#ifndef mitkRenderingStatistics_h
+#define mitkRenderingStatistics_h
+
+#include <MitkCoreExports.h>
+
+#include <string>
+
+namespace mitk
+{
+  /**
+   * \brief Rolling statistics of the durations of a recurring task, e.g. rendering a frame.
+   *
+   * Mean and maximum are computed from the last WindowSize durations, so they follow
+   * changes of the rendered scene quickly.
+   *
+   * \ingroup Renderer
+   */
+  class MITKCORE_EXPORT RollingTimeStatistics
+  {
+  public:
+    /** Number of durations that mean and maximum are computed from. */
+    static const unsigned int WindowSize = 32;
+
+    RollingTimeStatistics();
+
+    void AddSample(double milliseconds);
+    void Clear();
+
+    /** Number of durations added since construction or the last Clear(). */
+    unsigned long GetNumberOfSamples() const;
+
+    /** Last duration in milliseconds, 0 if there is none. */
+    double GetLast() const;
+
+    /** Mean of the last WindowSize durations in milliseconds, 0 if there is none. */
+    double GetMean() const;
+
+    /** Maximum of the last WindowSize durations in milliseconds, 0 if there is none. */
+    double GetMaximum() const;
+
+  private:
+    double m_Samples[WindowSize];
+    unsigned long m_NumberOfSamples;
+  };
+
+  /**
+   * \brief Time spent by a mapper of a BaseRenderer.
+   *
+   * \sa BaseRenderer::GetMapperRenderingStatistics
+   * \ingroup Renderer
+   */
+  struct MapperRenderingStatistics
+  {
+    /** Name of the DataNode of the mapper. */
+    std::string NodeName;
+    std::string MapperClassName;
+    /** Durations of Mapper::Update(), i.e. of generating the data for the renderer. */
+    RollingTimeStatistics UpdateTime;
+    /** Durations of all render passes of the mapper within one frame. */
+    RollingTimeStatistics RenderTime;
+  };
+}
+
+#endif
@@ -20,7 +20,9 @@ See LICENSE.txt or http://www.mitk.org for details.
 #include "MitkCoreExports.h"
 #include "mitkStateMachineTransition.h"
 #include <itkLightObject.h>
+#include <map>
 #include <string>
+#include <utility>
 
 namespace mitk
 {
@@ -52,8 +54,11 @@ namespace mitk
 
     /**
     * @brief Return Transitions that match given event description.
+    *
+    * Matching a transition requires creating an event of the given class, so the result is compiled once
+    * per event class and variant and looked up in a table afterwards.
     **/
-    TransitionVector GetTransitionList(const std::string &eventClass, const std::string &eventVariant);
+    const TransitionVector &GetTransitionList(const std::string &eventClass, const std::string &eventVariant);
 
     /**
     * @brief Returns the name.
@@ -93,6 +98,13 @@ namespace mitk
     * @brief map of transitions that lead from this state to the next state
     **/
     TransitionVector m_Transitions;
+
+    typedef std::map<std::pair<std::string, std::string>, TransitionVector> TransitionTableType;
+
+    /**
+    * @brief matching transitions per (event class, event variant), cleared when a transition is added
+    **/
+    TransitionTableType m_TransitionTable;
   };
 } // namespace mitk
 #endif /* SMSTATE_H_HEADER_INCLUDED_C19A8A5D */
@@ -45,6 +45,7 @@ namespace mitk
       m_MaxLOD(1),
       m_LODIncreaseBlocked(false),
       m_LODAbortMechanismEnabled(false),
+      m_LODFrameTimeBudget(0.0),
       m_ClippingPlaneEnabled(false),
       m_TimeNavigationController(SliceNavigationController::New()),
       m_DataStorage(nullptr),
@@ -542,8 +543,14 @@ namespace mitk
     auto renderWindow = dynamic_cast<vtkRenderWindow*>(caller);
 
     if (nullptr != renderWindow)
+    {
       renderingManager->m_RenderWindowList[renderWindow] = RENDERING_INPROGRESS;
 
+      auto renderer = BaseRenderer::GetInstance(renderWindow);
+      if (nullptr != renderer)
+        renderer->StartFrameTiming();
+    }
+
     renderingManager->m_UpdatePending = false;
   }
 
@@ -575,6 +582,8 @@ namespace mitk
 
       if (nullptr != renderer)
       {
+        renderer->StopFrameTiming();
+
         auto renderingManager = RenderingManager::GetInstance();
         renderingManager->m_RenderWindowList[renderer->GetRenderWindow()] = RENDERING_INACTIVE;
 
@@ -584,10 +593,12 @@ namespace mitk
           {
             renderingManager->StartOrResetTimer();
           }
-          else
+          else if (renderingManager->m_LODFrameTimeBudget <= 0.0 ||
+                   renderer->GetFrameTimeStatistics().GetLast() > renderingManager->m_LODFrameTimeBudget)
           {
+            // high resolution frames are too slow for interaction, render at low resolution first again
             renderingManager->m_NextLODMap[renderer] = 0;
-          }            
+          }
         }
       }
     }
@@ -804,6 +804,35 @@ bool mitk::Image::SetImportChannel(void *data, int n, ImportMemoryManagementType
   return true;
 }
 
+void mitk::Image::Graft(const itk::DataObject *data)
+{
+  const auto *image = dynamic_cast<const mitk::Image *>(data);
+  if (image == nullptr)
+  {
+    mitkThrow() << "Cannot graft " << (data != nullptr ? data->GetNameOfClass() : "nullptr") << " onto an image";
+  }
+  if (image == this)
+    return;
+  if (!image->IsInitialized())
+  {
+    mitkThrow() << "Cannot graft an image which is not initialized";
+  }
+
+  this->Initialize(image);
+
+  {
+    MutexHolder lock(m_ImageDataArraysLock);
+    MutexHolder imageLock(image->m_ImageDataArraysLock);
+
+    m_Channels = image->m_Channels;
+    m_Volumes = image->m_Volumes;
+    m_Slices = image->m_Slices;
+    m_CompleteData = image->m_CompleteData;
+  }
+
+  this->Modified();
+}
+
 void mitk::Image::Initialize()
 {
   ImageDataItemPointerArray::iterator it, end;
@@ -22,6 +22,7 @@ See LICENSE.txt or http://www.mitk.org for details.
 #include <mitkFileReaderRegistry.h>
 #include <mitkFileWriterRegistry.h>
 #include <mitkIMimeTypeProvider.h>
+#include <mitkLocaleSwitch.h>
 #include <mitkProgressBar.h>
 #include <mitkStandaloneDataStorage.h>
 #include <usGetModuleContext.h>
@@ -39,8 +40,14 @@ See LICENSE.txt or http://www.mitk.org for details.
 #include <vtkSmartPointer.h>
 #include <vtkTriangleFilter.h>
 
+#include <algorithm>
 #include <cerrno>
+#include <chrono>
 #include <cstdlib>
+#include <deque>
+#include <future>
+#include <memory>
+#include <thread>
 
 static std::string GetLastErrorStr()
 {
@@ -317,6 +324,38 @@ namespace mitk
 
     static BaseData::Pointer LoadBaseDataFromFile(const std::string &path, const ReaderOptionsFunctorBase* optionsCallback = nullptr);
 
+    struct ReadResult
+    {
+      DataStorage::SetOfObjects::Pointer Nodes;
+      std::vector<std::string> ReadFiles;
+      std::string ErrorMessage;
+      double Milliseconds;
+    };
+
+    struct PendingRead
+    {
+      LoadInfo *Info;
+      DataStorage::Pointer Storage;
+      std::future<ReadResult> Result;
+    };
+
+    /** Creates the load infos, detecting the mime-types of several files concurrently. */
+    static std::vector<LoadInfo> CreateLoadInfos(const std::vector<std::string> &paths);
+
+    /** Reads the file into ds, or into new nodes if ds is nullptr. */
+    static ReadResult ReadFile(IFileReader *reader, const std::string &path, DataStorage *ds);
+
+    /**
+     * Moves the result to the load info and to the node result. Nodes which have been read into a
+     * private DataStorage (readStorage differs from ds) are added to ds with their sources.
+     */
+    static std::string AddReadResult(LoadInfo &loadInfo,
+                                     ReadResult &result,
+                                     DataStorage *readStorage,
+                                     DataStorage *ds,
+                                     DataStorage::SetOfObjects *nodeResult,
+                                     std::vector<std::string> &readFiles);
+
     static void SetDefaultDataNodeProperties(mitk::DataNode *node, const std::string &filePath = std::string());
   };
 
@@ -536,11 +575,7 @@ namespace mitk
   DataStorage::SetOfObjects::Pointer IOUtil::Load(const std::vector<std::string> &paths, DataStorage &storage, const ReaderOptionsFunctorBase *optionsCallback)
   {
     DataStorage::SetOfObjects::Pointer nodeResult = DataStorage::SetOfObjects::New();
-    std::vector<LoadInfo> loadInfos;
-    for (auto loadInfo : paths)
-    {
-      loadInfos.push_back(loadInfo);
-    }
+    std::vector<LoadInfo> loadInfos = Impl::CreateLoadInfos(paths);
     std::string errMsg = Load(loadInfos, nodeResult, &storage, optionsCallback);
     if (!errMsg.empty())
     {
@@ -552,11 +587,7 @@ namespace mitk
   std::vector<BaseData::Pointer> IOUtil::Load(const std::vector<std::string> &paths, const ReaderOptionsFunctorBase *optionsCallback)
   {
     std::vector<BaseData::Pointer> result;
-    std::vector<LoadInfo> loadInfos;
-    for (auto loadInfo : paths)
-    {
-      loadInfos.push_back(loadInfo);
-    }
+    std::vector<LoadInfo> loadInfos = Impl::CreateLoadInfos(paths);
     std::string errMsg = Load(loadInfos, nullptr, nullptr, optionsCallback);
     if (!errMsg.empty())
     {
@@ -586,9 +617,29 @@ namespace mitk
 
     std::string errMsg;
 
-    std::map<std::string, FileReaderSelector::Item> usedReaderItems;
+    // The options are copied when a reader is selected, because the reader itself may be reading concurrently
+    // when its options are re-used for the next file.
+    std::map<std::string, std::pair<FileReaderSelector::Item, IFileReader::Options>> usedReaderItems;
+
+    // Files of thread-safe readers are read concurrently, but their results are added
+    // in the order of loadInfos. Reading starts as soon as a reader has been selected.
+    std::deque<Impl::PendingRead> pendingReads;
+    const bool readConcurrently = loadInfos.size() > 1;
+    const std::size_t maxPendingReads = std::max(1u, std::thread::hardware_concurrency());
+
+    // the locale is switched once for all readers, because switching it in concurrent readers would interfere
+    std::unique_ptr<LocaleSwitch> localeSwitch(readConcurrently ? new LocaleSwitch("C") : nullptr);
 
     std::vector< std::string > read_files;
+    auto finishPendingRead = [&]() {
+      Impl::PendingRead &pendingRead = pendingReads.front();
+      Impl::ReadResult result = pendingRead.Result.get();
+      errMsg += Impl::AddReadResult(*pendingRead.Info, result, pendingRead.Storage, ds, nodeResult, read_files);
+      pendingReads.pop_front();
+      mitk::ProgressBar::GetInstance()->Progress(2);
+      --filesToRead;
+    };
+
     for (auto &loadInfo : loadInfos)
     {
       if(std::find(read_files.begin(), read_files.end(), loadInfo.m_Path) != read_files.end())
@@ -619,8 +670,7 @@ namespace mitk
            mimeTypeIter != mimeTypeIterEnd;
            ++mimeTypeIter)
       {
-        std::map<std::string, FileReaderSelector::Item>::const_iterator oldSelectedItemIter =
-          usedReaderItems.find(mimeTypeIter->GetName());
+        auto oldSelectedItemIter = usedReaderItems.find(mimeTypeIter->GetName());
         if (oldSelectedItemIter != usedReaderItems.end())
         {
           // we found an already used item for a mime-type which is contained
@@ -632,15 +682,14 @@ namespace mitk
                ++currReaderItem)
           {
             if (currReaderItem->GetMimeType().GetName() == mimeTypeIter->GetName() &&
-                currReaderItem->GetServiceId() == oldSelectedItemIter->second.GetServiceId() &&
-                currReaderItem->GetConfidenceLevel() >= oldSelectedItemIter->second.GetConfidenceLevel())
+                currReaderItem->GetServiceId() == oldSelectedItemIter->second.first.GetServiceId() &&
+                currReaderItem->GetConfidenceLevel() >= oldSelectedItemIter->second.first.GetConfidenceLevel())
             {
               // okay, we used the same reader already, re-use its options
               selectedMimeType = mimeTypeIter->GetName();
               callOptionsCallback = false;
-              loadInfo.m_ReaderSelector.Select(oldSelectedItemIter->second.GetServiceId());
-              loadInfo.m_ReaderSelector.GetSelected().GetReader()->SetOptions(
-                oldSelectedItemIter->second.GetReader()->GetOptions());
+              loadInfo.m_ReaderSelector.Select(oldSelectedItemIter->second.first.GetServiceId());
+              loadInfo.m_ReaderSelector.GetSelected().GetReader()->SetOptions(oldSelectedItemIter->second.second);
               break;
             }
           }
@@ -656,7 +705,8 @@ namespace mitk
         {
           usedReaderItems.erase(selectedMimeType);
           FileReaderSelector::Item selectedItem = loadInfo.m_ReaderSelector.GetSelected();
-          usedReaderItems.insert(std::make_pair(selectedItem.GetMimeType().GetName(), selectedItem));
+          usedReaderItems.insert(std::make_pair(selectedItem.GetMimeType().GetName(),
+                                                std::make_pair(selectedItem, selectedItem.GetReader()->GetOptions())));
         }
       }
 
@@ -673,69 +723,46 @@ namespace mitk
         break;
       }
 
-      // Do the actual reading
-      try
+      if (readConcurrently && reader->IsThreadSafe())
       {
-        DataStorage::SetOfObjects::Pointer nodes;
-        if (ds != nullptr)
+        if (pendingReads.size() >= maxPendingReads)
         {
-          nodes = reader->Read(*ds);
-
-          std::vector< std::string > new_files =  reader->GetReadFiles();
-          read_files.insert( read_files.end(), new_files.begin(), new_files.end() );
-        }
-        else
-        {
-          nodes = DataStorage::SetOfObjects::New();
-          std::vector<mitk::BaseData::Pointer> baseData = reader->Read();
-          for (auto iter = baseData.begin(); iter != baseData.end(); ++iter)
-          {
-            if (iter->IsNotNull())
-            {
-              mitk::DataNode::Pointer node = mitk::DataNode::New();
-              node->SetData(*iter);
-              nodes->InsertElement(nodes->Size(), node);
-            }
-          }
-
-          std::vector< std::string > new_files =  reader->GetReadFiles();
-          read_files.insert( read_files.end(), new_files.begin(), new_files.end() );
+          finishPendingRead();
         }
 
-        for (DataStorage::SetOfObjects::ConstIterator nodeIter = nodes->Begin(), nodeIterEnd = nodes->End();
-             nodeIter != nodeIterEnd;
-             ++nodeIter)
+        DataStorage::Pointer readStorage;
+        if (ds != nullptr)
         {
-          const mitk::DataNode::Pointer &node = nodeIter->Value();
-          mitk::BaseData::Pointer data = node->GetData();
-          if (data.IsNull())
-          {
-            continue;
-          }
-
-          mitk::StringProperty::Pointer pathProp = mitk::StringProperty::New(loadInfo.m_Path);
-          data->SetProperty("path", pathProp);
-
-          loadInfo.m_Output.push_back(data);
-          if (nodeResult)
-          {
-            nodeResult->push_back(nodeIter->Value());
-          }
+          readStorage = StandaloneDataStorage::New().GetPointer();
         }
 
-        if (loadInfo.m_Output.empty() || (nodeResult && nodeResult->Size() == 0))
-        {
-          errMsg += "Unknown read error occurred reading " + loadInfo.m_Path;
-        }
+        Impl::PendingRead pendingRead;
+        pendingRead.Info = &loadInfo;
+        pendingRead.Storage = readStorage;
+        pendingRead.Result =
+          std::async(std::launch::async, &Impl::ReadFile, reader, loadInfo.m_Path, readStorage.GetPointer());
+        pendingReads.push_back(std::move(pendingRead));
+        continue;
       }
-      catch (const std::exception &e)
+
+      // keep the order, before reading the next file serially
+      while (!pendingReads.empty())
       {
-        errMsg += "Exception occured when reading file " + loadInfo.m_Path + ":\n" + e.what() + "\n\n";
+        finishPendingRead();
       }
+
+      // Do the actual reading
+      Impl::ReadResult result = Impl::ReadFile(reader, loadInfo.m_Path, ds);
+      errMsg += Impl::AddReadResult(loadInfo, result, ds, ds, nodeResult, read_files);
       mitk::ProgressBar::GetInstance()->Progress(2);
       --filesToRead;
     }
 
+    while (!pendingReads.empty())
+    {
+      finishPendingRead();
+    }
+
     if (!errMsg.empty())
     {
       MITK_ERROR << errMsg;
@@ -1002,6 +1029,142 @@ namespace mitk
     }
   }
 
+  std::vector<IOUtil::LoadInfo> IOUtil::Impl::CreateLoadInfos(const std::vector<std::string> &paths)
+  {
+    std::vector<LoadInfo> loadInfos;
+    if (paths.size() < 2)
+    {
+      for (const auto &path : paths)
+      {
+        loadInfos.push_back(LoadInfo(path));
+      }
+      return loadInfos;
+    }
+
+    // the mime-type detection may need to open the files, so split the paths
+    // into one block for each thread and create the load infos of each block concurrently
+    const std::size_t numberOfBlocks = std::min<std::size_t>(paths.size(), std::max(1u, std::thread::hardware_concurrency()));
+    const std::size_t blockSize = (paths.size() + numberOfBlocks - 1) / numberOfBlocks;
+
+    std::vector<std::future<std::vector<LoadInfo>>> blocks;
+    for (std::size_t begin = 0; begin < paths.size(); begin += blockSize)
+    {
+      const std::size_t end = std::min(begin + blockSize, paths.size());
+      blocks.push_back(std::async(std::launch::async, [&paths, begin, end]() {
+        std::vector<LoadInfo> block;
+        for (std::size_t i = begin; i < end; ++i)
+        {
+          block.push_back(LoadInfo(paths[i]));
+        }
+        return block;
+      }));
+    }
+
+    for (auto &block : blocks)
+    {
+      std::vector<LoadInfo> blockLoadInfos = block.get();
+      loadInfos.insert(loadInfos.end(), blockLoadInfos.begin(), blockLoadInfos.end());
+    }
+
+    return loadInfos;
+  }
+
+  IOUtil::Impl::ReadResult IOUtil::Impl::ReadFile(IFileReader *reader, const std::string &path, DataStorage *ds)
+  {
+    ReadResult result;
+    auto start = std::chrono::steady_clock::now();
+
+    try
+    {
+      if (ds != nullptr)
+      {
+        result.Nodes = reader->Read(*ds);
+      }
+      else
+      {
+        result.Nodes = DataStorage::SetOfObjects::New();
+        std::vector<mitk::BaseData::Pointer> baseData = reader->Read();
+        for (auto iter = baseData.begin(); iter != baseData.end(); ++iter)
+        {
+          if (iter->IsNotNull())
+          {
+            mitk::DataNode::Pointer node = mitk::DataNode::New();
+            node->SetData(*iter);
+            result.Nodes->InsertElement(result.Nodes->Size(), node);
+          }
+        }
+      }
+
+      result.ReadFiles = reader->GetReadFiles();
+    }
+    catch (const std::exception &e)
+    {
+      result.ErrorMessage = "Exception occured when reading file " + path + ":\n" + e.what() + "\n\n";
+    }
+
+    result.Milliseconds = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    return result;
+  }
+
+  std::string IOUtil::Impl::AddReadResult(LoadInfo &loadInfo,
+                                          ReadResult &result,
+                                          DataStorage *readStorage,
+                                          DataStorage *ds,
+                                          DataStorage::SetOfObjects *nodeResult,
+                                          std::vector<std::string> &readFiles)
+  {
+    loadInfo.m_ReadTime = result.Milliseconds;
+    MITK_DEBUG << "Read " << loadInfo.m_Path << " in " << result.Milliseconds << " ms";
+
+    if (!result.ErrorMessage.empty())
+    {
+      return result.ErrorMessage;
+    }
+
+    // a concurrently read file might have been read already by a reader of a preceding file
+    if (std::find(readFiles.begin(), readFiles.end(), loadInfo.m_Path) != readFiles.end())
+    {
+      return std::string();
+    }
+
+    readFiles.insert(readFiles.end(), result.ReadFiles.begin(), result.ReadFiles.end());
+
+    for (DataStorage::SetOfObjects::ConstIterator nodeIter = result.Nodes->Begin(), nodeIterEnd = result.Nodes->End();
+         nodeIter != nodeIterEnd;
+         ++nodeIter)
+    {
+      const mitk::DataNode::Pointer &node = nodeIter->Value();
+
+      if (readStorage != ds)
+      {
+        // the nodes are in order, so the sources of a node have already been added
+        ds->Add(node, readStorage->GetSources(node, nullptr, true));
+      }
+
+      mitk::BaseData::Pointer data = node->GetData();
+      if (data.IsNull())
+      {
+        continue;
+      }
+
+      mitk::StringProperty::Pointer pathProp = mitk::StringProperty::New(loadInfo.m_Path);
+      data->SetProperty("path", pathProp);
+
+      loadInfo.m_Output.push_back(data);
+      if (nodeResult)
+      {
+        nodeResult->push_back(node);
+      }
+    }
+
+    if (loadInfo.m_Output.empty() || (nodeResult && nodeResult->Size() == 0))
+    {
+      return "Unknown read error occurred reading " + loadInfo.m_Path;
+    }
+
+    return std::string();
+  }
+
   IOUtil::SaveInfo::SaveInfo(const BaseData *baseData, const MimeType &mimeType, const std::string &path)
     : m_BaseData(baseData),
       m_WriterSelector(baseData, mimeType.GetName(), path),
@@ -1027,5 +1190,8 @@ namespace mitk
     return r < 0;
   }
 
-  IOUtil::LoadInfo::LoadInfo(const std::string &path) : m_Path(path), m_ReaderSelector(path), m_Cancel(false) {}
+  IOUtil::LoadInfo::LoadInfo(const std::string &path)
+    : m_Path(path), m_ReaderSelector(path), m_Cancel(false), m_ReadTime(0.0)
+  {
+  }
 }
@@ -15,23 +15,40 @@ See LICENSE.txt or http://www.mitk.org for details.
 ===================================================================*/
 
 #include "mitkItkImageIO.h"
+#include "mitkParallelGzip.h"
 
 #include <mitkArbitraryTimeGeometry.h>
 #include <mitkCoreServices.h>
 #include <mitkCustomMimeType.h>
 #include <mitkIOMimeTypes.h>
+#include <mitkIOUtil.h>
 #include <mitkIPropertyPersistence.h>
 #include <mitkImage.h>
 #include <mitkImageReadAccessor.h>
 #include <mitkLocaleSwitch.h>
+#include <mitkMemoryMappedFile.h>
 
+#include <itkByteSwapper.h>
 #include <itkImage.h>
 #include <itkImageFileReader.h>
 #include <itkImageIOFactory.h>
 #include <itkImageIORegion.h>
 #include <itkMetaDataObject.h>
+#include <itksys/SystemTools.hxx>
 
 #include <algorithm>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <cstdio>
+#include <fstream>
+#include <iomanip>
+#include <vector>
+
+#ifndef _WIN32
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
 
 namespace mitk
 {
@@ -40,6 +57,47 @@ namespace mitk
   const char *const PROPERTY_KEY_TIMEGEOMETRY_TYPE = "org_mitk_timegeometry_type";
   const char *const PROPERTY_KEY_TIMEGEOMETRY_TIMEPOINTS = "org_mitk_timegeometry_timepoints";
 
+  const char *const OPTION_COMPRESSION_LEVEL = "Compression level";
+
+  /**Helper function that checks if the pixel data of files written by the given image IO is compressed by
+   * WriteParallelCompressed() instead of the image IO itself.*/
+  bool SupportsParallelCompression(const std::string &imageIOName, const std::string &path = std::string())
+  {
+    const std::string extension = itksys::SystemTools::LowerCase(itksys::SystemTools::GetFilenameLastExtension(path));
+    if (imageIOName == "NrrdImageIO")
+      return path.empty() || extension == ".nrrd";
+    if (imageIOName == "MetaImageIO")
+      return path.empty() || extension == ".mha";
+    return false;
+  }
+
+  /**Helper function that checks if the given image IO writes the pixel data into the image file itself, which
+   * then may be memory mapped by ItkImageIO::Read().*/
+  bool IsMappableFile(const std::string &imageIOName, const std::string &path)
+  {
+    const std::string extension = itksys::SystemTools::LowerCase(itksys::SystemTools::GetFilenameLastExtension(path));
+    return (imageIOName == "NrrdImageIO" && extension == ".nrrd") ||
+           (imageIOName == "MetaImageIO" && extension == ".mha") ||
+           (imageIOName == "NiftiImageIO" && extension == ".nii");
+  }
+
+  /**Helper function that gives a file, which is going to replace an existing one, the owner and the permissions
+   * of that file. Changing the owner needs privileges, so without them the writing user stays the owner.*/
+  void CopyOwnerAndPermissions(const std::string &existingPath, const std::string &path)
+  {
+#ifndef _WIN32
+    struct stat status;
+    if (stat(existingPath.c_str(), &status) == 0 && chown(path.c_str(), status.st_uid, status.st_gid) != 0)
+    {
+      MITK_DEBUG << "Could not transfer the owner of " << existingPath << " to " << path;
+    }
+#endif
+
+    mode_t permissions;
+    if (itksys::SystemTools::GetPermissions(existingPath, permissions))
+      itksys::SystemTools::SetPermissions(path, permissions);
+  }
+
   ItkImageIO::ItkImageIO(const ItkImageIO &other)
     : AbstractFileIO(other), m_ImageIO(dynamic_cast<itk::ImageIOBase *>(other.m_ImageIO->Clone().GetPointer()))
   {
@@ -195,6 +253,13 @@ namespace mitk
     this->SetReaderDescription(description);
     this->SetWriterDescription(description);
 
+    if (SupportsParallelCompression(imageIO->GetNameOfClass()))
+    {
+      Options defaultOptions;
+      defaultOptions[OPTION_COMPRESSION_LEVEL] = 6;
+      this->SetDefaultWriterOptions(defaultOptions);
+    }
+
     this->RegisterService();
   }
 
@@ -241,6 +306,258 @@ namespace mitk
     return result;
   };
 
+  /**Helper function that removes leading and trailing white space of a header entry.*/
+  std::string TrimHeaderEntry(const std::string &entry)
+  {
+    const std::size_t begin = entry.find_first_not_of(" \t\r");
+    if (begin == std::string::npos)
+      return std::string();
+
+    const std::size_t end = entry.find_last_not_of(" \t\r");
+    return entry.substr(begin, end - begin + 1);
+  }
+
+  /**Helper function that resolves the path of a detached data file relative to its header.*/
+  std::string GetDataFilePath(const std::string &headerPath, const std::string &dataFile)
+  {
+    if (itksys::SystemTools::FileIsFullPath(dataFile.c_str()))
+      return dataFile;
+
+    return itksys::SystemTools::CollapseFullPath(dataFile, itksys::SystemTools::GetFilenamePath(headerPath));
+  }
+
+  /**Helper function that locates the pixel data of a raw encoded NRRD file, either attached behind
+   * the empty line ending the header or in a single detached data file.*/
+  bool GetNrrdRawDataLocation(const std::string &path,
+                              std::size_t componentSize,
+                              std::string &dataFile,
+                              std::size_t &dataOffset)
+  {
+    std::ifstream stream(path.c_str(), std::ios::binary);
+    std::string line;
+    if (!std::getline(stream, line) || line.compare(0, 4, "NRRD") != 0)
+      return false;
+
+    const std::string hostEndian = itk::ByteSwapper<int>::SystemIsBigEndian() ? "big" : "little";
+    bool isRaw = false;
+    bool isHostEndian = componentSize == 1;
+    dataFile.clear();
+
+    while (std::getline(stream, line))
+    {
+      line = TrimHeaderEntry(line);
+      if (line.empty())
+        break;
+
+      // skip comments and key/value pairs
+      if (line[0] == '#' || line.find(":=") != std::string::npos)
+        continue;
+
+      const std::size_t separator = line.find(':');
+      if (separator == std::string::npos)
+        continue;
+
+      std::string field = line.substr(0, separator);
+      field.erase(std::remove(field.begin(), field.end(), ' '), field.end());
+      const std::string value = TrimHeaderEntry(line.substr(separator + 1));
+
+      if (field == "encoding")
+      {
+        isRaw = value == "raw";
+      }
+      else if (field == "endian")
+      {
+        isHostEndian = isHostEndian || value == hostEndian;
+      }
+      else if (field == "datafile")
+      {
+        // lists of data files and file name patterns are not supported
+        if (value == "LIST" || value.find_first_of(" \t") != std::string::npos)
+          return false;
+
+        dataFile = GetDataFilePath(path, value);
+      }
+      else if ((field == "lineskip" || field == "byteskip") && value != "0")
+      {
+        return false;
+      }
+    }
+
+    if (!isRaw || !isHostEndian)
+      return false;
+
+    if (dataFile.empty())
+    {
+      const std::streamoff offset = stream ? static_cast<std::streamoff>(stream.tellg()) : -1;
+      if (offset < 0)
+        return false;
+
+      dataFile = path;
+      dataOffset = static_cast<std::size_t>(offset);
+    }
+    else
+    {
+      dataOffset = 0;
+    }
+
+    return true;
+  }
+
+  /**Helper function that locates the pixel data of an uncompressed binary MetaImage, either attached
+   * behind the ElementDataFile entry (which ends the header) or in a single detached data file.*/
+  bool GetMetaImageRawDataLocation(const std::string &path,
+                                   std::size_t componentSize,
+                                   std::string &dataFile,
+                                   std::size_t &dataOffset)
+  {
+    std::ifstream stream(path.c_str(), std::ios::binary);
+    std::string line;
+    bool isHostEndian = true;
+    std::string headerSize = "0";
+
+    while (std::getline(stream, line))
+    {
+      const std::size_t separator = line.find('=');
+      if (separator == std::string::npos)
+        continue;
+
+      const std::string key = TrimHeaderEntry(line.substr(0, separator));
+      const std::string value = itksys::SystemTools::LowerCase(TrimHeaderEntry(line.substr(separator + 1)));
+
+      if ((key == "CompressedData" && value != "false") || (key == "BinaryData" && value != "true"))
+      {
+        return false;
+      }
+      else if (key == "BinaryDataByteOrderMSB" || key == "ElementByteOrderMSB")
+      {
+        isHostEndian = componentSize == 1 || (value == "true") == itk::ByteSwapper<int>::SystemIsBigEndian();
+      }
+      else if (key == "HeaderSize")
+      {
+        headerSize = value;
+      }
+      else if (key == "ElementDataFile")
+      {
+        if (!isHostEndian || headerSize.find('-') != std::string::npos)
+          return false;
+
+        if (value == "local")
+        {
+          const std::streamoff offset = stream ? static_cast<std::streamoff>(stream.tellg()) : -1;
+          if (offset < 0 || headerSize != "0")
+            return false;
+
+          dataFile = path;
+          dataOffset = static_cast<std::size_t>(offset);
+          return true;
+        }
+
+        // lists of data files and file name patterns are not supported
+        if (value == "list" || value.find_first_of(" \t%") != std::string::npos)
+          return false;
+
+        dataFile = GetDataFilePath(path, TrimHeaderEntry(line.substr(separator + 1)));
+        dataOffset = static_cast<std::size_t>(std::strtoull(headerSize.c_str(), nullptr, 10));
+        return true;
+      }
+    }
+
+    return false;
+  }
+
+  /**Helper function that locates the pixel data of an uncompressed single file NIfTI-1 image.*/
+  bool GetNiftiRawDataLocation(const std::string &path, std::string &dataFile, std::size_t &dataOffset)
+  {
+    if (itksys::SystemTools::LowerCase(itksys::SystemTools::GetFilenameLastExtension(path)) != ".nii")
+      return false;
+
+    std::ifstream stream(path.c_str(), std::ios::binary);
+    char header[348];
+    if (!stream.read(header, sizeof(header)))
+      return false;
+
+    std::int32_t headerSize;
+    float voxelOffset, slope, intercept;
+    std::memcpy(&headerSize, header, sizeof(headerSize));
+    std::memcpy(&voxelOffset, header + 108, sizeof(voxelOffset));
+    std::memcpy(&slope, header + 112, sizeof(slope));
+    std::memcpy(&intercept, header + 116, sizeof(intercept));
+
+    // a header size of 348 in host byte order rules out swapped files as well as NIfTI-2
+    if (headerSize != 348 || !(voxelOffset >= 348))
+      return false;
+
+    // scaled intensities are converted while reading
+    if (!(slope == 0 || (slope == 1 && intercept == 0)))
+      return false;
+
+    dataFile = path;
+    dataOffset = static_cast<std::size_t>(voxelOffset);
+    return true;
+  }
+
+  /**Helper function that determines where the pixel data of an image is stored if it can be used
+   * directly, i.e. uncompressed scalar pixels in host byte order and suitably aligned. Returns false
+   * for all other images, which have to be read by the image IO.*/
+  bool GetRawDataLocation(const std::string &path,
+                          itk::ImageIOBase *imageIO,
+                          std::string &dataFile,
+                          std::size_t &dataOffset)
+  {
+    // ITK rearranges multi component pixels of some formats while reading
+    if (imageIO->GetNumberOfComponents() != 1)
+      return false;
+
+    const std::size_t componentSize = imageIO->GetComponentSize();
+    const std::string imageIOName = imageIO->GetNameOfClass();
+    bool found = false;
+
+    if (imageIOName == "NrrdImageIO")
+    {
+      found = GetNrrdRawDataLocation(path, componentSize, dataFile, dataOffset);
+    }
+    else if (imageIOName == "MetaImageIO")
+    {
+      found = GetMetaImageRawDataLocation(path, componentSize, dataFile, dataOffset);
+    }
+    else if (imageIOName == "NiftiImageIO")
+    {
+      found = GetNiftiRawDataLocation(path, dataFile, dataOffset);
+    }
+
+    return found && componentSize > 0 && dataOffset % componentSize == 0;
+  }
+
+  /**Helper function that maps the pixel data of an image into memory. Returns nullptr if the data
+   * cannot be mapped and has to be read into a buffer instead.*/
+  MemoryMappedFile::Pointer MapRawData(const std::string &path, itk::ImageIOBase *imageIO, std::size_t &dataOffset)
+  {
+    std::string dataFile;
+    if (!GetRawDataLocation(path, imageIO, dataFile, dataOffset))
+      return nullptr;
+
+    // Only pixel data in the image file itself is mapped, because ItkImageIO::Write() replaces such files
+    // instead of overwriting them. Separate data files of detached headers are overwritten in place by ITK.
+    if (!itksys::SystemTools::SameFile(dataFile, path))
+      return nullptr;
+
+    MemoryMappedFile::Pointer mappedFile = MemoryMappedFile::New();
+    try
+    {
+      mappedFile->Open(dataFile);
+    }
+    catch (const mitk::Exception &e)
+    {
+      MITK_WARN << e.GetDescription() << ". Falling back to reading into memory.";
+      return nullptr;
+    }
+
+    if (mappedFile->GetSize() < dataOffset || mappedFile->GetSize() - dataOffset < imageIO->GetImageSizeInBytes())
+      return nullptr;
+
+    return mappedFile;
+  }
+
   std::vector<BaseData::Pointer> ItkImageIO::Read()
   {
     std::vector<BaseData::Pointer> result;
@@ -316,11 +633,30 @@ namespace mitk
 
     MITK_INFO << "ioRegion: " << ioRegion << std::endl;
     m_ImageIO->SetIORegion(ioRegion);
-    void *buffer = new unsigned char[m_ImageIO->GetImageSizeInBytes()];
-    m_ImageIO->Read(buffer);
+
+    // Uncompressed data is mapped into memory instead of being copied into a new buffer. The mapping
+    // is private, i.e. modifications of the image are never written back to the file.
+    std::size_t dataOffset = 0;
+    MemoryMappedFile::Pointer mappedFile;
+    if (ndim == m_ImageIO->GetNumberOfDimensions())
+    {
+      mappedFile = MapRawData(path, m_ImageIO, dataOffset);
+    }
 
     image->Initialize(MakePixelType(m_ImageIO), ndim, dimensions);
-    image->SetImportChannel(buffer, 0, Image::ManageMemory);
+
+    if (mappedFile.IsNotNull())
+    {
+      MITK_DEBUG << "memory mapping pixel data at offset " << dataOffset;
+      image->SetImportChannel(mappedFile->GetData() + dataOffset, 0, Image::ReferenceMemory);
+      image->GetChannelData(0)->SetMemoryOwner(mappedFile);
+    }
+    else
+    {
+      void *buffer = new unsigned char[m_ImageIO->GetImageSizeInBytes()];
+      m_ImageIO->Read(buffer);
+      image->SetImportChannel(buffer, 0, Image::ManageMemory);
+    }
 
     const itk::MetaDataDictionary &dictionary = m_ImageIO->GetMetaDataDictionary();
 
@@ -410,7 +746,6 @@ namespace mitk
 
     image->SetTimeGeometry(timeGeometry);
 
-    buffer = nullptr;
     MITK_INFO << "number of image components: " << image->GetPixelType().GetNumberOfComponents() << std::endl;
 
     for (auto iter = dictionary.Begin(), iterEnd = dictionary.End(); iter != iterEnd;
@@ -497,6 +832,126 @@ namespace mitk
     return m_ImageIO->CanReadFile(GetLocalFileName().c_str()) ? IFileReader::Supported : IFileReader::Unsupported;
   }
 
+  /**Helper function that writes a NRRD or MetaImage file with gzip compressed pixel data, which is compressed by
+   * several threads. The image IO writes the header of an image with a single pixel and the same meta data into a
+   * temporary file. Afterwards the header is adapted to the image size and the compressed encoding and the pixel
+   * data is compressed directly from the image buffer. Returns false if the header could not be adapted.*/
+  bool WriteParallelCompressed(itk::ImageIOBase *imageIO, const std::string &path, const void *data, int level)
+  {
+    const std::size_t dataSize = imageIO->GetImageSizeInBytes();
+    const std::size_t pixelSize = imageIO->GetPixelSize();
+    const unsigned int dimension = imageIO->GetNumberOfDimensions();
+    const itk::ImageIORegion ioRegion = imageIO->GetIORegion();
+
+    // NRRD lists the number of components as additional, first axis
+    const bool isMetaImage = std::string(imageIO->GetNameOfClass()) == "MetaImageIO";
+    std::string sizeEntry = isMetaImage ? "DimSize =" : "sizes:";
+    std::string onePixelSizeEntry = sizeEntry;
+    if (!isMetaImage && imageIO->GetNumberOfComponents() > 1)
+    {
+      sizeEntry += " " + std::to_string(imageIO->GetNumberOfComponents());
+      onePixelSizeEntry = sizeEntry;
+    }
+
+    std::vector<itk::SizeValueType> dimensions(dimension);
+    itk::ImageIORegion onePixelRegion(dimension);
+    for (unsigned int i = 0; i < dimension; ++i)
+    {
+      dimensions[i] = imageIO->GetDimensions(i);
+      sizeEntry += " " + std::to_string(dimensions[i]);
+      onePixelSizeEntry += " 1";
+      onePixelRegion.SetSize(i, 1);
+    }
+
+    const std::string temporaryPath =
+      IOUtil::CreateTemporaryFile("XXXXXX" + itksys::SystemTools::GetFilenameLastExtension(path));
+
+    auto restoreImageIO = [&]() {
+      std::remove(temporaryPath.c_str());
+      for (unsigned int i = 0; i < dimension; ++i)
+        imageIO->SetDimensions(i, dimensions[i]);
+      imageIO->SetIORegion(ioRegion);
+      imageIO->SetFileName(path);
+    };
+
+    std::string header;
+    try
+    {
+      for (unsigned int i = 0; i < dimension; ++i)
+        imageIO->SetDimensions(i, 1);
+      imageIO->SetIORegion(onePixelRegion);
+      imageIO->SetFileName(temporaryPath);
+      imageIO->UseCompressionOff();
+
+      const std::vector<char> pixel(pixelSize, 0);
+      imageIO->Write(pixel.data());
+
+      std::ifstream stream(temporaryPath.c_str(), std::ios::binary | std::ios::ate);
+      const std::streamoff fileSize = stream.tellg();
+      if (fileSize < static_cast<std::streamoff>(pixelSize))
+      {
+        mitkThrow() << "Unexpected size of uncompressed file " << temporaryPath;
+      }
+
+      header.resize(static_cast<std::size_t>(fileSize) - pixelSize);
+      stream.seekg(0);
+      stream.read(&header[0], header.size());
+    }
+    catch (...)
+    {
+      restoreImageIO();
+      throw;
+    }
+
+    restoreImageIO();
+
+    const std::size_t sizePosition = header.find("\n" + onePixelSizeEntry + "\n");
+    if (sizePosition == std::string::npos)
+      return false;
+
+    header.replace(sizePosition + 1, onePixelSizeEntry.size(), sizeEntry);
+
+    // MetaImage needs the size of the compressed data, which is written over a placeholder afterwards
+    std::string rawEntry = "encoding: raw\n";
+    std::string compressedEntry = "encoding: gzip\n";
+    const std::string compressedSizeEntry = "CompressedDataSize = ";
+    const std::size_t compressedSizeWidth = 20;
+    if (isMetaImage)
+    {
+      rawEntry = "CompressedData = False\n";
+      compressedEntry = "CompressedData = True\n" + compressedSizeEntry + std::string(compressedSizeWidth, '0') + "\n";
+    }
+
+    const std::size_t entryPosition = header.find(rawEntry);
+    if (entryPosition == std::string::npos)
+      return false;
+
+    header.replace(entryPosition, rawEntry.size(), compressedEntry);
+    const std::size_t compressedSizePosition = header.find(compressedSizeEntry);
+
+    std::ofstream stream(path.c_str(), std::ios::binary | std::ios::trunc);
+    if (!stream)
+    {
+      mitkThrow() << "Could not open " << path << " for writing";
+    }
+
+    stream.write(header.data(), header.size());
+    const std::size_t compressedSize = WriteParallelGzip(stream, data, dataSize, level);
+
+    if (compressedSizePosition != std::string::npos)
+    {
+      stream.seekp(compressedSizePosition + compressedSizeEntry.size());
+      stream << std::setw(compressedSizeWidth) << std::setfill('0') << compressedSize;
+    }
+
+    if (!stream)
+    {
+      mitkThrow() << "Could not write " << path;
+    }
+
+    return true;
+  }
+
   void ItkImageIO::Write()
   {
     const auto *image = dynamic_cast<const mitk::Image *>(this->GetInput());
@@ -534,6 +989,21 @@ namespace mitk
 
     MITK_INFO << "Writing image: " << path << std::endl;
 
+    // An existing file may be memory mapped by images read from it (see Read()). Overwriting it in place would
+    // change their pixel data or, since the file is truncated first, even invalidate it. So the image is written
+    // into a temporary file next to the existing one, which then replaces it. If the path is a symbolic link, the
+    // file it points to is replaced, so that the link is kept.
+    std::string writePath = path;
+    std::string targetPath = path;
+    if (itksys::SystemTools::FileExists(path, true) && IsMappableFile(m_ImageIO->GetNameOfClass(), path))
+    {
+      targetPath = itksys::SystemTools::GetRealPath(path);
+      writePath = IOUtil::CreateTemporaryFile(itksys::SystemTools::GetFilenameWithoutLastExtension(targetPath) +
+                                                "-XXXXXX" + itksys::SystemTools::GetFilenameLastExtension(targetPath),
+                                              itksys::SystemTools::GetFilenamePath(targetPath) + "/");
+      CopyOwnerAndPermissions(targetPath, writePath);
+    }
+
     try
     {
       // Implementation of writer using itkImageIO directly. This skips the use
@@ -604,10 +1074,16 @@ namespace mitk
       }
 
       // use compression if available
-      m_ImageIO->UseCompressionOn();
+      us::Any compressionLevelOption = this->GetWriterOption(OPTION_COMPRESSION_LEVEL);
+      const int compressionLevel = compressionLevelOption.Empty() ? -1 : us::any_cast<int>(compressionLevelOption);
+      if (!compressionLevelOption.Empty() && (compressionLevel < 0 || compressionLevel > 9))
+      {
+        mitkThrow() << "Invalid compression level " << compressionLevel << ", expected a value from 0 to 9";
+      }
+      m_ImageIO->SetUseCompression(compressionLevel != 0);
 
       m_ImageIO->SetIORegion(ioRegion);
-      m_ImageIO->SetFileName(path);
+      m_ImageIO->SetFileName(writePath);
 
       // Handle time geometry
       const auto *arbitraryTG = dynamic_cast<const ArbitraryTimeGeometry *>(image->GetTimeGeometry());
@@ -655,10 +1131,34 @@ namespace mitk
       }
       ImageReadAccessor imageAccess(image);
       LocaleSwitch localeSwitch2("C");
-      m_ImageIO->Write(imageAccess.GetData());
+
+      bool written = false;
+      if (compressionLevel > 0 && SupportsParallelCompression(m_ImageIO->GetNameOfClass(), path))
+      {
+        written = WriteParallelCompressed(m_ImageIO, writePath, imageAccess.GetData(), compressionLevel);
+        if (!written)
+        {
+          MITK_WARN << "Unexpected header written by " << m_ImageIO->GetNameOfClass()
+                    << ", falling back to single-threaded compression";
+          m_ImageIO->UseCompressionOn();
+        }
+      }
+
+      if (!written)
+      {
+        m_ImageIO->Write(imageAccess.GetData());
+      }
+
+      if (writePath != path && !itksys::SystemTools::RenameFile(writePath, targetPath))
+      {
+        mitkThrow() << "Could not replace " << targetPath << " by the written file " << writePath;
+      }
     }
     catch (const std::exception &e)
     {
+      if (writePath != path)
+        std::remove(writePath.c_str());
+
       mitkThrow() << e.what();
     }
   }
@@ -691,6 +1191,8 @@ namespace mitk
     return IFileWriter::Supported;
   }
 
+  bool ItkImageIO::IsThreadSafe() const { return true; }
+
   ItkImageIO *ItkImageIO::IOClone() const { return new ItkImageIO(*this); }
   void ItkImageIO::InitializeDefaultMetaDataKeys()
   {
@@ -21,9 +21,16 @@ See LICENSE.txt or http://www.mitk.org for details.
 #include <itkOutputWindow.h>
 #include <itkSimpleFastMutexLock.h>
 
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
 #include <cstdio>
+#include <cstdlib>
 #include <fstream>
 #include <iostream>
+#include <memory>
+#include <mutex>
+#include <thread>
 
 static itk::SimpleFastMutexLock logMutex;
 static mitk::LoggingBackend *mitkLogBackend = nullptr;
@@ -32,27 +39,194 @@ static std::string logFileName = "";
 static std::stringstream *outputWindow = nullptr;
 static bool logOutputWindow = false;
 
+namespace
+{
+  /** A message as it waits for the writer thread, the thread ID is only known where the message was emitted. */
+  struct QueuedMessage
+  {
+    int Level;
+    const char *FilePath;
+    int LineNumber;
+    const char *FunctionName;
+    const char *ModuleName;
+    std::string Category;
+    std::string Message;
+    int ThreadID;
+  };
+
+  /**
+   * Bounded queue for many producers and a single consumer (the array based queue of D. Vyukov).
+   * Producers claim a cell with a single compare-and-swap and publish it via the sequence number
+   * of the cell, so logging threads never wait for a lock. A full queue rejects messages.
+   */
+  class MessageQueue
+  {
+  public:
+    explicit MessageQueue(std::size_t capacity)
+      : m_Cells(new Cell[capacity]), m_Mask(capacity - 1), m_EnqueuePosition(0), m_DequeuePosition(0)
+    {
+      for (std::size_t i = 0; i < capacity; ++i)
+      {
+        m_Cells[i].Sequence.store(i, std::memory_order_relaxed);
+      }
+    }
+
+    bool TryPush(QueuedMessage &message)
+    {
+      Cell *cell;
+      std::size_t position = m_EnqueuePosition.load(std::memory_order_relaxed);
+      while (true)
+      {
+        cell = &m_Cells[position & m_Mask];
+        const std::size_t sequence = cell->Sequence.load(std::memory_order_acquire);
+        const auto difference = static_cast<std::ptrdiff_t>(sequence - position);
+        if (difference == 0)
+        {
+          if (m_EnqueuePosition.compare_exchange_weak(position, position + 1, std::memory_order_relaxed))
+            break;
+        }
+        else if (difference < 0)
+        {
+          return false;
+        }
+        else
+        {
+          position = m_EnqueuePosition.load(std::memory_order_relaxed);
+        }
+      }
+
+      cell->Message = std::move(message);
+      cell->Sequence.store(position + 1, std::memory_order_release);
+      return true;
+    }
+
+    /** Must only be called by the consumer thread. */
+    bool TryPop(QueuedMessage &message)
+    {
+      Cell &cell = m_Cells[m_DequeuePosition & m_Mask];
+      if (cell.Sequence.load(std::memory_order_acquire) != m_DequeuePosition + 1)
+        return false;
+
+      message = std::move(cell.Message);
+      cell.Sequence.store(m_DequeuePosition + m_Mask + 1, std::memory_order_release);
+      ++m_DequeuePosition;
+      return true;
+    }
+
+  private:
+    struct Cell
+    {
+      std::atomic<std::size_t> Sequence;
+      QueuedMessage Message;
+    };
+
+    std::unique_ptr<Cell[]> m_Cells;
+    const std::size_t m_Mask;
+    std::atomic<std::size_t> m_EnqueuePosition;
+    std::size_t m_DequeuePosition;
+  };
+
+  // must be a power of two
+  const std::size_t MessageQueueCapacity = 32768;
+
+  MessageQueue &GetMessageQueue()
+  {
+    static MessageQueue queue(MessageQueueCapacity);
+    return queue;
+  }
+
+  std::atomic<bool> asynchronous(true);
+  std::atomic<bool> writerRunning(false);
+  std::atomic<bool> writerWaiting(false);
+  std::atomic<unsigned long> queuedMessages(0);
+  std::atomic<unsigned long> droppedMessages(0);
+  std::atomic<unsigned long> totalDroppedMessages(0);
+
+  // guarded by writerMutex
+  std::mutex writerMutex;
+  std::condition_variable writerCondition;
+  std::condition_variable flushCondition;
+  std::thread *writerThread = nullptr;
+  std::thread::id writerThreadID;
+  mitk::LoggingBackend *writerBackend = nullptr;
+  unsigned long writtenMessages = 0;
+}
+
 void mitk::LoggingBackend::EnableAdditionalConsoleWindow(bool enable)
 {
   logOutputWindow = enable;
 }
 
+mitk::LoggingBackend::~LoggingBackend()
+{
+  if (writerBackend == this)
+  {
+    StopWriterThread();
+  }
+}
+
 void mitk::LoggingBackend::ProcessMessage(const mbilog::LogMessage &l)
 {
-  logMutex.Lock();
 #ifdef _WIN32
-  FormatSmart(l, (int)GetCurrentThreadId());
+  const int threadID = (int)GetCurrentThreadId();
 #else
-  FormatSmart(l);
+  const int threadID = 0;
 #endif
 
+  if (!asynchronous)
+  {
+    this->WriteMessage(l, threadID);
+    return;
+  }
+
+  this->StartWriterThread();
+
+  QueuedMessage message{
+    l.level, l.filePath, l.lineNumber, l.functionName, l.moduleName, l.category, l.message, threadID};
+
+  // an error is often followed by a crash, so it is written before returning
+  const bool isError = l.level == mbilog::Error || l.level == mbilog::Fatal;
+
+  if (GetMessageQueue().TryPush(message))
+  {
+    ++queuedMessages;
+    if (writerWaiting)
+      writerCondition.notify_one();
+
+    // The writer might have been stopped after StartWriterThread() and have written the remaining messages
+    // already. The fence pairs with the one in StopWriterThread(): either the writer's final pass sees this
+    // message or this thread sees the stopped writer.
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (!writerRunning)
+    {
+      this->WriteQueuedMessagesOfStoppedWriter();
+    }
+    else if (isError)
+    {
+      Flush();
+    }
+  }
+  else if (isError)
+  {
+    // errors are never dropped, they are written after the queued messages
+    Flush();
+    this->WriteMessage(l, threadID);
+  }
+  else
+  {
+    ++droppedMessages;
+    ++totalDroppedMessages;
+  }
+}
+
+void mitk::LoggingBackend::WriteMessage(const mbilog::LogMessage &l, int threadID)
+{
+  logMutex.Lock();
+  FormatSmart(l, threadID);
+
   if (logFile)
   {
-#ifdef _WIN32
-    FormatFull(*logFile, l, (int)GetCurrentThreadId());
-#else
-    FormatFull(*logFile, l);
-#endif
+    FormatFull(*logFile, l, threadID);
   }
   if (logOutputWindow)
   {
@@ -62,16 +236,156 @@ void mitk::LoggingBackend::ProcessMessage(const mbilog::LogMessage &l)
     }
     outputWindow->str("");
     outputWindow->clear();
-#ifdef _WIN32
-    FormatFull(*outputWindow, l, (int)GetCurrentThreadId());
-#else
-    FormatFull(*outputWindow, l);
-#endif
+    FormatFull(*outputWindow, l, threadID);
     itk::OutputWindow::GetInstance()->DisplayText(outputWindow->str().c_str());
   }
   logMutex.Unlock();
 }
 
+unsigned long mitk::LoggingBackend::WriteQueuedMessages()
+{
+  unsigned long written = 0;
+  QueuedMessage message;
+  while (GetMessageQueue().TryPop(message))
+  {
+    mbilog::LogMessage l(message.Level, message.FilePath, message.LineNumber, message.FunctionName);
+    l.moduleName = message.ModuleName;
+    l.category = std::move(message.Category);
+    l.message = std::move(message.Message);
+    this->WriteMessage(l, message.ThreadID);
+    ++written;
+  }
+
+  const unsigned long dropped = droppedMessages.exchange(0);
+  if (dropped > 0)
+  {
+    mbilog::LogMessage l(mbilog::Warn, __FILE__, __LINE__, __FUNCTION__);
+    l.moduleName = MBILOG_MODULENAME;
+    l.message = std::to_string(dropped) + " log message(s) dropped, because the logging queue was full";
+    this->WriteMessage(l, 0);
+  }
+
+  return written;
+}
+
+void mitk::LoggingBackend::WriteQueuedMessagesOfStoppedWriter()
+{
+  std::lock_guard<std::mutex> lock(writerMutex);
+
+  // a (re)started writer writes the messages itself, a stopping one in its final pass
+  if (writerThread != nullptr)
+    return;
+
+  writtenMessages += this->WriteQueuedMessages();
+  flushCondition.notify_all();
+}
+
+void mitk::LoggingBackend::RunWriterThread()
+{
+  while (true)
+  {
+    const unsigned long written = this->WriteQueuedMessages();
+
+    std::unique_lock<std::mutex> lock(writerMutex);
+    writtenMessages += written;
+    flushCondition.notify_all();
+
+    if (!writerRunning)
+      break;
+
+    // producers only notify a waiting writer, the timeout covers a notification right before waiting
+    writerWaiting = true;
+    writerCondition.wait_for(lock, std::chrono::milliseconds(10), [] {
+      return !writerRunning || queuedMessages != writtenMessages;
+    });
+    writerWaiting = false;
+  }
+}
+
+void mitk::LoggingBackend::StartWriterThread()
+{
+  if (writerRunning)
+    return;
+
+  std::lock_guard<std::mutex> lock(writerMutex);
+  if (writerThread == nullptr)
+  {
+    static bool stopAtExit = false;
+    if (!stopAtExit)
+    {
+      // write all pending messages before the static objects used for writing (including the
+      // queue, which is therefore created first) are destroyed
+      GetMessageQueue();
+      std::atexit([] { mitk::LoggingBackend::SetAsynchronous(false); });
+      stopAtExit = true;
+    }
+
+    writerBackend = this;
+    writerRunning = true;
+    writerThread = new std::thread(&LoggingBackend::RunWriterThread, this);
+    writerThreadID = writerThread->get_id();
+  }
+}
+
+void mitk::LoggingBackend::StopWriterThread()
+{
+  std::thread *thread = nullptr;
+  LoggingBackend *backend = nullptr;
+  {
+    std::lock_guard<std::mutex> lock(writerMutex);
+    if (writerThread == nullptr || std::this_thread::get_id() == writerThreadID)
+      return;
+
+    thread = writerThread;
+    backend = writerBackend;
+    writerRunning = false;
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    writerCondition.notify_one();
+  }
+
+  thread->join();
+  delete thread;
+
+  // Messages of threads which have seen the writer running just before it stopped. Producers which see it
+  // stopped write their messages themselves, see ProcessMessage().
+  std::lock_guard<std::mutex> lock(writerMutex);
+  writtenMessages += backend->WriteQueuedMessages();
+  writerThread = nullptr;
+  writerBackend = nullptr;
+  writerThreadID = std::thread::id();
+  flushCondition.notify_all();
+}
+
+void mitk::LoggingBackend::SetAsynchronous(bool enable)
+{
+  asynchronous = enable;
+  if (!enable)
+  {
+    StopWriterThread();
+  }
+}
+
+bool mitk::LoggingBackend::GetAsynchronous()
+{
+  return asynchronous;
+}
+
+void mitk::LoggingBackend::Flush()
+{
+  std::unique_lock<std::mutex> lock(writerMutex);
+  if (writerThread == nullptr || std::this_thread::get_id() == writerThreadID)
+    return;
+
+  const unsigned long target = queuedMessages;
+  writerCondition.notify_one();
+  flushCondition.wait(lock, [target] { return writtenMessages >= target || !writerRunning; });
+}
+
+unsigned long mitk::LoggingBackend::GetNumberOfDroppedMessages()
+{
+  return totalDroppedMessages;
+}
+
 void mitk::LoggingBackend::Register()
 {
   if (mitkLogBackend)
@@ -86,6 +400,7 @@ void mitk::LoggingBackend::Unregister()
   {
     SetLogFile(nullptr);
     mbilog::UnregisterBackend(mitkLogBackend);
+    StopWriterThread();
     delete mitkLogBackend;
     mitkLogBackend = nullptr;
   }
@@ -93,6 +408,9 @@ void mitk::LoggingBackend::Unregister()
 
 void mitk::LoggingBackend::SetLogFile(const char *file)
 {
+  // queued messages belong to the old logfile
+  Flush();
+
   // closing old logfile
   {
     bool closed = false;
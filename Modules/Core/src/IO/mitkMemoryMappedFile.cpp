@@ -0,0 +1,157 @@
+/*===================================================================
+
+The Medical Imaging Interaction Toolkit (MITK)
+
+Copyright (c) German Cancer Research Center,
+Division of Medical and Biological Informatics.
+All rights reserved.
+
+This software is distributed WITHOUT ANY WARRANTY; without
+even the implied warranty of MERCHANTABILITY or FITNESS FOR
+A PARTICULAR PURPOSE.
+
+See LICENSE.txt or http://www.mitk.org for details.
+
+===================================================================*/
+
+#include "mitkMemoryMappedFile.h"
+
+#include <mitkExceptionMacro.h>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <cerrno>
+#include <cstring>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+mitk::MemoryMappedFile::MemoryMappedFile()
+  : m_Data(nullptr),
+    m_Size(0)
+#ifdef _WIN32
+    ,
+    m_FileHandle(INVALID_HANDLE_VALUE),
+    m_MappingHandle(nullptr)
+#endif
+{
+}
+
+mitk::MemoryMappedFile::~MemoryMappedFile()
+{
+  this->Close();
+}
+
+#ifdef _WIN32
+
+void mitk::MemoryMappedFile::Open(const std::string &path)
+{
+  this->Close();
+
+  // FILE_SHARE_DELETE allows to replace the file by another one while it is mapped
+  m_FileHandle = CreateFileA(path.c_str(),
+                             GENERIC_READ,
+                             FILE_SHARE_READ | FILE_SHARE_DELETE,
+                             nullptr,
+                             OPEN_EXISTING,
+                             FILE_ATTRIBUTE_NORMAL,
+                             nullptr);
+  if (m_FileHandle == INVALID_HANDLE_VALUE)
+  {
+    mitkThrow() << "Could not open " << path << " for memory mapping (error " << GetLastError() << ")";
+  }
+
+  LARGE_INTEGER size;
+  if (!GetFileSizeEx(m_FileHandle, &size) || size.QuadPart == 0)
+  {
+    this->Close();
+    mitkThrow() << "Could not memory map " << path << ": file is empty or its size is unknown";
+  }
+
+  // PAGE_WRITECOPY / FILE_MAP_COPY give a private copy of every page which is written to
+  m_MappingHandle = CreateFileMappingA(m_FileHandle, nullptr, PAGE_WRITECOPY, 0, 0, nullptr);
+  void *data = m_MappingHandle != nullptr ? MapViewOfFile(m_MappingHandle, FILE_MAP_COPY, 0, 0, 0) : nullptr;
+  if (data == nullptr)
+  {
+    DWORD error = GetLastError();
+    this->Close();
+    mitkThrow() << "Could not memory map " << path << " (error " << error << ")";
+  }
+
+  m_Data = static_cast<unsigned char *>(data);
+  m_Size = static_cast<std::size_t>(size.QuadPart);
+}
+
+void mitk::MemoryMappedFile::Close()
+{
+  if (m_Data != nullptr)
+  {
+    UnmapViewOfFile(m_Data);
+  }
+  if (m_MappingHandle != nullptr)
+  {
+    CloseHandle(m_MappingHandle);
+  }
+  if (m_FileHandle != INVALID_HANDLE_VALUE)
+  {
+    CloseHandle(m_FileHandle);
+  }
+
+  m_Data = nullptr;
+  m_Size = 0;
+  m_MappingHandle = nullptr;
+  m_FileHandle = INVALID_HANDLE_VALUE;
+}
+
+#else
+
+void mitk::MemoryMappedFile::Open(const std::string &path)
+{
+  this->Close();
+
+  int fd = open(path.c_str(), O_RDONLY);
+  if (fd == -1)
+  {
+    mitkThrow() << "Could not open " << path << " for memory mapping: " << std::strerror(errno);
+  }
+
+  struct stat fileStatus;
+  if (fstat(fd, &fileStatus) != 0 || fileStatus.st_size == 0)
+  {
+    close(fd);
+    mitkThrow() << "Could not memory map " << path << ": file is empty or its size is unknown";
+  }
+
+  const auto size = static_cast<std::size_t>(fileStatus.st_size);
+
+  // MAP_PRIVATE gives a private copy of every page which is written to
+  void *data = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0);
+  const int error = errno;
+
+  // the mapping stays valid after the file descriptor has been closed
+  close(fd);
+
+  if (data == MAP_FAILED)
+  {
+    mitkThrow() << "Could not memory map " << path << ": " << std::strerror(error);
+  }
+
+  m_Data = static_cast<unsigned char *>(data);
+  m_Size = size;
+}
+
+void mitk::MemoryMappedFile::Close()
+{
+  if (m_Data != nullptr)
+  {
+    munmap(m_Data, m_Size);
+  }
+
+  m_Data = nullptr;
+  m_Size = 0;
+}
+
+#endif
@@ -0,0 +1,170 @@
+/*===================================================================
+
+The Medical Imaging Interaction Toolkit (MITK)
+
+Copyright (c) German Cancer Research Center,
+Division of Medical and Biological Informatics.
+All rights reserved.
+
+This software is distributed WITHOUT ANY WARRANTY; without
+even the implied warranty of MERCHANTABILITY or FITNESS FOR
+A PARTICULAR PURPOSE.
+
+See LICENSE.txt or http://www.mitk.org for details.
+
+===================================================================*/
+
+#include "mitkParallelGzip.h"
+
+#include <mitkExceptionMacro.h>
+
+#include "itk_zlib.h"
+
+#include <algorithm>
+#include <cstring>
+#include <deque>
+#include <future>
+#include <thread>
+#include <vector>
+
+namespace
+{
+  const std::size_t BlockSize = 1024 * 1024;
+  const std::size_t DictionarySize = 32 * 1024;
+
+  struct CompressedBlock
+  {
+    std::vector<unsigned char> Data;
+    uLong Crc;
+    std::size_t Length;
+  };
+
+  CompressedBlock DeflateBlock(const unsigned char *data, std::size_t offset, std::size_t length, bool last, int level)
+  {
+    z_stream zStream;
+    std::memset(&zStream, 0, sizeof(zStream));
+
+    // negative window bits: raw deflate data without zlib header and checksum
+    if (deflateInit2(&zStream, level, Z_DEFLATED, -MAX_WBITS, 8, Z_DEFAULT_STRATEGY) != Z_OK)
+    {
+      mitkThrow() << "Could not initialize zlib compression with level " << level;
+    }
+
+    if (offset > 0)
+    {
+      const std::size_t dictionaryLength = std::min(offset, DictionarySize);
+      deflateSetDictionary(&zStream, data + offset - dictionaryLength, static_cast<uInt>(dictionaryLength));
+    }
+
+    CompressedBlock block;
+    block.Length = length;
+    block.Crc = crc32(crc32(0L, Z_NULL, 0), data + offset, static_cast<uInt>(length));
+    block.Data.resize(deflateBound(&zStream, static_cast<uLong>(length)) + 16);
+
+    zStream.next_in = const_cast<Bytef *>(data + offset);
+    zStream.avail_in = static_cast<uInt>(length);
+    zStream.next_out = block.Data.data();
+    zStream.avail_out = static_cast<uInt>(block.Data.size());
+
+    // all but the last block end with an empty stored block, which aligns them to a byte boundary
+    const int flush = last ? Z_FINISH : Z_SYNC_FLUSH;
+    int result = Z_OK;
+    while (true)
+    {
+      if (zStream.avail_out == 0)
+      {
+        const std::size_t used = block.Data.size();
+        block.Data.resize(2 * used);
+        zStream.next_out = block.Data.data() + used;
+        zStream.avail_out = static_cast<uInt>(used);
+      }
+
+      result = deflate(&zStream, flush);
+      if (result == Z_STREAM_ERROR || (last ? result == Z_STREAM_END : zStream.avail_out != 0))
+        break;
+    }
+
+    block.Data.resize(zStream.total_out);
+    deflateEnd(&zStream);
+
+    if (result == Z_STREAM_ERROR || zStream.avail_in != 0)
+    {
+      mitkThrow() << "zlib compression failed";
+    }
+
+    return block;
+  }
+
+  void WriteLittleEndian(std::ostream &stream, uLong value)
+  {
+    for (int i = 0; i < 4; ++i)
+    {
+      stream.put(static_cast<char>((value >> (8 * i)) & 0xff));
+    }
+  }
+}
+
+std::size_t mitk::WriteParallelGzip(
+  std::ostream &stream, const void *data, std::size_t size, int level, unsigned int numberOfThreads)
+{
+  if (level < 1 || level > 9)
+  {
+    mitkThrow() << "Invalid compression level " << level << ", expected a value from 1 to 9";
+  }
+
+  if (numberOfThreads == 0)
+  {
+    numberOfThreads = std::max(1u, std::thread::hardware_concurrency());
+  }
+
+  const auto *bytes = static_cast<const unsigned char *>(data);
+  const std::size_t numberOfBlocks = std::max<std::size_t>(1, (size + BlockSize - 1) / BlockSize);
+
+  // gzip header: magic number, deflate, no flags, no modification time, extra flags, unknown OS
+  const char extraFlags = level == 9 ? 2 : (level == 1 ? 4 : 0);
+  const char header[10] = {'\x1f', '\x8b', 8, 0, 0, 0, 0, 0, extraFlags, '\xff'};
+  stream.write(header, sizeof(header));
+  std::size_t written = sizeof(header);
+
+  uLong crc = crc32(0L, Z_NULL, 0);
+
+  auto writeBlock = [&](const CompressedBlock &block) {
+    stream.write(reinterpret_cast<const char *>(block.Data.data()), block.Data.size());
+    written += block.Data.size();
+    crc = crc32_combine(crc, block.Crc, static_cast<z_off_t>(block.Length));
+  };
+
+  // at most one block per thread is compressed at a time, blocks are written in order
+  std::deque<std::future<CompressedBlock>> pendingBlocks;
+  for (std::size_t i = 0; i < numberOfBlocks; ++i)
+  {
+    if (pendingBlocks.size() >= numberOfThreads)
+    {
+      writeBlock(pendingBlocks.front().get());
+      pendingBlocks.pop_front();
+    }
+
+    const std::size_t offset = i * BlockSize;
+    const std::size_t length = std::min(BlockSize, size - offset);
+    pendingBlocks.push_back(
+      std::async(std::launch::async, DeflateBlock, bytes, offset, length, i + 1 == numberOfBlocks, level));
+  }
+
+  while (!pendingBlocks.empty())
+  {
+    writeBlock(pendingBlocks.front().get());
+    pendingBlocks.pop_front();
+  }
+
+  // gzip trailer: CRC-32 and size modulo 2^32 of the uncompressed data
+  WriteLittleEndian(stream, crc);
+  WriteLittleEndian(stream, static_cast<uLong>(size & 0xffffffff));
+  written += 8;
+
+  if (!stream)
+  {
+    mitkThrow() << "Could not write compressed data";
+  }
+
+  return written;
+}
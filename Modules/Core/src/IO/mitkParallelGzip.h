@@ -0,0 +1,42 @@
+/*===================================================================
+
+The Medical Imaging Interaction Toolkit (MITK)
+
+Copyright (c) German Cancer Research Center,
+Division of Medical and Biological Informatics.
+All rights reserved.
+
+This software is distributed WITHOUT ANY WARRANTY; without
+even the implied warranty of MERCHANTABILITY or FITNESS FOR
+A PARTICULAR PURPOSE.
+
+See LICENSE.txt or http://www.mitk.org for details.
+
+===================================================================*/
+
+#ifndef mitkParallelGzip_h
+#define mitkParallelGzip_h
+
+#include <cstddef>
+#include <ostream>
+
+namespace mitk
+{
+  /**
+   * \brief Writes data as a single member gzip stream (RFC 1952), compressed by several threads.
+   *
+   * The data is split into blocks which are deflated independently. Each block uses the last
+   * 32 KiB of the preceding block as dictionary and is flushed to a byte boundary, so the blocks
+   * concatenate to one regular deflate stream. The result can be read by any gzip or zlib
+   * reader and is only marginally larger than with single-threaded compression.
+   *
+   * \param level zlib compression level from 1 (fastest) to 9 (smallest)
+   * \param numberOfThreads number of blocks compressed at the same time, 0 for one per core
+   * \return the number of bytes written
+   * \throws mitk::Exception if compressing or writing fails
+   */
+  std::size_t WriteParallelGzip(
+    std::ostream &stream, const void *data, std::size_t size, int level, unsigned int numberOfThreads = 0);
+}
+
+#endif
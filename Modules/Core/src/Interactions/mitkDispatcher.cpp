@@ -20,18 +20,10 @@
 #include "mitkInternalEvent.h"
 #include "usGetModuleContext.h"
 
-namespace
-{
-  struct cmp
-  {
-    bool operator()(mitk::WeakPointer<mitk::DataInteractor> d1, mitk::WeakPointer<mitk::DataInteractor> d2)
-    {
-      return (d1.Lock()->GetLayer() > d2.Lock()->GetLayer());
-    }
-  };
-}
+#include <algorithm>
 
-mitk::Dispatcher::Dispatcher(const std::string &rendererName) : m_ProcessingMode(REGULAR)
+mitk::Dispatcher::Dispatcher(const std::string &rendererName)
+  : m_ProcessingMode(REGULAR), m_EventObserverTrackingCount(-1)
 {
   // LDAP filter string to find all listeners specific for the renderer
   // corresponding to this dispatcher
@@ -62,7 +54,10 @@ void mitk::Dispatcher::AddDataInteractor(const DataNode *dataNode)
   auto dataInteractor = dataNode->GetDataInteractor().GetPointer();
 
   if (dataInteractor != nullptr)
+  {
     m_Interactors.push_back(dataInteractor);
+    m_SortedInteractors.reset();
+  }
 }
 
 /*
@@ -80,6 +75,7 @@ void mitk::Dispatcher::RemoveDataInteractor(const DataNode *dataNode)
     if ((*it).IsExpired() || (*it).Lock()->GetDataNode() == nullptr || (*it).Lock()->GetDataNode() == dataNode)
     {
       it = m_Interactors.erase(it);
+      m_SortedInteractors.reset();
     }
     else
     {
@@ -163,26 +159,24 @@ bool mitk::Dispatcher::ProcessEvent(InteractionEvent *event)
   {
     if (std::strcmp(p->GetNameOfClass(), "MousePressEvent") == 0)
       RenderingManager::GetInstance()->SetRenderWindowFocus(event->GetSender()->GetRenderWindow());
-    m_Interactors.sort(cmp()); // sorts interactors by layer (descending);
 
-    // copy the list to prevent iterator invalidation as executing actions
-    // in HandleEvent() can cause the m_Interactors list to be updated
-    const ListInteractorType tmpInteractorList(m_Interactors);
-    ListInteractorType::const_iterator it;
-    for (it = tmpInteractorList.cbegin(); it != tmpInteractorList.cend(); ++it)
+    // keep the snapshot alive, executing actions in HandleEvent() can cause the m_Interactors list to be updated
+    const std::shared_ptr<const LayeredInteractorVectorType> sortedInteractors = GetSortedInteractors();
+    for (auto it = sortedInteractors->cbegin(); it != sortedInteractors->cend(); ++it)
     {
-      if (!(*it).IsExpired() && (*it).Lock()->HandleEvent(event, (*it).Lock()->GetDataNode()))
+      const mitk::WeakPointer<DataInteractor> &interactor = it->Interactor;
+      if (!interactor.IsExpired() && interactor.Lock()->HandleEvent(event, interactor.Lock()->GetDataNode()))
       {
         // Interactor can be deleted during HandleEvent(), so check it again
-        if (!(*it).IsExpired())
+        if (!interactor.IsExpired())
         {
           // if an event is handled several properties are checked, in order to determine the processing mode of the
           // dispatcher
-          SetEventProcessingMode((*it).Lock());
+          SetEventProcessingMode(interactor.Lock());
         }
         if (std::strcmp(p->GetNameOfClass(), "MousePressEvent") == 0 && m_ProcessingMode == REGULAR)
         {
-          m_SelectedInteractor = *it;
+          m_SelectedInteractor = interactor;
           m_ProcessingMode = CONNECTEDMOUSEACTION;
         }
         eventIsHandled = true;
@@ -192,20 +186,27 @@ bool mitk::Dispatcher::ProcessEvent(InteractionEvent *event)
   }
 
   /* Notify InteractionEventObserver  */
-  const std::vector<us::ServiceReference<InteractionEventObserver>> listEventObserver =
-    m_EventObserverTracker->GetServiceReferences();
-  for (auto it = listEventObserver.cbegin();
-       it != listEventObserver.cend();
-       ++it)
+  const std::vector<InteractionEventObserver *> listEventObserver = GetEventObservers();
+  const int trackingCount = m_EventObserverTrackingCount;
+  for (auto it = listEventObserver.cbegin(); it != listEventObserver.cend(); ++it)
   {
-    InteractionEventObserver *interactionEventObserver = m_EventObserverTracker->GetService(*it);
-    if (interactionEventObserver != nullptr)
+    InteractionEventObserver *interactionEventObserver = *it;
+
+    // a notified observer may have caused others to be unregistered
+    if (m_EventObserverTracker->GetTrackingCount() != trackingCount)
     {
-      if (interactionEventObserver->IsEnabled())
+      const std::vector<InteractionEventObserver *> &currentObservers = GetEventObservers();
+      if (std::find(currentObservers.cbegin(), currentObservers.cend(), interactionEventObserver) ==
+          currentObservers.cend())
       {
-        interactionEventObserver->Notify(event, eventIsHandled);
+        continue;
       }
     }
+
+    if (interactionEventObserver != nullptr && interactionEventObserver->IsEnabled())
+    {
+      interactionEventObserver->Notify(event, eventIsHandled);
+    }
   }
 
   // Process event queue
@@ -224,6 +225,8 @@ bool mitk::Dispatcher::ProcessEvent(InteractionEvent *event)
  */
 void mitk::Dispatcher::RemoveOrphanedInteractors()
 {
+  m_SortedInteractors.reset();
+
   for (auto it = m_Interactors.begin(); it != m_Interactors.end();)
   {
     if ((*it).IsExpired())
@@ -255,6 +258,55 @@ void mitk::Dispatcher::RemoveOrphanedInteractors()
   }
 }
 
+std::shared_ptr<const mitk::Dispatcher::LayeredInteractorVectorType> mitk::Dispatcher::GetSortedInteractors()
+{
+  // layers are properties of the DataNodes and may change at any time
+  if (m_SortedInteractors != nullptr)
+  {
+    for (auto it = m_SortedInteractors->cbegin(); it != m_SortedInteractors->cend(); ++it)
+    {
+      if (!it->Interactor.IsExpired() && it->Interactor.Lock()->GetLayer() != it->Layer)
+      {
+        m_SortedInteractors.reset();
+        break;
+      }
+    }
+  }
+
+  if (m_SortedInteractors == nullptr)
+  {
+    auto sortedInteractors = std::make_shared<LayeredInteractorVectorType>();
+    for (auto it = m_Interactors.cbegin(); it != m_Interactors.cend(); ++it)
+    {
+      if (!it->IsExpired())
+      {
+        LayeredInteractor layeredInteractor = {*it, it->Lock()->GetLayer()};
+        sortedInteractors->push_back(layeredInteractor);
+      }
+    }
+
+    // stable, so interactors in the same layer keep the order in which they were added
+    std::stable_sort(sortedInteractors->begin(),
+                     sortedInteractors->end(),
+                     [](const LayeredInteractor &a, const LayeredInteractor &b) { return a.Layer > b.Layer; });
+
+    m_SortedInteractors = sortedInteractors;
+  }
+
+  return m_SortedInteractors;
+}
+
+const std::vector<mitk::InteractionEventObserver *> &mitk::Dispatcher::GetEventObservers()
+{
+  const int trackingCount = m_EventObserverTracker->GetTrackingCount();
+  if (trackingCount != m_EventObserverTrackingCount)
+  {
+    m_EventObservers = m_EventObserverTracker->GetServices();
+    m_EventObserverTrackingCount = trackingCount;
+  }
+  return m_EventObservers;
+}
+
 void mitk::Dispatcher::QueueEvent(InteractionEvent *event)
 {
   m_QueuedEvents.push_back(event);
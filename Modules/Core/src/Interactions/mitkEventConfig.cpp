@@ -32,6 +32,10 @@
 #include "usModuleResource.h"
 #include "usModuleResourceStream.h"
 
+#include <functional>
+#include <map>
+#include <vector>
+
 namespace mitk
 {
   class EventConfigXMLParser : public vtkXMLParser
@@ -78,6 +82,11 @@ namespace mitk
 
     void CopyMapping(const EventListType);
 
+    /**
+     * Rebuilds m_EventIndex, needs to be called whenever m_EventList changes
+     */
+    void UpdateEventIndex();
+
     /**
      * @brief List of all global properties of the config object.
      */
@@ -97,6 +106,14 @@ namespace mitk
      */
     EventListType m_EventList;
 
+    typedef std::map<std::string, std::vector<const EventMapping *>, std::less<>> EventIndexType;
+
+    /**
+     * Mappings of m_EventList by class name of their event, in list order.
+     * Only events of the same class can be equal, so an event is only compared to these.
+     */
+    EventIndexType m_EventIndex;
+
     bool
       m_Errors; // use member, because of inheritance from vtkXMLParser we can't return a success value for parsing the
                 // file.
@@ -123,6 +140,7 @@ mitk::EventConfigPrivate::EventConfigPrivate(const EventConfigPrivate &other)
 {
   // Avoid VTK warning: Trying to delete object with non-zero reference count.
   m_XmlParser.SetReferenceCount(0);
+  UpdateEventIndex();
 }
 
 void mitk::EventConfigPrivate::InsertMapping(const EventMapping &mapping)
@@ -137,6 +155,7 @@ void mitk::EventConfigPrivate::InsertMapping(const EventMapping &mapping)
     }
   }
   m_EventList.push_back(mapping);
+  UpdateEventIndex();
 }
 
 void mitk::EventConfigPrivate::CopyMapping(const EventListType eventList)
@@ -148,6 +167,15 @@ void mitk::EventConfigPrivate::CopyMapping(const EventListType eventList)
   }
 }
 
+void mitk::EventConfigPrivate::UpdateEventIndex()
+{
+  m_EventIndex.clear();
+  for (auto it = m_EventList.cbegin(); it != m_EventList.cend(); ++it)
+  {
+    m_EventIndex[it->interactionEvent->GetNameOfClass()].push_back(&(*it));
+  }
+}
+
 mitk::EventConfigXMLParser::EventConfigXMLParser(EventConfigPrivate *d) : d(d)
 {
 }
@@ -381,11 +409,15 @@ std::string mitk::EventConfig::GetMappedEvent(const EventType &interactionEvent)
     return internalEvent->GetSignalName();
   }
 
-  for (auto it = d->m_EventList.begin(); it != d->m_EventList.end(); ++it)
+  auto mappings = d->m_EventIndex.find(interactionEvent->GetNameOfClass());
+  if (mappings != d->m_EventIndex.cend())
   {
-    if (*(it->interactionEvent) == *interactionEvent)
+    for (auto it = mappings->second.cbegin(); it != mappings->second.cend(); ++it)
     {
-      return (*it).variantName;
+      if (*((*it)->interactionEvent) == *interactionEvent)
+      {
+        return (*it)->variantName;
+      }
     }
   }
   // if this part is reached, no mapping has been found,
@@ -406,5 +438,6 @@ void mitk::EventConfig::ClearConfig()
   d->m_CurrEventMapping.variantName.clear();
   d->m_CurrEventMapping.interactionEvent = nullptr;
   d->m_EventList.clear();
+  d->m_EventIndex.clear();
   d->m_Errors = false;
 }
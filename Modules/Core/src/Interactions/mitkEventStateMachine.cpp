@@ -249,7 +249,7 @@ mitk::StateMachineTransition *mitk::EventStateMachine::GetExecutableTransition(m
   std::map<std::string, bool> conditionsMap;
 
   // Get a list of all transitions that match the given event
-  const mitk::StateMachineState::TransitionVector transitionList =
+  const mitk::StateMachineState::TransitionVector &transitionList =
     m_CurrentState->GetTransitionList(event->GetNameOfClass(), MapToEventVariant(event));
 
   // if there are not transitions, we can return nullptr here.
@@ -265,7 +265,7 @@ mitk::StateMachineTransition *mitk::EventStateMachine::GetExecutableTransition(m
     bool allConditionsFulfilled(true);
 
     // Get all conditions for the current transition
-    const ConditionVectorType conditions = (*transitionIter)->GetConditions();
+    const ConditionVectorType &conditions = (*transitionIter)->GetConditions();
     for (conditionIter = conditions.cbegin(); conditionIter != conditions.cend(); ++conditionIter)
     {
       bool currentConditionFulfilled(false);
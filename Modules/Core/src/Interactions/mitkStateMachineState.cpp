@@ -39,6 +39,7 @@ bool mitk::StateMachineState::AddTransition(StateMachineTransition::Pointer tran
       return false;
   }
   m_Transitions.push_back(transition);
+  m_TransitionTable.clear();
   return true;
 }
 
@@ -63,10 +64,17 @@ mitk::StateMachineTransition::Pointer mitk::StateMachineState::GetTransition(con
   }
 }
 
-mitk::StateMachineState::TransitionVector mitk::StateMachineState::GetTransitionList(const std::string &eventClass,
-                                                                                     const std::string &eventVariant)
+const mitk::StateMachineState::TransitionVector &mitk::StateMachineState::GetTransitionList(
+  const std::string &eventClass, const std::string &eventVariant)
 {
-  TransitionVector transitions;
+  const auto key = std::make_pair(eventClass, eventVariant);
+  auto entry = m_TransitionTable.find(key);
+  if (entry != m_TransitionTable.end())
+  {
+    return entry->second;
+  }
+
+  TransitionVector &transitions = m_TransitionTable[key];
   mitk::StateMachineTransition::Pointer t = mitk::StateMachineTransition::New("", eventClass, eventVariant);
   for (auto it = m_Transitions.begin(); it != m_Transitions.end(); ++it)
   {
@@ -116,7 +116,8 @@ mitk::BaseRenderer::BaseRenderer(const char *name,
     m_CurrentWorldPlaneGeometryTransformTime(0),
     m_Name(name),
     m_EmptyWorldGeometry(true),
-    m_NumberOfVisibleLODEnabledMappers(0)
+    m_NumberOfVisibleLODEnabledMappers(0),
+    m_RenderingStatisticsEnabled(false)
 {
   m_Bounds[0] = 0;
   m_Bounds[1] = 0;
@@ -565,6 +566,83 @@ unsigned int mitk::BaseRenderer::GetNumberOfVisibleLODEnabledMappers() const
   return m_NumberOfVisibleLODEnabledMappers;
 }
 
+const mitk::BaseRenderer::MapperRenderingStatisticsMapType &mitk::BaseRenderer::GetMapperRenderingStatistics() const
+{
+  return m_MapperRenderingStatistics;
+}
+
+const mitk::RollingTimeStatistics &mitk::BaseRenderer::GetFrameTimeStatistics() const
+{
+  return m_FrameTimeStatistics;
+}
+
+void mitk::BaseRenderer::ResetRenderingStatistics()
+{
+  m_MapperRenderingStatistics.clear();
+  m_MapperFrameRenderTimes.clear();
+  m_FrameTimeStatistics.Clear();
+}
+
+void mitk::BaseRenderer::StartFrameTiming()
+{
+  m_MapperFrameRenderTimes.clear();
+  m_FrameStartTime = std::chrono::steady_clock::now();
+}
+
+void mitk::BaseRenderer::StopFrameTiming()
+{
+  m_FrameTimeStatistics.AddSample(
+    std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - m_FrameStartTime).count());
+
+  if (!m_RenderingStatisticsEnabled)
+    return;
+
+  for (const auto &frameRenderTime : m_MapperFrameRenderTimes)
+  {
+    auto statistics = m_MapperRenderingStatistics.find(frameRenderTime.first);
+    if (statistics != m_MapperRenderingStatistics.end())
+      statistics->second.RenderTime.AddSample(frameRenderTime.second);
+  }
+  m_MapperFrameRenderTimes.clear();
+
+  this->InvokeEvent(RenderingStatisticsEvent());
+}
+
+void mitk::BaseRenderer::AddMapperUpdateTime(const Mapper *mapper, double milliseconds)
+{
+  auto statistics = m_MapperRenderingStatistics.find(mapper);
+  if (statistics == m_MapperRenderingStatistics.end())
+  {
+    MapperRenderingStatistics newStatistics;
+    newStatistics.MapperClassName = mapper->GetNameOfClass();
+    if (mapper->GetDataNode() != nullptr)
+      newStatistics.NodeName = mapper->GetDataNode()->GetName();
+
+    statistics = m_MapperRenderingStatistics.insert(std::make_pair(mapper, newStatistics)).first;
+  }
+  statistics->second.UpdateTime.AddSample(milliseconds);
+}
+
+void mitk::BaseRenderer::AddMapperRenderTime(const Mapper *mapper, double milliseconds)
+{
+  m_MapperFrameRenderTimes[mapper] += milliseconds;
+}
+
+void mitk::BaseRenderer::RemoveMapperRenderingStatistics(const std::set<const Mapper *> &remainingMappers)
+{
+  for (auto it = m_MapperRenderingStatistics.begin(); it != m_MapperRenderingStatistics.end();)
+  {
+    if (remainingMappers.count(it->first) == 0)
+    {
+      it = m_MapperRenderingStatistics.erase(it);
+    }
+    else
+    {
+      ++it;
+    }
+  }
+}
+
 /*!
  Sets the new Navigation controller
  */
@@ -0,0 +1,67 @@
+/*===================================================================
+
+The Medical Imaging Interaction Toolkit (MITK)
+
+Copyright (c) German Cancer Research Center,
+Division of Medical and Biological Informatics.
+All rights reserved.
+
+This software is distributed WITHOUT ANY WARRANTY; without
+even the implied warranty of MERCHANTABILITY or FITNESS FOR
+A PARTICULAR PURPOSE.
+
+See LICENSE.txt or http://www.mitk.org for details.
+
+===================================================================*/
+
+#include "mitkRenderingStatistics.h"
+
+#include <algorithm>
+
+mitk::RollingTimeStatistics::RollingTimeStatistics() : m_NumberOfSamples(0)
+{
+}
+
+void mitk::RollingTimeStatistics::AddSample(double milliseconds)
+{
+  m_Samples[m_NumberOfSamples % WindowSize] = milliseconds;
+  ++m_NumberOfSamples;
+}
+
+void mitk::RollingTimeStatistics::Clear()
+{
+  m_NumberOfSamples = 0;
+}
+
+unsigned long mitk::RollingTimeStatistics::GetNumberOfSamples() const
+{
+  return m_NumberOfSamples;
+}
+
+double mitk::RollingTimeStatistics::GetLast() const
+{
+  return m_NumberOfSamples > 0 ? m_Samples[(m_NumberOfSamples - 1) % WindowSize] : 0.0;
+}
+
+double mitk::RollingTimeStatistics::GetMean() const
+{
+  const unsigned long count = std::min<unsigned long>(m_NumberOfSamples, WindowSize);
+  if (count == 0)
+    return 0.0;
+
+  double sum = 0.0;
+  for (unsigned long i = 0; i < count; ++i)
+  {
+    sum += m_Samples[i];
+  }
+  return sum / count;
+}
+
+double mitk::RollingTimeStatistics::GetMaximum() const
+{
+  const unsigned long count = std::min<unsigned long>(m_NumberOfSamples, WindowSize);
+  if (count == 0)
+    return 0.0;
+
+  return *std::max_element(m_Samples, m_Samples + count);
+}
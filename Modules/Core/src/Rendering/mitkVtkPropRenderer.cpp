@@ -57,6 +57,9 @@ See LICENSE.txt or http://www.mitk.org for details.
 #include <vtkTransform.h>
 #include <vtkWorldPointPicker.h>
 
+#include <chrono>
+#include <set>
+
 mitk::VtkPropRenderer::VtkPropRenderer(const char *name, vtkRenderWindow *renWin)
   : BaseRenderer(name, renWin),
     m_CameraInitializedForMapperID(0)
@@ -178,7 +181,18 @@ int mitk::VtkPropRenderer::Render(mitk::VtkPropRenderer::RenderType type)
   for (auto it = m_MappersMap.cbegin(); it != m_MappersMap.cend(); it++)
   {
     Mapper *mapper = (*it).second;
-    mapper->MitkRender(this, type);
+
+    if (m_RenderingStatisticsEnabled)
+    {
+      const auto start = std::chrono::steady_clock::now();
+      mapper->MitkRender(this, type);
+      this->AddMapperRenderTime(
+        mapper, std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count());
+    }
+    else
+    {
+      mapper->MitkRender(this, type);
+    }
   }
 
   // Render text
@@ -259,6 +273,16 @@ void mitk::VtkPropRenderer::PrepareMapperQueue()
     m_MappersMap.insert(std::pair<int, Mapper *>(nr, mapper));
     mapperNo++;
   }
+
+  // forget about mappers which are no longer rendered, their addresses might be reused
+  if (m_RenderingStatisticsEnabled)
+  {
+    std::set<const Mapper *> mappers;
+    for (auto it = m_MappersMap.cbegin(); it != m_MappersMap.cend(); ++it)
+      mappers.insert(it->second);
+
+    this->RemoveMapperRenderingStatistics(mappers);
+  }
 }
 
 void mitk::VtkPropRenderer::SetPropertyKeys(vtkInformation *info)
@@ -298,6 +322,8 @@ void mitk::VtkPropRenderer::Update(mitk::DataNode *datatreenode)
     {
       if (GetCurrentWorldPlaneGeometry()->IsValid())
       {
+        const auto start = std::chrono::steady_clock::now();
+
         mapper->Update(this);
         {
           auto *vtkmapper = dynamic_cast<VtkMapper *>(mapper.GetPointer());
@@ -306,6 +332,12 @@ void mitk::VtkPropRenderer::Update(mitk::DataNode *datatreenode)
             vtkmapper->UpdateVtkTransform(this);
           }
         }
+
+        if (m_RenderingStatisticsEnabled)
+        {
+          this->AddMapperUpdateTime(
+            mapper, std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count());
+        }
       }
     }
   }
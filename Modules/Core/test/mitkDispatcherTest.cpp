@@ -19,9 +19,53 @@
 #include "mitkDataInteractor.h"
 #include "mitkDataNode.h"
 #include "mitkDispatcher.h"
+#include "mitkInteractionEventObserver.h"
+#include "mitkInteractionKeyEvent.h"
 #include "mitkStandaloneDataStorage.h"
 #include "mitkTestingMacros.h"
 #include "mitkVtkPropRenderer.h"
+#include "usGetModuleContext.h"
+#include "usModuleContext.h"
+
+namespace
+{
+  std::vector<mitk::DataNode *> offeredNodes;
+
+  // Records the nodes of the interactors an event is offered to, without handling the event
+  class RecordingDataInteractor : public mitk::DataInteractor
+  {
+  public:
+    mitkClassMacro(RecordingDataInteractor, mitk::DataInteractor);
+    itkFactorylessNewMacro(Self);
+
+  protected:
+    bool FilterEvents(mitk::InteractionEvent *, mitk::DataNode *dataNode) override
+    {
+      offeredNodes.push_back(dataNode);
+      return false;
+    }
+  };
+
+  // Unregisters another observer when it is notified
+  class UnregisteringObserver : public mitk::InteractionEventObserver
+  {
+  public:
+    UnregisteringObserver() : NumberOfNotifications(0), OtherRegistration(nullptr) {}
+
+    void Notify(mitk::InteractionEvent *, bool) override
+    {
+      ++NumberOfNotifications;
+      if (OtherRegistration != nullptr && *OtherRegistration)
+      {
+        OtherRegistration->Unregister();
+        *OtherRegistration = 0;
+      }
+    }
+
+    int NumberOfNotifications;
+    us::ServiceRegistration<mitk::InteractionEventObserver> *OtherRegistration;
+  };
+}
 
 int mitkDispatcherTest(int /*argc*/, char * /*argv*/ [])
 {
@@ -117,6 +161,62 @@ int mitkDispatcherTest(int /*argc*/, char * /*argv*/ [])
   MITK_TEST_CONDITION_REQUIRED(ei->GetReferenceCount() == 1,
                                "11 Number of references of Interactors " << num << " , expected 1");
 
+  /*
+   * The dispatcher caches the interactors sorted by layer. Changing the layer of a node has to reorder the
+   * interactors, even though no interactor was added or removed.
+   */
+  mitk::DataNode::Pointer lowerNode = mitk::DataNode::New();
+  mitk::DataNode::Pointer upperNode = mitk::DataNode::New();
+  lowerNode->SetIntProperty("layer", 1);
+  upperNode->SetIntProperty("layer", 2);
+  RecordingDataInteractor::Pointer lowerInteractor = RecordingDataInteractor::New();
+  RecordingDataInteractor::Pointer upperInteractor = RecordingDataInteractor::New();
+  lowerInteractor->SetDataNode(lowerNode);
+  upperInteractor->SetDataNode(upperNode);
+  ds->Add(lowerNode);
+  ds->Add(upperNode);
+
+  mitk::InteractionKeyEvent::Pointer keyEvent =
+    mitk::InteractionKeyEvent::New(renderer, "A", mitk::InteractionEvent::NoKey);
+
+  offeredNodes.clear();
+  renderer->GetDispatcher()->ProcessEvent(keyEvent);
+  MITK_TEST_CONDITION_REQUIRED(offeredNodes.size() == 2, "12 Event is offered to both interactors");
+  MITK_TEST_CONDITION(offeredNodes[0] == upperNode.GetPointer() && offeredNodes[1] == lowerNode.GetPointer(),
+                      "13 Event is offered to the interactor of the higher layer first");
+
+  lowerNode->SetIntProperty("layer", 3);
+  offeredNodes.clear();
+  renderer->GetDispatcher()->ProcessEvent(keyEvent);
+  MITK_TEST_CONDITION_REQUIRED(offeredNodes.size() == 2, "14 Event is offered to both interactors");
+  MITK_TEST_CONDITION(offeredNodes[0] == lowerNode.GetPointer() && offeredNodes[1] == upperNode.GetPointer(),
+                      "15 Changed layer reorders the interactors");
+
+  ds->Remove(lowerNode);
+  ds->Remove(upperNode);
+
+  /*
+   * The dispatcher caches the registered InteractionEventObservers. An observer that is unregistered while
+   * another one is notified must not be notified on the same pass anymore.
+   */
+  UnregisteringObserver firstObserver;
+  UnregisteringObserver secondObserver;
+  us::ServiceRegistration<mitk::InteractionEventObserver> firstRegistration =
+    us::GetModuleContext()->RegisterService<mitk::InteractionEventObserver>(&firstObserver);
+  us::ServiceRegistration<mitk::InteractionEventObserver> secondRegistration =
+    us::GetModuleContext()->RegisterService<mitk::InteractionEventObserver>(&secondObserver);
+  firstObserver.OtherRegistration = &secondRegistration;
+  secondObserver.OtherRegistration = &firstRegistration;
+
+  renderer->GetDispatcher()->ProcessEvent(keyEvent);
+  MITK_TEST_CONDITION(firstObserver.NumberOfNotifications + secondObserver.NumberOfNotifications == 1,
+                      "16 Observer unregistered during notification is skipped");
+
+  if (firstRegistration)
+    firstRegistration.Unregister();
+  if (secondRegistration)
+    secondRegistration.Unregister();
+
   renWin->Delete();
   // always end with this!
   MITK_TEST_END()
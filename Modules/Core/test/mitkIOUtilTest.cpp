@@ -20,6 +20,9 @@ See LICENSE.txt or http://www.mitk.org for details.
 
 #include <mitkIOUtil.h>
 #include <mitkImageGenerator.h>
+#include <mitkPointSet.h>
+#include <mitkStandaloneDataStorage.h>
+#include <mitkSurface.h>
 
 #include <itksys/SystemTools.hxx>
 
@@ -33,6 +36,7 @@ class mitkIOUtilTestSuite : public mitk::TestFixture
   MITK_TEST(TestNullSave);
   MITK_TEST(TestLoadAndSavePointSet);
   MITK_TEST(TestLoadAndSaveSurface);
+  MITK_TEST(TestLoadMultipleFiles);
   MITK_TEST(TestTempMethodsForUniqueFilenames);
   MITK_TEST(TestTempMethodsForUniqueFilenames);
   CPPUNIT_TEST_SUITE_END();
@@ -230,6 +234,32 @@ public:
     // delete the files after the test is done
     std::remove(surfacePath.c_str());
   }
+
+  void TestLoadMultipleFiles()
+  {
+    // images are read concurrently, the other files in between serially
+    std::vector<std::string> paths = {m_ImagePath, m_SurfacePath, m_ImagePath, m_ImagePath, m_PointSetPath, m_ImagePath};
+
+    mitk::DataStorage::Pointer storage = mitk::StandaloneDataStorage::New().GetPointer();
+    mitk::DataStorage::SetOfObjects::Pointer nodes = mitk::IOUtil::Load(paths, *storage);
+
+    CPPUNIT_ASSERT_EQUAL(paths.size(), static_cast<std::size_t>(nodes->Size()));
+    CPPUNIT_ASSERT_EQUAL(paths.size(), static_cast<std::size_t>(storage->GetAll()->Size()));
+
+    for (std::size_t i = 0; i < paths.size(); ++i)
+    {
+      mitk::BaseData *data = nodes->ElementAt(i)->GetData();
+      CPPUNIT_ASSERT_EQUAL(paths[i], data->GetProperty("path")->GetValueAsString());
+      CPPUNIT_ASSERT(storage->Exists(nodes->ElementAt(i)));
+    }
+    CPPUNIT_ASSERT(dynamic_cast<mitk::Image *>(nodes->ElementAt(0)->GetData()) != nullptr);
+    CPPUNIT_ASSERT(dynamic_cast<mitk::Surface *>(nodes->ElementAt(1)->GetData()) != nullptr);
+    CPPUNIT_ASSERT(dynamic_cast<mitk::PointSet *>(nodes->ElementAt(4)->GetData()) != nullptr);
+
+    std::vector<mitk::BaseData::Pointer> data = mitk::IOUtil::Load(paths);
+    CPPUNIT_ASSERT_EQUAL(paths.size(), data.size());
+    CPPUNIT_ASSERT(dynamic_cast<mitk::Image *>(data[5].GetPointer()) != nullptr);
+  }
 };
 
 MITK_TEST_SUITE_REGISTRATION(mitkIOUtil)
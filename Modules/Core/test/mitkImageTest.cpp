@@ -159,6 +159,28 @@ public:
 
     MITK_ASSERT_EQUAL(imageGeometry, planegeometry, "Matrix elements of cloned matrix equal original matrix");
   }
+
+  void Graft_InitializedImage_SharesPixelData()
+  {
+    mitk::Image::Pointer image = mitk::ImageGenerator::GenerateRandomImage<float>(20, 30, 4, 1, 0.5, 0.5, 2.0);
+    mitk::Image::Pointer grafted = mitk::Image::New();
+    grafted->Graft(image);
+
+    MITK_TEST_CONDITION_REQUIRED(grafted->IsInitialized(), "Grafted image is initialized");
+    MITK_TEST_CONDITION(grafted->GetPixelType() == image->GetPixelType(), "Grafted image has the pixel type of the source");
+    MITK_ASSERT_EQUAL(grafted->GetGeometry(), image->GetGeometry(), "Grafted image has the geometry of the source");
+
+    const void *data = mitk::ImageReadAccessor(image).GetData();
+    const void *graftedData = mitk::ImageReadAccessor(grafted).GetData();
+    MITK_TEST_CONDITION(data == graftedData, "Grafted image references the pixel data of the source");
+
+    // the pixel data stays valid after the source is gone
+    image = nullptr;
+    mitk::ImagePixelReadAccessor<float, 3> accessor(grafted);
+    MITK_TEST_CONDITION(accessor.GetData() == graftedData, "Pixel data is kept alive by the grafted image");
+
+    MITK_TEST_FOR_EXCEPTION(mitk::Exception, grafted->Graft(mitk::Image::New()));
+  }
 };
 
 int mitkImageTest(int argc, char *argv[])
@@ -167,6 +189,7 @@ int mitkImageTest(int argc, char *argv[])
 
   mitkImageTestClass tester;
   tester.SetClonedGeometry_None_ClonedEqualInput();
+  tester.Graft_InitializedImage_SharesPixelData();
 
   // Create Image out of nowhere
   mitk::Image::Pointer imgMem = mitk::Image::New();
@@ -0,0 +1,111 @@
+/*===================================================================
+
+The Medical Imaging Interaction Toolkit (MITK)
+
+Copyright (c) German Cancer Research Center,
+Division of Medical and Biological Informatics.
+All rights reserved.
+
+This software is distributed WITHOUT ANY WARRANTY; without
+even the implied warranty of MERCHANTABILITY or FITNESS FOR
+A PARTICULAR PURPOSE.
+
+See LICENSE.txt or http://www.mitk.org for details.
+
+===================================================================*/
+
+#include "mitkTestingMacros.h"
+#include <mitkTestFixture.h>
+#include <mitkTestingConfig.h>
+
+#include "mitkInteractionTestHelper.h"
+#include <mitkIOUtil.h>
+#include <mitkPointSet.h>
+#include <mitkPointSetDataInteractor.h>
+
+#include <vtkDebugLeaks.h>
+
+#include <sstream>
+
+/**
+ * Plays back recorded interactions with InteractionTestHelper::BenchmarkInteraction and prints
+ * the measured times. Compare the report of two revisions to find regressions in interaction
+ * and rendering code.
+ */
+class mitkInteractionBenchmarkTestSuite : public mitk::TestFixture
+{
+  CPPUNIT_TEST_SUITE(mitkInteractionBenchmarkTestSuite);
+
+  /// \todo Fix VTK memory leaks. Bug 18144.
+  vtkDebugLeaks::SetExitError(0);
+
+  MITK_TEST(AddPointsBenchmark);
+  MITK_TEST(MoveRemovePointsBenchmark);
+  CPPUNIT_TEST_SUITE_END();
+
+private:
+  mitk::DataNode::Pointer m_PointSetNode;
+  mitk::DataNode::Pointer m_ImageNode;
+  mitk::PointSetDataInteractor::Pointer m_DataInteractor;
+
+  void Benchmark(const std::string &interactionXmlPath)
+  {
+    mitk::InteractionTestHelper interactionTestHelper(interactionXmlPath);
+    interactionTestHelper.AddNodeToStorage(m_PointSetNode);
+    interactionTestHelper.AddNodeToStorage(m_ImageNode);
+
+    mitk::InteractionTestHelper::EventTimingListType timings = interactionTestHelper.BenchmarkInteraction();
+
+    CPPUNIT_ASSERT_MESSAGE("Timings of played back events", !timings.empty());
+    bool hasMapperTimes = false;
+    for (const auto &timing : timings)
+    {
+      CPPUNIT_ASSERT_MESSAGE("Event class of timing", !timing.EventClass.empty());
+      CPPUNIT_ASSERT_MESSAGE("Latency includes processing and rendering",
+                             timing.Latency >= timing.ProcessingTime && timing.Latency >= timing.RenderTime);
+      CPPUNIT_ASSERT_MESSAGE("Mapper times are only recorded for rendered windows",
+                             timing.RenderTimePerMapper.empty() || !timing.RenderTimePerWindow.empty());
+      hasMapperTimes = hasMapperTimes || !timing.RenderTimePerMapper.empty();
+    }
+    CPPUNIT_ASSERT_MESSAGE("Render time is broken down per mapper", hasMapperTimes);
+
+    std::stringstream report;
+    mitk::InteractionTestHelper::PrintBenchmarkReport(timings, report);
+    MITK_INFO << "Benchmark of " << interactionXmlPath << "\n" << report.str();
+  }
+
+public:
+  void setUp() override
+  {
+    m_DataInteractor = mitk::PointSetDataInteractor::New();
+    m_DataInteractor->LoadStateMachine("PointSet.xml");
+    m_DataInteractor->SetEventConfig("PointSetConfig.xml");
+
+    m_PointSetNode = mitk::DataNode::New();
+    m_PointSetNode->SetData(mitk::PointSet::New());
+    m_DataInteractor->SetDataNode(m_PointSetNode);
+
+    m_ImageNode = mitk::DataNode::New();
+    m_ImageNode->SetData(mitk::IOUtil::Load<mitk::Image>(GetTestDataFilePath("Pic3D.nrrd")));
+  }
+
+  void tearDown() override
+  {
+    m_PointSetNode->SetDataInteractor(nullptr);
+    m_PointSetNode = nullptr;
+    m_ImageNode = nullptr;
+    m_DataInteractor = nullptr;
+  }
+
+  void AddPointsBenchmark()
+  {
+    this->Benchmark(GetTestDataFilePath("InteractionTestData/Interactions/TestAddPoints.xml"));
+  }
+
+  void MoveRemovePointsBenchmark()
+  {
+    this->Benchmark(GetTestDataFilePath("InteractionTestData/Interactions/TestMoveRemovePoints.xml"));
+  }
+};
+
+MITK_TEST_SUITE_REGISTRATION(mitkInteractionBenchmark)
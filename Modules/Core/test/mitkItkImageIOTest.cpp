@@ -22,10 +22,14 @@ See LICENSE.txt or http://www.mitk.org for details.
 #include "mitkIOUtil.h"
 #include "mitkITKImageImport.h"
 #include <mitkExtractSliceFilter.h>
+#include <mitkImageReadAccessor.h>
+#include <mitkImageWriteAccessor.h>
 
 #include "itksys/SystemTools.hxx"
+#include <itkByteSwapper.h>
 #include <itkImageRegionIterator.h>
 
+#include <cstring>
 #include <fstream>
 #include <iostream>
 
@@ -47,6 +51,14 @@ class mitkItkImageIOTestSuite : public mitk::TestFixture
   MITK_TEST(TestWrite3DImageWithTwoPlanes);
   MITK_TEST(TestWrite3DplusT_ArbitraryTG);
   MITK_TEST(TestWrite3DplusT_ProportionalTG);
+  MITK_TEST(TestReadMemoryMappedNrrd);
+  MITK_TEST(TestReadUnalignedNrrd);
+  MITK_TEST(TestReadMemoryMappedNifti);
+  MITK_TEST(TestSaveMemoryMappedNrrdInPlace);
+  MITK_TEST(TestReadCompressedNrrdIsNotMemoryMapped);
+  MITK_TEST(TestSaveMemoryMappedNrrdKeepsFileAttributes);
+  MITK_TEST(TestWriteCompressionLevels);
+  MITK_TEST(TestWriteCompressedMultipleBlocks);
   CPPUNIT_TEST_SUITE_END();
 
 public:
@@ -422,6 +434,256 @@ public:
     CPPUNIT_ASSERT_THROW(mitk::IOUtil::Save(image, mitk::IOUtil::CreateTemporaryFile("3Dto2DTestImageXXXXXX.png")),
                          mitk::Exception);
   }
+
+  mitk::Image::Pointer CreateShortImage(unsigned int size)
+  {
+    typedef itk::Image<short, 3> ItkImageType;
+    ItkImageType::RegionType region;
+    region.SetSize(0, size);
+    region.SetSize(1, size);
+    region.SetSize(2, size);
+
+    ItkImageType::Pointer itkImage = ItkImageType::New();
+    itkImage->SetRegions(region);
+    itkImage->Allocate();
+
+    itk::ImageRegionIterator<ItkImageType> iter(itkImage, region);
+    for (int value = 0; !iter.IsAtEnd(); ++iter, value = (value + 7) % 30011)
+    {
+      iter.Set(static_cast<short>(value));
+    }
+
+    return mitk::GrabItkImageMemory(itkImage);
+  }
+
+  /** writes a raw encoded NRRD, the pixel data is aligned unless requested otherwise */
+  std::string WriteRawNrrd(const mitk::Image *image, bool aligned = true)
+  {
+    std::string header = "NRRD0004\n"
+                         "type: short\n"
+                         "dimension: 3\n"
+                         "sizes: " + std::to_string(image->GetDimension(0)) + " " + std::to_string(image->GetDimension(1)) + " " +
+                         std::to_string(image->GetDimension(2)) + "\n"
+                         "encoding: raw\n"
+                         "endian: " + std::string(itk::ByteSwapper<int>::SystemIsBigEndian() ? "big" : "little") + "\n\n";
+
+    // an additional (empty) comment shifts the data by one byte
+    if ((header.size() % sizeof(short) == 0) != aligned)
+    {
+      header.insert(header.find('\n') + 1, "# \n");
+    }
+
+    std::ofstream stream;
+    std::string path = mitk::IOUtil::CreateTemporaryFile(stream, std::ios_base::binary, "MappedImage-XXXXXX.nrrd");
+    mitk::ImageReadAccessor accessor(image);
+    stream << header;
+    stream.write(static_cast<const char *>(accessor.GetData()), image->GetPixelType().GetSize() * image->GetDimension(0) *
+                                                                  image->GetDimension(1) * image->GetDimension(2));
+    stream.close();
+    return path;
+  }
+
+  bool IsMemoryMapped(const mitk::Image *image) { return image->GetChannelData(0)->GetMemoryOwner() != nullptr; }
+
+  bool HaveEqualPixels(const mitk::Image *image, const mitk::Image *reference)
+  {
+    const std::size_t size = reference->GetPixelType().GetSize() * reference->GetDimension(0) *
+                             reference->GetDimension(1) * reference->GetDimension(2);
+    mitk::ImageReadAccessor imageAccessor(image);
+    mitk::ImageReadAccessor referenceAccessor(reference);
+    return image->GetPixelType() == reference->GetPixelType() &&
+           std::memcmp(imageAccessor.GetData(), referenceAccessor.GetData(), size) == 0;
+  }
+
+  void TestReadMemoryMappedNrrd()
+  {
+    mitk::Image::Pointer reference = CreateShortImage(32);
+    std::string path = WriteRawNrrd(reference);
+
+    mitk::Image::Pointer image = mitk::IOUtil::Load<mitk::Image>(path);
+    CPPUNIT_ASSERT_MESSAGE("Raw NRRD is memory mapped", IsMemoryMapped(image));
+    CPPUNIT_ASSERT_MESSAGE("Memory mapped NRRD has the written pixel values", HaveEqualPixels(image, reference));
+
+    // modifications are private to the image and are not written back to the file
+    {
+      mitk::ImageWriteAccessor accessor(image);
+      std::memset(accessor.GetData(), 0, 1024);
+    }
+    CPPUNIT_ASSERT(!HaveEqualPixels(image, reference));
+
+    mitk::Image::Pointer reloadedImage = mitk::IOUtil::Load<mitk::Image>(path);
+    CPPUNIT_ASSERT_MESSAGE("File is unchanged by modifications of the mapped image", HaveEqualPixels(reloadedImage, reference));
+
+    std::remove(path.c_str());
+  }
+
+  void TestReadUnalignedNrrd()
+  {
+    mitk::Image::Pointer reference = CreateShortImage(32);
+    std::string path = WriteRawNrrd(reference, false);
+
+    mitk::Image::Pointer image = mitk::IOUtil::Load<mitk::Image>(path);
+    CPPUNIT_ASSERT_MESSAGE("Unaligned pixel data is read into memory", !IsMemoryMapped(image));
+    CPPUNIT_ASSERT(HaveEqualPixels(image, reference));
+
+    std::remove(path.c_str());
+  }
+
+  void TestReadMemoryMappedNifti()
+  {
+    mitk::Image::Pointer reference = CreateShortImage(32);
+    std::string path = mitk::IOUtil::CreateTemporaryFile("MappedImage-XXXXXX.nii");
+    mitk::IOUtil::Save(reference, path);
+
+    mitk::Image::Pointer image = mitk::IOUtil::Load<mitk::Image>(path);
+    CPPUNIT_ASSERT_MESSAGE("Uncompressed NIfTI is memory mapped", IsMemoryMapped(image));
+    CPPUNIT_ASSERT(HaveEqualPixels(image, reference));
+
+    std::remove(path.c_str());
+  }
+
+  void TestSaveMemoryMappedNrrdInPlace()
+  {
+    mitk::Image::Pointer reference = CreateShortImage(32);
+    std::string path = WriteRawNrrd(reference);
+
+    for (int level : {0, 1})
+    {
+      mitk::Image::Pointer image = mitk::IOUtil::Load<mitk::Image>(path);
+      CPPUNIT_ASSERT(IsMemoryMapped(image));
+
+      mitk::IFileWriter::Options options;
+      options["Compression level"] = level;
+      mitk::IOUtil::Save(image, path, options);
+
+      CPPUNIT_ASSERT_MESSAGE("Memory mapped image is still valid after saving it to its own file",
+                             HaveEqualPixels(image, reference));
+      CPPUNIT_ASSERT_MESSAGE("Image saved to its own file can be reloaded",
+                             HaveEqualPixels(mitk::IOUtil::Load<mitk::Image>(path), reference));
+    }
+
+    std::remove(path.c_str());
+  }
+
+  void TestReadCompressedNrrdIsNotMemoryMapped()
+  {
+    mitk::Image::Pointer reference = CreateShortImage(32);
+    std::string path = mitk::IOUtil::CreateTemporaryFile("CompressedImage-XXXXXX.nrrd");
+    mitk::IOUtil::Save(reference, path);
+
+    mitk::Image::Pointer image = mitk::IOUtil::Load<mitk::Image>(path);
+    CPPUNIT_ASSERT_MESSAGE("Compressed NRRD is read into memory", !IsMemoryMapped(image));
+    CPPUNIT_ASSERT(HaveEqualPixels(image, reference));
+
+    std::remove(path.c_str());
+  }
+
+  /** saving over a memory mapped file replaces the file by a new one, which must look like the old one */
+  void TestSaveMemoryMappedNrrdKeepsFileAttributes()
+  {
+    mitk::Image::Pointer reference = CreateShortImage(32);
+    std::string path = WriteRawNrrd(reference);
+    std::string savePath = path;
+
+#ifndef WIN32
+    const mode_t permissions = 0640;
+    CPPUNIT_ASSERT(itksys::SystemTools::SetPermissions(path, permissions));
+
+    // the image is saved through a symbolic link, which must still point to the replaced file afterwards
+    savePath = path + ".link.nrrd";
+    CPPUNIT_ASSERT_EQUAL(0, symlink(path.c_str(), savePath.c_str()));
+#endif
+
+    mitk::Image::Pointer image = mitk::IOUtil::Load<mitk::Image>(savePath);
+    CPPUNIT_ASSERT(IsMemoryMapped(image));
+
+    mitk::IFileWriter::Options options;
+    options["Compression level"] = 1;
+    mitk::IOUtil::Save(image, savePath, options);
+
+    CPPUNIT_ASSERT_MESSAGE("Memory mapped image is still valid after saving it", HaveEqualPixels(image, reference));
+    CPPUNIT_ASSERT_MESSAGE("Replaced file has the saved image",
+                           HaveEqualPixels(mitk::IOUtil::Load<mitk::Image>(path), reference));
+
+#ifndef WIN32
+    mode_t replacedPermissions = 0;
+    CPPUNIT_ASSERT(itksys::SystemTools::GetPermissions(path, replacedPermissions));
+    CPPUNIT_ASSERT_EQUAL_MESSAGE(
+      "Replaced file keeps its permissions", permissions, static_cast<mode_t>(replacedPermissions & 0777));
+    CPPUNIT_ASSERT_MESSAGE("Symbolic link is kept", itksys::SystemTools::FileIsSymlink(savePath));
+    std::remove(savePath.c_str());
+#endif
+    std::remove(path.c_str());
+  }
+
+  std::string SaveWithCompressionLevel(const mitk::Image *image, const std::string &extension, int level)
+  {
+    mitk::IFileWriter::Options options;
+    options["Compression level"] = level;
+    std::string path = mitk::IOUtil::CreateTemporaryFile("CompressedImage-XXXXXX" + extension);
+    mitk::IOUtil::Save(image, path, options);
+    return path;
+  }
+
+  void TestWriteCompressionLevels()
+  {
+    mitk::Image::Pointer reference = CreateShortImage(64);
+
+    for (const std::string extension : {".nrrd", ".mha"})
+    {
+      std::string rawPath = SaveWithCompressionLevel(reference, extension, 0);
+      std::string fastPath = SaveWithCompressionLevel(reference, extension, 1);
+      std::string smallPath = SaveWithCompressionLevel(reference, extension, 9);
+
+      mitk::Image::Pointer rawImage = mitk::IOUtil::Load<mitk::Image>(rawPath);
+      CPPUNIT_ASSERT_MESSAGE("Compression level 0 writes raw data", IsMemoryMapped(rawImage));
+      CPPUNIT_ASSERT(HaveEqualPixels(rawImage, reference));
+      CPPUNIT_ASSERT_MESSAGE("Image compressed with level 1 can be read",
+                             HaveEqualPixels(mitk::IOUtil::Load<mitk::Image>(fastPath), reference));
+      CPPUNIT_ASSERT_MESSAGE("Image compressed with level 9 can be read",
+                             HaveEqualPixels(mitk::IOUtil::Load<mitk::Image>(smallPath), reference));
+
+      const auto rawSize = itksys::SystemTools::FileLength(rawPath);
+      const auto fastSize = itksys::SystemTools::FileLength(fastPath);
+      const auto smallSize = itksys::SystemTools::FileLength(smallPath);
+      CPPUNIT_ASSERT(fastSize < rawSize);
+      CPPUNIT_ASSERT(smallSize <= fastSize);
+
+      std::remove(rawPath.c_str());
+      std::remove(fastPath.c_str());
+      std::remove(smallPath.c_str());
+    }
+
+    CPPUNIT_ASSERT_THROW(SaveWithCompressionLevel(reference, ".nrrd", 10), mitk::Exception);
+  }
+
+  /** the pixel data of the image is compressed in several blocks of 1 MiB */
+  void TestWriteCompressedMultipleBlocks()
+  {
+    mitk::Image::Pointer reference = CreateShortImage(160);
+    mitk::Vector3D spacing;
+    mitk::FillVector3D(spacing, 0.5, 0.75, 2.0);
+    mitk::Point3D origin;
+    mitk::FillVector3D(origin, -10.0, 20.0, 30.0);
+    reference->GetGeometry()->SetSpacing(spacing);
+    reference->GetGeometry()->SetOrigin(origin);
+
+    for (const std::string extension : {".nrrd", ".mha"})
+    {
+      for (int level : {1, 9})
+      {
+        std::string path = SaveWithCompressionLevel(reference, extension, level);
+        mitk::Image::Pointer image = mitk::IOUtil::Load<mitk::Image>(path);
+        CPPUNIT_ASSERT_MESSAGE("Header has the size of the image",
+                               image->GetDimension(0) == 160 && image->GetDimension(1) == 160 &&
+                                 image->GetDimension(2) == 160);
+        CPPUNIT_ASSERT_MESSAGE("Header has the geometry of the image",
+                               mitk::Equal(*image->GetGeometry(), *reference->GetGeometry(), mitk::eps, true));
+        CPPUNIT_ASSERT_MESSAGE("Image compressed in several blocks can be read", HaveEqualPixels(image, reference));
+        std::remove(path.c_str());
+      }
+    }
+  }
 };
 
 MITK_TEST_SUITE_REGISTRATION(mitkItkImageIO)
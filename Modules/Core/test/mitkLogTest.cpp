@@ -22,6 +22,12 @@ See LICENSE.txt or http://www.mitk.org for details.
 #include <mitkNumericTypes.h>
 #include <mitkStandardFileLocations.h>
 
+#include <atomic>
+#include <chrono>
+#include <fstream>
+#include <thread>
+#include <vector>
+
 /** Documentation
  *
  * @brief this class provides an accessible BackendCout to determine whether this backend was
@@ -276,6 +282,137 @@ public:
     // to mbilog utility one may add this test.
   }
 
+  static void TestAsynchronousLogging(bool asynchronous)
+  {
+    const unsigned int numberOfThreads = 8;
+    const unsigned int messagesPerThread = 10000;
+
+    std::string filename = mitk::StandardFileLocations::GetInstance()->GetOptionDirectory() + "/testasynclog.log";
+    itksys::SystemTools::RemoveFile(filename.c_str());
+
+    mitk::LoggingBackend::Register();
+    mitk::LoggingBackend::SetAsynchronous(asynchronous);
+    mitk::LoggingBackend::SetLogFile(filename.c_str());
+
+    const unsigned long droppedBefore = mitk::LoggingBackend::GetNumberOfDroppedMessages();
+    const auto start = std::chrono::steady_clock::now();
+
+    std::vector<std::thread> threads;
+    for (unsigned int threadIdx = 0; threadIdx < numberOfThreads; ++threadIdx)
+    {
+      threads.emplace_back([threadIdx]() {
+        for (unsigned int i = 0; i < messagesPerThread; ++i)
+        {
+          MITK_INFO << "Asynchronous logging benchmark message " << i << " from thread " << threadIdx;
+        }
+      });
+    }
+    for (auto &thread : threads)
+    {
+      thread.join();
+    }
+
+    const auto loggingTime = std::chrono::steady_clock::now() - start;
+    mitk::LoggingBackend::Flush();
+
+    const unsigned long dropped = mitk::LoggingBackend::GetNumberOfDroppedMessages() - droppedBefore;
+
+    const double seconds = std::chrono::duration<double>(loggingTime).count();
+    MITK_TEST_OUTPUT(<< (asynchronous ? "Asynchronous" : "Synchronous") << " logging from " << numberOfThreads
+                     << " threads: " << static_cast<unsigned long>(numberOfThreads * messagesPerThread / seconds)
+                     << " messages per second, " << dropped << " dropped")
+
+    // close the log file before it is read
+    mitk::LoggingBackend::Unregister();
+    mitk::LoggingBackend::SetAsynchronous(true);
+
+    unsigned long writtenMessages = 0;
+    std::ifstream logFile(filename.c_str());
+    std::string line;
+    while (std::getline(logFile, line))
+    {
+      if (line.find("Asynchronous logging benchmark message") != std::string::npos)
+        ++writtenMessages;
+    }
+
+    MITK_TEST_CONDITION_REQUIRED(writtenMessages + dropped == numberOfThreads * messagesPerThread,
+                                 "Test that every message is either written or counted as dropped.");
+    if (!asynchronous)
+    {
+      MITK_TEST_CONDITION_REQUIRED(dropped == 0, "Test that synchronous logging drops no messages.");
+    }
+  }
+
+  /** errors are never dropped and no message gets lost while the writer thread is stopped and restarted */
+  static void TestAsynchronousSwitching()
+  {
+    const unsigned int numberOfThreads = 8;
+    const unsigned int messagesPerThread = 10000;
+    const unsigned int errorInterval = 100;
+
+    std::string filename = mitk::StandardFileLocations::GetInstance()->GetOptionDirectory() + "/testasyncswitch.log";
+    itksys::SystemTools::RemoveFile(filename.c_str());
+
+    mitk::LoggingBackend::Register();
+    mitk::LoggingBackend::SetAsynchronous(true);
+    mitk::LoggingBackend::SetLogFile(filename.c_str());
+
+    const unsigned long droppedBefore = mitk::LoggingBackend::GetNumberOfDroppedMessages();
+
+    std::atomic<bool> logging(true);
+    std::thread switcher([&logging]() {
+      for (bool enable = false; logging; enable = !enable)
+      {
+        mitk::LoggingBackend::SetAsynchronous(enable);
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+      }
+    });
+
+    std::vector<std::thread> threads;
+    for (unsigned int threadIdx = 0; threadIdx < numberOfThreads; ++threadIdx)
+    {
+      threads.emplace_back([threadIdx]() {
+        for (unsigned int i = 0; i < messagesPerThread; ++i)
+        {
+          if (i % errorInterval == 0)
+            MITK_ERROR << "Asynchronous switching error message " << i << " from thread " << threadIdx;
+          else
+            MITK_INFO << "Asynchronous switching message " << i << " from thread " << threadIdx;
+        }
+      });
+    }
+    for (auto &thread : threads)
+    {
+      thread.join();
+    }
+
+    logging = false;
+    switcher.join();
+    mitk::LoggingBackend::Flush();
+
+    const unsigned long dropped = mitk::LoggingBackend::GetNumberOfDroppedMessages() - droppedBefore;
+
+    mitk::LoggingBackend::Unregister();
+    mitk::LoggingBackend::SetAsynchronous(true);
+
+    unsigned long writtenMessages = 0;
+    unsigned long writtenErrors = 0;
+    std::ifstream logFile(filename.c_str());
+    std::string line;
+    while (std::getline(logFile, line))
+    {
+      if (line.find("Asynchronous switching message") != std::string::npos)
+        ++writtenMessages;
+      else if (line.find("Asynchronous switching error message") != std::string::npos)
+        ++writtenErrors;
+    }
+
+    const unsigned long numberOfErrors = numberOfThreads * messagesPerThread / errorInterval;
+    MITK_TEST_CONDITION_REQUIRED(writtenErrors == numberOfErrors, "Test that error messages are never dropped.");
+    MITK_TEST_CONDITION_REQUIRED(writtenMessages + dropped == numberOfThreads * messagesPerThread - numberOfErrors,
+                                 "Test that no message is lost while switching the asynchronous logging.");
+  }
+
   static void TestEnableDisableBackends()
   {
     TestBackendCout myCoutBackend = TestBackendCout();
@@ -309,6 +446,9 @@ int mitkLogTest(int /* argc */, char * /*argv*/ [])
   mitkLogTestClass::TestThreadSaveLog(false); // false = to console
   mitkLogTestClass::TestThreadSaveLog(true);  // true = to file
   mitkLogTestClass::TestEnableDisableBackends();
+  mitkLogTestClass::TestAsynchronousLogging(false);
+  mitkLogTestClass::TestAsynchronousLogging(true);
+  mitkLogTestClass::TestAsynchronousSwitching();
   // TODO actually test file somehow?
 
   // always end with this!
@@ -0,0 +1,170 @@
+/*===================================================================
+
+The Medical Imaging Interaction Toolkit (MITK)
+
+Copyright (c) German Cancer Research Center,
+Division of Medical and Biological Informatics.
+All rights reserved.
+
+This software is distributed WITHOUT ANY WARRANTY; without
+even the implied warranty of MERCHANTABILITY or FITNESS FOR
+A PARTICULAR PURPOSE.
+
+See LICENSE.txt or http://www.mitk.org for details.
+
+===================================================================*/
+
+// MITK
+#include <mitkRenderingManager.h>
+#include <mitkRenderingTestHelper.h>
+#include <mitkSurface.h>
+#include <mitkSurfaceVtkMapper3D.h>
+#include <mitkTestFixture.h>
+#include <mitkTestingMacros.h>
+
+// VTK
+#include <vtkSmartPointer.h>
+#include <vtkSphereSource.h>
+
+namespace
+{
+  /** surface mapper which makes the RenderingManager use level of detail for its renderer */
+  class LODEnabledSurfaceMapper : public mitk::SurfaceVtkMapper3D
+  {
+  public:
+    mitkClassMacro(LODEnabledSurfaceMapper, mitk::SurfaceVtkMapper3D);
+    itkFactorylessNewMacro(Self);
+
+    bool IsLODEnabled(mitk::BaseRenderer *) const override { return true; }
+  };
+}
+
+class mitkRenderingStatisticsRenderingTestSuite : public mitk::TestFixture
+{
+  CPPUNIT_TEST_SUITE(mitkRenderingStatisticsRenderingTestSuite);
+  MITK_TEST(RecordMapperStatistics);
+  MITK_TEST(RemoveStatisticsOfRemovedNodes);
+  MITK_TEST(KeepHighResolutionWithinFrameTimeBudget);
+  CPPUNIT_TEST_SUITE_END();
+
+private:
+  mitk::RenderingTestHelper m_RenderingTestHelper;
+  mitk::BaseRenderer *m_Renderer;
+
+  mitk::DataNode::Pointer CreateSphereNode(const std::string &name, double radius)
+  {
+    auto sphere = vtkSmartPointer<vtkSphereSource>::New();
+    sphere->SetRadius(radius);
+    sphere->SetThetaResolution(32);
+    sphere->SetPhiResolution(32);
+    sphere->Update();
+
+    mitk::Surface::Pointer surface = mitk::Surface::New();
+    surface->SetVtkPolyData(sphere->GetOutput());
+
+    mitk::DataNode::Pointer node = mitk::DataNode::New();
+    node->SetName(name);
+    node->SetData(surface);
+    return node;
+  }
+
+  const mitk::Mapper *GetMapper(mitk::DataNode *node) { return node->GetMapper(mitk::BaseRenderer::Standard3D); }
+
+  bool HasStatistics(mitk::DataNode *node)
+  {
+    const auto &statistics = m_Renderer->GetMapperRenderingStatistics();
+    return statistics.find(GetMapper(node)) != statistics.end();
+  }
+
+public:
+  mitkRenderingStatisticsRenderingTestSuite() : m_RenderingTestHelper(640, 480), m_Renderer(nullptr) {}
+
+  void setUp() override
+  {
+    m_RenderingTestHelper = mitk::RenderingTestHelper(640, 480);
+    m_RenderingTestHelper.SetMapperID(mitk::BaseRenderer::Standard3D);
+    m_Renderer = mitk::BaseRenderer::GetInstance(m_RenderingTestHelper.GetVtkRenderWindow());
+  }
+
+  void tearDown() override
+  {
+    mitk::RenderingManager::GetInstance()->SetLODFrameTimeBudget(0.0);
+    m_Renderer = nullptr;
+  }
+
+  void RecordMapperStatistics()
+  {
+    mitk::DataNode::Pointer node = CreateSphereNode("sphere", 10.0);
+    m_RenderingTestHelper.AddNodeToStorage(node);
+
+    m_RenderingTestHelper.Render();
+    CPPUNIT_ASSERT_MESSAGE("Statistics are disabled by default", m_Renderer->GetMapperRenderingStatistics().empty());
+
+    m_Renderer->RenderingStatisticsEnabledOn();
+    m_RenderingTestHelper.Render();
+    m_RenderingTestHelper.Render();
+
+    CPPUNIT_ASSERT_MESSAGE("Statistics contain the mapper of the rendered node", HasStatistics(node));
+
+    const mitk::MapperRenderingStatistics &statistics =
+      m_Renderer->GetMapperRenderingStatistics().find(GetMapper(node))->second;
+    CPPUNIT_ASSERT_EQUAL(std::string("sphere"), statistics.NodeName);
+    CPPUNIT_ASSERT_EQUAL(std::string(GetMapper(node)->GetNameOfClass()), statistics.MapperClassName);
+    CPPUNIT_ASSERT_MESSAGE("Update time is recorded in every frame", statistics.UpdateTime.GetNumberOfSamples() >= 2);
+    CPPUNIT_ASSERT_MESSAGE("Render time is recorded in every frame", statistics.RenderTime.GetNumberOfSamples() >= 2);
+    CPPUNIT_ASSERT(statistics.RenderTime.GetMaximum() >= statistics.RenderTime.GetMean());
+    CPPUNIT_ASSERT(m_Renderer->GetFrameTimeStatistics().GetNumberOfSamples() >= 3);
+  }
+
+  void RemoveStatisticsOfRemovedNodes()
+  {
+    mitk::DataNode::Pointer removedNode = CreateSphereNode("removed", 10.0);
+    mitk::DataNode::Pointer remainingNode = CreateSphereNode("remaining", 5.0);
+    m_RenderingTestHelper.AddNodeToStorage(removedNode);
+    m_RenderingTestHelper.AddNodeToStorage(remainingNode);
+
+    m_Renderer->RenderingStatisticsEnabledOn();
+    m_RenderingTestHelper.Render();
+    CPPUNIT_ASSERT(HasStatistics(removedNode));
+    CPPUNIT_ASSERT(HasStatistics(remainingNode));
+
+    m_RenderingTestHelper.GetDataStorage()->Remove(removedNode);
+    m_RenderingTestHelper.Render();
+    CPPUNIT_ASSERT_MESSAGE("Statistics of mappers which are no longer rendered are removed",
+                           !HasStatistics(removedNode));
+    CPPUNIT_ASSERT_MESSAGE("Statistics of rendered mappers are kept", HasStatistics(remainingNode));
+    CPPUNIT_ASSERT_EQUAL(std::size_t(1), m_Renderer->GetMapperRenderingStatistics().size());
+  }
+
+  void KeepHighResolutionWithinFrameTimeBudget()
+  {
+    mitk::DataNode::Pointer node = CreateSphereNode("sphere", 10.0);
+    node->SetMapper(mitk::BaseRenderer::Standard3D, LODEnabledSurfaceMapper::New());
+    m_RenderingTestHelper.AddNodeToStorage(node);
+
+    auto renderingManager = mitk::RenderingManager::GetInstance();
+
+    // the first frame determines the number of LOD-enabled mappers
+    m_RenderingTestHelper.Render();
+    CPPUNIT_ASSERT_EQUAL(1u, m_Renderer->GetNumberOfVisibleLODEnabledMappers());
+    CPPUNIT_ASSERT_EQUAL(0, renderingManager->GetNextLOD(m_Renderer));
+
+    // a budget no frame exceeds keeps the renderer at the highest level of detail
+    renderingManager->SetLODFrameTimeBudget(1.0e6);
+    renderingManager->ExecutePendingHighResRenderingRequest();
+    CPPUNIT_ASSERT_EQUAL(1, renderingManager->GetNextLOD(m_Renderer));
+    m_RenderingTestHelper.Render();
+    CPPUNIT_ASSERT_MESSAGE("Fast high resolution frame keeps the highest level of detail",
+                           renderingManager->GetNextLOD(m_Renderer) == 1);
+    m_RenderingTestHelper.Render();
+    CPPUNIT_ASSERT(renderingManager->GetNextLOD(m_Renderer) == 1);
+
+    // without a budget every high resolution frame is followed by a low resolution one
+    renderingManager->SetLODFrameTimeBudget(0.0);
+    m_RenderingTestHelper.Render();
+    CPPUNIT_ASSERT_MESSAGE("Without budget the next frame is rendered at low resolution",
+                           renderingManager->GetNextLOD(m_Renderer) == 0);
+  }
+};
+
+MITK_TEST_SUITE_REGISTRATION(mitkRenderingStatisticsRendering)
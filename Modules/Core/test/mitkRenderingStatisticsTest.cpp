@@ -0,0 +1,84 @@
+/*===================================================================
+
+The Medical Imaging Interaction Toolkit (MITK)
+
+Copyright (c) German Cancer Research Center,
+Division of Medical and Biological Informatics.
+All rights reserved.
+
+This software is distributed WITHOUT ANY WARRANTY; without
+even the implied warranty of MERCHANTABILITY or FITNESS FOR
+A PARTICULAR PURPOSE.
+
+See LICENSE.txt or http://www.mitk.org for details.
+
+===================================================================*/
+
+#include "mitkRenderingStatistics.h"
+#include "mitkNumericConstants.h"
+
+#include "mitkTestFixture.h"
+#include "mitkTestingMacros.h"
+
+class mitkRenderingStatisticsTestSuite : public mitk::TestFixture
+{
+  CPPUNIT_TEST_SUITE(mitkRenderingStatisticsTestSuite);
+
+  MITK_TEST(Empty);
+  MITK_TEST(AddSamples);
+  MITK_TEST(RollingWindow);
+  MITK_TEST(Clear);
+
+  CPPUNIT_TEST_SUITE_END();
+
+public:
+  void Empty()
+  {
+    mitk::RollingTimeStatistics statistics;
+
+    CPPUNIT_ASSERT_EQUAL(0ul, statistics.GetNumberOfSamples());
+    CPPUNIT_ASSERT_EQUAL(0.0, statistics.GetLast());
+    CPPUNIT_ASSERT_EQUAL(0.0, statistics.GetMean());
+    CPPUNIT_ASSERT_EQUAL(0.0, statistics.GetMaximum());
+  }
+
+  void AddSamples()
+  {
+    mitk::RollingTimeStatistics statistics;
+    statistics.AddSample(2.0);
+    statistics.AddSample(6.0);
+    statistics.AddSample(1.0);
+
+    CPPUNIT_ASSERT_EQUAL(3ul, statistics.GetNumberOfSamples());
+    CPPUNIT_ASSERT_EQUAL(1.0, statistics.GetLast());
+    CPPUNIT_ASSERT_DOUBLES_EQUAL(3.0, statistics.GetMean(), mitk::eps);
+    CPPUNIT_ASSERT_EQUAL(6.0, statistics.GetMaximum());
+  }
+
+  void RollingWindow()
+  {
+    mitk::RollingTimeStatistics statistics;
+
+    // the large first duration has to drop out of the window
+    statistics.AddSample(100.0);
+    for (unsigned int i = 0; i < mitk::RollingTimeStatistics::WindowSize; ++i)
+      statistics.AddSample(4.0);
+
+    CPPUNIT_ASSERT_EQUAL(mitk::RollingTimeStatistics::WindowSize + 1ul, statistics.GetNumberOfSamples());
+    CPPUNIT_ASSERT_EQUAL(4.0, statistics.GetLast());
+    CPPUNIT_ASSERT_DOUBLES_EQUAL(4.0, statistics.GetMean(), mitk::eps);
+    CPPUNIT_ASSERT_EQUAL(4.0, statistics.GetMaximum());
+  }
+
+  void Clear()
+  {
+    mitk::RollingTimeStatistics statistics;
+    statistics.AddSample(5.0);
+    statistics.Clear();
+
+    CPPUNIT_ASSERT_EQUAL(0ul, statistics.GetNumberOfSamples());
+    CPPUNIT_ASSERT_EQUAL(0.0, statistics.GetMean());
+  }
+};
+
+MITK_TEST_SUITE_REGISTRATION(mitkRenderingStatistics)
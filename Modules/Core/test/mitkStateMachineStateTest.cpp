@@ -0,0 +1,93 @@
+/*===================================================================
+
+ The Medical Imaging Interaction Toolkit (MITK)
+
+ Copyright (c) German Cancer Research Center,
+ Division of Medical and Biological Informatics.
+ All rights reserved.
+
+ This software is distributed WITHOUT ANY WARRANTY; without
+ even the implied warranty of MERCHANTABILITY or FITNESS FOR
+ A PARTICULAR PURPOSE.
+
+ See LICENSE.txt or http://www.mitk.org for details.
+
+ ===================================================================*/
+
+#include "mitkStateMachineState.h"
+#include "mitkStateMachineTransition.h"
+#include "mitkTestFixture.h"
+#include "mitkTestingMacros.h"
+
+class mitkStateMachineStateTestSuite : public mitk::TestFixture
+{
+  CPPUNIT_TEST_SUITE(mitkStateMachineStateTestSuite);
+  MITK_TEST(GetTransitionList_MatchesClassAndVariant);
+  MITK_TEST(GetTransitionList_MatchesSubclassEvents);
+  MITK_TEST(AddTransition_UpdatesTransitionList);
+  CPPUNIT_TEST_SUITE_END();
+
+private:
+  mitk::StateMachineState::Pointer m_State;
+
+public:
+  void setUp() override { m_State = mitk::StateMachineState::New("start", "REGULAR"); }
+
+  void tearDown() override { m_State = nullptr; }
+
+  void GetTransitionList_MatchesClassAndVariant()
+  {
+    mitk::StateMachineTransition::Pointer press = mitk::StateMachineTransition::New("next", "MousePressEvent", "Press");
+    mitk::StateMachineTransition::Pointer release =
+      mitk::StateMachineTransition::New("next", "MouseReleaseEvent", "Release");
+    m_State->AddTransition(press);
+    m_State->AddTransition(release);
+
+    const mitk::StateMachineState::TransitionVector &transitions =
+      m_State->GetTransitionList("MousePressEvent", "Press");
+    CPPUNIT_ASSERT_EQUAL(std::size_t(1), transitions.size());
+    CPPUNIT_ASSERT(transitions[0] == press);
+
+    CPPUNIT_ASSERT_MESSAGE("Variant must match", m_State->GetTransitionList("MousePressEvent", "Release").empty());
+    CPPUNIT_ASSERT_MESSAGE("Repeated lookup returns the same result",
+                           m_State->GetTransitionList("MousePressEvent", "Release").empty());
+    CPPUNIT_ASSERT_EQUAL(std::size_t(1), m_State->GetTransitionList("MousePressEvent", "Press").size());
+  }
+
+  void GetTransitionList_MatchesSubclassEvents()
+  {
+    mitk::StateMachineTransition::Pointer mouseEvent =
+      mitk::StateMachineTransition::New("next", "InteractionPositionEvent", "Position");
+    m_State->AddTransition(mouseEvent);
+
+    const mitk::StateMachineState::TransitionVector &transitions =
+      m_State->GetTransitionList("MouseMoveEvent", "Position");
+    CPPUNIT_ASSERT_EQUAL(std::size_t(1), transitions.size());
+    CPPUNIT_ASSERT(transitions[0] == mouseEvent);
+  }
+
+  void AddTransition_UpdatesTransitionList()
+  {
+    mitk::StateMachineTransition::Pointer first = mitk::StateMachineTransition::New("next", "MousePressEvent", "Press");
+    m_State->AddTransition(first);
+    CPPUNIT_ASSERT_EQUAL(std::size_t(1), m_State->GetTransitionList("MousePressEvent", "Press").size());
+    CPPUNIT_ASSERT(m_State->GetTransitionList("MouseMoveEvent", "Move").empty());
+
+    // both lookups were compiled into the transition table, adding a transition has to clear it
+    mitk::StateMachineTransition::Pointer second =
+      mitk::StateMachineTransition::New("other", "MousePressEvent", "Press");
+    mitk::StateMachineTransition::Pointer move = mitk::StateMachineTransition::New("next", "MouseMoveEvent", "Move");
+    CPPUNIT_ASSERT(m_State->AddTransition(second));
+    CPPUNIT_ASSERT(m_State->AddTransition(move));
+    CPPUNIT_ASSERT_MESSAGE("Adding a transition twice is rejected", !m_State->AddTransition(move));
+
+    const mitk::StateMachineState::TransitionVector &transitions =
+      m_State->GetTransitionList("MousePressEvent", "Press");
+    CPPUNIT_ASSERT_EQUAL(std::size_t(2), transitions.size());
+    CPPUNIT_ASSERT(transitions[0] == first);
+    CPPUNIT_ASSERT(transitions[1] == second);
+    CPPUNIT_ASSERT_EQUAL(std::size_t(1), m_State->GetTransitionList("MouseMoveEvent", "Move").size());
+  }
+};
+
+MITK_TEST_SUITE_REGISTRATION(mitkStateMachineState)
@@ -152,6 +152,49 @@ public:
    */
   static const std::string& PROP_AUTOLOADED_MODULES();
 
+  /**
+   * Returns the property key with a value of \c module.activation_policy for
+   * looking up this module's activation policy.
+   * The property value is of type \c std::string and is either \c eager
+   * (the default) or \c lazy. A lazy module is activated on the first request
+   * of one of the interfaces listed in PROP_PROVIDED_INTERFACES(), provided
+   * that lazy activation is enabled in ModuleSettings.
+   *
+   * @return The activation policy property key.
+   */
+  static const std::string& PROP_ACTIVATION_POLICY();
+
+  /**
+   * Returns the property key with a value of \c module.provided_interfaces for
+   * looking up the service interfaces registered by this module's activator.
+   * The property value is a list of interface ids.
+   *
+   * @return The provided interfaces property key.
+   */
+  static const std::string& PROP_PROVIDED_INTERFACES();
+
+  /**
+   * Returns the property key with a value of \c module.load_time for
+   * looking up the time it took to auto-load this module's shared library,
+   * including its static initialization and, unless the module is activated
+   * lazily, its activation.
+   * The property value is of type \c long \c long in microseconds and only
+   * set for auto-loaded modules.
+   *
+   * @return The load time property key.
+   */
+  static const std::string& PROP_LOAD_TIME();
+
+  /**
+   * Returns the property key with a value of \c module.activation_time for
+   * looking up the time spent in this module's ModuleActivator::Load method.
+   * The property value is of type \c long \c long in microseconds and only
+   * set for activated modules with an activator.
+   *
+   * @return The activation time property key.
+   */
+  static const std::string& PROP_ACTIVATION_TIME();
+
   ~Module();
 
   /**
@@ -165,6 +208,18 @@ public:
    */
   bool IsLoaded() const;
 
+  /**
+   * Returns whether this module's activator has been run.
+   *
+   * <p>
+   * A loaded module with a lazy activation policy is not activated until
+   * one of its provided interfaces is requested.
+   *
+   * @return <code>true</code> if the module is loaded and its activation
+   *         is not pending, <code>false</code> otherwise.
+   */
+  bool IsActivated() const;
+
   /**
    * Returns this module's {@link ModuleContext}. The returned
    * <code>ModuleContext</code> can be used by the caller to act on behalf
@@ -97,6 +97,27 @@ public:
    */
   static void SetAutoLoadingEnabled(bool enable);
 
+  /**
+   * \return \c true if modules with a lazy activation policy are activated
+   * on the first request of one of their provided interfaces, \c false if
+   * all modules are activated when they are loaded.
+   *
+   * \remarks Lazy activation is disabled by default. It can also be enabled
+   * by defining the US_ENABLE_LAZY_ACTIVATION environment variable.
+   *
+   * \sa Module::PROP_ACTIVATION_POLICY()
+   */
+  static bool IsLazyActivationEnabled();
+
+  /**
+   * Enable or disable lazy module activation.
+   *
+   * \param enable If \c true, enable lazy activation, disable it otherwise.
+   *
+   * \remarks The setting only affects modules loaded afterwards.
+   */
+  static void SetLazyActivationEnabled(bool enable);
+
   /**
    * \return A list of paths in the file-system from which modules will be
    * auto-loaded.
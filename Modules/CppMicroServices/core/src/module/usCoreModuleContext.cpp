@@ -25,6 +25,11 @@
 US_MSVC_DISABLE_WARNING(4355)
 
 #include "usCoreModuleContext_p.h"
+#include "usLDAPExpr_p.h"
+#include "usModulePrivate.h"
+
+#include <algorithm>
+#include <stdexcept>
 
 US_BEGIN_NAMESPACE
 
@@ -33,6 +38,7 @@ CoreModuleContext::CoreModuleContext()
   , services(this)
   , serviceHooks(this)
   , moduleHooks(this)
+  , lazyModuleCount(0)
 {
 }
 
@@ -50,4 +56,106 @@ void CoreModuleContext::Uninit()
   serviceHooks.Close();
 }
 
+void CoreModuleContext::AddLazyModule(ModulePrivate* module, const std::vector<std::string>& interfaces)
+{
+  std::lock_guard<std::mutex> lock(lazyModulesMutex);
+  for (std::vector<std::string>::const_iterator i = interfaces.begin(); i != interfaces.end(); ++i)
+  {
+    lazyModules[*i].push_back(module);
+  }
+  ++lazyModuleCount;
+}
+
+void CoreModuleContext::RemoveLazyModule(ModulePrivate* module)
+{
+  std::lock_guard<std::mutex> lock(lazyModulesMutex);
+  bool removed = false;
+  for (MapInterfaceModules::iterator i = lazyModules.begin(); i != lazyModules.end();)
+  {
+    std::vector<ModulePrivate*>& modules = i->second;
+    std::vector<ModulePrivate*>::iterator end = std::remove(modules.begin(), modules.end(), module);
+    if (end != modules.end())
+    {
+      removed = true;
+      modules.erase(end, modules.end());
+    }
+
+    if (modules.empty())
+    {
+      i = lazyModules.erase(i);
+    }
+    else
+    {
+      ++i;
+    }
+  }
+
+  if (removed)
+  {
+    --lazyModuleCount;
+  }
+}
+
+void CoreModuleContext::ActivateLazyModules(const std::string& clazz, const std::string& filter)
+{
+  // Most lookups happen when no module waits for its activation
+  if (lazyModuleCount.load() == 0)
+  {
+    return;
+  }
+
+  LDAPExpr::ObjectClassSet classes;
+  bool hasClasses = false;
+  if (clazz.empty() && !filter.empty())
+  {
+    try
+    {
+      hasClasses = LDAPExpr(filter).GetMatchedObjectClasses(classes);
+    }
+    catch (const std::invalid_argument&)
+    {
+      // the invalid filter is reported by the service registry
+      return;
+    }
+  }
+
+  std::vector<ModulePrivate*> modules;
+  {
+    std::lock_guard<std::mutex> lock(lazyModulesMutex);
+
+    if (!clazz.empty())
+    {
+      MapInterfaceModules::const_iterator i = lazyModules.find(clazz);
+      if (i != lazyModules.end())
+      {
+        modules = i->second;
+      }
+    }
+    else
+    {
+      for (MapInterfaceModules::const_iterator i = lazyModules.begin(); i != lazyModules.end(); ++i)
+      {
+        if (!hasClasses || classes.count(i->first) > 0)
+        {
+          modules.insert(modules.end(), i->second.begin(), i->second.end());
+        }
+      }
+
+      // a module providing several of the classes is activated once
+      std::sort(modules.begin(), modules.end());
+      modules.erase(std::unique(modules.begin(), modules.end()), modules.end());
+    }
+  }
+
+  // The activators run without holding the lock, since they register services
+  // and request other services themselves. A module stays in lazyModules until
+  // its activator returned, so concurrent requests find it and wait for it in
+  // ModulePrivate::ActivateLazily().
+  for (std::vector<ModulePrivate*>::const_iterator module = modules.begin(); module != modules.end(); ++module)
+  {
+    US_DEBUG << "Lazily activating module " << (*module)->info.name << " for " << (clazz.empty() ? filter : clazz);
+    (*module)->ActivateLazily();
+  }
+}
+
 US_END_NAMESPACE
@@ -28,8 +28,13 @@
 #include "usModuleHooks_p.h"
 #include "usServiceHooks_p.h"
 
+#include <atomic>
+#include <mutex>
+
 US_BEGIN_NAMESPACE
 
+class ModulePrivate;
+
 /**
  * This class is not part of the public API.
  */
@@ -69,6 +74,45 @@ public:
 
   void Uninit();
 
+  /**
+   * Defers the activation of a loaded module until one of the given
+   * interfaces is requested.
+   */
+  void AddLazyModule(ModulePrivate* module, const std::vector<std::string>& interfaces);
+
+  /**
+   * Removes a module from the modules waiting for lazy activation.
+   */
+  void RemoveLazyModule(ModulePrivate* module);
+
+  /**
+   * Activates the modules waiting for a request of <code>clazz</code>,
+   * or of the classes matched by <code>filter</code> if <code>clazz</code>
+   * is empty.
+   */
+  void ActivateLazyModules(const std::string& clazz, const std::string& filter);
+
+private:
+
+  typedef US_UNORDERED_MAP_TYPE<std::string, std::vector<ModulePrivate*> > MapInterfaceModules;
+
+  /**
+   * Modules waiting for lazy activation, by provided interface.
+   */
+  MapInterfaceModules lazyModules;
+
+  /**
+   * Number of modules in lazyModules. Checked without locking, so that
+   * service lookups do not contend for lazyModulesMutex once every lazy
+   * module was activated.
+   */
+  std::atomic<std::size_t> lazyModuleCount;
+
+  /**
+   * Protects lazyModules. It is never held while a module activator runs.
+   */
+  std::mutex lazyModulesMutex;
+
 };
 
 US_END_NAMESPACE
@@ -26,11 +26,14 @@
 #include "usModuleActivator.h"
 #include "usModulePrivate.h"
 #include "usModuleResource.h"
+#include "usModuleRegistry.h"
 #include "usModuleSettings.h"
 #include "usCoreModuleContext_p.h"
 
 #include "usCoreConfig.h"
 
+#include <algorithm>
+
 US_BEGIN_NAMESPACE
 
 const std::string& Module::PROP_ID()
@@ -78,6 +81,30 @@ const std::string&Module::PROP_AUTOLOADED_MODULES()
   return s;
 }
 
+const std::string&Module::PROP_ACTIVATION_POLICY()
+{
+  static const std::string s("module.activation_policy");
+  return s;
+}
+
+const std::string&Module::PROP_PROVIDED_INTERFACES()
+{
+  static const std::string s("module.provided_interfaces");
+  return s;
+}
+
+const std::string&Module::PROP_LOAD_TIME()
+{
+  static const std::string s("module.load_time");
+  return s;
+}
+
+const std::string&Module::PROP_ACTIVATION_TIME()
+{
+  static const std::string s("module.activation_time");
+  return s;
+}
+
 Module::Module()
 : d(nullptr)
 {
@@ -101,6 +128,12 @@ void Module::Uninit()
 {
   if (d->moduleContext != nullptr)
   {
+    if (d->activationPending)
+    {
+      d->coreCtx->RemoveLazyModule(d);
+      d->activationPending = false;
+    }
+
     //d->coreCtx->listeners.HooksModuleStopped(d->moduleContext);
     d->RemoveModuleResources();
     delete d->moduleContext;
@@ -116,6 +149,11 @@ bool Module::IsLoaded() const
   return d->moduleContext != nullptr;
 }
 
+bool Module::IsActivated() const
+{
+  return d->moduleContext != nullptr && !d->activationPending;
+}
+
 void Module::Start()
 {
 
@@ -127,42 +165,46 @@ void Module::Start()
 
   d->moduleContext = new ModuleContext(this->d);
 
-  typedef ModuleActivator*(*ModuleActivatorHook)(void);
-  ModuleActivatorHook activatorHook = nullptr;
-
-  std::string activator_func = "_us_module_activator_instance_" + d->info.name;
-  void* activatorHookSym = ModuleUtils::GetSymbol(d->info, activator_func.c_str());
-  std::memcpy(&activatorHook, &activatorHookSym, sizeof(void*));
-
   d->coreCtx->listeners.ModuleChanged(ModuleEvent(ModuleEvent::LOADING, this));
-  // try to get a ModuleActivator instance
 
-  if (activatorHook)
+  d->CreateActivator();
+
+  std::vector<std::string> lazyInterfaces;
+  if (ModuleSettings::IsLazyActivationEnabled())
   {
-    try
-    {
-      d->moduleActivator = activatorHook();
-    }
-    catch (...)
-    {
-      US_ERROR << "Creating the module activator of " << d->info.name << " failed";
-      throw;
-    }
+    lazyInterfaces = d->GetLazyActivationInterfaces();
+  }
 
-    // This method should be "noexcept" and by not catching exceptions
-    // here we semantically treat it that way since any exception during
-    // static initialization will either terminate the program or cause
-    // the dynamic loader to report an error.
-    d->moduleActivator->Load(d->moduleContext);
+  if (lazyInterfaces.empty())
+  {
+    d->Activate();
+  }
+  else
+  {
+    d->activationFlag.reset(new std::once_flag);
+    d->activationPending = true;
+    d->coreCtx->AddLazyModule(d, lazyInterfaces);
   }
 
 #ifdef US_ENABLE_AUTOLOADING_SUPPORT
   if (ModuleSettings::IsAutoLoadingEnabled())
   {
-    const std::vector<std::string> loadedPaths = AutoLoadModules(d->info);
+    std::vector<long long> loadTimes;
+    const std::vector<std::string> loadedPaths = AutoLoadModules(d->info, loadTimes);
     if (!loadedPaths.empty())
     {
       d->moduleManifest.SetValue(PROP_AUTOLOADED_MODULES(), Any(loadedPaths));
+
+      const std::vector<Module*> modules = ModuleRegistry::GetModules();
+      for (std::vector<Module*>::const_iterator module = modules.begin(); module != modules.end(); ++module)
+      {
+        std::vector<std::string>::const_iterator path =
+            std::find(loadedPaths.begin(), loadedPaths.end(), (*module)->GetLocation());
+        if (path != loadedPaths.end())
+        {
+          (*module)->d->moduleManifest.SetValue(PROP_LOAD_TIME(), Any(loadTimes[path - loadedPaths.begin()]));
+        }
+      }
     }
   }
 #endif
@@ -182,7 +224,8 @@ void Module::Stop()
   {
     d->coreCtx->listeners.ModuleChanged(ModuleEvent(ModuleEvent::UNLOADING, this));
 
-    if (d->moduleActivator)
+    // a module still waiting for its activation was never loaded by its activator
+    if (d->moduleActivator && !d->activationPending)
     {
       d->moduleActivator->Unload(d->moduleContext);
     }
@@ -33,6 +33,7 @@
 #include "usServiceReferenceBasePrivate.h"
 
 #include <algorithm>
+#include <chrono>
 #include <iterator>
 #include <cassert>
 #include <cstring>
@@ -48,6 +49,8 @@ ModulePrivate::ModulePrivate(Module* qq, CoreModuleContext* coreCtx,
   , resourceContainer(info)
   , moduleContext(nullptr)
   , moduleActivator(nullptr)
+  , activationPending(false)
+  , activatingThread(std::thread::id())
   , q(qq)
 {
   // Check if the module provides a manifest.json file and if yes, parse it.
@@ -115,6 +118,100 @@ ModulePrivate::~ModulePrivate()
   delete moduleContext;
 }
 
+void ModulePrivate::CreateActivator()
+{
+  typedef ModuleActivator*(*ModuleActivatorHook)(void);
+  ModuleActivatorHook activatorHook = nullptr;
+
+  std::string activator_func = "_us_module_activator_instance_" + info.name;
+  void* activatorHookSym = ModuleUtils::GetSymbol(info, activator_func.c_str());
+  std::memcpy(&activatorHook, &activatorHookSym, sizeof(void*));
+
+  // try to get a ModuleActivator instance
+  if (activatorHook)
+  {
+    try
+    {
+      moduleActivator = activatorHook();
+    }
+    catch (...)
+    {
+      US_ERROR << "Creating the module activator of " << info.name << " failed";
+      throw;
+    }
+  }
+}
+
+void ModulePrivate::Activate()
+{
+  activationPending = false;
+
+  if (moduleActivator)
+  {
+    // This method should be "noexcept" and by not catching exceptions
+    // here we semantically treat it that way since any exception during
+    // static initialization will either terminate the program or cause
+    // the dynamic loader to report an error.
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    moduleActivator->Load(moduleContext);
+    long long activationTime = std::chrono::duration_cast<std::chrono::microseconds>(
+          std::chrono::steady_clock::now() - start).count();
+    moduleManifest.SetValue(Module::PROP_ACTIVATION_TIME(), Any(activationTime));
+  }
+}
+
+void ModulePrivate::ActivateLazily()
+{
+  if (activatingThread.load() == std::this_thread::get_id())
+  {
+    // the activator of this module requests one of its own interfaces
+    return;
+  }
+
+  std::call_once(*activationFlag, [this]()
+  {
+    activatingThread = std::this_thread::get_id();
+    Activate();
+    activatingThread = std::thread::id();
+    coreCtx->RemoveLazyModule(this);
+  });
+}
+
+std::vector<std::string> ModulePrivate::GetLazyActivationInterfaces() const
+{
+  std::vector<std::string> interfaces;
+
+  Any policy = moduleManifest.GetValue(Module::PROP_ACTIVATION_POLICY());
+  if (policy.Type() != typeid(std::string) || ref_any_cast<std::string>(policy) != "lazy")
+  {
+    return interfaces;
+  }
+
+  Any provided = moduleManifest.GetValue(Module::PROP_PROVIDED_INTERFACES());
+  if (provided.Type() == typeid(std::string))
+  {
+    interfaces.push_back(ref_any_cast<std::string>(provided));
+  }
+  else if (provided.Type() == typeid(std::vector<Any>))
+  {
+    const std::vector<Any>& list = ref_any_cast<std::vector<Any> >(provided);
+    for (std::vector<Any>::const_iterator i = list.begin(); i != list.end(); ++i)
+    {
+      if (i->Type() == typeid(std::string))
+      {
+        interfaces.push_back(ref_any_cast<std::string>(*i));
+      }
+    }
+  }
+
+  if (interfaces.empty())
+  {
+    US_WARN << "Module " << info.name << " has a lazy activation policy, but no provided interfaces. "
+            << "It is activated when it is loaded.";
+  }
+  return interfaces;
+}
+
 void ModulePrivate::RemoveModuleResources()
 {
   coreCtx->listeners.RemoveAllListeners(moduleContext);
@@ -22,8 +22,12 @@
 #ifndef USMODULEPRIVATE_H
 #define USMODULEPRIVATE_H
 
+#include <atomic>
 #include <map>
 #include <list>
+#include <memory>
+#include <mutex>
+#include <thread>
 
 #include "usModuleRegistry.h"
 #include "usModuleVersion.h"
@@ -55,6 +59,32 @@ public:
 
   void RemoveModuleResources();
 
+  /**
+   * Looks up the module activator. This must happen while the module is
+   * being loaded, since the activator is a function-local static of the
+   * module library and has to be destroyed after the module was stopped.
+   */
+  void CreateActivator();
+
+  /**
+   * Runs the module activator, if the module has one, and records
+   * the time spent in ModuleActivator::Load.
+   */
+  void Activate();
+
+  /**
+   * Activates a module waiting for lazy activation. The activator runs
+   * once, concurrent callers wait until it returned. Afterwards the module
+   * is removed from the modules waiting for lazy activation.
+   */
+  void ActivateLazily();
+
+  /**
+   * Returns the interfaces whose first request activates this module,
+   * or an empty list if the module is activated when it is loaded.
+   */
+  std::vector<std::string> GetLazyActivationInterfaces() const;
+
   CoreModuleContext* const coreCtx;
 
   /**
@@ -73,6 +103,23 @@ public:
 
   ModuleActivator* moduleActivator;
 
+  /**
+   * True while a loaded module waits for lazy activation.
+   */
+  std::atomic<bool> activationPending;
+
+  /**
+   * Guards the lazy activation. It is created whenever the module is
+   * started lazily, since a module can be loaded again after it was unloaded.
+   */
+  std::unique_ptr<std::once_flag> activationFlag;
+
+  /**
+   * The thread running the activator during lazy activation. Requests
+   * from the activator itself must not wait for its activation.
+   */
+  std::atomic<std::thread::id> activatingThread;
+
   ModuleManifest moduleManifest;
 
   std::string baseStoragePath;
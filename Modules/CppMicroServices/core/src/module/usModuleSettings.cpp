@@ -67,6 +67,7 @@ struct ModuleSettingsPrivate : public MultiThreaded<>
     , autoLoadingEnabled(false)
   #endif
     , autoLoadingDisabled(false)
+    , lazyActivationEnabled(getenv("US_ENABLE_LAZY_ACTIVATION") != nullptr)
     , logLevel(DebugMsg)
   {
     autoLoadPaths.insert(ModuleSettings::CURRENT_MODULE_PATH());
@@ -101,6 +102,7 @@ struct ModuleSettingsPrivate : public MultiThreaded<>
   std::set<std::string> extraPaths;
   bool autoLoadingEnabled;
   bool autoLoadingDisabled;
+  bool lazyActivationEnabled;
   std::string storagePath;
   MsgType logLevel;
 };
@@ -133,6 +135,18 @@ void ModuleSettings::SetAutoLoadingEnabled(bool enable)
   moduleSettingsPrivate()->autoLoadingEnabled = enable;
 }
 
+bool ModuleSettings::IsLazyActivationEnabled()
+{
+  US_UNUSED(ModuleSettingsPrivate::Lock(moduleSettingsPrivate()));
+  return moduleSettingsPrivate()->lazyActivationEnabled;
+}
+
+void ModuleSettings::SetLazyActivationEnabled(bool enable)
+{
+  US_UNUSED(ModuleSettingsPrivate::Lock(moduleSettingsPrivate()));
+  moduleSettingsPrivate()->lazyActivationEnabled = enable;
+}
+
 ModuleSettings::PathList ModuleSettings::GetAutoLoadPaths()
 {
   US_UNUSED(ModuleSettingsPrivate::Lock(moduleSettingsPrivate()));
@@ -24,6 +24,7 @@
 #include "usAny.h"
 #include "usServicePropertiesImpl_p.h"
 
+#include <algorithm>
 #include <limits>
 #include <iterator>
 #include <cctype>
@@ -287,6 +288,70 @@ bool LDAPExpr::GetMatchedObjectClasses(ObjectClassSet& objClasses) const
   return false;
 }
 
+void LDAPExpr::GetRequiredPropertyValues(PropertyValueMap& values) const
+{
+  if (d->m_operator == EQ)
+  {
+    if (d->m_attrValue.find(LDAPExprConstants::WILDCARD()) == std::string::npos)
+    {
+      values[d->m_attrName] = StringList(1, d->m_attrValue);
+    }
+  }
+  else if (d->m_operator == AND)
+  {
+    // Every operand has to match, so the constraints of any operand apply.
+    // A multi-valued property may match different operands with different
+    // values, hence the lists of a key must not be intersected.
+    for (std::size_t i = 0; i < d->m_args.size(); i++)
+    {
+      PropertyValueMap r;
+      d->m_args[i].GetRequiredPropertyValues(r);
+      for (PropertyValueMap::iterator it = r.begin(); it != r.end(); ++it)
+      {
+        PropertyValueMap::iterator existing = values.find(it->first);
+        if (existing == values.end() || it->second.size() < existing->second.size())
+        {
+          values[it->first].swap(it->second);
+        }
+      }
+    }
+  }
+  else if (d->m_operator == OR)
+  {
+    // Only keys constrained by all operands are constrained by the expression.
+    for (std::size_t i = 0; i < d->m_args.size(); i++)
+    {
+      PropertyValueMap r;
+      d->m_args[i].GetRequiredPropertyValues(r);
+      if (i == 0)
+      {
+        values.swap(r);
+        continue;
+      }
+
+      for (PropertyValueMap::iterator it = values.begin(); it != values.end();)
+      {
+        PropertyValueMap::iterator other = r.find(it->first);
+        if (other == r.end())
+        {
+          it = values.erase(it);
+        }
+        else
+        {
+          for (StringList::const_iterator value = other->second.begin(); value != other->second.end(); ++value)
+          {
+            if (std::find(it->second.begin(), it->second.end(), *value) == it->second.end())
+            {
+              it->second.push_back(*value);
+            }
+          }
+          ++it;
+        }
+      }
+    }
+  }
+}
+
 std::string LDAPExpr::ToLower(const std::string& str)
 {
   std::string lowerStr(str);
@@ -57,6 +57,7 @@ public:
   typedef std::vector<std::string> StringList;
   typedef std::vector<StringList> LocalCache;
   typedef US_UNORDERED_SET_TYPE<std::string> ObjectClassSet;
+  typedef US_UNORDERED_MAP_TYPE<std::string, StringList> PropertyValueMap;
 
 
   /**
@@ -83,6 +84,17 @@ public:
    */
   bool GetMatchedObjectClasses(ObjectClassSet& objClasses) const;
 
+  /**
+   * Get the property values required by this LDAP expression. A service can
+   * only match if, for every key in <code>values</code>, one of its values for
+   * that key is contained in the associated list. Keys are returned exactly as
+   * spelled in the expression. Only equality tests without wildcards constrain
+   * a key, so the map may stay empty.
+   *
+   * \param values The required values will be added to values.
+   */
+  void GetRequiredPropertyValues(PropertyValueMap& values) const;
+
   /**
    * Checks if this LDAP expression is "simple". The definition of
    * a simple filter is:
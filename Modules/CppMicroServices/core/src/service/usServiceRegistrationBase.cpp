@@ -133,6 +133,7 @@ void ServiceRegistrationBase::SetProperties(const ServiceProperties& props)
       {
         d->module->coreCtx->services.UpdateServiceRegistrationOrder(*this, classes);
       }
+      d->module->coreCtx->services.UpdateServiceRegistrationProperties(*this);
     }
     else
     {
@@ -19,7 +19,9 @@
 
 =============================================================================*/
 
+#include <algorithm>
 #include <iterator>
+#include <list>
 #include <stdexcept>
 #include <cassert>
 
@@ -34,6 +36,17 @@
 
 US_BEGIN_NAMESPACE
 
+namespace {
+
+// Filters are usually string literals, but a filter built from changing
+// values must not let the cache grow without bound.
+const std::size_t MaxCachedFilters = 1024;
+
+// Every index has to be updated on each service (un)registration.
+const std::size_t MaxPropertyIndices = 32;
+
+}
+
 ServicePropertiesImpl ServiceRegistry::CreateServiceProperties(const ServiceProperties& in,
                                                                const std::vector<std::string>& classes,
                                                                bool isFactory, bool isPrototypeFactory,
@@ -81,6 +94,8 @@ void ServiceRegistry::Clear()
   services.clear();
   serviceRegistrations.clear();
   classServices.clear();
+  filterCache.clear();
+  propertyIndices.clear();
   core = nullptr;
 }
 
@@ -123,6 +138,11 @@ ServiceRegistrationBase ServiceRegistry::RegisterService(ModulePrivate* module,
           std::lower_bound(s.begin(), s.end(), res);
       s.insert(ip, res);
     }
+    for (MapPropertyIndices::iterator i = propertyIndices.begin();
+         i != propertyIndices.end(); ++i)
+    {
+      AddToPropertyIndex_unlocked(i->first, i->second, res);
+    }
   }
 
   ServiceReferenceBase r = res.GetReference(std::string());
@@ -147,6 +167,178 @@ void ServiceRegistry::UpdateServiceRegistrationOrder(const ServiceRegistrationBa
   }
 }
 
+void ServiceRegistry::UpdateServiceRegistrationProperties(const ServiceRegistrationBase& sr)
+{
+  MutexLock lock(mutex);
+  for (MapPropertyIndices::iterator i = propertyIndices.begin();
+       i != propertyIndices.end(); ++i)
+  {
+    RemoveFromPropertyIndex_unlocked(i->second, sr);
+    AddToPropertyIndex_unlocked(i->first, i->second, sr);
+  }
+}
+
+const ServiceRegistry::CompiledFilter& ServiceRegistry::GetCompiledFilter_unlocked(const std::string& filter) const
+{
+  MapFilterCache::const_iterator i = filterCache.find(filter);
+  if (i != filterCache.end())
+  {
+    return i->second;
+  }
+
+  // throws std::invalid_argument for an invalid filter, which is not cached
+  CompiledFilter compiledFilter;
+  compiledFilter.ldap = LDAPExpr(filter);
+  compiledFilter.hasObjectClasses = compiledFilter.ldap.GetMatchedObjectClasses(compiledFilter.objectClasses);
+  compiledFilter.ldap.GetRequiredPropertyValues(compiledFilter.requiredValues);
+
+  if (filterCache.size() >= MaxCachedFilters)
+  {
+    filterCache.clear();
+  }
+  return filterCache.insert(std::make_pair(filter, compiledFilter)).first->second;
+}
+
+ServiceRegistry::PropertyIndex* ServiceRegistry::GetPropertyIndex_unlocked(const std::string& key) const
+{
+  MapPropertyIndices::iterator i = propertyIndices.find(key);
+  if (i != propertyIndices.end())
+  {
+    return &i->second;
+  }
+
+  if (propertyIndices.size() >= MaxPropertyIndices)
+  {
+    return nullptr;
+  }
+
+  PropertyIndex& index = propertyIndices[key];
+  for (std::vector<ServiceRegistrationBase>::const_iterator sr = serviceRegistrations.begin();
+       sr != serviceRegistrations.end(); ++sr)
+  {
+    AddToPropertyIndex_unlocked(key, index, *sr);
+  }
+  return &index;
+}
+
+void ServiceRegistry::AddToPropertyIndex_unlocked(const std::string& key, PropertyIndex& index,
+                                                  const ServiceRegistrationBase& sr) const
+{
+  // look up the key like LDAPExpr::Evaluate does
+  const ServicePropertiesImpl& properties = sr.d->properties;
+  int propertyIndex = properties.FindCaseSensitive(key);
+  if (propertyIndex < 0) propertyIndex = properties.Find(key);
+  if (propertyIndex < 0)
+  {
+    // an equality test fails for a missing property
+    return;
+  }
+
+  const Any& value = properties.Value(propertyIndex);
+  std::vector<std::string>& values = index.serviceValues[sr];
+  if (value.Type() == typeid(std::string))
+  {
+    values.push_back(ref_any_cast<std::string>(value));
+  }
+  else if (value.Type() == typeid(std::vector<std::string>))
+  {
+    const std::vector<std::string>& list = ref_any_cast<std::vector<std::string> >(value);
+    values.assign(list.begin(), list.end());
+  }
+  else if (value.Type() == typeid(std::list<std::string>))
+  {
+    const std::list<std::string>& list = ref_any_cast<std::list<std::string> >(value);
+    values.assign(list.begin(), list.end());
+  }
+  else
+  {
+    // numbers, booleans etc. are converted when compared
+    index.otherServices.push_back(sr);
+    return;
+  }
+
+  std::sort(values.begin(), values.end());
+  values.erase(std::unique(values.begin(), values.end()), values.end());
+  for (std::vector<std::string>::const_iterator i = values.begin(); i != values.end(); ++i)
+  {
+    index.valueServices[*i].push_back(sr);
+  }
+}
+
+void ServiceRegistry::RemoveFromPropertyIndex_unlocked(PropertyIndex& index, const ServiceRegistrationBase& sr) const
+{
+  US_UNORDERED_MAP_TYPE<ServiceRegistrationBase, std::vector<std::string> >::iterator entry =
+      index.serviceValues.find(sr);
+  if (entry == index.serviceValues.end())
+  {
+    return;
+  }
+
+  for (std::vector<std::string>::const_iterator i = entry->second.begin(); i != entry->second.end(); ++i)
+  {
+    std::vector<ServiceRegistrationBase>& s = index.valueServices[*i];
+    s.erase(std::remove(s.begin(), s.end(), sr), s.end());
+    if (s.empty())
+    {
+      index.valueServices.erase(*i);
+    }
+  }
+  index.otherServices.erase(std::remove(index.otherServices.begin(), index.otherServices.end(), sr),
+                            index.otherServices.end());
+  index.serviceValues.erase(entry);
+}
+
+bool ServiceRegistry::GetIndexedServices_unlocked(const CompiledFilter& compiledFilter, std::size_t maxServices,
+                                                  std::vector<ServiceRegistrationBase>& serviceRegs) const
+{
+  const PropertyIndex* bestIndex = nullptr;
+  const LDAPExpr::StringList* bestValues = nullptr;
+  std::size_t bestCount = maxServices;
+
+  for (LDAPExpr::PropertyValueMap::const_iterator i = compiledFilter.requiredValues.begin();
+       i != compiledFilter.requiredValues.end(); ++i)
+  {
+    // object classes are already indexed by classServices
+    if (i->first == ServiceConstants::OBJECTCLASS()) continue;
+
+    const PropertyIndex* index = GetPropertyIndex_unlocked(i->first);
+    if (index == nullptr) continue;
+
+    std::size_t count = index->otherServices.size();
+    for (LDAPExpr::StringList::const_iterator value = i->second.begin(); value != i->second.end(); ++value)
+    {
+      US_UNORDERED_MAP_TYPE<std::string, std::vector<ServiceRegistrationBase> >::const_iterator s =
+          index->valueServices.find(*value);
+      if (s != index->valueServices.end()) count += s->second.size();
+    }
+
+    if (count < bestCount)
+    {
+      bestIndex = index;
+      bestValues = &i->second;
+      bestCount = count;
+    }
+  }
+
+  if (bestIndex == nullptr)
+  {
+    return false;
+  }
+
+  serviceRegs.reserve(bestCount);
+  for (LDAPExpr::StringList::const_iterator value = bestValues->begin(); value != bestValues->end(); ++value)
+  {
+    US_UNORDERED_MAP_TYPE<std::string, std::vector<ServiceRegistrationBase> >::const_iterator s =
+        bestIndex->valueServices.find(*value);
+    if (s != bestIndex->valueServices.end())
+    {
+      serviceRegs.insert(serviceRegs.end(), s->second.begin(), s->second.end());
+    }
+  }
+  serviceRegs.insert(serviceRegs.end(), bestIndex->otherServices.begin(), bestIndex->otherServices.end());
+  return true;
+}
+
 void ServiceRegistry::Get(const std::string& clazz,
                           std::vector<ServiceRegistrationBase>& serviceRegs) const
 {
@@ -198,41 +390,42 @@ void ServiceRegistry::Get_unlocked(const std::string& clazz, const std::string&
   std::vector<ServiceRegistrationBase>::const_iterator s;
   std::vector<ServiceRegistrationBase>::const_iterator send;
   std::vector<ServiceRegistrationBase> v;
-  LDAPExpr ldap;
+  const CompiledFilter* compiledFilter = filter.empty() ? nullptr : &GetCompiledFilter_unlocked(filter);
   if (clazz.empty())
   {
-    if (!filter.empty())
+    if (compiledFilter != nullptr && compiledFilter->hasObjectClasses)
     {
-      ldap = LDAPExpr(filter);
-      LDAPExpr::ObjectClassSet matched;
-      if (ldap.GetMatchedObjectClasses(matched))
+      for(LDAPExpr::ObjectClassSet::const_iterator className = compiledFilter->objectClasses.begin();
+          className != compiledFilter->objectClasses.end(); ++className)
       {
-        v.clear();
-        for(LDAPExpr::ObjectClassSet::const_iterator className = matched.begin();
-            className != matched.end(); ++className)
+        MapClassServices::const_iterator i = classServices.find(*className);
+        if (i != classServices.end())
         {
-          MapClassServices::const_iterator i = classServices.find(*className);
-          if (i != classServices.end())
-          {
-            std::copy(i->second.begin(), i->second.end(), std::back_inserter(v));
-          }
-        }
-        if (!v.empty())
-        {
-          s = v.begin();
-          send = v.end();
-        }
-        else
-        {
-          return;
+          std::copy(i->second.begin(), i->second.end(), std::back_inserter(v));
         }
       }
+      if (!v.empty())
+      {
+        s = v.begin();
+        send = v.end();
+      }
       else
       {
-        s = serviceRegistrations.begin();
-        send = serviceRegistrations.end();
+        return;
       }
     }
+    else if (compiledFilter != nullptr &&
+             GetIndexedServices_unlocked(*compiledFilter, serviceRegistrations.size(), v))
+    {
+      // same order as serviceRegistrations, i.e. by service id
+      std::sort(v.begin(), v.end(), [](const ServiceRegistrationBase& a, const ServiceRegistrationBase& b) {
+        return any_cast<long int>(a.d->properties.Value(ServiceConstants::SERVICE_ID())) <
+               any_cast<long int>(b.d->properties.Value(ServiceConstants::SERVICE_ID()));
+      });
+      v.erase(std::unique(v.begin(), v.end()), v.end());
+      s = v.begin();
+      send = v.end();
+    }
     else
     {
       s = serviceRegistrations.begin();
@@ -242,18 +435,28 @@ void ServiceRegistry::Get_unlocked(const std::string& clazz, const std::string&
   else
   {
     MapClassServices::const_iterator it = classServices.find(clazz);
-    if (it != classServices.end())
+    if (it == classServices.end())
     {
-      s = it->second.begin();
-      send = it->second.end();
+      return;
     }
-    else
+
+    if (compiledFilter != nullptr && GetIndexedServices_unlocked(*compiledFilter, it->second.size(), v))
     {
-      return;
+      // keep the services registered under clazz, ordered like classServices
+      v.erase(std::remove_if(v.begin(), v.end(), [this, &clazz](const ServiceRegistrationBase& sr) {
+        MapServiceClasses::const_iterator classes = services.find(sr);
+        return classes == services.end() ||
+               std::find(classes->second.begin(), classes->second.end(), clazz) == classes->second.end();
+      }), v.end());
+      std::sort(v.begin(), v.end());
+      v.erase(std::unique(v.begin(), v.end()), v.end());
+      s = v.begin();
+      send = v.end();
     }
-    if (!filter.empty())
+    else
     {
-      ldap = LDAPExpr(filter);
+      s = it->second.begin();
+      send = it->second.end();
     }
   }
 
@@ -261,7 +464,7 @@ void ServiceRegistry::Get_unlocked(const std::string& clazz, const std::string&
   {
     ServiceReferenceBase sri = s->GetReference(clazz);
 
-    if (filter.empty() || ldap.Evaluate(s->d->properties, false))
+    if (compiledFilter == nullptr || compiledFilter->ldap.Evaluate(s->d->properties, false))
     {
       res.push_back(sri);
     }
@@ -288,6 +491,11 @@ void ServiceRegistry::RemoveServiceRegistration(const ServiceRegistrationBase& s
   const std::vector<std::string>& classes = ref_any_cast<std::vector<std::string> >(
         sr.d->properties.Value(ServiceConstants::OBJECTCLASS()));
   services.erase(sr);
+  for (MapPropertyIndices::iterator i = propertyIndices.begin();
+       i != propertyIndices.end(); ++i)
+  {
+    RemoveFromPropertyIndex_unlocked(i->second, sr);
+  }
   serviceRegistrations.erase(std::remove(serviceRegistrations.begin(), serviceRegistrations.end(), sr),
                              serviceRegistrations.end());
   for (std::vector<std::string>::const_iterator i = classes.begin();
@@ -26,6 +26,7 @@
 #include "usServiceInterface.h"
 #include "usServiceRegistration.h"
 
+#include "usLDAPExpr_p.h"
 #include "usThreads_p.h"
 
 US_BEGIN_NAMESPACE
@@ -116,6 +117,13 @@ public:
   void UpdateServiceRegistrationOrder(const ServiceRegistrationBase& sr,
                                       const std::vector<std::string>& classes);
 
+  /**
+   * Service properties changed, update the property indices.
+   *
+   * @param sr The ServiceRegistration object whose properties changed.
+   */
+  void UpdateServiceRegistrationProperties(const ServiceRegistrationBase& sr);
+
   /**
    * Get all services implementing a certain class.
    * Only used internally by the framework.
@@ -173,6 +181,58 @@ private:
 
   friend class ServiceHooks;
 
+  /**
+   * A parsed filter together with the object classes and property
+   * values a matching service is required to have.
+   */
+  struct CompiledFilter
+  {
+    LDAPExpr ldap;
+    bool hasObjectClasses;
+    LDAPExpr::ObjectClassSet objectClasses;
+    LDAPExpr::PropertyValueMap requiredValues;
+  };
+
+  typedef US_UNORDERED_MAP_TYPE<std::string, CompiledFilter> MapFilterCache;
+
+  /**
+   * Mapping of the string values of a service property to the services
+   * having that value. Services with a non-string value are kept in
+   * <code>otherServices</code>, since they can match in other ways.
+   */
+  struct PropertyIndex
+  {
+    US_UNORDERED_MAP_TYPE<std::string, std::vector<ServiceRegistrationBase> > valueServices;
+    std::vector<ServiceRegistrationBase> otherServices;
+    US_UNORDERED_MAP_TYPE<ServiceRegistrationBase, std::vector<std::string> > serviceValues;
+  };
+
+  typedef US_UNORDERED_MAP_TYPE<std::string, PropertyIndex> MapPropertyIndices;
+
+  /**
+   * Compiled filters by filter string. Parsing a filter is expensive
+   * compared to evaluating it and the same filters are used over and over.
+   */
+  mutable MapFilterCache filterCache;
+
+  /**
+   * Property indices by property key. An index is created when a filter
+   * first requires certain values for that key.
+   */
+  mutable MapPropertyIndices propertyIndices;
+
+  const CompiledFilter& GetCompiledFilter_unlocked(const std::string& filter) const;
+
+  PropertyIndex* GetPropertyIndex_unlocked(const std::string& key) const;
+
+  void AddToPropertyIndex_unlocked(const std::string& key, PropertyIndex& index,
+                                   const ServiceRegistrationBase& sr) const;
+
+  void RemoveFromPropertyIndex_unlocked(PropertyIndex& index, const ServiceRegistrationBase& sr) const;
+
+  bool GetIndexedServices_unlocked(const CompiledFilter& compiledFilter, std::size_t maxServices,
+                                   std::vector<ServiceRegistrationBase>& serviceRegs) const;
+
   void Get_unlocked(const std::string& clazz, std::vector<ServiceRegistrationBase>& serviceRegs) const;
 
   void Get_unlocked(const std::string& clazz, const std::string& filter,
@@ -25,6 +25,7 @@
 #include "usModuleInfo.h"
 #include "usModuleSettings.h"
 
+#include <chrono>
 #include <string>
 #include <cstdio>
 #include <cctype>
@@ -106,7 +107,8 @@ bool load_impl(const std::string&) { return false; }
 
 US_BEGIN_NAMESPACE
 
-std::vector<std::string> AutoLoadModulesFromPath(const std::string& absoluteBasePath, const std::string& subDir)
+std::vector<std::string> AutoLoadModulesFromPath(const std::string& absoluteBasePath, const std::string& subDir,
+                                                 std::vector<long long>& loadTimes)
 {
   std::vector<std::string> loadedModules;
 
@@ -171,6 +173,7 @@ std::vector<std::string> AutoLoadModulesFromPath(const std::string& absoluteBase
       libPath += entryFileName;
       US_DEBUG << "Auto-loading module " << libPath;
 
+      std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
       if (!load_impl(libPath))
       {
         US_WARN << "Auto-loading of module " << libPath << " failed.";
@@ -178,6 +181,8 @@ std::vector<std::string> AutoLoadModulesFromPath(const std::string& absoluteBase
       else
       {
         loadedModules.push_back(libPath);
+        loadTimes.push_back(std::chrono::duration_cast<std::chrono::microseconds>(
+                              std::chrono::steady_clock::now() - start).count());
       }
     }
     closedir(dir);
@@ -185,7 +190,7 @@ std::vector<std::string> AutoLoadModulesFromPath(const std::string& absoluteBase
   return loadedModules;
 }
 
-std::vector<std::string> AutoLoadModules(const ModuleInfo& moduleInfo)
+std::vector<std::string> AutoLoadModules(const ModuleInfo& moduleInfo, std::vector<long long>& loadTimes)
 {
   std::vector<std::string> loadedModules;
 
@@ -217,7 +222,7 @@ std::vector<std::string> AutoLoadModules(const ModuleInfo& moduleInfo)
        i != autoLoadPaths.end(); ++i)
   {
     if (i->empty()) continue;
-    std::vector<std::string> paths = AutoLoadModulesFromPath(*i, moduleInfo.autoLoadDir);
+    std::vector<std::string> paths = AutoLoadModulesFromPath(*i, moduleInfo.autoLoadDir, loadTimes);
     loadedModules.insert(loadedModules.end(), paths.begin(), paths.end());
   }
   return loadedModules;
@@ -36,7 +36,12 @@ US_BEGIN_NAMESPACE
 
 struct ModuleInfo;
 
-std::vector<std::string> AutoLoadModules(const ModuleInfo& moduleInfo);
+/**
+ * Loads the modules from the auto-load directories of the given module.
+ * Returns the paths of the loaded modules and adds the time it took to
+ * load each of them (in microseconds) to loadTimes.
+ */
+std::vector<std::string> AutoLoadModules(const ModuleInfo& moduleInfo, std::vector<long long>& loadTimes);
 
 US_END_NAMESPACE
 
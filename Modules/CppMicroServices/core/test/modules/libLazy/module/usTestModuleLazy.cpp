@@ -0,0 +1,65 @@
+/*=============================================================================
+
+  Library: CppMicroServices
+
+  Copyright (c) German Cancer Research Center,
+    Division of Medical and Biological Informatics
+
+  Licensed under the Apache License, Version 2.0 (the "License");
+  you may not use this file except in compliance with the License.
+  You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+
+=============================================================================*/
+
+#include <usModuleActivator.h>
+#include <usModuleContext.h>
+
+#include <chrono>
+#include <thread>
+
+US_BEGIN_NAMESPACE
+
+/**
+ * An activator which only registers services, like the IO activators of
+ * an application. The sleep stands in for the work of creating them.
+ */
+class TestModuleLazyActivator : public ModuleActivator
+{
+
+public:
+
+  void Load(ModuleContext* context) override
+  {
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+
+    for (int i = 0; i < NumberOfServices; ++i)
+    {
+      InterfaceMap im;
+      im.insert(std::make_pair(std::string(US_TEST_LAZY_INTERFACE), &services[i]));
+      context->RegisterService(im);
+    }
+  }
+
+  void Unload(ModuleContext* /*context*/) override
+  {
+  }
+
+private:
+
+  static const int NumberOfServices = 25;
+
+  int services[NumberOfServices];
+
+};
+
+US_END_NAMESPACE
+
+US_EXPORT_MODULE_ACTIVATOR(US_PREPEND_NAMESPACE(TestModuleLazyActivator))
@@ -84,6 +84,10 @@ void testDefaultAutoLoadPath(bool autoLoadEnabled)
     US_TEST_CONDITION_REQUIRED(loadedModulesVec.size() == 1, "Test for PROP_AUTOLOADED_MODULES vector size")
     US_TEST_CONDITION_REQUIRED(loadedModulesVec[0] == moduleAL_1->GetLocation(), "Test for PROP_AUTOLOADED_MODULES vector content")
 
+    Any loadTime = moduleAL_1->GetProperty(Module::PROP_LOAD_TIME());
+    US_TEST_CONDITION(loadTime.Type() == typeid(long long), "Test for PROP_LOAD_TIME property type")
+    US_TEST_CONDITION(moduleAL->GetProperty(Module::PROP_LOAD_TIME()).Empty(), "Test for empty PROP_LOAD_TIME on explicitly loaded module")
+
     pEvts.push_back(ModuleEvent(ModuleEvent::LOADING, moduleAL_1));
     pEvts.push_back(ModuleEvent(ModuleEvent::LOADED, moduleAL_1));
   }
@@ -0,0 +1,229 @@
+/*=============================================================================
+
+  Library: CppMicroServices
+
+  Copyright (c) German Cancer Research Center,
+    Division of Medical and Biological Informatics
+
+  Licensed under the Apache License, Version 2.0 (the "License");
+  you may not use this file except in compliance with the License.
+  You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+
+=============================================================================*/
+
+#include <usModuleContext.h>
+#include <usGetModuleContext.h>
+#include <usModuleRegistry.h>
+#include <usModule.h>
+#include <usModuleSettings.h>
+#include <usSharedLibrary.h>
+
+#include <usTestingConfig.h>
+
+#include "usTestingMacros.h"
+
+#include <chrono>
+#include <sstream>
+#include <thread>
+
+US_USE_NAMESPACE
+
+namespace {
+
+#ifdef US_PLATFORM_WINDOWS
+  static const std::string LIB_PATH = US_RUNTIME_OUTPUT_DIRECTORY;
+#else
+  static const std::string LIB_PATH = US_LIBRARY_OUTPUT_DIRECTORY;
+#endif
+
+// Number of TestModuleLazy<i> modules and services registered by each of them
+const int NumberOfLazyModules = 4;
+const std::size_t NumberOfServices = 25;
+
+std::string GetLazyModuleName(int index)
+{
+  std::stringstream ss;
+  ss << "TestModuleLazy" << index;
+  return ss.str();
+}
+
+std::string GetLazyInterfaceId(int index)
+{
+  std::stringstream ss;
+  ss << "TestModuleLazyService" << index;
+  return ss.str();
+}
+
+long long ElapsedMicro(const std::chrono::steady_clock::time_point& start)
+{
+  return std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start).count();
+}
+
+void testEagerActivation()
+{
+  ModuleSettings::SetLazyActivationEnabled(false);
+
+  SharedLibrary lib(LIB_PATH, GetLazyModuleName(1));
+  lib.Load();
+
+  Module* module = ModuleRegistry::GetModule(GetLazyModuleName(1));
+  US_TEST_CONDITION_REQUIRED(module != nullptr, "Test for existing module TestModuleLazy1")
+  US_TEST_CONDITION(module->GetProperty(Module::PROP_ACTIVATION_POLICY()).ToString() == "lazy", "Test for activation policy property")
+  US_TEST_CONDITION(module->IsActivated(), "Test for eager activation if lazy activation is disabled")
+  US_TEST_CONDITION(module->GetRegisteredServices().size() == NumberOfServices, "Test for registered services")
+  US_TEST_CONDITION(module->GetProperty(Module::PROP_ACTIVATION_TIME()).Type() == typeid(long long), "Test for PROP_ACTIVATION_TIME property type")
+
+  lib.Unload();
+}
+
+void testLazyActivation()
+{
+  ModuleSettings::SetLazyActivationEnabled(true);
+
+  ModuleContext* mc = GetModuleContext();
+  SharedLibrary lib(LIB_PATH, GetLazyModuleName(1));
+  lib.Load();
+
+  Module* module = ModuleRegistry::GetModule(GetLazyModuleName(1));
+  US_TEST_CONDITION_REQUIRED(module != nullptr, "Test for existing module TestModuleLazy1")
+  US_TEST_CONDITION(module->IsLoaded(), "Test if lazy module is loaded")
+  US_TEST_CONDITION(!module->IsActivated(), "Test if lazy module is not activated after loading")
+  US_TEST_CONDITION(module->GetRegisteredServices().empty(), "Test for no registered services before activation")
+  US_TEST_CONDITION(module->GetProperty(Module::PROP_ACTIVATION_TIME()).Empty(), "Test for empty PROP_ACTIVATION_TIME before activation")
+
+  // requests for other interfaces leave the module alone
+  mc->GetServiceReferences(GetLazyInterfaceId(2));
+  US_TEST_CONDITION(!module->IsActivated(), "Test if unrelated service request does not activate module")
+
+  std::vector<ServiceReferenceU> refs = mc->GetServiceReferences(GetLazyInterfaceId(1));
+  US_TEST_CONDITION(module->IsActivated(), "Test if service request activates module")
+  US_TEST_CONDITION(refs.size() == NumberOfServices, "Test for services of lazily activated module")
+  US_TEST_CONDITION(module->GetProperty(Module::PROP_ACTIVATION_TIME()).Type() == typeid(long long), "Test for PROP_ACTIVATION_TIME property type")
+
+  lib.Unload();
+
+  // unloading a module which is still waiting for its activation
+  lib.Load();
+  module = ModuleRegistry::GetModule(GetLazyModuleName(1));
+  US_TEST_CONDITION_REQUIRED(module != nullptr, "Test for existing module TestModuleLazy1")
+  US_TEST_CONDITION(!module->IsActivated(), "Test if reloaded lazy module is not activated")
+  lib.Unload();
+
+  refs = mc->GetServiceReferences(GetLazyInterfaceId(1));
+  US_TEST_CONDITION(refs.empty(), "Test for no services of unloaded lazy module")
+
+  ModuleSettings::SetLazyActivationEnabled(false);
+}
+
+// Requests the services of a lazy module from several threads at once. Every
+// request has to wait until the activator registered all services.
+void testConcurrentLazyActivation()
+{
+  ModuleSettings::SetLazyActivationEnabled(true);
+
+  ModuleContext* mc = GetModuleContext();
+  SharedLibrary lib(LIB_PATH, GetLazyModuleName(1));
+  lib.Load();
+
+  const std::size_t numberOfThreads = 4;
+  std::vector<std::size_t> numberOfRefs(numberOfThreads, 0);
+  std::vector<std::thread> threads;
+  for (std::size_t i = 0; i < numberOfThreads; ++i)
+  {
+    threads.push_back(std::thread([mc, i, &numberOfRefs]() {
+      numberOfRefs[i] = mc->GetServiceReferences(GetLazyInterfaceId(1)).size();
+    }));
+  }
+  for (std::size_t i = 0; i < numberOfThreads; ++i)
+  {
+    threads[i].join();
+  }
+
+  Module* module = ModuleRegistry::GetModule(GetLazyModuleName(1));
+  US_TEST_CONDITION_REQUIRED(module != nullptr, "Test for existing module TestModuleLazy1")
+  US_TEST_CONDITION(module->IsActivated(), "Test if concurrent service requests activate module")
+  for (std::size_t i = 0; i < numberOfThreads; ++i)
+  {
+    US_TEST_CONDITION(numberOfRefs[i] == NumberOfServices, "Test for services in concurrent request " << i)
+  }
+
+  lib.Unload();
+
+  ModuleSettings::SetLazyActivationEnabled(false);
+}
+
+// Compares the startup time of a set of modules which only contribute services,
+// with eager and with lazy activation.
+void testStartupTime()
+{
+  ModuleContext* mc = GetModuleContext();
+
+  long long startupTimes[2] = { 0, 0 };
+  for (int lazy = 0; lazy < 2; ++lazy)
+  {
+    ModuleSettings::SetLazyActivationEnabled(lazy != 0);
+
+    std::vector<SharedLibrary> libs;
+    for (int i = 1; i <= NumberOfLazyModules; ++i)
+    {
+      libs.push_back(SharedLibrary(LIB_PATH, GetLazyModuleName(i)));
+    }
+
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    for (std::vector<SharedLibrary>::iterator iter = libs.begin(); iter != libs.end(); ++iter)
+    {
+      iter->Load();
+    }
+    startupTimes[lazy] = ElapsedMicro(start);
+
+    start = std::chrono::steady_clock::now();
+    for (int i = 1; i <= NumberOfLazyModules; ++i)
+    {
+      US_TEST_CONDITION(mc->GetServiceReferences(GetLazyInterfaceId(i)).size() == NumberOfServices, "Test for services of module " << GetLazyModuleName(i))
+    }
+    long long requestTime = ElapsedMicro(start);
+
+    US_TEST_OUTPUT(<< (lazy ? "Lazy" : "Eager") << " activation: startup " << startupTimes[lazy]
+                   << " us, first service requests " << requestTime << " us")
+    for (int i = 1; i <= NumberOfLazyModules; ++i)
+    {
+      Module* module = ModuleRegistry::GetModule(GetLazyModuleName(i));
+      US_TEST_CONDITION_REQUIRED(module != nullptr, "Test for existing module " << GetLazyModuleName(i))
+      US_TEST_OUTPUT(<< "  " << module->GetName() << " activation time: "
+                     << module->GetProperty(Module::PROP_ACTIVATION_TIME()).ToString() << " us")
+    }
+
+    for (std::vector<SharedLibrary>::iterator iter = libs.begin(); iter != libs.end(); ++iter)
+    {
+      iter->Unload();
+    }
+  }
+
+  ModuleSettings::SetLazyActivationEnabled(false);
+
+  // the activators of the test modules take at least 10 ms each
+  US_TEST_CONDITION(startupTimes[1] < startupTimes[0], "Test for faster startup with lazy activation")
+}
+
+} // end unnamed namespace
+
+
+int usModuleLazyActivationTest(int /*argc*/, char* /*argv*/[])
+{
+  US_TEST_BEGIN("ModuleLazyActivationTest");
+
+  testEagerActivation();
+  testLazyActivation();
+  testConcurrentLazyActivation();
+  testStartupTime();
+
+  US_TEST_END()
+}
@@ -204,6 +204,7 @@ public:
   void TestAddListeners();
   void TestRegisterServices();
 
+  void TestFindServices();
   void TestModifyServices();
   void TestUnregisterServices();
 
@@ -358,6 +359,35 @@ void ServiceRegistryPerformanceTest::RegisterServices(int n)
   }
 }
 
+void ServiceRegistryPerformanceTest::TestFindServices()
+{
+  const int nLookups = 100000;
+
+  Log() << "Find services by their service.pid property, and check that we get "
+        << "exactly one service per lookup\n";
+
+  std::vector<std::string> filters;
+  for(int i = 0; i < nServices; i++)
+  {
+    std::stringstream ss;
+    ss << "(service.pid=my.service." << i << ")";
+    filters.push_back(ss.str());
+  }
+
+  std::size_t nFound = 0;
+  HighPrecisionTimer t;
+  t.Start();
+  for(int i = 0; i < nLookups; i++)
+  {
+    nFound += mc->GetServiceReferences<IPerfTestService>(filters[i % nServices]).size();
+  }
+  long long us = t.ElapsedMicro();
+  Log() << nLookups << " lookups took " << us / 1000 << "ms ("
+        << static_cast<double>(us) / nLookups << "us per lookup)\n";
+  US_TEST_CONDITION_REQUIRED(nFound == static_cast<std::size_t>(nLookups),
+                             "# found services must be same as # of lookups");
+}
+
 void ServiceRegistryPerformanceTest::TestModifyServices()
 {
   Log() << "Modify all services, and check that we get #of services ("
@@ -370,6 +400,8 @@ void ServiceRegistryPerformanceTest::TestModifyServices()
   Log() << "modify took " << ms << "ms\n";
   US_TEST_CONDITION_REQUIRED(nServices * listeners.size() == nModified,
                              "# MODIFIED events must be same as # of modified services  * # of listeners");
+  US_TEST_CONDITION_REQUIRED(mc->GetServiceReferences<IPerfTestService>("(service.pid=my.service.0)").empty(),
+                             "Modified services must not be found by their removed service.pid");
 }
 
 void ServiceRegistryPerformanceTest::ModifyServices()
@@ -420,6 +452,7 @@ int usServiceRegistryPerformanceTest(int /*argc*/, char* /*argv*/[])
   perfTest.InitTestCase();
   perfTest.TestAddListeners();
   perfTest.TestRegisterServices();
+  perfTest.TestFindServices();
   perfTest.TestModifyServices();
   perfTest.TestUnregisterServices();
   perfTest.CleanupTestCase();
@@ -127,6 +127,74 @@ void TestServicePropertiesUpdate()
   US_TEST_CONDITION_REQUIRED(context->GetServiceReferences<ITestServiceA>().empty(), "Testing service count")
 }
 
+void TestFilteredServiceLookup()
+{
+  struct TestServiceA : public ITestServiceA
+  {
+  };
+
+  ModuleContext* context = GetModuleContext();
+
+  TestServiceA s1;
+  ServiceProperties props1;
+  props1["test.mimetype"] = std::string("a");
+  ServiceRegistration<ITestServiceA> reg1 = context->RegisterService<ITestServiceA>(&s1, props1);
+
+  TestServiceA s2;
+  ServiceProperties props2;
+  std::vector<std::string> mimeTypes;
+  mimeTypes.push_back("a");
+  mimeTypes.push_back("b");
+  props2["test.mimetype"] = mimeTypes;
+  props2[ServiceConstants::SERVICE_RANKING()] = 10;
+  ServiceRegistration<ITestServiceA> reg2 = context->RegisterService<ITestServiceA>(&s2, props2);
+
+  TestServiceA s3;
+  ServiceProperties props3;
+  props3["test.mimetype"] = 5;
+  ServiceRegistration<ITestServiceA> reg3 = context->RegisterService<ITestServiceA>(&s3, props3);
+
+  TestServiceA s4;
+  ServiceRegistration<ITestServiceA> reg4 = context->RegisterService<ITestServiceA>(&s4);
+
+  US_TEST_CONDITION_REQUIRED(context->GetServiceReferences<ITestServiceA>("(test.mimetype=a)").size() == 2, "Testing indexed lookup")
+  US_TEST_CONDITION_REQUIRED(context->GetServiceReferences<ITestServiceA>("(test.mimetype=b)").size() == 1, "Testing indexed lookup of multi-valued property")
+  US_TEST_CONDITION_REQUIRED(context->GetServiceReferences<ITestServiceA>("(test.mimetype=5)").size() == 1, "Testing indexed lookup of non-string property")
+  US_TEST_CONDITION_REQUIRED(context->GetServiceReferences<ITestServiceA>("(test.mimetype=c)").empty(), "Testing indexed lookup without match")
+  US_TEST_CONDITION_REQUIRED(context->GetServiceReferences<ITestServiceA>("(|(test.mimetype=a)(test.mimetype=b))").size() == 2, "Testing indexed lookup with OR")
+  US_TEST_CONDITION_REQUIRED(context->GetServiceReferences<ITestServiceA>("(&(test.mimetype=a)(test.mimetype=b))").size() == 1, "Testing indexed lookup with AND")
+  US_TEST_CONDITION_REQUIRED(context->GetServiceReferences<ITestServiceA>("(test.mimetype=a*)").size() == 2, "Testing lookup with wildcard")
+  US_TEST_CONDITION_REQUIRED(context->GetServiceReferences("", "(test.mimetype=b)").size() == 1, "Testing indexed lookup without class")
+
+  // the index must not change the order of the references
+  std::vector<ServiceReference<ITestServiceA> > indexedRefs = context->GetServiceReferences<ITestServiceA>("(test.mimetype=a)");
+  std::vector<ServiceReference<ITestServiceA> > refs = context->GetServiceReferences<ITestServiceA>("(test.mimetype~=a)");
+  US_TEST_CONDITION_REQUIRED(indexedRefs == refs, "Testing order of indexed lookup")
+
+  props1["test.mimetype"] = std::string("b");
+  reg1.SetProperties(props1);
+  US_TEST_CONDITION_REQUIRED(context->GetServiceReferences<ITestServiceA>("(test.mimetype=a)").size() == 1, "Testing indexed lookup after property update")
+  US_TEST_CONDITION_REQUIRED(context->GetServiceReferences<ITestServiceA>("(test.mimetype=b)").size() == 2, "Testing indexed lookup after property update")
+
+  reg2.Unregister();
+  US_TEST_CONDITION_REQUIRED(context->GetServiceReferences<ITestServiceA>("(test.mimetype=a)").empty(), "Testing indexed lookup after unregistration")
+  US_TEST_CONDITION_REQUIRED(context->GetServiceReferences<ITestServiceA>("(test.mimetype=b)").size() == 1, "Testing indexed lookup after unregistration")
+
+  try
+  {
+    context->GetServiceReferences<ITestServiceA>("(test.mimetype=a");
+    US_TEST_FAILED_MSG(<< "Invalid filter did not throw")
+  }
+  catch (const std::invalid_argument&)
+  {
+  }
+
+  reg1.Unregister();
+  reg3.Unregister();
+  reg4.Unregister();
+  US_TEST_CONDITION_REQUIRED(context->GetServiceReferences<ITestServiceA>().empty(), "Testing service count")
+}
+
 
 int usServiceRegistryTest(int /*argc*/, char* /*argv*/[])
 {
@@ -135,6 +203,7 @@ int usServiceRegistryTest(int /*argc*/, char* /*argv*/[])
   TestServiceInterfaceId();
   TestMultipleServiceRegistrations();
   TestServicePropertiesUpdate();
+  TestFilteredServiceLookup();
 
   US_TEST_END()
 }
@@ -32,7 +32,11 @@ namespace mitk
   /**
     \brief Holds one (compressed) mitk::Image
 
-    Uses zlib to compress the data of an mitk::Image.
+    Compresses the data of an mitk::Image slice by slice, so that single slices can be accessed without
+    uncompressing the whole image and the slices can be compressed and uncompressed in parallel.
+
+    Two compression methods are available: zlib with an adjustable compression level and a simple
+    run-length encoding of pixel values, which is much faster and works well for label images.
 
     $Author$
   */
@@ -42,13 +46,32 @@ namespace mitk
     mitkClassMacroItkParent(CompressedImageContainer, itk::Object);
     itkFactorylessNewMacro(Self) itkCloneMacro(Self)
 
-      /**
-       * \brief Creates a compressed version of the image.
-       *
-       * Will not hold any further SmartPointers to the image.
-       *
-       */
-      void SetImage(Image *);
+    enum CompressionMethod
+    {
+      Zlib,
+      RunLength
+    };
+
+    /**
+     * \brief Compression method used by subsequent calls of SetImage(), Zlib by default.
+     */
+    itkSetEnumMacro(CompressionMethod, CompressionMethod);
+    itkGetEnumMacro(CompressionMethod, CompressionMethod);
+
+    /**
+     * \brief zlib compression level (1 = fastest, 9 = smallest, 6 by default), ignored for run-length encoding.
+     */
+    itkSetClampMacro(CompressionLevel, int, 1, 9);
+    itkGetConstMacro(CompressionLevel, int);
+
+    /**
+     * \brief Creates a compressed version of the image.
+     *
+     * Will not hold any further SmartPointers to the image. Slices that do not
+     * become smaller by compression (e.g. noise) are stored uncompressed.
+     *
+     */
+    void SetImage(Image *);
 
     /**
      * \brief Creates a full mitk::Image from its compressed version.
@@ -59,21 +82,52 @@ namespace mitk
      */
     Image::Pointer GetImage();
 
+    /**
+     * \brief Uncompresses a single slice (along the third dimension) of a time step into the
+     * buffer, which must hold at least GetSliceSizeInBytes() bytes.
+     *
+     * 2D images consist of a single slice per time step.
+     */
+    void GetSliceData(unsigned int slice, unsigned int timeStep, void *buffer) const;
+
+    unsigned int GetNumberOfSlices() const;
+    unsigned int GetNumberOfTimeSteps() const;
+    unsigned long GetSliceSizeInBytes() const;
+
+    /**
+     * \brief Size of the uncompressed respectively compressed image data, e.g. to determine the compression ratio.
+     */
+    unsigned long GetUncompressedSizeInBytes() const;
+    unsigned long GetCompressedSizeInBytes() const;
+
   protected:
     CompressedImageContainer(); // purposely hidden
     ~CompressedImageContainer() override;
 
+    typedef std::vector<unsigned char> ChunkType;
+
+    void Compress(const unsigned char *source, ChunkType &chunk, ChunkType &buffer) const;
+    void Uncompress(const ChunkType &chunk, unsigned char *dest) const;
+
     PixelType *m_PixelType;
 
     unsigned int m_ImageDimension;
     std::vector<unsigned int> m_ImageDimensions;
 
     unsigned long m_OneTimeStepImageSizeInBytes;
+    unsigned long m_SliceSizeInBytes;
 
     unsigned int m_NumberOfTimeSteps;
+    unsigned int m_NumberOfSlices;
+
+    CompressionMethod m_CompressionMethod;
+    int m_CompressionLevel;
+
+    /// method which has been used to compress the chunks
+    CompressionMethod m_ChunkCompressionMethod;
 
-    /// one for each timestep. first = pointer to compressed data; second = size of buffer in bytes
-    std::vector<std::pair<unsigned char *, unsigned long>> m_ByteBuffers;
+    /// compressed data, one for each slice of each timestep (index = timestep * number of slices + slice)
+    std::vector<ChunkType> m_Chunks;
 
     BaseGeometry::Pointer m_ImageGeometry;
   };
@@ -15,53 +15,66 @@ See LICENSE.txt or http://www.mitk.org for details.
 ===================================================================*/
 
 #include "mitkCompressedImageContainer.h"
+#include "mitkExceptionMacro.h"
 #include "mitkImageReadAccessor.h"
+#include "mitkImageWriteAccessor.h"
 
 #include "itk_zlib.h"
 
-#include <cstdlib>
+#include <cstring>
+#include <exception>
+#include <memory>
 
-mitk::CompressedImageContainer::CompressedImageContainer() : m_PixelType(nullptr), m_ImageGeometry(nullptr)
+mitk::CompressedImageContainer::CompressedImageContainer()
+  : m_PixelType(nullptr),
+    m_ImageDimension(0),
+    m_OneTimeStepImageSizeInBytes(0),
+    m_SliceSizeInBytes(0),
+    m_NumberOfTimeSteps(0),
+    m_NumberOfSlices(0),
+    m_CompressionMethod(Zlib),
+    m_CompressionLevel(6), // zlib default
+    m_ChunkCompressionMethod(Zlib),
+    m_ImageGeometry(nullptr)
 {
 }
 
 mitk::CompressedImageContainer::~CompressedImageContainer()
 {
-  for (auto iter = m_ByteBuffers.begin(); iter != m_ByteBuffers.end(); ++iter)
-  {
-    free(iter->first);
-  }
-
   delete m_PixelType;
 }
 
 void mitk::CompressedImageContainer::SetImage(Image *image)
 {
-  for (auto iter = m_ByteBuffers.begin(); iter != m_ByteBuffers.end(); ++iter)
-  {
-    free(iter->first);
-  }
-
-  m_ByteBuffers.clear();
+  m_Chunks.clear();
+  m_ChunkCompressionMethod = m_CompressionMethod;
 
-  // Compress diff image using zlib (will be restored on demand)
+  // Compress diff image slice by slice (will be restored on demand)
   // determine memory size occupied by voxel data
   m_ImageDimension = image->GetDimension();
   m_ImageDimensions.clear();
 
+  delete m_PixelType;
   m_PixelType = new mitk::PixelType(image->GetPixelType());
 
-  m_OneTimeStepImageSizeInBytes = m_PixelType->GetSize(); // bits per element divided by 8
+  m_SliceSizeInBytes = m_PixelType->GetSize(); // bits per element divided by 8
+  m_NumberOfSlices = 1;
   for (unsigned int i = 0; i < m_ImageDimension; ++i)
   {
     unsigned int currentImageDimension = image->GetDimension(i);
     m_ImageDimensions.push_back(currentImageDimension);
-    if (i < 3)
+    if (i < 2)
     {
-      m_OneTimeStepImageSizeInBytes *= currentImageDimension; // only the 3D memory size
+      m_SliceSizeInBytes *= currentImageDimension;
+    }
+    else if (i == 2)
+    {
+      m_NumberOfSlices = currentImageDimension;
     }
   }
 
+  m_OneTimeStepImageSizeInBytes = m_SliceSizeInBytes * m_NumberOfSlices; // only the 3D memory size
+
   m_ImageGeometry = image->GetGeometry();
 
   m_NumberOfTimeSteps = 1;
@@ -70,64 +83,70 @@ void mitk::CompressedImageContainer::SetImage(Image *image)
     m_NumberOfTimeSteps = image->GetDimension(3);
   }
 
+  std::vector<std::unique_ptr<ImageReadAccessor>> accessors;
   for (unsigned int timestep = 0; timestep < m_NumberOfTimeSteps; ++timestep)
   {
-    // allocate a buffer as specified by zlib
-    unsigned long bufferSize =
-      m_OneTimeStepImageSizeInBytes + static_cast<unsigned long>(m_OneTimeStepImageSizeInBytes * 0.2) + 12;
-    auto *byteBuffer = (unsigned char *)malloc(bufferSize);
+    accessors.emplace_back(new ImageReadAccessor(image, image->GetVolumeData(timestep)));
+  }
 
-    if (itk::Object::GetDebug())
-    {
-      // compress image here into a buffer
-      MITK_INFO << "Using ZLib version: '" << zlibVersion() << "'" << std::endl
-                << "Attempting to compress " << m_OneTimeStepImageSizeInBytes << " image bytes into a buffer of size "
-                << bufferSize << std::endl;
-    }
+  if (itk::Object::GetDebug())
+  {
+    MITK_INFO << "Using ZLib version: '" << zlibVersion() << "'" << std::endl
+              << "Attempting to compress " << m_NumberOfTimeSteps << " x " << m_OneTimeStepImageSizeInBytes
+              << " image bytes in chunks of " << m_SliceSizeInBytes << " bytes" << std::endl;
+  }
+
+  const int numberOfChunks = static_cast<int>(m_NumberOfTimeSteps * m_NumberOfSlices);
+  m_Chunks.resize(numberOfChunks);
 
-    ImageReadAccessor imgAcc(image, image->GetVolumeData(timestep));
-    ::Bytef *dest(byteBuffer);
-    ::uLongf destLen(bufferSize);
-    auto *source((unsigned char *)imgAcc.GetData());
-    ::uLongf sourceLen(m_OneTimeStepImageSizeInBytes);
-    int zlibRetVal = ::compress(dest, &destLen, source, sourceLen);
-    if (itk::Object::GetDebug())
+  // exceptions must not leave an OpenMP region, the first one is rethrown after it
+  std::exception_ptr exception;
+
+#pragma omp parallel
+  {
+    // each slice is compressed into a buffer of the worst case size and copied to a chunk of the
+    // actually needed size afterwards, so that the peak memory stays at one buffer per thread
+    ChunkType buffer;
+
+#pragma omp for schedule(dynamic)
+    for (int chunk = 0; chunk < numberOfChunks; ++chunk)
     {
-      if (zlibRetVal == Z_OK)
+      const unsigned int timestep = chunk / m_NumberOfSlices;
+      const unsigned int slice = chunk % m_NumberOfSlices;
+      auto *source = static_cast<const unsigned char *>(accessors[timestep]->GetData()) + slice * m_SliceSizeInBytes;
+
+      try
       {
-        MITK_INFO << "Success, using " << destLen << " bytes of the buffer (ratio "
-                  << ((double)destLen / (double)sourceLen) << ")" << std::endl;
+        this->Compress(source, m_Chunks[chunk], buffer);
       }
-      else
+      catch (...)
       {
-        switch (zlibRetVal)
+#pragma omp critical
         {
-          case Z_MEM_ERROR:
-            MITK_ERROR << "not enough memory" << std::endl;
-            break;
-          case Z_BUF_ERROR:
-            MITK_ERROR << "output buffer too small" << std::endl;
-            break;
-          default:
-            MITK_ERROR << "other, unspecified error" << std::endl;
-            break;
+          if (!exception)
+            exception = std::current_exception();
         }
       }
     }
+  }
 
-    // only use the neccessary amount of memory, realloc the buffer!
-    byteBuffer = (unsigned char *)realloc(byteBuffer, destLen);
-    bufferSize = destLen;
-    // MITK_INFO << "Using " << bufferSize << " bytes to store compressed image (" << destLen << " needed)" <<
-    // std::endl;
+  if (exception)
+  {
+    m_Chunks.clear();
+    std::rethrow_exception(exception);
+  }
 
-    m_ByteBuffers.push_back(std::pair<unsigned char *, unsigned long>(byteBuffer, bufferSize));
+  if (itk::Object::GetDebug())
+  {
+    MITK_INFO << "Success, using " << this->GetCompressedSizeInBytes() << " bytes (ratio "
+              << ((double)this->GetCompressedSizeInBytes() / (double)this->GetUncompressedSizeInBytes()) << ")"
+              << std::endl;
   }
 }
 
 mitk::Image::Pointer mitk::CompressedImageContainer::GetImage()
 {
-  if (m_ByteBuffers.empty())
+  if (m_Chunks.empty())
     return nullptr;
 
   // uncompress image data, create an Image
@@ -139,44 +158,200 @@ mitk::Image::Pointer mitk::CompressedImageContainer::GetImage()
   image->Initialize(*m_PixelType, m_ImageDimension, dims); // this IS needed, right ?? But it does allocate memory ->
                                                            // does create one big lump of memory (also in windows)
 
-  unsigned int timeStep(0);
-  for (auto iter = m_ByteBuffers.begin(); iter != m_ByteBuffers.end(); ++iter, ++timeStep)
+  std::vector<std::unique_ptr<ImageWriteAccessor>> accessors;
+  for (unsigned int timestep = 0; timestep < m_NumberOfTimeSteps; ++timestep)
   {
-    ImageReadAccessor imgAcc(image, image->GetVolumeData(timeStep));
-    auto *dest((unsigned char *)imgAcc.GetData());
-    ::uLongf destLen(m_OneTimeStepImageSizeInBytes);
-    ::Bytef *source(iter->first);
-    ::uLongf sourceLen(iter->second);
-    int zlibRetVal = ::uncompress(dest, &destLen, source, sourceLen);
-    if (itk::Object::GetDebug())
+    accessors.emplace_back(new ImageWriteAccessor(image, image->GetVolumeData(timestep)));
+  }
+
+  const int numberOfChunks = static_cast<int>(m_Chunks.size());
+  std::exception_ptr exception;
+
+#pragma omp parallel for schedule(dynamic)
+  for (int chunk = 0; chunk < numberOfChunks; ++chunk)
+  {
+    const unsigned int timestep = chunk / m_NumberOfSlices;
+    const unsigned int slice = chunk % m_NumberOfSlices;
+    auto *dest = static_cast<unsigned char *>(accessors[timestep]->GetData()) + slice * m_SliceSizeInBytes;
+
+    try
     {
-      if (zlibRetVal == Z_OK)
-      {
-        MITK_INFO << "Success, destLen now " << destLen << " bytes" << std::endl;
-      }
-      else
+      this->Uncompress(m_Chunks[chunk], dest);
+    }
+    catch (...)
+    {
+#pragma omp critical
       {
-        switch (zlibRetVal)
-        {
-          case Z_DATA_ERROR:
-            MITK_ERROR << "compressed data corrupted" << std::endl;
-            break;
-          case Z_MEM_ERROR:
-            MITK_ERROR << "not enough memory" << std::endl;
-            break;
-          case Z_BUF_ERROR:
-            MITK_ERROR << "output buffer too small" << std::endl;
-            break;
-          default:
-            MITK_ERROR << "other, unspecified error" << std::endl;
-            break;
-        }
+        if (!exception)
+          exception = std::current_exception();
       }
     }
   }
 
+  accessors.clear();
+
+  if (exception)
+    std::rethrow_exception(exception);
+
   image->SetGeometry(m_ImageGeometry);
   image->Modified();
 
   return image;
 }
+
+void mitk::CompressedImageContainer::GetSliceData(unsigned int slice, unsigned int timeStep, void *buffer) const
+{
+  if (slice >= m_NumberOfSlices || timeStep >= m_NumberOfTimeSteps || m_Chunks.empty())
+    mitkThrow() << "Slice " << slice << " of time step " << timeStep << " is not available.";
+
+  this->Uncompress(m_Chunks[timeStep * m_NumberOfSlices + slice], static_cast<unsigned char *>(buffer));
+}
+
+unsigned int mitk::CompressedImageContainer::GetNumberOfSlices() const
+{
+  return m_NumberOfSlices;
+}
+
+unsigned int mitk::CompressedImageContainer::GetNumberOfTimeSteps() const
+{
+  return m_NumberOfTimeSteps;
+}
+
+unsigned long mitk::CompressedImageContainer::GetSliceSizeInBytes() const
+{
+  return m_SliceSizeInBytes;
+}
+
+unsigned long mitk::CompressedImageContainer::GetUncompressedSizeInBytes() const
+{
+  return m_Chunks.size() * m_SliceSizeInBytes;
+}
+
+unsigned long mitk::CompressedImageContainer::GetCompressedSizeInBytes() const
+{
+  unsigned long size = 0;
+  for (const auto &chunk : m_Chunks)
+    size += chunk.size();
+
+  return size;
+}
+
+void mitk::CompressedImageContainer::Compress(const unsigned char *source, ChunkType &chunk, ChunkType &buffer) const
+{
+  // Slices that would not become smaller are stored as they are. Compressed chunks are always smaller than a
+  // slice, so Uncompress() recognizes these by their size.
+  if (m_ChunkCompressionMethod == RunLength)
+  {
+    // sequence of (run length, pixel value) pairs
+    const std::size_t pixelSize = m_PixelType->GetSize();
+    const std::size_t numberOfPixels = m_SliceSizeInBytes / pixelSize;
+    const std::size_t entrySize = sizeof(unsigned int) + pixelSize;
+
+    buffer.resize(m_SliceSizeInBytes);
+    unsigned char *dest = buffer.data();
+    const unsigned char *destEnd = buffer.data() + buffer.size();
+
+    for (std::size_t pixel = 0; pixel < numberOfPixels;)
+    {
+      const unsigned char *value = source + pixel * pixelSize;
+      unsigned int runLength = 1;
+      while (pixel + runLength < numberOfPixels &&
+             std::memcmp(value, value + runLength * pixelSize, pixelSize) == 0)
+      {
+        ++runLength;
+      }
+
+      if (dest + entrySize >= destEnd)
+      {
+        chunk.assign(source, source + m_SliceSizeInBytes);
+        return;
+      }
+
+      std::memcpy(dest, &runLength, sizeof(unsigned int));
+      std::memcpy(dest + sizeof(unsigned int), value, pixelSize);
+      dest += entrySize;
+      pixel += runLength;
+    }
+
+    chunk.assign(buffer.data(), dest);
+  }
+  else
+  {
+    ::uLongf destLen = ::compressBound(m_SliceSizeInBytes);
+    buffer.resize(destLen);
+
+    int zlibRetVal = ::compress2(buffer.data(), &destLen, source, m_SliceSizeInBytes, m_CompressionLevel);
+
+    switch (zlibRetVal)
+    {
+      case Z_OK:
+        break;
+      case Z_MEM_ERROR:
+        mitkThrow() << "zlib: not enough memory";
+      case Z_BUF_ERROR:
+        mitkThrow() << "zlib: output buffer too small";
+      default:
+        mitkThrow() << "zlib: other, unspecified error";
+    }
+
+    // only use the neccessary amount of memory
+    if (destLen < m_SliceSizeInBytes)
+      chunk.assign(buffer.data(), buffer.data() + destLen);
+    else
+      chunk.assign(source, source + m_SliceSizeInBytes);
+  }
+}
+
+void mitk::CompressedImageContainer::Uncompress(const ChunkType &chunk, unsigned char *dest) const
+{
+  if (chunk.size() == m_SliceSizeInBytes)
+  {
+    // stored uncompressed, see Compress()
+    std::memcpy(dest, chunk.data(), chunk.size());
+  }
+  else if (m_ChunkCompressionMethod == RunLength)
+  {
+    const std::size_t pixelSize = m_PixelType->GetSize();
+    const std::size_t entrySize = sizeof(unsigned int) + pixelSize;
+    const unsigned char *destEnd = dest + m_SliceSizeInBytes;
+
+    for (const unsigned char *source = chunk.data(); source < chunk.data() + chunk.size(); source += entrySize)
+    {
+      unsigned int runLength;
+      std::memcpy(&runLength, source, sizeof(unsigned int));
+
+      if (dest + runLength * pixelSize > destEnd)
+        mitkThrow() << "compressed data corrupted";
+
+      if (pixelSize == 1)
+      {
+        std::memset(dest, *(source + sizeof(unsigned int)), runLength);
+        dest += runLength;
+      }
+      else
+      {
+        for (unsigned int i = 0; i < runLength; ++i, dest += pixelSize)
+          std::memcpy(dest, source + sizeof(unsigned int), pixelSize);
+      }
+    }
+  }
+  else
+  {
+    ::uLongf destLen(m_SliceSizeInBytes);
+    int zlibRetVal = ::uncompress(dest, &destLen, chunk.data(), chunk.size());
+
+    switch (zlibRetVal)
+    {
+      case Z_OK:
+        break;
+      case Z_DATA_ERROR:
+        mitkThrow() << "zlib: compressed data corrupted";
+      case Z_MEM_ERROR:
+        mitkThrow() << "zlib: not enough memory";
+      case Z_BUF_ERROR:
+        mitkThrow() << "zlib: output buffer too small";
+      default:
+        mitkThrow() << "zlib: other, unspecified error";
+    }
+  }
+}
@@ -19,6 +19,10 @@ See LICENSE.txt or http://www.mitk.org for details.
 #include "mitkIOUtil.h"
 #include "mitkImageDataItem.h"
 #include "mitkImageReadAccessor.h"
+#include "mitkImageWriteAccessor.h"
+
+#include <cstring>
+#include <vector>
 
 class mitkCompressedImageContainerTestClass
 {
@@ -111,6 +115,115 @@ public:
       }
     }
   }
+
+  static void TestSliceAccess(mitk::CompressedImageContainer *container, mitk::Image *image, unsigned int &numberFailed)
+  {
+    container->SetImage(image);
+
+    std::vector<unsigned char> slice(container->GetSliceSizeInBytes());
+    for (unsigned int timeStep = 0; timeStep < container->GetNumberOfTimeSteps(); ++timeStep)
+    {
+      mitk::ImageReadAccessor origImgAcc(image, image->GetVolumeData(timeStep));
+      auto *originalData((const unsigned char *)origImgAcc.GetData());
+
+      for (unsigned int sliceIndex = 0; sliceIndex < container->GetNumberOfSlices(); ++sliceIndex)
+      {
+        container->GetSliceData(sliceIndex, timeStep, slice.data());
+        if (std::memcmp(slice.data(), originalData + sliceIndex * slice.size(), slice.size()) != 0)
+        {
+          ++numberFailed;
+          std::cerr << "  (EE) Slice " << sliceIndex << " of timestep " << timeStep
+                    << " not identical after uncompression." << std::endl;
+          return;
+        }
+      }
+    }
+  }
+
+  /// label images consist of long runs of equal pixels and must compress well with both methods
+  static void TestLabelImage(unsigned int &numberFailed)
+  {
+    mitk::Image::Pointer image = CreateLabelImage();
+
+    const mitk::CompressedImageContainer::CompressionMethod methods[] = {mitk::CompressedImageContainer::Zlib,
+                                                                        mitk::CompressedImageContainer::RunLength};
+    for (auto method : methods)
+    {
+      mitk::CompressedImageContainer::Pointer container = mitk::CompressedImageContainer::New();
+      container->SetCompressionMethod(method);
+      container->SetCompressionLevel(1);
+      Test(container, image, numberFailed);
+      TestSliceAccess(container, image, numberFailed);
+
+      if (container->GetCompressedSizeInBytes() * 2 > container->GetUncompressedSizeInBytes())
+      {
+        ++numberFailed;
+        std::cerr << "  (EE) Label image compressed poorly by compression method " << method << " ("
+                  << container->GetCompressedSizeInBytes() << " of " << container->GetUncompressedSizeInBytes()
+                  << " bytes)" << std::endl;
+      }
+    }
+  }
+
+  /// compressed data must never be larger than the image, even if the pixels do not compress at all
+  static void TestIncompressibleImage(unsigned int &numberFailed)
+  {
+    unsigned int dims[] = {128, 128, 16};
+    mitk::Image::Pointer image = mitk::Image::New();
+    image->Initialize(mitk::MakeScalarPixelType<unsigned char>(), 3, dims);
+    {
+      mitk::ImageWriteAccessor accessor(image);
+      auto *data = static_cast<unsigned char *>(accessor.GetData());
+      unsigned int state = 12345;
+      for (unsigned int i = 0; i < dims[0] * dims[1] * dims[2]; ++i)
+      {
+        state = state * 1103515245u + 12345u;
+        data[i] = static_cast<unsigned char>(state >> 16);
+      }
+    }
+
+    const mitk::CompressedImageContainer::CompressionMethod methods[] = {mitk::CompressedImageContainer::Zlib,
+                                                                        mitk::CompressedImageContainer::RunLength};
+    for (auto method : methods)
+    {
+      mitk::CompressedImageContainer::Pointer container = mitk::CompressedImageContainer::New();
+      container->SetCompressionMethod(method);
+      Test(container, image, numberFailed);
+      TestSliceAccess(container, image, numberFailed);
+
+      if (container->GetCompressedSizeInBytes() > container->GetUncompressedSizeInBytes())
+      {
+        ++numberFailed;
+        std::cerr << "  (EE) Noise image expanded by compression method " << method << " ("
+                  << container->GetCompressedSizeInBytes() << " of " << container->GetUncompressedSizeInBytes()
+                  << " bytes)" << std::endl;
+      }
+    }
+  }
+
+  /// label image with a few nested boxes
+  static mitk::Image::Pointer CreateLabelImage()
+  {
+    unsigned int dims[] = {128, 128, 64};
+    mitk::Image::Pointer image = mitk::Image::New();
+    image->Initialize(mitk::MakeScalarPixelType<unsigned short>(), 3, dims);
+
+    mitk::ImageWriteAccessor accessor(image);
+    auto *data = static_cast<unsigned short *>(accessor.GetData());
+    for (unsigned int z = 0; z < dims[2]; ++z)
+      for (unsigned int y = 0; y < dims[1]; ++y)
+        for (unsigned int x = 0; x < dims[0]; ++x)
+        {
+          unsigned short label = 0;
+          for (unsigned int border = 8; border < 64 && x >= border && y >= border && z >= border / 2 &&
+                                         x < dims[0] - border && y < dims[1] - border && z < dims[2] - border / 2;
+               border += 16)
+            ++label;
+          data[(z * dims[1] + y) * dims[0] + x] = label;
+        }
+
+    return image;
+  }
 };
 
 /// ctest entry point
@@ -165,6 +278,18 @@ int mitkCompressedImageContainerTest(int argc, char *argv[])
 
   // some real work
   mitkCompressedImageContainerTestClass::Test(container, image, numberFailed);
+  mitkCompressedImageContainerTestClass::TestSliceAccess(container, image, numberFailed);
+
+  std::cout << "Testing run-length encoding" << std::endl;
+  container->SetCompressionMethod(mitk::CompressedImageContainer::RunLength);
+  mitkCompressedImageContainerTestClass::Test(container, image, numberFailed);
+  mitkCompressedImageContainerTestClass::TestSliceAccess(container, image, numberFailed);
+
+  std::cout << "Testing incompressible image" << std::endl;
+  mitkCompressedImageContainerTestClass::TestIncompressibleImage(numberFailed);
+
+  std::cout << "Testing label image" << std::endl;
+  mitkCompressedImageContainerTestClass::TestLabelImage(numberFailed);
 
   std::cout << "Testing destruction" << std::endl;
 
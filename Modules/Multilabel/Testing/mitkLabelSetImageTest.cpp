@@ -15,11 +15,15 @@ See LICENSE.txt or http://www.mitk.org for details.
 ===================================================================*/
 
 #include <mitkIOUtil.h>
+#include <mitkImagePixelReadAccessor.h>
+#include <mitkImagePixelWriteAccessor.h>
 #include <mitkImageStatisticsHolder.h>
 #include <mitkLabelSetImage.h>
 #include <mitkTestFixture.h>
 #include <mitkTestingMacros.h>
 
+#include <chrono>
+
 class mitkLabelSetImageTestSuite : public mitk::TestFixture
 {
   CPPUNIT_TEST_SUITE(mitkLabelSetImageTestSuite);
@@ -35,9 +39,13 @@ class mitkLabelSetImageTestSuite : public mitk::TestFixture
   MITK_TEST(TestExistsLabel);
   MITK_TEST(TestExistsLabelSet);
   MITK_TEST(TestSetActiveLayer);
+  MITK_TEST(TestSetActiveLayerSharesLayerData);
   MITK_TEST(TestRemoveLayer);
   MITK_TEST(TestRemoveLabels);
   MITK_TEST(TestMergeLabel);
+  MITK_TEST(TestRemapLabels);
+  MITK_TEST(TestMergeLabelsKeepsStatistics);
+  MITK_TEST(TestEraseLabelInActiveLayer);
   // TODO check it these functionalities can be moved into a process object
   //  MITK_TEST(TestMergeLabels);
   //  MITK_TEST(TestConcatenate);
@@ -336,6 +344,49 @@ public:
                            mitk::Equal(*newlayer, *m_LabelSetImage->GetActiveLabelSet(), 0.00001, true));
   }
 
+  void TestSetActiveLayerSharesLayerData()
+  {
+    const unsigned int numberOfLayers = 5;
+    for (unsigned int layer = 1; layer < numberOfLayers; ++layer)
+      m_LabelSetImage->AddLayer();
+
+    // write a different value into every layer through the label set image
+    for (unsigned int layer = 0; layer < numberOfLayers; ++layer)
+    {
+      m_LabelSetImage->SetActiveLayer(layer);
+      mitk::ImagePixelWriteAccessor<mitk::LabelSetImage::PixelType, 3> writeAccessor(m_LabelSetImage.GetPointer());
+      itk::Index<3> index = {{10, 20, 30}};
+      writeAccessor.SetPixelByIndex(index, layer + 1);
+    }
+
+    std::size_t layerSize = sizeof(mitk::LabelSetImage::PixelType);
+    for (unsigned int dim = 0; dim < m_LabelSetImage->GetDimension(); ++dim)
+      layerSize *= m_LabelSetImage->GetDimension(dim);
+
+    const unsigned int numberOfSwitches = 100;
+    auto start = std::chrono::steady_clock::now();
+    for (unsigned int i = 0; i < numberOfSwitches; ++i)
+      m_LabelSetImage->SetActiveLayer(i % numberOfLayers);
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    MITK_INFO << "Layer switch: " << 1000.0 * seconds / numberOfSwitches << " ms, " << layerSize / (1024 * 1024)
+              << " MB per layer";
+
+    for (unsigned int layer = 0; layer < numberOfLayers; ++layer)
+    {
+      m_LabelSetImage->SetActiveLayer(layer);
+
+      mitk::ImageReadAccessor imageAccessor(m_LabelSetImage.GetPointer());
+      mitk::ImageReadAccessor layerAccessor(m_LabelSetImage->GetLayerImage(layer));
+      CPPUNIT_ASSERT_MESSAGE("Active layer image and label set image do not share their data",
+                             imageAccessor.GetData() == layerAccessor.GetData());
+
+      mitk::ImagePixelReadAccessor<mitk::LabelSetImage::PixelType, 3> readAccessor(m_LabelSetImage.GetPointer());
+      itk::Index<3> index = {{10, 20, 30}};
+      CPPUNIT_ASSERT_MESSAGE("Layer lost its pixel values while switching layers",
+                             readAccessor.GetPixelByIndex(index) == layer + 1);
+    }
+  }
+
   void TestRemoveLayer()
   {
     // Cache active layer
@@ -443,6 +494,163 @@ public:
     // Check if merge label has 507 + 823 = 1330 pixels
     CPPUNIT_ASSERT_MESSAGE("Label with value 7 was not remove from the image", m_LabelSetImage->GetStatistics()->GetCountOfMaxValuedVoxels() == 1330);
   }
+
+  void TestRemapLabels()
+  {
+    typedef mitk::LabelSetImage::PixelType PixelType;
+    const unsigned int *dims = m_LabelSetImage->GetDimensions();
+
+    // twelve labels arranged in x/z blocks
+    auto blockLabel = [](unsigned int x, unsigned int z) { return static_cast<PixelType>(1 + x / 64 + 4 * (z / 104)); };
+    {
+      mitk::ImagePixelWriteAccessor<PixelType, 3> writeAccessor(m_LabelSetImage.GetPointer());
+      PixelType *data = writeAccessor.GetData();
+      for (unsigned int z = 0; z < dims[2]; ++z)
+        for (unsigned int y = 0; y < dims[1]; ++y)
+          for (unsigned int x = 0; x < dims[0]; ++x)
+            *data++ = blockLabel(x, z);
+    }
+    m_LabelSetImage->Modified();
+
+    for (PixelType value = 1; value <= 12; ++value)
+    {
+      mitk::Label::Pointer label = mitk::Label::New();
+      label->SetValue(value);
+      m_LabelSetImage->GetActiveLabelSet()->AddLabel(label);
+    }
+
+    const std::size_t blockSize = 64 * 256 * 104;
+    CPPUNIT_ASSERT_MESSAGE("Wrong number of voxels", m_LabelSetImage->GetNumberOfVoxels(5) == blockSize);
+    m_LabelSetImage->UpdateCenterOfMass(5);
+    mitk::Point3D centerIndex = m_LabelSetImage->GetLabel(5)->GetCenterOfMassIndex();
+    CPPUNIT_ASSERT_MESSAGE("Wrong center of mass",
+                           mitk::Equal(centerIndex[0], 31.5) && mitk::Equal(centerIndex[1], 127.5) &&
+                             mitk::Equal(centerIndex[2], 155.5));
+
+    // merge 2 into 1, erase 3, swap 11 and 12 in one pass
+    std::vector<PixelType> lookupTable(13);
+    for (PixelType value = 0; value < lookupTable.size(); ++value)
+      lookupTable[value] = value;
+    lookupTable[2] = 1;
+    lookupTable[3] = 0;
+    lookupTable[11] = 12;
+    lookupTable[12] = 11;
+
+    m_LabelSetImage->RemapLabels(lookupTable);
+
+    {
+      mitk::ImagePixelReadAccessor<PixelType, 3> readAccessor(m_LabelSetImage.GetPointer());
+      const PixelType *data = readAccessor.GetData();
+      bool remapped = true;
+      for (unsigned int z = 0; z < dims[2]; ++z)
+        for (unsigned int y = 0; y < dims[1]; ++y)
+          for (unsigned int x = 0; x < dims[0]; ++x)
+            remapped = remapped && *data++ == lookupTable[blockLabel(x, z)];
+      CPPUNIT_ASSERT_MESSAGE("Pixel values were not remapped correctly", remapped);
+    }
+
+    // the statistics are updated together with the pixels
+    CPPUNIT_ASSERT_MESSAGE("Wrong number of voxels of merged label",
+                           m_LabelSetImage->GetNumberOfVoxels(1) == 2 * blockSize);
+    CPPUNIT_ASSERT_MESSAGE("Erased label still has voxels", m_LabelSetImage->GetNumberOfVoxels(3) == 0);
+    CPPUNIT_ASSERT_MESSAGE("Wrong number of exterior voxels", m_LabelSetImage->GetNumberOfVoxels(0) == blockSize);
+    itk::ImageRegion<4> boundingBox = m_LabelSetImage->GetBoundingBox(1);
+    CPPUNIT_ASSERT_MESSAGE("Wrong bounding box of merged label",
+                           boundingBox.GetIndex()[0] == 0 && boundingBox.GetSize()[0] == 128 &&
+                             boundingBox.GetIndex()[2] == 0 && boundingBox.GetSize()[2] == 104);
+    boundingBox = m_LabelSetImage->GetBoundingBox(12);
+    CPPUNIT_ASSERT_MESSAGE("Wrong bounding box of swapped label",
+                           boundingBox.GetIndex()[0] == 128 && boundingBox.GetIndex()[2] == 208);
+
+    m_LabelSetImage->UpdateCenterOfMass(1);
+    centerIndex = m_LabelSetImage->GetLabel(1)->GetCenterOfMassIndex();
+    CPPUNIT_ASSERT_MESSAGE("Wrong center of mass of merged label",
+                           mitk::Equal(centerIndex[0], 63.5) && mitk::Equal(centerIndex[2], 51.5));
+
+    // erasing labels one by one gives the same result as the batched erase
+    mitk::LabelSetImage::Pointer clone = m_LabelSetImage->Clone();
+    std::vector<PixelType> labelsToErase = {4, 5, 6, 7, 8};
+    m_LabelSetImage->EraseLabels(labelsToErase);
+    for (auto value : labelsToErase)
+      clone->EraseLabel(value);
+
+    CPPUNIT_ASSERT_MESSAGE("Batched and single erase differ",
+                           mitk::Equal(*m_LabelSetImage, *clone, mitk::eps, true));
+    CPPUNIT_ASSERT_MESSAGE("Wrong number of exterior voxels after erase",
+                           m_LabelSetImage->GetNumberOfVoxels(0) == 6 * blockSize);
+  }
+
+  void TestMergeLabelsKeepsStatistics()
+  {
+    typedef mitk::LabelSetImage::PixelType PixelType;
+    const itk::Index<3> index = {{10, 20, 30}};
+
+    {
+      mitk::ImagePixelWriteAccessor<PixelType, 3> writeAccessor(m_LabelSetImage.GetPointer());
+      writeAccessor.SetPixelByIndex(index, 1);
+    }
+    m_LabelSetImage->Modified();
+
+    for (PixelType value = 1; value <= 2; ++value)
+    {
+      mitk::Label::Pointer label = mitk::Label::New();
+      label->SetValue(value);
+      m_LabelSetImage->GetActiveLabelSet()->AddLabel(label);
+    }
+    CPPUNIT_ASSERT_MESSAGE("Wrong number of voxels", m_LabelSetImage->GetNumberOfVoxels(1) == 1);
+
+    // change a pixel without notifying the image, only a rescan of the image would notice
+    {
+      mitk::ImagePixelWriteAccessor<PixelType, 3> writeAccessor(m_LabelSetImage.GetPointer());
+      writeAccessor.SetPixelByIndex(index, 3);
+    }
+
+    // merging modifies the label set before remapping, which must not invalidate the cached statistics
+    std::vector<PixelType> sourceValues(1, 2);
+    m_LabelSetImage->MergeLabels(1, sourceValues, m_LabelSetImage->GetActiveLayer());
+    CPPUNIT_ASSERT_MESSAGE("Statistics were recomputed instead of remapped after merging",
+                           m_LabelSetImage->GetNumberOfVoxels(1) == 1 && m_LabelSetImage->GetNumberOfVoxels(3) == 0);
+
+    // removing labels modifies the label set before erasing as well
+    std::vector<PixelType> labelsToRemove(1, 1);
+    m_LabelSetImage->RemoveLabels(labelsToRemove, m_LabelSetImage->GetActiveLayer());
+    CPPUNIT_ASSERT_MESSAGE("Statistics were recomputed instead of remapped after removing",
+                           m_LabelSetImage->GetNumberOfVoxels(1) == 0 && m_LabelSetImage->GetNumberOfVoxels(3) == 0);
+
+    // notifying the image about the pixel change invalidates the statistics
+    m_LabelSetImage->Modified();
+    CPPUNIT_ASSERT_MESSAGE("Statistics were not recomputed after modifying the pixels",
+                           m_LabelSetImage->GetNumberOfVoxels(3) == 1);
+  }
+
+  void TestEraseLabelInActiveLayer()
+  {
+    typedef mitk::LabelSetImage::PixelType PixelType;
+    const itk::Index<3> index = {{10, 20, 30}};
+
+    m_LabelSetImage->AddLayer();
+    for (unsigned int layer = 0; layer < 2; ++layer)
+    {
+      m_LabelSetImage->SetActiveLayer(layer);
+      mitk::ImagePixelWriteAccessor<PixelType, 3> writeAccessor(m_LabelSetImage.GetPointer());
+      writeAccessor.SetPixelByIndex(index, 3);
+    }
+    m_LabelSetImage->Modified();
+
+    // the layer with the label is active, as when erasing from the label set widget
+    m_LabelSetImage->EraseLabel(3, m_LabelSetImage->GetActiveLayer());
+    {
+      mitk::ImagePixelReadAccessor<PixelType, 3> readAccessor(m_LabelSetImage.GetPointer());
+      CPPUNIT_ASSERT_MESSAGE("Label was not erased from the active layer", readAccessor.GetPixelByIndex(index) == 0);
+    }
+    CPPUNIT_ASSERT_MESSAGE("Erased label still has voxels in the active layer",
+                           m_LabelSetImage->GetNumberOfVoxels(3, 1) == 0);
+
+    m_LabelSetImage->SetActiveLayer(0);
+    mitk::ImagePixelReadAccessor<PixelType, 3> readAccessor(m_LabelSetImage.GetPointer());
+    CPPUNIT_ASSERT_MESSAGE("Label was erased from an inactive layer", readAccessor.GetPixelByIndex(index) == 3);
+    CPPUNIT_ASSERT_MESSAGE("Inactive layer lost voxels of the label", m_LabelSetImage->GetNumberOfVoxels(3, 0) == 1);
+  }
 };
 
 MITK_TEST_SUITE_REGISTRATION(mitkLabelSetImage)
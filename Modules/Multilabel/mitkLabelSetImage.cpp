@@ -20,6 +20,8 @@ See LICENSE.txt or http://www.mitk.org for details.
 #include "mitkImageCast.h"
 #include "mitkImagePixelReadAccessor.h"
 #include "mitkImagePixelWriteAccessor.h"
+#include "mitkImageReadAccessor.h"
+#include "mitkImageWriteAccessor.h"
 #include "mitkInteractionConst.h"
 #include "mitkLookupTableProperty.h"
 #include "mitkPadImageFilter.h"
@@ -38,6 +40,9 @@ See LICENSE.txt or http://www.mitk.org for details.
 
 #include <itkCommand.h>
 
+#include <algorithm>
+#include <limits>
+
 template <typename TPixel, unsigned int VDimensions>
 void SetToZero(itk::Image<TPixel, VDimensions> *source)
 {
@@ -64,8 +69,27 @@ void CreateLabelMaskProcessing(mitk::Image *layerImage, mitk::Image *mask, mitk:
   }
 }
 
+// lookup table for mitk::LabelSetImage::RemapLabels() which maps all source values to the target value
+static std::vector<mitk::LabelSet::PixelType> CreateMergeLookupTable(
+  mitk::LabelSet::PixelType targetPixelValue, const std::vector<mitk::LabelSet::PixelType> &sourcePixelValues)
+{
+  std::vector<mitk::LabelSet::PixelType> lookupTable;
+  for (auto sourcePixelValue : sourcePixelValues)
+  {
+    if (lookupTable.size() <= sourcePixelValue)
+    {
+      const std::size_t oldSize = lookupTable.size();
+      lookupTable.resize(static_cast<std::size_t>(sourcePixelValue) + 1);
+      for (std::size_t value = oldSize; value < lookupTable.size(); ++value)
+        lookupTable[value] = static_cast<mitk::LabelSet::PixelType>(value);
+    }
+    lookupTable[sourcePixelValue] = targetPixelValue;
+  }
+  return lookupTable;
+}
+
 mitk::LabelSetImage::LabelSetImage()
-  : mitk::Image(), m_ActiveLayer(0), m_activeLayerInvalid(false), m_ExteriorLabel(nullptr)
+  : mitk::Image(), m_ActiveLayer(0), m_activeLayerInvalid(false), m_ExteriorLabel(nullptr), m_ActiveLayerDataMTime(0)
 {
   // Iniitlaize Background Label
   mitk::Color color;
@@ -85,7 +109,8 @@ mitk::LabelSetImage::LabelSetImage(const mitk::LabelSetImage &other)
   : Image(other),
     m_ActiveLayer(other.GetActiveLayer()),
     m_activeLayerInvalid(false),
-    m_ExteriorLabel(other.GetExteriorLabel()->Clone())
+    m_ExteriorLabel(other.GetExteriorLabel()->Clone()),
+    m_ActiveLayerDataMTime(0)
 {
   for (unsigned int i = 0; i < other.GetNumberOfLayers(); i++)
   {
@@ -102,13 +127,27 @@ mitk::LabelSetImage::LabelSetImage(const mitk::LabelSetImage &other)
     m_LayerContainer.push_back(liClone);
   }
 
+  // the active layer of the clone refers to the same data as the cloned image, unless the
+  // data of the other image was replaced since its layer was activated
+  if (other.IsActiveLayerReferenced())
+  {
+    this->ReferenceLayerImage(m_ActiveLayer);
+  }
+
   // Add some DICOM Tags as properties to segmentation image
   DICOMSegmentationPropertyHelper::DeriveDICOMSegmentationProperties(this);
 }
 
 void mitk::LabelSetImage::OnLabelSetModified()
+{
+  // the pixels did not change, so m_ActiveLayerDataMTime is kept
+  Superclass::Modified();
+}
+
+void mitk::LabelSetImage::Modified() const
 {
   Superclass::Modified();
+  m_ActiveLayerDataMTime = this->GetMTime();
 }
 
 void mitk::LabelSetImage::SetExteriorLabel(mitk::Label *label)
@@ -142,15 +181,8 @@ void mitk::LabelSetImage::Initialize(const mitk::Image *other)
   auto originalGeometry = other->GetTimeGeometry()->Clone();
   this->SetTimeGeometry(originalGeometry);
 
-  // initialize image memory to zero
-  if (4 == this->GetDimension())
-  {
-    AccessFixedDimensionByItk(this, SetToZero, 4);
-  }
-  else
-  {
-    AccessByItk(this, SetToZero);
-  }
+  // the image memory is not allocated here, the image references the (zero initialized) layer added below
+  m_activeLayerInvalid = true;
 
   // Transfer some general DICOM properties from the source image to derived image (e.g. Patient information,...)
   DICOMQIPropertyHelper::DeriveDICOMSourceProperties(other, this);
@@ -204,6 +236,7 @@ void mitk::LabelSetImage::RemoveLayer()
   // remove labelset and image data
   m_LabelSetContainer.erase(m_LabelSetContainer.begin() + layerToDelete);
   m_LayerContainer.erase(m_LayerContainer.begin() + layerToDelete);
+  m_LayerStatistics.clear();
 
   if (layerToDelete == 0)
   {
@@ -303,47 +336,38 @@ void mitk::LabelSetImage::SetActiveLayer(unsigned int layer)
 {
   try
   {
-    if (4 == this->GetDimension())
+    if ((layer != GetActiveLayer() || m_activeLayerInvalid || !IsActiveLayerReferenced()) &&
+        (layer < this->GetNumberOfLayers()))
     {
-      if ((layer != GetActiveLayer() || m_activeLayerInvalid) && (layer < this->GetNumberOfLayers()))
-      {
-        BeforeChangeLayerEvent.Send();
+      BeforeChangeLayerEvent.Send();
 
-        if (m_activeLayerInvalid)
-        {
-          // We should not write the invalid layer back to the vector
-          m_activeLayerInvalid = false;
-        }
-        else
-        {
-          AccessFixedDimensionByItk_n(this, ImageToLayerContainerProcessing, 4, (GetActiveLayer()));
-        }
-        m_ActiveLayer = layer; // only at this place m_ActiveLayer should be manipulated!!! Use Getter and Setter
-        AccessFixedDimensionByItk_n(this, LayerContainerToImageProcessing, 4, (GetActiveLayer()));
-
-        AfterChangeLayerEvent.Send();
+      if (m_activeLayerInvalid)
+      {
+        // We should not write the invalid layer back to the vector
+        m_activeLayerInvalid = false;
       }
-    }
-    else
-    {
-      if ((layer != GetActiveLayer() || m_activeLayerInvalid) && (layer < this->GetNumberOfLayers()))
+      else if (!IsActiveLayerReferenced())
       {
-        BeforeChangeLayerEvent.Send();
-
-        if (m_activeLayerInvalid)
+        // the image data was replaced (e.g. by SetVolume()) since the layer was activated,
+        // so the layer does not know the current pixels yet
+        if (4 == this->GetDimension())
         {
-          // We should not write the invalid layer back to the vector
-          m_activeLayerInvalid = false;
+          AccessFixedDimensionByItk_n(this, ImageToLayerContainerProcessing, 4, (GetActiveLayer()));
         }
         else
         {
           AccessByItk_1(this, ImageToLayerContainerProcessing, GetActiveLayer());
         }
-        m_ActiveLayer = layer; // only at this place m_ActiveLayer should be manipulated!!! Use Getter and Setter
-        AccessByItk_1(this, LayerContainerToImageProcessing, GetActiveLayer());
-
-        AfterChangeLayerEvent.Send();
       }
+      else
+      {
+        // the pixels of the layer were changed through this image
+        m_LayerContainer[GetActiveLayer()]->Modified();
+      }
+      m_ActiveLayer = layer; // only at this place m_ActiveLayer should be manipulated!!! Use Getter and Setter
+      this->ReferenceLayerImage(GetActiveLayer());
+
+      AfterChangeLayerEvent.Send();
     }
   }
   catch (itk::ExceptionObject &e)
@@ -353,6 +377,63 @@ void mitk::LabelSetImage::SetActiveLayer(unsigned int layer)
   this->Modified();
 }
 
+void mitk::LabelSetImage::ReferenceLayerImage(unsigned int layer)
+{
+  mitk::Image *layerImage = m_LayerContainer[layer];
+  if (layerImage->GetPixelType() != this->GetPixelType() || layerImage->GetDimension() != this->GetDimension() ||
+      !std::equal(this->GetDimensions(), this->GetDimensions() + this->GetDimension(), layerImage->GetDimensions()))
+  {
+    mitkThrow() << "Layer " << layer << " does not match pixel type and size of the label set image.";
+  }
+
+  const unsigned int numberOfChannels = this->GetImageDescriptor()->GetNumberOfChannels();
+  std::vector<ImageDataItemPointer> layerChannels;
+  for (unsigned int n = 0; n < numberOfChannels; ++n)
+  {
+    layerChannels.push_back(layerImage->GetChannelData(n));
+  }
+
+  MutexHolder lock(m_ImageDataArraysLock);
+  // share the complete channels of the layer image, volumes and slices are recreated on demand as parts of them
+  for (unsigned int n = 0; n < numberOfChannels; ++n)
+  {
+    m_Channels[n] = layerChannels[n];
+  }
+  for (auto &volume : m_Volumes)
+  {
+    volume = nullptr;
+  }
+  for (auto &slice : m_Slices)
+  {
+    slice = nullptr;
+  }
+  m_CompleteData = nullptr;
+}
+
+bool mitk::LabelSetImage::IsActiveLayerReferenced() const
+{
+  if (m_LayerContainer.size() <= static_cast<std::size_t>(GetActiveLayer()) || m_Channels.empty())
+  {
+    return false;
+  }
+
+  MutexHolder lock(m_ImageDataArraysLock);
+  const ImageDataItem *channel = m_Channels[0].GetPointer();
+  if (channel == nullptr)
+  {
+    return false;
+  }
+  // volumes imported after the layer was referenced replace the data
+  for (const auto &volume : m_Volumes)
+  {
+    if (volume.GetPointer() != nullptr && volume->GetParent().GetPointer() != channel)
+    {
+      return false;
+    }
+  }
+  return channel == m_LayerContainer[GetActiveLayer()]->GetChannelData(0).GetPointer();
+}
+
 void mitk::LabelSetImage::Concatenate(mitk::LabelSetImage *other)
 {
   const unsigned int *otherDims = other->GetDimensions();
@@ -420,33 +501,14 @@ bool mitk::LabelSetImage::ExistLabelSet(unsigned int layer) const
 
 void mitk::LabelSetImage::MergeLabel(PixelType pixelValue, PixelType sourcePixelValue, unsigned int layer)
 {
-  try
-  {
-    AccessByItk_2(this, MergeLabelProcessing, pixelValue, sourcePixelValue);
-  }
-  catch (itk::ExceptionObject &e)
-  {
-    mitkThrow() << e.GetDescription();
-  }
-  GetLabelSet(layer)->SetActiveLabel(pixelValue);
-  Modified();
+  std::vector<PixelType> sourcePixelValues(1, sourcePixelValue);
+  this->MergeLabels(pixelValue, sourcePixelValues, layer);
 }
 
 void mitk::LabelSetImage::MergeLabels(PixelType pixelValue, std::vector<PixelType>& vectorOfSourcePixelValues, unsigned int layer)
 {
-  try
-  {
-    for (unsigned int idx = 0; idx < vectorOfSourcePixelValues.size(); idx++)
-    {
-      AccessByItk_2(this, MergeLabelProcessing, pixelValue, vectorOfSourcePixelValues[idx]);
-    }
-  }
-  catch (itk::ExceptionObject &e)
-  {
-    mitkThrow() << e.GetDescription();
-  }
   GetLabelSet(layer)->SetActiveLabel(pixelValue);
-  Modified();
+  this->RemapLabels(CreateMergeLookupTable(pixelValue, vectorOfSourcePixelValues), layer);
 }
 
 void mitk::LabelSetImage::RemoveLabels(std::vector<PixelType> &VectorOfLabelPixelValues, unsigned int layer)
@@ -454,29 +516,78 @@ void mitk::LabelSetImage::RemoveLabels(std::vector<PixelType> &VectorOfLabelPixe
   for (unsigned int idx = 0; idx < VectorOfLabelPixelValues.size(); idx++)
   {
     GetLabelSet(layer)->RemoveLabel(VectorOfLabelPixelValues[idx]);
-    EraseLabel(VectorOfLabelPixelValues[idx], layer);
   }
+  this->EraseLabels(VectorOfLabelPixelValues, layer);
 }
 
 void mitk::LabelSetImage::EraseLabels(std::vector<PixelType> &VectorOfLabelPixelValues, unsigned int layer)
 {
-  for (unsigned int i = 0; i < VectorOfLabelPixelValues.size(); i++)
-  {
-    this->EraseLabel(VectorOfLabelPixelValues[i], layer);
-  }
+  this->RemapLabels(CreateMergeLookupTable(0, VectorOfLabelPixelValues), layer);
 }
 
 void mitk::LabelSetImage::EraseLabel(PixelType pixelValue, unsigned int layer)
 {
-  try
+  this->RemapLabels(CreateMergeLookupTable(0, std::vector<PixelType>(1, pixelValue)), layer);
+}
+
+void mitk::LabelSetImage::RemapLabels(const std::vector<PixelType> &lookupTable, unsigned int layer)
+{
+  if (layer >= m_LayerContainer.size())
   {
-    AccessByItk_2(this, EraseLabelProcessing, pixelValue, layer);
+    mitkThrow() << "Trying to remap labels of non-existing layer " << layer << ".";
   }
-  catch (itk::ExceptionObject &e)
+
+  // a table covering all pixel values keeps the range check out of the pixel loop
+  std::vector<PixelType> table(static_cast<std::size_t>(std::numeric_limits<PixelType>::max()) + 1);
+  for (std::size_t value = 0; value < table.size(); ++value)
   {
-    mitkThrow() << e.GetDescription();
+    table[value] = value < lookupTable.size() ? lookupTable[value] : static_cast<PixelType>(value);
+  }
+
+  // statistics which are up to date can be remapped as well instead of being recomputed later
+  LayerStatistics *statistics = nullptr;
+  if (layer < m_LayerStatistics.size() && m_LayerStatistics[layer].Valid &&
+      m_LayerStatistics[layer].DataMTime == this->GetLayerDataMTime(layer))
+  {
+    statistics = &m_LayerStatistics[layer];
+  }
+
+  mitk::Image *layerImage = this->GetLayerDataImage(layer);
+  std::size_t numberOfPixels = 1;
+  for (unsigned int dim = 0; dim < layerImage->GetDimension(); ++dim)
+  {
+    numberOfPixels *= static_cast<std::size_t>(layerImage->GetDimension(dim));
+  }
+
+  {
+    mitk::ImageWriteAccessor accessor(layerImage);
+    auto *data = static_cast<PixelType *>(accessor.GetData());
+    const auto numberOfPixelsSigned = static_cast<std::ptrdiff_t>(numberOfPixels);
+
+#pragma omp parallel for
+    for (std::ptrdiff_t i = 0; i < numberOfPixelsSigned; ++i)
+    {
+      data[i] = table[data[i]];
+    }
+  }
+
+  if (statistics != nullptr)
+  {
+    LabelStatisticsMapType remappedLabels;
+    for (const auto &label : statistics->Labels)
+    {
+      remappedLabels[table[label.first]].Merge(label.second);
+    }
+    statistics->Labels.swap(remappedLabels);
+  }
+
+  layerImage->Modified();
+  this->Modified();
+
+  if (statistics != nullptr)
+  {
+    statistics->DataMTime = this->GetLayerDataMTime(layer);
   }
-  Modified();
 }
 
 mitk::Label *mitk::LabelSetImage::GetActiveLabel(unsigned int layer)
@@ -521,14 +632,204 @@ mitk::LabelSet *mitk::LabelSetImage::GetActiveLabelSet()
 
 void mitk::LabelSetImage::UpdateCenterOfMass(PixelType pixelValue, unsigned int layer)
 {
-  if (4 == this->GetDimension())
+  mitk::Label *label = this->GetLabel(pixelValue, layer);
+  if (label == nullptr || 4 == this->GetDimension())
   {
-    AccessFixedDimensionByItk_2(this, CalculateCenterOfMassProcessing, 4, pixelValue, layer);
+    return;
   }
-  else
+
+  const LabelStatisticsMapType &labels = this->GetLabelStatistics(layer);
+
+  mitk::Point3D pos;
+  pos.Fill(0.0);
+
+  auto labelIter = labels.find(pixelValue);
+  if (labelIter != labels.end() && labelIter->second.NumberOfVoxels > 0)
+  {
+    for (unsigned int i = 0; i < 3; ++i)
+    {
+      pos[i] = labelIter->second.IndexSum[i] / static_cast<double>(labelIter->second.NumberOfVoxels);
+    }
+  }
+
+  label->SetCenterOfMassIndex(pos);
+  this->GetSlicedGeometry()->IndexToWorld(pos, pos); // TODO: TimeGeometry?
+  label->SetCenterOfMassCoordinates(pos);
+}
+
+std::size_t mitk::LabelSetImage::GetNumberOfVoxels(PixelType pixelValue, unsigned int layer)
+{
+  const LabelStatisticsMapType &labels = this->GetLabelStatistics(layer);
+  auto labelIter = labels.find(pixelValue);
+  return labelIter != labels.end() ? labelIter->second.NumberOfVoxels : 0;
+}
+
+itk::ImageRegion<4> mitk::LabelSetImage::GetBoundingBox(PixelType pixelValue, unsigned int layer)
+{
+  itk::ImageRegion<4> region;
+
+  const LabelStatisticsMapType &labels = this->GetLabelStatistics(layer);
+  auto labelIter = labels.find(pixelValue);
+  if (labelIter == labels.end() || labelIter->second.NumberOfVoxels == 0)
+  {
+    return region;
+  }
+
+  itk::ImageRegion<4>::IndexType index;
+  itk::ImageRegion<4>::SizeType size;
+  for (unsigned int i = 0; i < 4; ++i)
+  {
+    index[i] = labelIter->second.BoundingBoxMin[i];
+    size[i] = static_cast<itk::SizeValueType>(labelIter->second.BoundingBoxMax[i] - labelIter->second.BoundingBoxMin[i] + 1);
+  }
+  region.SetIndex(index);
+  region.SetSize(size);
+  return region;
+}
+
+mitk::LabelSetImage::LabelStatistics::LabelStatistics() : NumberOfVoxels(0)
+{
+  for (unsigned int i = 0; i < 3; ++i)
+  {
+    IndexSum[i] = 0.0;
+  }
+  for (unsigned int i = 0; i < 4; ++i)
+  {
+    BoundingBoxMin[i] = std::numeric_limits<long>::max();
+    BoundingBoxMax[i] = std::numeric_limits<long>::min();
+  }
+}
+
+void mitk::LabelSetImage::LabelStatistics::Merge(const LabelStatistics &other)
+{
+  if (other.NumberOfVoxels == 0)
+  {
+    return;
+  }
+
+  NumberOfVoxels += other.NumberOfVoxels;
+  for (unsigned int i = 0; i < 3; ++i)
+  {
+    IndexSum[i] += other.IndexSum[i];
+  }
+  for (unsigned int i = 0; i < 4; ++i)
+  {
+    BoundingBoxMin[i] = std::min(BoundingBoxMin[i], other.BoundingBoxMin[i]);
+    BoundingBoxMax[i] = std::max(BoundingBoxMax[i], other.BoundingBoxMax[i]);
+  }
+}
+
+mitk::Image *mitk::LabelSetImage::GetLayerDataImage(unsigned int layer)
+{
+  // the active layer may have been replaced through this image (e.g. by SetVolume()), so its pixels are
+  // always accessed here
+  if (layer == this->GetActiveLayer())
+  {
+    return this;
+  }
+  return m_LayerContainer[layer];
+}
+
+unsigned long mitk::LabelSetImage::GetLayerDataMTime(unsigned int layer)
+{
+  // this image is also modified by changes of its label sets, which do not touch the pixels
+  if (layer == this->GetActiveLayer())
+  {
+    return m_ActiveLayerDataMTime;
+  }
+  return m_LayerContainer[layer]->GetMTime();
+}
+
+const mitk::LabelSetImage::LabelStatisticsMapType &mitk::LabelSetImage::GetLabelStatistics(unsigned int layer)
+{
+  if (layer >= m_LayerContainer.size())
+  {
+    mitkThrow() << "Trying to get label statistics of non-existing layer " << layer << ".";
+  }
+
+  if (m_LayerStatistics.size() < m_LayerContainer.size())
+  {
+    m_LayerStatistics.resize(m_LayerContainer.size());
+  }
+
+  LayerStatistics &statistics = m_LayerStatistics[layer];
+  const unsigned long dataMTime = this->GetLayerDataMTime(layer);
+  if (statistics.Valid && statistics.DataMTime == dataMTime)
+  {
+    return statistics.Labels;
+  }
+
+  mitk::Image *layerImage = this->GetLayerDataImage(layer);
+  const unsigned int dimension = layerImage->GetDimension();
+  const long dimX = layerImage->GetDimension(0);
+  const long dimY = dimension > 1 ? layerImage->GetDimension(1) : 1;
+  const long dimZ = dimension > 2 ? layerImage->GetDimension(2) : 1;
+  const long dimT = dimension > 3 ? layerImage->GetDimension(3) : 1;
+  const auto numberOfSlices = static_cast<std::ptrdiff_t>(dimZ * dimT);
+
+  statistics.Labels.clear();
+
+  mitk::ImageReadAccessor accessor(layerImage);
+  const auto *data = static_cast<const PixelType *>(accessor.GetData());
+
+#pragma omp parallel
   {
-    AccessByItk_2(this, CalculateCenterOfMassProcessing, pixelValue, layer);
+    LabelStatisticsMapType sliceLabels;
+
+#pragma omp for
+    for (std::ptrdiff_t slice = 0; slice < numberOfSlices; ++slice)
+    {
+      const long z = static_cast<long>(slice % dimZ);
+      const long t = static_cast<long>(slice / dimZ);
+      const PixelType *sliceData = data + static_cast<std::size_t>(slice) * dimX * dimY;
+
+      for (long y = 0; y < dimY; ++y)
+      {
+        const PixelType *row = sliceData + static_cast<std::size_t>(y) * dimX;
+
+        // labels are mostly contiguous, so runs of equal values are accounted at once
+        long x = 0;
+        while (x < dimX)
+        {
+          const PixelType value = row[x];
+          long end = x + 1;
+          while (end < dimX && row[end] == value)
+          {
+            ++end;
+          }
+
+          const auto runLength = static_cast<std::size_t>(end - x);
+          LabelStatistics &labelStatistics = sliceLabels[value];
+          labelStatistics.NumberOfVoxels += runLength;
+          labelStatistics.IndexSum[0] += 0.5 * runLength * (x + end - 1);
+          labelStatistics.IndexSum[1] += static_cast<double>(runLength) * y;
+          labelStatistics.IndexSum[2] += static_cast<double>(runLength) * z;
+
+          const long runMin[4] = {x, y, z, t};
+          const long runMax[4] = {end - 1, y, z, t};
+          for (unsigned int i = 0; i < 4; ++i)
+          {
+            labelStatistics.BoundingBoxMin[i] = std::min(labelStatistics.BoundingBoxMin[i], runMin[i]);
+            labelStatistics.BoundingBoxMax[i] = std::max(labelStatistics.BoundingBoxMax[i], runMax[i]);
+          }
+
+          x = end;
+        }
+      }
+    }
+
+#pragma omp critical
+    {
+      for (const auto &label : sliceLabels)
+      {
+        statistics.Labels[label.first].Merge(label.second);
+      }
+    }
   }
+
+  statistics.DataMTime = dataMTime;
+  statistics.Valid = true;
+  return statistics.Labels;
 }
 
 unsigned int mitk::LabelSetImage::GetNumberOfLabels(unsigned int layer) const
@@ -744,48 +1045,6 @@ void mitk::LabelSetImage::MaskStampProcessing(ImageType *itkImage, mitk::Image *
   this->Modified();
 }
 
-template <typename ImageType>
-void mitk::LabelSetImage::CalculateCenterOfMassProcessing(ImageType *itkImage, PixelType pixelValue, unsigned int layer)
-{
-  // for now, we just retrieve the voxel in the middle
-  typedef itk::ImageRegionConstIterator<ImageType> IteratorType;
-  IteratorType iter(itkImage, itkImage->GetLargestPossibleRegion());
-  iter.GoToBegin();
-
-  std::vector<typename ImageType::IndexType> indexVector;
-
-  while (!iter.IsAtEnd())
-  {
-    // TODO fix comparison warning more effective
-    if (iter.Get() == pixelValue)
-    {
-      indexVector.push_back(iter.GetIndex());
-    }
-    ++iter;
-  }
-
-  mitk::Point3D pos;
-  pos.Fill(0.0);
-
-  if (!indexVector.empty())
-  {
-    typename itk::ImageRegionConstIteratorWithIndex<ImageType>::IndexType centerIndex;
-    centerIndex = indexVector.at(indexVector.size() / 2);
-    if (centerIndex.GetIndexDimension() == 3)
-    {
-      pos[0] = centerIndex[0];
-      pos[1] = centerIndex[1];
-      pos[2] = centerIndex[2];
-    }
-    else
-      return;
-  }
-
-  GetLabelSet(layer)->GetLabel(pixelValue)->SetCenterOfMassIndex(pos);
-  this->GetSlicedGeometry()->IndexToWorld(pos, pos); // TODO: TimeGeometry?
-  GetLabelSet(layer)->GetLabel(pixelValue)->SetCenterOfMassCoordinates(pos);
-}
-
 template <typename ImageType>
 void mitk::LabelSetImage::ClearBufferProcessing(ImageType *itkImage)
 {
@@ -873,44 +1132,6 @@ void mitk::LabelSetImage::ImageToLayerContainerProcessing(itk::Image<TPixel, VIm
   }
 }
 
-template <typename ImageType>
-void mitk::LabelSetImage::EraseLabelProcessing(ImageType *itkImage, PixelType pixelValue, unsigned int /*layer*/)
-{
-  typedef itk::ImageRegionIterator<ImageType> IteratorType;
-
-  IteratorType iter(itkImage, itkImage->GetLargestPossibleRegion());
-  iter.GoToBegin();
-
-  while (!iter.IsAtEnd())
-  {
-    PixelType value = iter.Get();
-
-    if (value == pixelValue)
-    {
-      iter.Set(0);
-    }
-    ++iter;
-  }
-}
-
-template <typename ImageType>
-void mitk::LabelSetImage::MergeLabelProcessing(ImageType *itkImage, PixelType pixelValue, PixelType index)
-{
-  typedef itk::ImageRegionIterator<ImageType> IteratorType;
-
-  IteratorType iter(itkImage, itkImage->GetLargestPossibleRegion());
-  iter.GoToBegin();
-
-  while (!iter.IsAtEnd())
-  {
-    if (iter.Get() == index)
-    {
-      iter.Set(pixelValue);
-    }
-    ++iter;
-  }
-}
-
 bool mitk::Equal(const mitk::LabelSetImage &leftHandSide,
                  const mitk::LabelSetImage &rightHandSide,
                  ScalarType eps,
@@ -20,6 +20,10 @@ See LICENSE.txt or http://www.mitk.org for details.
 #include <mitkImage.h>
 #include <mitkLabelSet.h>
 
+#include <itkImageRegion.h>
+
+#include <map>
+
 #include <MitkMultilabelExports.h>
 
 namespace mitk
@@ -86,9 +90,35 @@ namespace mitk
     void MergeLabels(PixelType pixelValue, std::vector<PixelType>& vectorOfSourcePixelValues, unsigned int layer = 0);
 
     /**
-      * \brief  */
+     * @brief Replaces every pixel value v of the given layer by lookupTable[v] in a single pass over the image.
+     *
+     * Merging, erasing, reordering and relabeling of any number of labels are all expressed by one lookup
+     * table, so the image is scanned once regardless of the number of affected labels. Pixel values that are
+     * not covered by the table are kept. The label sets are not changed.
+     * @param lookupTable the new pixel value for each old pixel value
+     * @param layer the layer in which the values should be replaced
+     */
+    void RemapLabels(const std::vector<PixelType> &lookupTable, unsigned int layer = 0);
+
+    /**
+     * @brief Sets the center of mass (the mean index of all voxels) of the given label.
+     *
+     * The label statistics of a layer are computed for all labels in one pass when first needed and are
+     * kept up to date by RemapLabels(), so updating several labels does not rescan the image.
+     */
     void UpdateCenterOfMass(PixelType pixelValue, unsigned int layer = 0);
 
+    /**
+     * @brief Returns the number of voxels of the given label in the given layer.
+     */
+    std::size_t GetNumberOfVoxels(PixelType pixelValue, unsigned int layer = 0);
+
+    /**
+     * @brief Returns the index region enclosing all voxels of the given label in the given layer.
+     *        The region is empty if the label has no voxel. For 4D images the fourth index is the time step.
+     */
+    itk::ImageRegion<4> GetBoundingBox(PixelType pixelValue, unsigned int layer = 0);
+
     /**
      * @brief Removes labels from the mitk::LabelSet of given layer.
      *        Calls mitk::LabelSetImage::EraseLabels() which also removes the labels from within the image.
@@ -202,7 +232,10 @@ namespace mitk
     void MaskStamp(mitk::Image *mask, bool forceOverwrite);
 
     /**
-      * \brief  */
+      * \brief Activates the given layer.
+      *
+      * The image data of the LabelSetImage refers to the data of the active layer image, so switching
+      * layers does not copy any pixels. */
     void SetActiveLayer(unsigned int layer);
 
     /**
@@ -252,6 +285,14 @@ namespace mitk
 
     void OnLabelSetModified();
 
+    /**
+     * @brief Marks the image and its pixel data as modified.
+     *
+     * Changes of the label sets modify the image as well, but not its pixels. They are reported through
+     * OnLabelSetModified(), which keeps the time stamp of the pixel data, so cached label statistics stay valid.
+     */
+    void Modified() const override;
+
     /**
      * @brief Sets the label which is used as default exterior label when creating a new layer
      * @param label the label which will be used as new exterior label
@@ -273,6 +314,17 @@ namespace mitk
     LabelSetImage(const LabelSetImage &other);
     ~LabelSetImage() override;
 
+    /**
+     * @brief Lets the image data of this image refer to the data of the given layer image.
+     *        No pixel is copied, all changes of the image are changes of the layer.
+     */
+    void ReferenceLayerImage(unsigned int layer);
+
+    /**
+     * @brief Returns true if the image data still refers to the data of the active layer image
+     */
+    bool IsActiveLayerReferenced() const;
+
     template <typename ImageType1, typename ImageType2>
     void ChangeLayerProcessing(ImageType1 *source, ImageType2 *target);
 
@@ -282,21 +334,9 @@ namespace mitk
     template <typename TPixel, unsigned int VImageDimension>
     void ImageToLayerContainerProcessing(itk::Image<TPixel, VImageDimension> *source, unsigned int layer) const;
 
-    template <typename ImageType>
-    void CalculateCenterOfMassProcessing(ImageType *input, PixelType index, unsigned int layer);
-
     template <typename ImageType>
     void ClearBufferProcessing(ImageType *input);
 
-    template <typename ImageType>
-    void EraseLabelProcessing(ImageType *input, PixelType index, unsigned int layer);
-
-    //  template < typename ImageType >
-    //  void ReorderLabelProcessing( ImageType* input, int index, int layer);
-
-    template <typename ImageType>
-    void MergeLabelProcessing(ImageType *input, PixelType pixelValue, PixelType index);
-
     template <typename ImageType>
     void ConcatenateProcessing(ImageType *input, mitk::LabelSetImage *other);
 
@@ -306,6 +346,47 @@ namespace mitk
     template <typename LabelSetImageType, typename ImageType>
     void InitializeByLabeledImageProcessing(LabelSetImageType *input, ImageType *other);
 
+    /**
+     * @brief Voxel count, index sums and index bounding box of one label.
+     */
+    struct LabelStatistics
+    {
+      LabelStatistics();
+      void Merge(const LabelStatistics &other);
+
+      std::size_t NumberOfVoxels;
+      double IndexSum[3];
+      long BoundingBoxMin[4];
+      long BoundingBoxMax[4];
+    };
+
+    typedef std::map<PixelType, LabelStatistics> LabelStatisticsMapType;
+
+    /**
+     * @brief Cached label statistics of a layer, valid as long as the layer data was not modified
+     *        since DataMTime.
+     */
+    struct LayerStatistics
+    {
+      LayerStatistics() : DataMTime(0), Valid(false) {}
+
+      LabelStatisticsMapType Labels;
+      unsigned long DataMTime;
+      bool Valid;
+    };
+
+    /**
+     * @brief Returns the image holding the pixels of the given layer, i.e. this image for the active layer.
+     */
+    mitk::Image *GetLayerDataImage(unsigned int layer);
+
+    unsigned long GetLayerDataMTime(unsigned int layer);
+
+    /**
+     * @brief Returns the statistics of all labels of the given layer, computed in one pass if outdated.
+     */
+    const LabelStatisticsMapType &GetLabelStatistics(unsigned int layer);
+
     std::vector<LabelSet::Pointer> m_LabelSetContainer;
     std::vector<Image::Pointer> m_LayerContainer;
 
@@ -314,6 +395,11 @@ namespace mitk
     bool m_activeLayerInvalid;
 
     mitk::Label::Pointer m_ExteriorLabel;
+
+    std::vector<LayerStatistics> m_LayerStatistics;
+
+    /** @brief Modification time of the pixels of the active layer, see Modified() */
+    mutable unsigned long m_ActiveLayerDataMTime;
   };
 
   /**
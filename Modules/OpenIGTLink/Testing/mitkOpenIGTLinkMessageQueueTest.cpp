@@ -0,0 +1,239 @@
+/*===================================================================
+
+The Medical Imaging Interaction Toolkit (MITK)
+
+Copyright (c) German Cancer Research Center,
+Division of Medical and Biological Informatics.
+All rights reserved.
+
+This software is distributed WITHOUT ANY WARRANTY; without
+even the implied warranty of MERCHANTABILITY or FITNESS FOR
+A PARTICULAR PURPOSE.
+
+See LICENSE.txt or http://www.mitk.org for details.
+
+===================================================================*/
+
+//TEST
+#include <mitkTestingMacros.h>
+#include <mitkTestFixture.h>
+
+//STD
+#include <thread>
+#include <chrono>
+
+//MITK
+#include "mitkIGTLMessageQueue.h"
+#include "mitkIGTLServer.h"
+#include "mitkIGTLClient.h"
+#include "mitkIGTLMessageFactory.h"
+
+static const std::string HOSTNAME = "localhost";
+
+class mitkOpenIGTLinkMessageQueueTestSuite : public mitk::TestFixture
+{
+  CPPUNIT_TEST_SUITE(mitkOpenIGTLinkMessageQueueTestSuite);
+  MITK_TEST(Test_PushAndPull_KeepsOrder);
+  MITK_TEST(Test_FullQueueDropOldest_KeepsNewestMessages);
+  MITK_TEST(Test_FullQueueDropNewest_KeepsOldestMessages);
+  MITK_TEST(Test_NoBufferingMode_KeepsOnlyLatestMessage);
+  MITK_TEST(Test_SendQueue_NotCountedAsReceived);
+  MITK_TEST(Test_ConcurrentProducerAndConsumer_NoMessageLost);
+  MITK_TEST(Test_Loopback_DeliversMessages);
+  CPPUNIT_TEST_SUITE_END();
+
+private:
+  mitk::IGTLMessageQueue::Pointer m_Queue;
+  mitk::IGTLMessageFactory::Pointer m_MessageFactory;
+
+  igtl::MessageBase::Pointer CreateTransformMessage(const std::string& deviceName)
+  {
+    igtl::MessageBase::Pointer message = m_MessageFactory->CreateInstance("TRANSFORM");
+    message->SetDeviceName(deviceName.c_str());
+    return message;
+  }
+
+public:
+
+  void setUp() override
+  {
+    m_MessageFactory = mitk::IGTLMessageFactory::New();
+    m_Queue = mitk::IGTLMessageQueue::New();
+    m_Queue->EnableNoBufferingMode(false);
+  }
+
+  void tearDown() override
+  {
+    m_Queue = nullptr;
+    m_MessageFactory = nullptr;
+  }
+
+  void Test_PushAndPull_KeepsOrder()
+  {
+    for (int i = 0; i < 10; ++i)
+      m_Queue->PushMessage(this->CreateTransformMessage(std::to_string(i)));
+
+    CPPUNIT_ASSERT_EQUAL(10, m_Queue->GetSize());
+    for (int i = 0; i < 10; ++i)
+    {
+      igtl::TransformMessage::Pointer message = m_Queue->PullTransformMessage();
+      CPPUNIT_ASSERT(message.IsNotNull());
+      CPPUNIT_ASSERT_EQUAL(std::to_string(i), std::string(message->GetDeviceName()));
+    }
+    CPPUNIT_ASSERT(m_Queue->PullTransformMessage().IsNull());
+    CPPUNIT_ASSERT_EQUAL(std::uint64_t(10), m_Queue->GetStatistics(mitk::IGTLMessageQueue::TransformQueue).Pulled);
+  }
+
+  void Test_FullQueueDropOldest_KeepsNewestMessages()
+  {
+    m_Queue->SetQueueCapacity(mitk::IGTLMessageQueue::TransformQueue, 4, mitk::IGTLMessageQueue::DropPolicy::DropOldest);
+    for (int i = 0; i < 10; ++i)
+      m_Queue->PushMessage(this->CreateTransformMessage(std::to_string(i)));
+
+    CPPUNIT_ASSERT_EQUAL(4, m_Queue->GetSize());
+    CPPUNIT_ASSERT_EQUAL(std::uint64_t(6), m_Queue->GetNumberOfDroppedMessages());
+    CPPUNIT_ASSERT_EQUAL(std::string("6"), std::string(m_Queue->PullTransformMessage()->GetDeviceName()));
+  }
+
+  void Test_FullQueueDropNewest_KeepsOldestMessages()
+  {
+    m_Queue->SetQueueCapacity(mitk::IGTLMessageQueue::TransformQueue, 4, mitk::IGTLMessageQueue::DropPolicy::DropNewest);
+    for (int i = 0; i < 10; ++i)
+      m_Queue->PushMessage(this->CreateTransformMessage(std::to_string(i)));
+
+    CPPUNIT_ASSERT_EQUAL(4, m_Queue->GetSize());
+    CPPUNIT_ASSERT_EQUAL(std::uint64_t(6), m_Queue->GetNumberOfDroppedMessages());
+    CPPUNIT_ASSERT_EQUAL(std::string("0"), std::string(m_Queue->PullTransformMessage()->GetDeviceName()));
+  }
+
+  void Test_NoBufferingMode_KeepsOnlyLatestMessage()
+  {
+    m_Queue->EnableNoBufferingMode(true);
+    for (int i = 0; i < 10; ++i)
+      m_Queue->PushMessage(this->CreateTransformMessage(std::to_string(i)));
+
+    CPPUNIT_ASSERT_EQUAL(1, m_Queue->GetSize());
+    CPPUNIT_ASSERT_EQUAL(std::string("9"), std::string(m_Queue->PullTransformMessage()->GetDeviceName()));
+
+    auto statistics = m_Queue->GetStatistics(mitk::IGTLMessageQueue::TransformQueue);
+    CPPUNIT_ASSERT_EQUAL(std::uint64_t(9), statistics.Replaced);
+    CPPUNIT_ASSERT_EQUAL_MESSAGE("Replaced messages are not dropped", std::uint64_t(0), m_Queue->GetNumberOfDroppedMessages());
+  }
+
+  void Test_SendQueue_NotCountedAsReceived()
+  {
+    m_Queue->SetQueueCapacity(mitk::IGTLMessageQueue::SendQueue, 4, mitk::IGTLMessageQueue::DropPolicy::DropNewest);
+    for (int i = 0; i < 10; ++i)
+      m_Queue->PushSendMessage(mitk::IGTLMessage::New(this->CreateTransformMessage(std::to_string(i))));
+
+    CPPUNIT_ASSERT_EQUAL(0, m_Queue->GetSize());
+    CPPUNIT_ASSERT_EQUAL(std::uint64_t(0), m_Queue->GetNumberOfDroppedMessages());
+
+    auto statistics = m_Queue->GetStatistics(mitk::IGTLMessageQueue::SendQueue);
+    CPPUNIT_ASSERT_EQUAL(std::size_t(4), statistics.Depth);
+    CPPUNIT_ASSERT_EQUAL(std::uint64_t(6), statistics.Dropped);
+  }
+
+  void Test_ConcurrentProducerAndConsumer_NoMessageLost()
+  {
+    const int numberOfMessages = 20000;
+    m_Queue->SetCapacity(64, mitk::IGTLMessageQueue::DropPolicy::DropNewest);
+
+    std::vector<igtl::MessageBase::Pointer> messages;
+    for (int i = 0; i < numberOfMessages; ++i)
+      messages.push_back(this->CreateTransformMessage(std::to_string(i)));
+
+    std::thread producer([&]() {
+      for (int i = 0; i < numberOfMessages; ++i)
+      {
+        while (m_Queue->GetSize() >= 64)
+          std::this_thread::yield();
+        m_Queue->PushMessage(messages[i]);
+      }
+    });
+
+    int received = 0;
+    bool ordered = true;
+    while (received < numberOfMessages)
+    {
+      igtl::TransformMessage::Pointer message = m_Queue->PullTransformMessage();
+      if (message.IsNull())
+      {
+        std::this_thread::yield();
+        continue;
+      }
+      ordered = ordered && message.GetPointer() == messages[received].GetPointer();
+      ++received;
+    }
+    producer.join();
+
+    CPPUNIT_ASSERT_MESSAGE("Messages were reordered", ordered);
+    CPPUNIT_ASSERT_EQUAL(std::uint64_t(0), m_Queue->GetNumberOfDroppedMessages());
+  }
+
+  /**
+  * Streams transform messages from a server to a client on localhost and
+  * checks that the statistics of the receiving queue account for every
+  * message that arrived.
+  */
+  void Test_Loopback_DeliversMessages()
+  {
+    const int numberOfMessages = 5000;
+
+    mitk::IGTLServer::Pointer server = mitk::IGTLServer::New(true);
+    server->SetHostname(HOSTNAME);
+    server->SetPortNumber(0);
+    server->EnableNoBufferingMode(false);
+
+    CPPUNIT_ASSERT_MESSAGE("Could not open Connection with Server", server->OpenConnection());
+    CPPUNIT_ASSERT_MESSAGE("Server did not report the chosen port", server->GetPortNumber() > 0);
+
+    mitk::IGTLClient::Pointer client = mitk::IGTLClient::New(true);
+    client->SetHostname(HOSTNAME);
+    client->SetPortNumber(server->GetPortNumber());
+    client->EnableNoBufferingMode(false);
+
+    CPPUNIT_ASSERT_MESSAGE("Could not connect to Server", client->OpenConnection());
+    server->StartCommunication();
+    client->StartCommunication();
+    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+
+    std::thread producer([&]() {
+      for (int i = 0; i < numberOfMessages; ++i)
+        server->SendMessage(mitk::IGTLMessage::New(this->CreateTransformMessage("Loopback")));
+    });
+
+    int received = 0;
+    int idleSteps = 0;
+    while (received < numberOfMessages && idleSteps < 1000)
+    {
+      if (client->GetNextTransformMessage().IsNotNull())
+      {
+        ++received;
+        idleSteps = 0;
+      }
+      else
+      {
+        ++idleSteps;
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+      }
+    }
+    producer.join();
+
+    client->StopCommunication();
+    server->StopCommunication();
+    client->CloseConnection();
+    server->CloseConnection();
+
+    auto sendStatistics = server->GetMessageQueue()->GetStatistics(mitk::IGTLMessageQueue::SendQueue);
+    auto receiveStatistics = client->GetMessageQueue()->GetStatistics(mitk::IGTLMessageQueue::TransformQueue);
+
+    CPPUNIT_ASSERT_MESSAGE("No message arrived at the client", received > 0);
+    CPPUNIT_ASSERT_EQUAL(std::uint64_t(numberOfMessages), sendStatistics.Pushed);
+    CPPUNIT_ASSERT_EQUAL(std::uint64_t(received), receiveStatistics.Pulled);
+    CPPUNIT_ASSERT_EQUAL(receiveStatistics.Pushed,
+                         receiveStatistics.Pulled + receiveStatistics.Dropped + receiveStatistics.Depth);
+  }
+};
+
+MITK_TEST_SUITE_REGISTRATION(mitkOpenIGTLinkMessageQueue)
@@ -17,205 +17,129 @@ See LICENSE.txt or http://www.mitk.org for details.
 #include "mitkIGTLMessageQueue.h"
 #include <string>
 #include "igtlMessageBase.h"
+#include <mitkExceptionMacro.h>
 
-void mitk::IGTLMessageQueue::PushSendMessage(mitk::IGTLMessage::Pointer message)
+template <typename T>
+void mitk::IGTLMessageQueue::PushToQueue(IGTLMessageRingBuffer<T>& queue, const T& message)
 {
-  this->m_Mutex->Lock();
   if (this->m_BufferingType == IGTLMessageQueue::NoBuffering)
-    m_SendQueue.clear();
+    queue.Replace(message);
+  else
+    queue.Push(message);
+}
 
-  m_SendQueue.push_back(message);
-  this->m_Mutex->Unlock();
+template <typename T>
+T mitk::IGTLMessageQueue::PullFromQueue(IGTLMessageRingBuffer<T>& queue)
+{
+  T ret = nullptr;
+  queue.Pop(ret);
+  return ret;
 }
 
-void mitk::IGTLMessageQueue::PushCommandMessage(igtl::MessageBase::Pointer message)
+void mitk::IGTLMessageQueue::PushSendMessage(mitk::IGTLMessage::Pointer message)
 {
-  this->m_Mutex->Lock();
-  if (this->m_BufferingType == IGTLMessageQueue::NoBuffering)
-    m_CommandQueue.clear();
+  this->PushToQueue(m_SendQueue, message);
+}
 
-  m_CommandQueue.push_back(message);
-  this->m_Mutex->Unlock();
+void mitk::IGTLMessageQueue::PushCommandMessage(igtl::MessageBase::Pointer message)
+{
+  this->PushToQueue(m_CommandQueue, message);
 }
 
 void mitk::IGTLMessageQueue::PushMessage(igtl::MessageBase::Pointer msg)
 {
-  this->m_Mutex->Lock();
-
   std::stringstream infolog;
 
   infolog << "Received message of type ";
 
   if (dynamic_cast<igtl::TrackingDataMessage*>(msg.GetPointer()) != nullptr)
   {
-    if (this->m_BufferingType == IGTLMessageQueue::NoBuffering)
-      m_TrackingDataQueue.clear();
-
-    this->m_TrackingDataQueue.push_back(dynamic_cast<igtl::TrackingDataMessage*>(msg.GetPointer()));
+    this->PushToQueue(m_TrackingDataQueue, igtl::TrackingDataMessage::Pointer(dynamic_cast<igtl::TrackingDataMessage*>(msg.GetPointer())));
 
     infolog << "TDATA";
   }
   else if (dynamic_cast<igtl::TransformMessage*>(msg.GetPointer()) != nullptr)
   {
-    if (this->m_BufferingType == IGTLMessageQueue::NoBuffering)
-      m_TransformQueue.clear();
-
-    this->m_TransformQueue.push_back(dynamic_cast<igtl::TransformMessage*>(msg.GetPointer()));
+    this->PushToQueue(m_TransformQueue, igtl::TransformMessage::Pointer(dynamic_cast<igtl::TransformMessage*>(msg.GetPointer())));
 
     infolog << "TRANSFORM";
   }
   else if (dynamic_cast<igtl::StringMessage*>(msg.GetPointer()) != nullptr)
   {
-    if (this->m_BufferingType == IGTLMessageQueue::NoBuffering)
-      m_StringQueue.clear();
-
-    this->m_StringQueue.push_back(dynamic_cast<igtl::StringMessage*>(msg.GetPointer()));
+    this->PushToQueue(m_StringQueue, igtl::StringMessage::Pointer(dynamic_cast<igtl::StringMessage*>(msg.GetPointer())));
 
     infolog << "STRING";
   }
   else if (dynamic_cast<igtl::ImageMessage*>(msg.GetPointer()) != nullptr)
   {
     igtl::ImageMessage::Pointer imageMsg = dynamic_cast<igtl::ImageMessage*>(msg.GetPointer());
-    int* dim = new int[3];
+    int dim[3];
     imageMsg->GetDimensions(dim);
     if (dim[2] > 1)
     {
-      if (this->m_BufferingType == IGTLMessageQueue::NoBuffering)
-        m_Image3dQueue.clear();
-
-      this->m_Image3dQueue.push_back(dynamic_cast<igtl::ImageMessage*>(msg.GetPointer()));
+      this->PushToQueue(m_Image3dQueue, imageMsg);
 
       infolog << "IMAGE3D";
     }
     else
     {
-      if (this->m_BufferingType == IGTLMessageQueue::NoBuffering)
-        m_Image2dQueue.clear();
-
-      this->m_Image2dQueue.push_back(dynamic_cast<igtl::ImageMessage*>(msg.GetPointer()));
+      this->PushToQueue(m_Image2dQueue, imageMsg);
 
       infolog << "IMAGE2D";
     }
   }
   else
   {
-    if (this->m_BufferingType == IGTLMessageQueue::NoBuffering)
-      m_MiscQueue.clear();
-
-    this->m_MiscQueue.push_back(msg);
+    this->PushToQueue(m_MiscQueue, msg);
 
     infolog << "OTHER";
   }
 
+  this->m_Mutex->Lock();
   m_Latest_Message = msg;
+  this->m_Mutex->Unlock();
 
   //MITK_INFO << infolog.str();
-
-  this->m_Mutex->Unlock();
 }
 
 mitk::IGTLMessage::Pointer mitk::IGTLMessageQueue::PullSendMessage()
 {
-  mitk::IGTLMessage::Pointer ret = nullptr;
-  this->m_Mutex->Lock();
-  if (this->m_SendQueue.size() > 0)
-  {
-    ret = this->m_SendQueue.front();
-    this->m_SendQueue.pop_front();
-  }
-  this->m_Mutex->Unlock();
-  return ret;
+  return this->PullFromQueue(m_SendQueue);
 }
 
 igtl::MessageBase::Pointer mitk::IGTLMessageQueue::PullMiscMessage()
 {
-  igtl::MessageBase::Pointer ret = nullptr;
-  this->m_Mutex->Lock();
-  if (this->m_MiscQueue.size() > 0)
-  {
-    ret = this->m_MiscQueue.front();
-    this->m_MiscQueue.pop_front();
-  }
-  this->m_Mutex->Unlock();
-  return ret;
+  return this->PullFromQueue(m_MiscQueue);
 }
 
 igtl::ImageMessage::Pointer mitk::IGTLMessageQueue::PullImage2dMessage()
 {
-  igtl::ImageMessage::Pointer ret = nullptr;
-  this->m_Mutex->Lock();
-  if (this->m_Image2dQueue.size() > 0)
-  {
-    ret = this->m_Image2dQueue.front();
-    this->m_Image2dQueue.pop_front();
-  }
-  this->m_Mutex->Unlock();
-  return ret;
+  return this->PullFromQueue(m_Image2dQueue);
 }
 
 igtl::ImageMessage::Pointer mitk::IGTLMessageQueue::PullImage3dMessage()
 {
-  igtl::ImageMessage::Pointer ret = nullptr;
-  this->m_Mutex->Lock();
-  if (this->m_Image3dQueue.size() > 0)
-  {
-    ret = this->m_Image3dQueue.front();
-    this->m_Image3dQueue.pop_front();
-  }
-  this->m_Mutex->Unlock();
-  return ret;
+  return this->PullFromQueue(m_Image3dQueue);
 }
 
 igtl::TrackingDataMessage::Pointer mitk::IGTLMessageQueue::PullTrackingMessage()
 {
-  igtl::TrackingDataMessage::Pointer ret = nullptr;
-  this->m_Mutex->Lock();
-  if (this->m_TrackingDataQueue.size() > 0)
-  {
-    ret = this->m_TrackingDataQueue.front();
-    this->m_TrackingDataQueue.pop_front();
-  }
-  this->m_Mutex->Unlock();
-  return ret;
+  return this->PullFromQueue(m_TrackingDataQueue);
 }
 
 igtl::MessageBase::Pointer mitk::IGTLMessageQueue::PullCommandMessage()
 {
-  igtl::MessageBase::Pointer ret = nullptr;
-  this->m_Mutex->Lock();
-  if (this->m_CommandQueue.size() > 0)
-  {
-    ret = this->m_CommandQueue.front();
-    this->m_CommandQueue.pop_front();
-  }
-  this->m_Mutex->Unlock();
-  return ret;
+  return this->PullFromQueue(m_CommandQueue);
 }
 
 igtl::StringMessage::Pointer mitk::IGTLMessageQueue::PullStringMessage()
 {
-  igtl::StringMessage::Pointer ret = nullptr;
-  this->m_Mutex->Lock();
-  if (this->m_StringQueue.size() > 0)
-  {
-    ret = this->m_StringQueue.front();
-    this->m_StringQueue.pop_front();
-  }
-  this->m_Mutex->Unlock();
-  return ret;
+  return this->PullFromQueue(m_StringQueue);
 }
 
 igtl::TransformMessage::Pointer mitk::IGTLMessageQueue::PullTransformMessage()
 {
-  igtl::TransformMessage::Pointer ret = nullptr;
-  this->m_Mutex->Lock();
-  if (this->m_TransformQueue.size() > 0)
-  {
-    ret = this->m_TransformQueue.front();
-    this->m_TransformQueue.pop_front();
-  }
-  this->m_Mutex->Unlock();
-  return ret;
+  return this->PullFromQueue(m_TransformQueue);
 }
 
 std::string mitk::IGTLMessageQueue::GetNextMsgInformationString()
@@ -286,21 +210,90 @@ std::string mitk::IGTLMessageQueue::GetLatestMsgDeviceType()
 
 int mitk::IGTLMessageQueue::GetSize()
 {
-  return (this->m_CommandQueue.size() + this->m_Image2dQueue.size() + this->m_Image3dQueue.size() + this->m_MiscQueue.size()
-    + this->m_StringQueue.size() + this->m_TrackingDataQueue.size() + this->m_TransformQueue.size());
+  return static_cast<int>(this->m_CommandQueue.GetSize() + this->m_Image2dQueue.GetSize() + this->m_Image3dQueue.GetSize() + this->m_MiscQueue.GetSize()
+    + this->m_StringQueue.GetSize() + this->m_TrackingDataQueue.GetSize() + this->m_TransformQueue.GetSize());
 }
 
 void mitk::IGTLMessageQueue::EnableNoBufferingMode(bool enable)
 {
-  this->m_Mutex->Lock();
   if (enable)
     this->m_BufferingType = IGTLMessageQueue::BufferingType::NoBuffering;
   else
     this->m_BufferingType = IGTLMessageQueue::BufferingType::Infinit;
-  this->m_Mutex->Unlock();
+}
+
+void mitk::IGTLMessageQueue::SetQueueCapacity(QueueType type, std::size_t capacity, DropPolicy policy)
+{
+  switch (type)
+  {
+  case CommandQueue: m_CommandQueue.Reset(capacity, policy); break;
+  case Image2dQueue: m_Image2dQueue.Reset(capacity, policy); break;
+  case Image3dQueue: m_Image3dQueue.Reset(capacity, policy); break;
+  case TransformQueue: m_TransformQueue.Reset(capacity, policy); break;
+  case TrackingDataQueue: m_TrackingDataQueue.Reset(capacity, policy); break;
+  case StringQueue: m_StringQueue.Reset(capacity, policy); break;
+  case MiscQueue: m_MiscQueue.Reset(capacity, policy); break;
+  case SendQueue: m_SendQueue.Reset(capacity, policy); break;
+  default: mitkThrow() << "Unknown queue type " << type;
+  }
+  this->Modified();
+}
+
+void mitk::IGTLMessageQueue::SetCapacity(std::size_t capacity, DropPolicy policy)
+{
+  for (int type = 0; type < NumberOfQueueTypes; ++type)
+    this->SetQueueCapacity(static_cast<QueueType>(type), capacity, policy);
+}
+
+std::size_t mitk::IGTLMessageQueue::GetQueueCapacity(QueueType type)
+{
+  switch (type)
+  {
+  case CommandQueue: return m_CommandQueue.GetCapacity();
+  case Image2dQueue: return m_Image2dQueue.GetCapacity();
+  case Image3dQueue: return m_Image3dQueue.GetCapacity();
+  case TransformQueue: return m_TransformQueue.GetCapacity();
+  case TrackingDataQueue: return m_TrackingDataQueue.GetCapacity();
+  case StringQueue: return m_StringQueue.GetCapacity();
+  case MiscQueue: return m_MiscQueue.GetCapacity();
+  case SendQueue: return m_SendQueue.GetCapacity();
+  default: mitkThrow() << "Unknown queue type " << type;
+  }
+}
+
+mitk::IGTLMessageQueue::Statistics mitk::IGTLMessageQueue::GetStatistics(QueueType type)
+{
+  switch (type)
+  {
+  case CommandQueue: return m_CommandQueue.GetStatistics();
+  case Image2dQueue: return m_Image2dQueue.GetStatistics();
+  case Image3dQueue: return m_Image3dQueue.GetStatistics();
+  case TransformQueue: return m_TransformQueue.GetStatistics();
+  case TrackingDataQueue: return m_TrackingDataQueue.GetStatistics();
+  case StringQueue: return m_StringQueue.GetStatistics();
+  case MiscQueue: return m_MiscQueue.GetStatistics();
+  case SendQueue: return m_SendQueue.GetStatistics();
+  default: mitkThrow() << "Unknown queue type " << type;
+  }
+}
+
+std::uint64_t mitk::IGTLMessageQueue::GetNumberOfDroppedMessages()
+{
+  std::uint64_t dropped = 0;
+  for (int type = 0; type < SendQueue; ++type)
+    dropped += this->GetStatistics(static_cast<QueueType>(type)).Dropped;
+  return dropped;
 }
 
 mitk::IGTLMessageQueue::IGTLMessageQueue()
+  : m_CommandQueue(DefaultCapacity),
+    m_Image2dQueue(DefaultCapacity),
+    m_Image3dQueue(DefaultCapacity),
+    m_TransformQueue(DefaultCapacity),
+    m_TrackingDataQueue(DefaultCapacity),
+    m_StringQueue(DefaultCapacity),
+    m_MiscQueue(DefaultCapacity),
+    m_SendQueue(DefaultCapacity)
 {
   this->m_Mutex = itk::FastMutexLock::New();
   this->m_BufferingType = IGTLMessageQueue::NoBuffering;
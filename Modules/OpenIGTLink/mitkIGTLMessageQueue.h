@@ -23,8 +23,8 @@ See LICENSE.txt or http://www.mitk.org for details.
 #include "itkFastMutexLock.h"
 #include "mitkCommon.h"
 
-#include <deque>
 #include <mitkIGTLMessage.h>
+#include "mitkIGTLMessageRingBuffer.h"
 
 //OpenIGTLink
 #include "igtlMessageBase.h"
@@ -38,6 +38,13 @@ namespace mitk {
   * \class IGTLMessageQueue
   * \brief Thread safe message queue to store OpenIGTLink messages.
   *
+  * Every message type is stored in its own bounded, lock-free ring buffer
+  * (see mitk::IGTLMessageRingBuffer), so the receiving and sending threads of
+  * mitk::IGTLDevice do not contend with the pipeline threads pulling messages.
+  * If a buffer is full, the configured DropPolicy decides whether the oldest
+  * or the newest message is discarded. Queue depth, dropped messages and the
+  * time messages spent in the queue can be queried with GetStatistics().
+  *
   * \ingroup OpenIGTLink
   */
   class MITKOPENIGTLINK_EXPORT IGTLMessageQueue : public itk::Object
@@ -54,6 +61,21 @@ namespace mitk {
        */
     enum BufferingType { Infinit, NoBuffering };
 
+    /**
+     * \brief The queues that are kept for the different message types
+     */
+    enum QueueType { CommandQueue, Image2dQueue, Image3dQueue, TransformQueue,
+      TrackingDataQueue, StringQueue, MiscQueue, SendQueue, NumberOfQueueTypes };
+
+    typedef IGTLMessageRingBufferBase::DropPolicy DropPolicy;
+    typedef IGTLMessageRingBufferBase::Statistics Statistics;
+
+    /**
+     * \brief Default number of messages that fit into one queue
+     * Infinit buffering is bounded by this capacity as well.
+     */
+    static const std::size_t DefaultCapacity = 1024;
+
     void PushSendMessage(mitk::IGTLMessage::Pointer message);
 
     /**
@@ -78,7 +100,8 @@ namespace mitk {
     mitk::IGTLMessage::Pointer PullSendMessage();
 
     /**
-    * \brief Get the number of messages in the queue
+    * \brief Get the number of received messages in the queue. The send queue
+    * is not included, see GetStatistics(SendQueue).
     */
     int GetSize();
 
@@ -105,38 +128,75 @@ namespace mitk {
     std::string GetLatestMsgDeviceType();
 
     /**
+     * \brief If enabled, every queue only keeps the most recent message.
+     * Older messages are counted as replaced, not as dropped.
      */
     void EnableNoBufferingMode(bool enable);
 
+    /**
+     * \brief Sets capacity and drop policy of one queue.
+     *
+     * All messages in that queue are discarded and its statistics are reset.
+     * Must not be called while the device is communicating.
+     */
+    void SetQueueCapacity(QueueType type, std::size_t capacity, DropPolicy policy = DropPolicy::DropOldest);
+
+    /**
+     * \brief Sets capacity and drop policy of all queues, see SetQueueCapacity()
+     */
+    void SetCapacity(std::size_t capacity, DropPolicy policy = DropPolicy::DropOldest);
+
+    std::size_t GetQueueCapacity(QueueType type);
+
+    /**
+     * \brief Returns the counters (pushed, pulled, dropped, replaced, depth and latency)
+     * of one queue
+     */
+    Statistics GetStatistics(QueueType type);
+
+    /**
+     * \brief Returns the number of received messages that were dropped because
+     * a queue was full. Like GetSize() this does not include the send queue.
+     * Messages superseded in no buffering mode are not dropped but replaced,
+     * see Statistics::Replaced.
+     */
+    std::uint64_t GetNumberOfDroppedMessages();
+
   protected:
     IGTLMessageQueue();
     ~IGTLMessageQueue() override;
 
   protected:
+    template <typename T>
+    void PushToQueue(IGTLMessageRingBuffer<T>& queue, const T& message);
+
+    template <typename T>
+    T PullFromQueue(IGTLMessageRingBuffer<T>& queue);
+
     /**
-    * \brief Mutex to take car of the queue
+    * \brief Mutex to protect the latest message. The queues themselves are lock-free.
     */
     itk::FastMutexLock::Pointer m_Mutex;
 
     /**
-    * \brief the queue that stores pointer to the inserted messages
+    * \brief the queues that store pointer to the inserted messages
     */
-    std::deque< igtl::MessageBase::Pointer > m_CommandQueue;
-    std::deque< igtl::ImageMessage::Pointer > m_Image2dQueue;
-    std::deque< igtl::ImageMessage::Pointer > m_Image3dQueue;
-    std::deque< igtl::TransformMessage::Pointer > m_TransformQueue;
-    std::deque< igtl::TrackingDataMessage::Pointer > m_TrackingDataQueue;
-    std::deque< igtl::StringMessage::Pointer > m_StringQueue;
-    std::deque< igtl::MessageBase::Pointer > m_MiscQueue;
+    IGTLMessageRingBuffer< igtl::MessageBase::Pointer > m_CommandQueue;
+    IGTLMessageRingBuffer< igtl::ImageMessage::Pointer > m_Image2dQueue;
+    IGTLMessageRingBuffer< igtl::ImageMessage::Pointer > m_Image3dQueue;
+    IGTLMessageRingBuffer< igtl::TransformMessage::Pointer > m_TransformQueue;
+    IGTLMessageRingBuffer< igtl::TrackingDataMessage::Pointer > m_TrackingDataQueue;
+    IGTLMessageRingBuffer< igtl::StringMessage::Pointer > m_StringQueue;
+    IGTLMessageRingBuffer< igtl::MessageBase::Pointer > m_MiscQueue;
 
-    std::deque< mitk::IGTLMessage::Pointer > m_SendQueue;
+    IGTLMessageRingBuffer< mitk::IGTLMessage::Pointer > m_SendQueue;
 
     igtl::MessageBase::Pointer m_Latest_Message;
 
     /**
     * \brief defines the kind of buffering
     */
-    BufferingType m_BufferingType;
+    std::atomic<BufferingType> m_BufferingType;
   };
 }
 
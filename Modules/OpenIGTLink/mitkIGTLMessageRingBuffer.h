@@ -0,0 +1,320 @@
+/*===================================================================
+
+The Medical Imaging Interaction Toolkit (MITK)
+
+Copyright (c) German Cancer Research Center,
+Division of Medical and Biological Informatics.
+All rights reserved.
+
+This software is distributed WITHOUT ANY WARRANTY; without
+even the implied warranty of MERCHANTABILITY or FITNESS FOR
+A PARTICULAR PURPOSE.
+
+See LICENSE.txt or http://www.mitk.org for details.
+
+===================================================================*/
+
+#ifndef IGTLMessageRingBuffer_H
+#define IGTLMessageRingBuffer_H
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace mitk {
+  /**
+  * \brief Type independent declarations of mitk::IGTLMessageRingBuffer
+  *
+  * \ingroup OpenIGTLink
+  */
+  class IGTLMessageRingBufferBase
+  {
+  public:
+    /**
+    * \brief What to do if an element is pushed into a full buffer
+    * DropOldest discards the oldest element to make room for the new one,
+    * DropNewest rejects the new element.
+    */
+    enum DropPolicy { DropOldest, DropNewest };
+
+    struct Statistics
+    {
+      std::uint64_t Pushed = 0;
+      std::uint64_t Pulled = 0;
+      std::uint64_t Dropped = 0;
+      std::uint64_t Replaced = 0;
+      std::size_t Depth = 0;
+      std::size_t MaxDepth = 0;
+      double MeanLatencyInMS = 0.0;
+      double MaxLatencyInMS = 0.0;
+    };
+  };
+
+  /**
+  * \class IGTLMessageRingBuffer
+  * \brief Bounded, lock-free ring buffer used by mitk::IGTLMessageQueue.
+  *
+  * Every slot carries its own sequence number (D. Vyukov's bounded queue), so
+  * producers and consumers never block each other. The usual configuration is
+  * one receiving thread pushing and one pipeline thread pulling, but the
+  * buffer stays correct with more threads on either side. This is what allows
+  * the DropOldest policy: a producer that finds the buffer full simply pops
+  * the oldest element itself before pushing the new one.
+  *
+  * Besides the elements the buffer keeps counters for pushed, pulled,
+  * dropped and replaced elements, the highest observed depth and the time elements spent
+  * inside the buffer.
+  *
+  * \note The capacity is rounded up to the next power of two. It can only be
+  * changed through Reset(), which must not be called while other threads
+  * access the buffer.
+  *
+  * \ingroup OpenIGTLink
+  */
+  template <typename T>
+  class IGTLMessageRingBuffer : public IGTLMessageRingBufferBase
+  {
+  public:
+    explicit IGTLMessageRingBuffer(std::size_t capacity = 64, DropPolicy policy = DropOldest)
+    {
+      this->Reset(capacity, policy);
+    }
+
+    IGTLMessageRingBuffer(const IGTLMessageRingBuffer&) = delete;
+    IGTLMessageRingBuffer& operator=(const IGTLMessageRingBuffer&) = delete;
+
+    /**
+    * \brief Discards all elements and counters and reallocates the buffer.
+    * Not thread safe.
+    */
+    void Reset(std::size_t capacity, DropPolicy policy)
+    {
+      std::size_t size = 1;
+      while (size < capacity)
+        size <<= 1;
+
+      m_Slots = std::vector<Slot>(size);
+      for (std::size_t i = 0; i < size; ++i)
+        m_Slots[i].Sequence.store(i, std::memory_order_relaxed);
+
+      m_Mask = size - 1;
+      m_DropPolicy = policy;
+      m_EnqueuePos.store(0, std::memory_order_relaxed);
+      m_DequeuePos.store(0, std::memory_order_relaxed);
+      m_Pushed.store(0, std::memory_order_relaxed);
+      m_Pulled.store(0, std::memory_order_relaxed);
+      m_Dropped.store(0, std::memory_order_relaxed);
+      m_Replaced.store(0, std::memory_order_relaxed);
+      m_MaxDepth.store(0, std::memory_order_relaxed);
+      m_LatencySumInNS.store(0, std::memory_order_relaxed);
+      m_MaxLatencyInNS.store(0, std::memory_order_relaxed);
+    }
+
+    std::size_t GetCapacity() const { return m_Mask + 1; }
+    DropPolicy GetDropPolicy() const { return m_DropPolicy; }
+
+    /**
+    * \brief Adds an element. Returns false if the element (DropNewest) or an
+    * older element (DropOldest) had to be dropped.
+    */
+    bool Push(const T& value)
+    {
+      bool droppedSomething = false;
+      while (!this->TryPush(value))
+      {
+        if (m_DropPolicy == DropNewest)
+        {
+          m_Dropped.fetch_add(1, std::memory_order_relaxed);
+          return false;
+        }
+        T discarded;
+        if (this->TryPop(discarded, false))
+        {
+          m_Dropped.fetch_add(1, std::memory_order_relaxed);
+          droppedSomething = true;
+        }
+      }
+      m_Pushed.fetch_add(1, std::memory_order_relaxed);
+      this->UpdateMaxDepth();
+      return !droppedSomething;
+    }
+
+    /**
+    * \brief Removes all elements and adds the new one. The removed elements
+    * are superseded by the new element, so they are counted as replaced
+    * instead of dropped.
+    */
+    bool Replace(const T& value)
+    {
+      T discarded;
+      while (this->TryPop(discarded, false))
+        m_Replaced.fetch_add(1, std::memory_order_relaxed);
+      return this->Push(value);
+    }
+
+    /**
+    * \brief Removes the oldest element. Returns false if the buffer was empty.
+    */
+    bool Pop(T& value)
+    {
+      return this->TryPop(value, true);
+    }
+
+    /**
+    * \brief Removes all elements and counts them as dropped.
+    */
+    void Clear()
+    {
+      T discarded;
+      while (this->TryPop(discarded, false))
+        m_Dropped.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    /**
+    * \brief Number of elements in the buffer. The value is only a snapshot if
+    * other threads access the buffer concurrently.
+    */
+    std::size_t GetSize() const
+    {
+      const std::size_t enqueuePos = m_EnqueuePos.load(std::memory_order_acquire);
+      const std::size_t dequeuePos = m_DequeuePos.load(std::memory_order_acquire);
+      return enqueuePos > dequeuePos ? enqueuePos - dequeuePos : 0;
+    }
+
+    Statistics GetStatistics() const
+    {
+      Statistics statistics;
+      statistics.Pushed = m_Pushed.load(std::memory_order_relaxed);
+      statistics.Pulled = m_Pulled.load(std::memory_order_relaxed);
+      statistics.Dropped = m_Dropped.load(std::memory_order_relaxed);
+      statistics.Replaced = m_Replaced.load(std::memory_order_relaxed);
+      statistics.Depth = this->GetSize();
+      statistics.MaxDepth = m_MaxDepth.load(std::memory_order_relaxed);
+      if (statistics.Pulled > 0)
+        statistics.MeanLatencyInMS = m_LatencySumInNS.load(std::memory_order_relaxed) / (1.0e6 * statistics.Pulled);
+      statistics.MaxLatencyInMS = m_MaxLatencyInNS.load(std::memory_order_relaxed) / 1.0e6;
+      return statistics;
+    }
+
+  private:
+    typedef std::chrono::steady_clock ClockType;
+
+    struct Slot
+    {
+      std::atomic<std::size_t> Sequence;
+      T Value;
+      ClockType::time_point PushTime;
+
+      Slot() : Sequence(0), Value() {}
+      Slot(const Slot&) : Sequence(0), Value() {}
+    };
+
+    bool TryPush(const T& value)
+    {
+      std::size_t pos = m_EnqueuePos.load(std::memory_order_relaxed);
+      for (;;)
+      {
+        Slot& slot = m_Slots[pos & m_Mask];
+        const std::size_t sequence = slot.Sequence.load(std::memory_order_acquire);
+        const std::ptrdiff_t diff = static_cast<std::ptrdiff_t>(sequence) - static_cast<std::ptrdiff_t>(pos);
+        if (diff == 0)
+        {
+          if (m_EnqueuePos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+          {
+            slot.Value = value;
+            slot.PushTime = ClockType::now();
+            slot.Sequence.store(pos + 1, std::memory_order_release);
+            return true;
+          }
+        }
+        else if (diff < 0)
+        {
+          return false; // full
+        }
+        else
+        {
+          pos = m_EnqueuePos.load(std::memory_order_relaxed);
+        }
+      }
+    }
+
+    bool TryPop(T& value, bool countAsPulled)
+    {
+      std::size_t pos = m_DequeuePos.load(std::memory_order_relaxed);
+      for (;;)
+      {
+        Slot& slot = m_Slots[pos & m_Mask];
+        const std::size_t sequence = slot.Sequence.load(std::memory_order_acquire);
+        const std::ptrdiff_t diff = static_cast<std::ptrdiff_t>(sequence) - static_cast<std::ptrdiff_t>(pos + 1);
+        if (diff == 0)
+        {
+          if (m_DequeuePos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+          {
+            value = slot.Value;
+            slot.Value = T();
+            if (countAsPulled)
+              this->RecordLatency(slot.PushTime);
+            slot.Sequence.store(pos + m_Mask + 1, std::memory_order_release);
+            return true;
+          }
+        }
+        else if (diff < 0)
+        {
+          return false; // empty
+        }
+        else
+        {
+          pos = m_DequeuePos.load(std::memory_order_relaxed);
+        }
+      }
+    }
+
+    void RecordLatency(const ClockType::time_point& pushTime)
+    {
+      const std::uint64_t latency = static_cast<std::uint64_t>(
+        std::chrono::duration_cast<std::chrono::nanoseconds>(ClockType::now() - pushTime).count());
+      m_Pulled.fetch_add(1, std::memory_order_relaxed);
+      m_LatencySumInNS.fetch_add(latency, std::memory_order_relaxed);
+      std::uint64_t maxLatency = m_MaxLatencyInNS.load(std::memory_order_relaxed);
+      while (latency > maxLatency && !m_MaxLatencyInNS.compare_exchange_weak(maxLatency, latency, std::memory_order_relaxed))
+      {
+      }
+    }
+
+    void UpdateMaxDepth()
+    {
+      const std::size_t depth = this->GetSize();
+      std::size_t maxDepth = m_MaxDepth.load(std::memory_order_relaxed);
+      while (depth > maxDepth && !m_MaxDepth.compare_exchange_weak(maxDepth, depth, std::memory_order_relaxed))
+      {
+      }
+    }
+
+    std::vector<Slot> m_Slots;
+    std::size_t m_Mask;
+    DropPolicy m_DropPolicy;
+
+    // Producer and consumer positions are kept at least one cache line apart by explicit padding.
+    // alignas() would not be honoured, since the queues owning the buffers are allocated by
+    // itk::Object's plain operator new.
+    static const std::size_t CacheLineSize = 64;
+
+    char m_PadBeforeEnqueuePos[CacheLineSize];
+    std::atomic<std::size_t> m_EnqueuePos;
+    char m_PadBeforeDequeuePos[CacheLineSize - sizeof(std::atomic<std::size_t>)];
+    std::atomic<std::size_t> m_DequeuePos;
+    char m_PadAfterDequeuePos[CacheLineSize - sizeof(std::atomic<std::size_t>)];
+
+    std::atomic<std::uint64_t> m_Pushed;
+    std::atomic<std::uint64_t> m_Pulled;
+    std::atomic<std::uint64_t> m_Dropped;
+    std::atomic<std::uint64_t> m_Replaced;
+    std::atomic<std::size_t> m_MaxDepth;
+    std::atomic<std::uint64_t> m_LatencySumInNS;
+    std::atomic<std::uint64_t> m_MaxLatencyInNS;
+  };
+}
+
+#endif
@@ -56,11 +56,11 @@ bool mitk::IGTLServer::OpenConnection()
   }
 
   //create a new server socket
-  m_Socket = igtl::ServerSocket::New();
+  igtl::ServerSocket::Pointer serverSocket = igtl::ServerSocket::New();
+  m_Socket = serverSocket;
 
   //try to create the igtl server
-  int response = dynamic_cast<igtl::ServerSocket*>(m_Socket.GetPointer())->
-    CreateServer(portNumber);
+  int response = serverSocket->CreateServer(portNumber);
 
   //check the response
   if (response != 0)
@@ -70,6 +70,10 @@ bool mitk::IGTLServer::OpenConnection()
     return false;
   }
 
+  //port 0 lets the operating system choose a free port
+  if (portNumber == 0)
+    this->SetPortNumber(serverSocket->GetServerPort());
+
   // everything is initialized and connected so the communication can be started
   this->SetState(Ready);
 
@@ -14,13 +14,19 @@ See LICENSE.txt or http://www.mitk.org for details.
 
 ===================================================================*/
 
+#include <algorithm>
 #include <mitkACVD.h>
 #include <mitkIOUtil.h>
 #include <mitkTestingMacros.h>
+#include <itkCommand.h>
+#include <itkProcessObject.h>
 #include <sstream>
 #include <vtkDebugLeaks.h>
 #include <vtkPolyData.h>
 #include <vtkSmartPointer.h>
+#include <vtkSphereSource.h>
+#include <vtkTriangleFilter.h>
+#include <vector>
 
 #define _MITK_TEST_FOR_EXCEPTION(STATEMENT, EXCEPTION, MESSAGE)                                                        \
   MITK_TEST_OUTPUT_NO_ENDL(<< MESSAGE)                                                                                 \
@@ -103,6 +109,70 @@ static void Remesh_SurfaceIsValid_ReturnsRemeshedSurface(const std::string &file
                       "Remesh_SurfaceIsValid_ReturnsRemeshedSurface")
 }
 
+static mitk::Surface::Pointer CreateSphere(int resolution)
+{
+  auto sphereSource = vtkSmartPointer<vtkSphereSource>::New();
+  sphereSource->SetThetaResolution(resolution);
+  sphereSource->SetPhiResolution(resolution);
+
+  auto triangleFilter = vtkSmartPointer<vtkTriangleFilter>::New();
+  triangleFilter->SetInputConnection(sphereSource->GetOutputPort());
+  triangleFilter->Update();
+
+  auto surface = mitk::Surface::New();
+  surface->SetVtkPolyData(triangleFilter->GetOutput());
+
+  return surface;
+}
+
+static void RemeshFilter_ReportsProgress()
+{
+  auto filter = mitk::ACVD::RemeshFilter::New();
+  filter->SetInput(CreateSphere(64));
+  filter->SetNumVertices(500);
+
+  std::vector<float> progress;
+  auto progressCommand = itk::CStyleCommand::New();
+  progressCommand->SetClientData(&progress);
+  progressCommand->SetConstCallback([](const itk::Object *caller, const itk::EventObject &, void *clientData) {
+    static_cast<std::vector<float> *>(clientData)->push_back(static_cast<const itk::ProcessObject *>(caller)->GetProgress());
+  });
+  filter->AddObserver(itk::ProgressEvent(), progressCommand);
+  filter->Update();
+
+  MITK_TEST_CONDITION(progress.size() > 2 && std::is_sorted(progress.begin(), progress.end()) && progress.back() == 1.0f,
+                      "RemeshFilter_ReportsProgress")
+}
+
+static void RemeshFilter_AbortGenerateData_ThrowsException()
+{
+  auto filter = mitk::ACVD::RemeshFilter::New();
+  filter->SetInput(CreateSphere(64));
+  filter->SetNumVertices(500);
+
+  auto abortCommand = itk::CStyleCommand::New();
+  abortCommand->SetCallback([](itk::Object *caller, const itk::EventObject &, void *) {
+    static_cast<itk::ProcessObject *>(caller)->AbortGenerateDataOn();
+  });
+  filter->AddObserver(itk::ProgressEvent(), abortCommand);
+
+  _MITK_TEST_FOR_EXCEPTION(
+    filter->Update(), itk::ProcessAborted, "RemeshFilter_AbortGenerateData_ThrowsException")
+}
+
+static void Remesh_Sphere_ReducesNumberOfVertices()
+{
+  auto sphere = CreateSphere(128);
+  auto numInputVertices = sphere->GetVtkPolyData()->GetNumberOfPoints();
+  int numVertices = static_cast<int>(numInputVertices / 10);
+
+  auto remeshedSurface = mitk::ACVD::Remesh(sphere.GetPointer(), 0, numVertices, 0.0);
+
+  MITK_TEST_CONDITION(remeshedSurface.IsNotNull() && remeshedSurface->GetVtkPolyData()->GetNumberOfPolys() != 0 &&
+                        remeshedSurface->GetVtkPolyData()->GetNumberOfPoints() < numInputVertices,
+                      "Remesh_Sphere_ReducesNumberOfVertices")
+}
+
 int mitkACVDTest(int argc, char *argv[])
 {
   if (argc != 10)
@@ -138,5 +208,9 @@ int mitkACVDTest(int argc, char *argv[])
   Remesh_SurfaceIsValid_ReturnsRemeshedSurface(
     filename, t, numVertices, gradation, subsampling, edgeSplitting, optimizationLevel, forceManifold, boundaryFixing);
 
+  RemeshFilter_ReportsProgress();
+  RemeshFilter_AbortGenerateData_ThrowsException();
+  Remesh_Sphere_ReducesNumberOfVertices();
+
   MITK_TEST_END()
 }
@@ -16,6 +16,8 @@ See LICENSE.txt or http://www.mitk.org for details.
 
 #include "mitkACVD.h"
 #include <mitkExceptionMacro.h>
+#include <vtkCallbackCommand.h>
+#include <vtkCommand.h>
 #include <vtkIdList.h>
 #include <vtkIntArray.h>
 #include <vtkIsotropicDiscreteRemeshing.h>
@@ -25,6 +27,12 @@ See LICENSE.txt or http://www.mitk.org for details.
 #include <vtkSmartPointer.h>
 #include <vtkSurface.h>
 
+#include <itkProcessObject.h>
+
+#include <algorithm>
+#include <functional>
+#include <vector>
+
 struct ClustersQuadrics
 {
   explicit ClustersQuadrics(int size) : Elements(new double *[size]), Size(size)
@@ -54,6 +62,30 @@ private:
   ClustersQuadrics &operator=(const ClustersQuadrics &);
 };
 
+// Maps the progress events of the ACVD clusterer to a subrange of the overall remeshing progress
+struct ClusteringProgress
+{
+  std::function<void(float)> Report;
+  float Start;
+  float End;
+  float Current;
+};
+
+static void ForwardClusteringProgress(vtkObject *, unsigned long eventId, void *clientData, void *callData)
+{
+  auto clusteringProgress = static_cast<ClusteringProgress *>(clientData);
+
+  // Iteration events carry no progress, but still give the callback the chance to abort
+  if (eventId == vtkCommand::ProgressEvent && callData != nullptr)
+  {
+    float value = clusteringProgress->Start +
+                  static_cast<float>(*static_cast<double *>(callData)) * (clusteringProgress->End - clusteringProgress->Start);
+    clusteringProgress->Current = std::max(clusteringProgress->Current, std::min(value, clusteringProgress->End));
+  }
+
+  clusteringProgress->Report(clusteringProgress->Current);
+}
+
 static void ValidateSurface(mitk::Surface::ConstPointer surface, unsigned int t)
 {
   if (surface.IsNull())
@@ -79,11 +111,18 @@ mitk::Surface::Pointer mitk::ACVD::Remesh(mitk::Surface::ConstPointer surface,
                                           double edgeSplitting,
                                           int optimizationLevel,
                                           bool forceManifold,
-                                          bool boundaryFixing)
+                                          bool boundaryFixing,
+                                          const ProgressCallback &progress)
 {
   ValidateSurface(surface, t);
 
+  auto reportProgress = [&progress](float value) {
+    if (progress)
+      progress(value);
+  };
+
   MITK_INFO << "Start remeshing...";
+  reportProgress(0.0f);
 
   vtkSmartPointer<vtkPolyData> surfacePolyData = vtkSmartPointer<vtkPolyData>::New();
   surfacePolyData->DeepCopy(const_cast<Surface *>(surface.GetPointer())->GetVtkPolyData(t));
@@ -100,7 +139,10 @@ mitk::Surface::Pointer mitk::ACVD::Remesh(mitk::Surface::ConstPointer surface,
     numVertices = surfacePolyData->GetNumberOfPoints();
 
   if (edgeSplitting != 0.0)
+  {
     mesh->SplitLongEdges(edgeSplitting);
+    reportProgress(0.1f);
+  }
 
   vtkSmartPointer<vtkIsotropicDiscreteRemeshing> remesher = vtkSmartPointer<vtkIsotropicDiscreteRemeshing>::New();
 
@@ -113,7 +155,18 @@ mitk::Surface::Pointer mitk::ACVD::Remesh(mitk::Surface::ConstPointer surface,
   remesher->SetNumberOfThreads(vtkMultiThreader::GetGlobalDefaultNumberOfThreads());
   remesher->SetSubsamplingThreshold(subsampling);
 
+  // Exceptions thrown by the progress callback to cancel the remeshing leave the clusterer through these observers
+  ClusteringProgress clusteringProgress = {reportProgress, 0.15f, 0.8f, 0.15f};
+  vtkSmartPointer<vtkCallbackCommand> clusteringObserver = vtkSmartPointer<vtkCallbackCommand>::New();
+  clusteringObserver->SetCallback(ForwardClusteringProgress);
+  clusteringObserver->SetClientData(&clusteringProgress);
+  remesher->AddObserver(vtkCommand::ProgressEvent, clusteringObserver);
+  remesher->AddObserver(vtkCommand::IterationEvent, clusteringObserver);
+
+  reportProgress(0.15f);
   remesher->Remesh();
+  remesher->RemoveObserver(clusteringObserver);
+  reportProgress(0.8f);
 
   // Optimization: Minimize distance between input surface and remeshed surface
   if (optimizationLevel != 0)
@@ -127,6 +180,9 @@ mitk::Surface::Pointer mitk::ACVD::Remesh(mitk::Surface::ConstPointer surface,
     int numItems = remesher->GetNumberOfItems();
     int numMisclassifiedItems = 0;
 
+    // Collect the faces of each cluster, so that the clusters can be processed in parallel
+    std::vector<std::vector<vtkIdType>> clusterFaces(numVertices);
+
     for (int i = 0; i < numItems; ++i)
     {
       int cluster = clustering->GetValue(i);
@@ -139,12 +195,11 @@ mitk::Surface::Pointer mitk::ACVD::Remesh(mitk::Surface::ConstPointer surface,
           int numIds = static_cast<int>(faceList->GetNumberOfIds());
 
           for (int j = 0; j < numIds; ++j)
-            vtkQuadricTools::AddTriangleQuadric(
-              clustersQuadrics.Elements[cluster], remesherInput, faceList->GetId(j), false);
+            clusterFaces[cluster].push_back(faceList->GetId(j));
         }
         else
         {
-          vtkQuadricTools::AddTriangleQuadric(clustersQuadrics.Elements[cluster], remesherInput, i, false);
+          clusterFaces[cluster].push_back(i);
         }
       }
       else
@@ -157,17 +212,29 @@ mitk::Surface::Pointer mitk::ACVD::Remesh(mitk::Surface::ConstPointer surface,
       std::cout << numMisclassifiedItems << " items with wrong cluster association" << std::endl;
 
     vtkSmartPointer<vtkSurface> remesherOutput = remesher->GetOutput();
-    double point[3];
+    std::vector<double> points(3 * numVertices);
 
+    // The cell and link lookups of the surfaces are built lazily and must not be queried concurrently,
+    // so only the representative points, which depend on the quadric of their cluster alone, are computed
+    // in parallel.
     for (int i = 0; i < numVertices; ++i)
     {
-      remesherOutput->GetPoint(i, point);
-      vtkQuadricTools::ComputeRepresentativePoint(clustersQuadrics.Elements[i], point, optimizationLevel);
-      remesherOutput->SetPointCoordinates(i, point);
+      for (auto face : clusterFaces[i])
+        vtkQuadricTools::AddTriangleQuadric(clustersQuadrics.Elements[i], remesherInput, face, false);
+
+      remesherOutput->GetPoint(i, &points[3 * i]);
     }
 
+#pragma omp parallel for
+    for (int i = 0; i < numVertices; ++i)
+      vtkQuadricTools::ComputeRepresentativePoint(clustersQuadrics.Elements[i], &points[3 * i], optimizationLevel);
+
+    for (int i = 0; i < numVertices; ++i)
+      remesherOutput->SetPointCoordinates(i, &points[3 * i]);
+
     std::cout << "After quadrics post-processing:" << std::endl;
     remesherOutput->DisplayMeshProperties();
+    reportProgress(0.95f);
   }
 
   vtkSmartPointer<vtkPolyDataNormals> normals = vtkSmartPointer<vtkPolyDataNormals>::New();
@@ -187,6 +254,7 @@ mitk::Surface::Pointer mitk::ACVD::Remesh(mitk::Surface::ConstPointer surface,
   remeshedSurface->SetVtkPolyData(normals->GetOutput());
 
   MITK_INFO << "Finished remeshing";
+  reportProgress(1.0f);
 
   return remeshedSurface;
 }
@@ -211,6 +279,16 @@ mitk::ACVD::RemeshFilter::~RemeshFilter()
 
 void mitk::ACVD::RemeshFilter::GenerateData()
 {
+  auto progress = [this](float value) {
+    if (this->GetAbortGenerateData())
+    {
+      itk::ProcessAborted e(__FILE__, __LINE__);
+      e.SetDescription("Remeshing aborted.");
+      throw e;
+    }
+    this->UpdateProgress(value);
+  };
+
   Surface::Pointer output = Remesh(this->GetInput(),
                                    m_TimeStep,
                                    m_NumVertices,
@@ -219,6 +297,7 @@ void mitk::ACVD::RemeshFilter::GenerateData()
                                    m_EdgeSplitting,
                                    m_OptimizationLevel,
                                    m_ForceManifold,
-                                   m_BoundaryFixing);
+                                   m_BoundaryFixing,
+                                   progress);
   this->SetNthOutput(0, output);
 }
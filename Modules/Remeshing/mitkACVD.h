@@ -21,10 +21,18 @@ See LICENSE.txt or http://www.mitk.org for details.
 #include <mitkSurface.h>
 #include <mitkSurfaceToSurfaceFilter.h>
 
+#include <functional>
+
 namespace mitk
 {
   namespace ACVD
   {
+    /** \brief Called with the progress in the range [0, 1] between the stages of the remeshing and for the
+     * progress and iteration events of the %ACVD clusterer. The remeshing can be cancelled by throwing an exception
+     * from the callback.
+     */
+    typedef std::function<void(float)> ProgressCallback;
+
     /** \brief Remesh a surface and store the result in a new surface.
      *
      * The %ACVD library is used for remeshing which is based on the paper "Approximated Centroidal Voronoi Diagrams for
@@ -54,6 +62,7 @@ namespace mitk
      * parameter.
      * \param[in] optimizationLevel Minimize distance between input surface and remeshed surface.
      * \param[in] boundaryFixing Keep original surface boundaries by adding additional polygons.
+     * \param[in] progress Optional callback, see ProgressCallback.
      * \return Returns the remeshed surface or nullptr if input surface is invalid.
      */
     MITKREMESHING_EXPORT Surface::Pointer Remesh(Surface::ConstPointer surface,
@@ -64,9 +73,13 @@ namespace mitk
                                                  double edgeSplitting = 0.0,
                                                  int optimizationLevel = 1,
                                                  bool forceManifold = false,
-                                                 bool boundaryFixing = false);
+                                                 bool boundaryFixing = false,
+                                                 const ProgressCallback &progress = ProgressCallback());
 
     /** \brief Encapsulates mitk::ACVD::Remesh function as filter.
+     *
+     * The filter reports its progress by itk::ProgressEvent. If AbortGenerateData is set, the filter throws an
+     * itk::ProcessAborted exception with the next progress update.
      */
     class MITKREMESHING_EXPORT RemeshFilter : public mitk::SurfaceToSurfaceFilter
     {
@@ -19,6 +19,7 @@ See LICENSE.txt or http://www.mitk.org for details.
 
 #include <MitkSceneSerializationExports.h>
 
+#include "mitkBaseDataSerializer.h"
 #include "mitkDataStorage.h"
 #include "mitkNodePredicateBase.h"
 
@@ -66,6 +67,9 @@ namespace mitk
      * Attempts to write a scene file, which contains the nodes of the
      * provided DataStorage, their parent/child relations, and properties.
      *
+     * Files which are already compressed by their writers (like images and surfaces) are stored in the
+     * scene file without compressing them again.
+     *
      * \param storage a DataStorage containing all nodes that should be saved
      * \param filename full filename of the scene file
      * \param predicate defining which items of the datastorage to use and which not
@@ -101,7 +105,9 @@ namespace mitk
 
     std::string CreateEmptyTempDirectory();
 
-    TiXmlElement *SaveBaseData(BaseData *data, const std::string &filenamehint, bool &error);
+    BaseDataSerializer::Pointer CreateBaseDataSerializer(BaseData *data, const std::string &filenamehint);
+    static std::string Serialize(BaseDataSerializer *serializer);
+    static std::string GetFilenameHint(DataNode *node);
     TiXmlElement *SavePropertyList(PropertyList *propertyList, const std::string &filenamehint);
 
     void OnUnzipError(const void *pSender, std::pair<const Poco::Zip::ZipLocalFileHeader, const std::string> &info);
@@ -14,7 +14,10 @@ See LICENSE.txt or http://www.mitk.org for details.
 
 ===================================================================*/
 
+#include <Poco/DateTime.h>
 #include <Poco/Delegate.h>
+#include <Poco/DeflatingStream.h>
+#include <Poco/DirectoryIterator.h>
 #include <Poco/Path.h>
 #include <Poco/TemporaryFile.h>
 #include <Poco/Zip/Compress.h>
@@ -39,9 +42,63 @@ See LICENSE.txt or http://www.mitk.org for details.
 #include <fstream>
 #include <mitkIOUtil.h>
 #include <sstream>
+#include <vector>
 
 #include "itksys/SystemTools.hxx"
 
+namespace
+{
+  /**
+   * Deflates the first bytes of the file to decide whether it is worth to compress it. Images and surfaces
+   * are usually compressed by their writers already and are stored as they are.
+   */
+  bool IsCompressible(const std::string &filename)
+  {
+    const std::streamsize sampleSize = 64 * 1024;
+    std::vector<char> sample(sampleSize);
+
+    std::ifstream file(filename.c_str(), std::ios::binary);
+    file.read(sample.data(), sampleSize);
+    const std::streamsize size = file.gcount();
+
+    if (size == 0)
+      return true;
+
+    std::ostringstream compressed;
+    Poco::DeflatingOutputStream deflater(compressed, Poco::DeflatingStreamBuf::STREAM_ZLIB, 1);
+    deflater.write(sample.data(), size);
+    deflater.close();
+
+    return compressed.str().size() < 0.9 * size;
+  }
+
+  void AddDirectoryToArchive(Poco::Zip::Compress &zipper, const Poco::Path &directory, const Poco::Path &nameInArchive)
+  {
+    for (Poco::DirectoryIterator iter(directory), end; iter != end; ++iter)
+    {
+      Poco::Path name(nameInArchive);
+      if (iter->isDirectory())
+      {
+        name.pushDirectory(iter.name());
+        zipper.addDirectory(name, iter->getLastModified());
+        AddDirectoryToArchive(zipper, iter.path(), name);
+      }
+      else
+      {
+        name.setFileName(iter.name());
+        if (IsCompressible(iter->path()))
+        {
+          zipper.addFile(iter.path(), name, Poco::Zip::ZipCommon::CM_DEFLATE, Poco::Zip::ZipCommon::CL_NORMAL);
+        }
+        else
+        {
+          zipper.addFile(iter.path(), name, Poco::Zip::ZipCommon::CM_STORE);
+        }
+      }
+    }
+  }
+}
+
 mitk::SceneIO::SceneIO() : m_WorkingDirectory(""), m_UnzipErrors(0)
 {
 }
@@ -293,17 +350,40 @@ bool mitk::SceneIO::SaveScene(DataStorage::SetOfObjects::ConstPointer sceneNodes
         }
       }
 
+      // write out all base data; this stays sequential, because the writers neither declare whether they are
+      // thread-safe nor avoid progress bar updates, which have to happen on the GUI thread
+      std::vector<DataNode *> nodes(sceneNodes->begin(), sceneNodes->end());
+      std::vector<TiXmlElement *> dataElements(nodes.size(), nullptr);
+      std::vector<BaseDataSerializer::Pointer> serializers(nodes.size());
+      std::vector<std::string> writtenFilenames(nodes.size());
+
+      for (std::size_t i = 0; i < nodes.size(); ++i)
+      {
+        if (nodes[i] && nodes[i]->GetData())
+        {
+          dataElements[i] = new TiXmlElement("data");
+          dataElements[i]->SetAttribute("type", nodes[i]->GetData()->GetNameOfClass());
+          serializers[i] = CreateBaseDataSerializer(nodes[i]->GetData(), GetFilenameHint(nodes[i]));
+        }
+      }
+
+      for (std::size_t i = 0; i < nodes.size(); ++i)
+      {
+        if (serializers[i].IsNotNull())
+        {
+          writtenFilenames[i] = Serialize(serializers[i]);
+        }
+      }
+
       // write out objects, dependencies and properties
-      for (auto iter = sceneNodes->begin(); iter != sceneNodes->end(); ++iter)
+      for (std::size_t i = 0; i < nodes.size(); ++i)
       {
-        DataNode *node = iter->GetPointer();
+        DataNode *node = nodes[i];
 
         if (node)
         {
           auto *nodeElement = new TiXmlElement("node");
-          std::string filenameHint(node->GetName());
-          filenameHint = itksys::SystemTools::MakeCindentifier(
-            filenameHint.c_str()); // escape filename <-- only allow [A-Za-z0-9_], replace everything else with _
+          std::string filenameHint(GetFilenameHint(node));
 
           // store dependencies
           auto searchUIDIter = nodeUIDs.find(node);
@@ -330,13 +410,15 @@ bool mitk::SceneIO::SaveScene(DataStorage::SetOfObjects::ConstPointer sceneNodes
           // store basedata
           if (BaseData *data = node->GetData())
           {
-            // std::string filenameHint( node->GetName() );
-            bool error(false);
-            TiXmlElement *dataElement(SaveBaseData(data, filenameHint, error)); // returns a reference to a file
-            if (error)
+            TiXmlElement *dataElement(dataElements[i]); // contains a reference to a file
+            if (writtenFilenames[i].empty())
             {
               m_FailedNodes->push_back(node);
             }
+            else
+            {
+              dataElement->SetAttribute("file", writtenFilenames[i]);
+            }
 
             // store basedata properties
             PropertyList *propertyList = data->GetPropertyList();
@@ -383,11 +465,11 @@ bool mitk::SceneIO::SaveScene(DataStorage::SetOfObjects::ConstPointer sceneNodes
       } // end for all nodes
     }   // end if sceneNodes
 
-    std::string defaultLocale_WorkingDirectory = Poco::Path::transcode( m_WorkingDirectory );
-
-    if (!document.SaveFile(defaultLocale_WorkingDirectory + Poco::Path::separator() + "index.xml"))
+    // index.xml is written to the archive directly
+    TiXmlPrinter printer;
+    if (!document.Accept(&printer))
     {
-      MITK_ERROR << "Could not write scene to " << defaultLocale_WorkingDirectory << Poco::Path::separator() << "index.xml"
+      MITK_ERROR << "Could not write scene index.xml"
                  << "\nTinyXML reports '" << document.ErrorDesc() << "'";
       return false;
     }
@@ -411,19 +493,26 @@ bool mitk::SceneIO::SaveScene(DataStorage::SetOfObjects::ConstPointer sceneNodes
         else
         {
           Poco::Zip::Compress zipper(file, true);
-          Poco::Path tmpdir(m_WorkingDirectory);
-          zipper.addRecursive(tmpdir);
+          std::istringstream index(printer.CStr());
+          zipper.addFile(index, Poco::DateTime(), Poco::Path("index.xml"));
+          if (!m_WorkingDirectory.empty())
+          {
+            AddDirectoryToArchive(zipper, Poco::Path::forDirectory(m_WorkingDirectory), Poco::Path());
+          }
           zipper.close();
         }
-        try
-        {
-          Poco::File deleteDir(m_WorkingDirectory);
-          deleteDir.remove(true); // recursive
-        }
-        catch (...)
+        if (!m_WorkingDirectory.empty())
         {
-          MITK_ERROR << "Could not delete temporary directory " << m_WorkingDirectory;
-          return false; // ok?
+          try
+          {
+            Poco::File deleteDir(m_WorkingDirectory);
+            deleteDir.remove(true); // recursive
+          }
+          catch (...)
+          {
+            MITK_ERROR << "Could not delete temporary directory " << m_WorkingDirectory;
+            return false; // ok?
+          }
         }
       }
       catch (std::exception &e)
@@ -441,18 +530,14 @@ bool mitk::SceneIO::SaveScene(DataStorage::SetOfObjects::ConstPointer sceneNodes
   }
 }
 
-TiXmlElement *mitk::SceneIO::SaveBaseData(BaseData *data, const std::string &filenamehint, bool &error)
+mitk::BaseDataSerializer::Pointer mitk::SceneIO::CreateBaseDataSerializer(BaseData *data,
+                                                                          const std::string &filenamehint)
 {
-  assert(data);
-  error = true;
-
   // find correct serializer
   // the serializer must
   //  - create a file containing all information to recreate the BaseData object --> needs to know where to put this
   //  file (and a filename?)
   //  - TODO what to do about writers that creates one file per timestep?
-  auto *element = new TiXmlElement("data");
-  element->SetAttribute("type", data->GetNameOfClass());
 
   // construct name of serializer class
   std::string serializername(data->GetNameOfClass());
@@ -475,21 +560,31 @@ TiXmlElement *mitk::SceneIO::SaveBaseData(BaseData *data, const std::string &fil
       serializer->SetFilenameHint(filenamehint);
       std::string defaultLocale_WorkingDirectory = Poco::Path::transcode( m_WorkingDirectory );
       serializer->SetWorkingDirectory(defaultLocale_WorkingDirectory);
-      try
-      {
-        std::string writtenfilename = serializer->Serialize();
-        element->SetAttribute("file", writtenfilename);
-        error = false;
-      }
-      catch (std::exception &e)
-      {
-        MITK_ERROR << "Serializer " << serializer->GetNameOfClass() << " failed: " << e.what();
-      }
-      break;
+      return serializer;
     }
   }
 
-  return element;
+  return nullptr;
+}
+
+std::string mitk::SceneIO::Serialize(BaseDataSerializer *serializer)
+{
+  try
+  {
+    return serializer->Serialize();
+  }
+  catch (std::exception &e)
+  {
+    MITK_ERROR << "Serializer " << serializer->GetNameOfClass() << " failed: " << e.what();
+  }
+
+  return "";
+}
+
+std::string mitk::SceneIO::GetFilenameHint(DataNode *node)
+{
+  // escape filename <-- only allow [A-Za-z0-9_], replace everything else with _
+  return itksys::SystemTools::MakeCindentifier(node->GetName().c_str());
 }
 
 TiXmlElement *mitk::SceneIO::SavePropertyList(PropertyList *propertyList, const std::string &filenamehint)
@@ -18,11 +18,15 @@ See LICENSE.txt or http://www.mitk.org for details.
 #include "Poco/Path.h"
 #include "mitkBaseRenderer.h"
 #include "mitkIOUtil.h"
+#include "mitkLocaleSwitch.h"
 #include "mitkProgressBar.h"
 #include "mitkPropertyListDeserializer.h"
 #include "mitkSerializerMacros.h"
+#include "mitkStringProperty.h"
 #include <mitkRenderingModeProperty.h>
 
+#include <memory>
+
 MITK_REGISTER_SERIALIZER(SceneReaderV1)
 
 namespace
@@ -79,11 +83,96 @@ bool mitk::SceneReaderV1::LoadScene(TiXmlDocument &document, const std::string &
 
   ProgressBar::GetInstance()->AddStepsToDo(listSize * 2);
 
+  std::vector<TiXmlElement *> dataElements;
   for (TiXmlElement *element = document.FirstChildElement("node"); element != nullptr;
        element = element->NextSiblingElement("node"))
   {
-    DataNodes.push_back(LoadBaseDataFromDataTag(element->FirstChildElement("data"), workingDirectory, error));
-    ProgressBar::GetInstance()->Progress();
+    dataElements.push_back(element->FirstChildElement("data"));
+  }
+
+  DataNodes.resize(dataElements.size());
+
+  {
+    // Files whose reader declares itself thread-safe (see IFileReader::IsThreadSafe()) are read in parallel,
+    // all others are read serially on this thread. The locale is switched once here, so that the readers do
+    // not switch it concurrently, and the progress is reported from this thread only.
+    LocaleSwitch localeSwitch("C");
+
+    std::vector<std::unique_ptr<IOUtil::LoadInfo>> loadInfos(dataElements.size());
+    std::vector<int> threadSafeReads;
+    for (std::size_t i = 0; i < dataElements.size(); ++i)
+    {
+      const char *filename = dataElements[i] ? dataElements[i]->Attribute("file") : nullptr;
+      if (filename && strlen(filename) != 0)
+      {
+        std::unique_ptr<IOUtil::LoadInfo> loadInfo(
+          new IOUtil::LoadInfo(workingDirectory + Poco::Path::separator() + filename));
+        IFileReader *reader = loadInfo->m_ReaderSelector.GetSelected().GetReader();
+        if (reader != nullptr && reader->IsThreadSafe())
+        {
+          threadSafeReads.push_back(static_cast<int>(i));
+          loadInfos[i] = std::move(loadInfo);
+        }
+      }
+    }
+
+    std::vector<std::string> readErrors(dataElements.size());
+
+#pragma omp parallel for schedule(dynamic)
+    for (int j = 0; j < static_cast<int>(threadSafeReads.size()); ++j)
+    {
+      IOUtil::LoadInfo &loadInfo = *loadInfos[threadSafeReads[j]];
+      try
+      {
+        loadInfo.m_Output = loadInfo.m_ReaderSelector.GetSelected().GetReader()->Read();
+      }
+      catch (const std::exception &e)
+      {
+        readErrors[threadSafeReads[j]] = e.what();
+      }
+      catch (...)
+      {
+        readErrors[threadSafeReads[j]] = "Unknown exception";
+      }
+    }
+
+    for (std::size_t i = 0; i < dataElements.size(); ++i)
+    {
+      if (loadInfos[i])
+      {
+        const char *filename = dataElements[i]->Attribute("file");
+        if (!readErrors[i].empty())
+        {
+          MITK_ERROR << "Error during attempt to read '" << filename << "'. Exception says: " << readErrors[i];
+          error = true;
+        }
+        else
+        {
+          for (const auto &data : loadInfos[i]->m_Output)
+          {
+            if (data.IsNotNull())
+              data->SetProperty("path", StringProperty::New(loadInfos[i]->m_Path));
+          }
+          DataNodes[i] = CreateNodeFromBaseData(loadInfos[i]->m_Output, filename);
+          if (DataNodes[i].IsNull())
+          {
+            MITK_ERROR << "Error during attempt to read '" << filename << "'. Factory returned nullptr object.";
+            error = true;
+          }
+        }
+
+        if (DataNodes[i].IsNull())
+          DataNodes[i] = DataNode::New();
+      }
+      else
+      {
+        bool dataError = false;
+        DataNodes[i] = LoadBaseDataFromDataTag(dataElements[i], workingDirectory, dataError);
+        error = error || dataError;
+      }
+
+      ProgressBar::GetInstance()->Progress();
+    }
   }
 
   // iterate all nodes
@@ -255,12 +344,7 @@ mitk::DataNode::Pointer mitk::SceneReaderV1::LoadBaseDataFromDataTag(TiXmlElemen
       try
       {
         std::vector<BaseData::Pointer> baseData = IOUtil::Load(workingDirectory + Poco::Path::separator() + filename);
-        if (baseData.size() > 1)
-        {
-          MITK_WARN << "Discarding multiple base data results from " << filename << " except the first one.";
-        }
-        node = DataNode::New();
-        node->SetData(baseData.front());
+        node = CreateNodeFromBaseData(baseData, filename);
       }
       catch (std::exception &e)
       {
@@ -285,6 +369,21 @@ mitk::DataNode::Pointer mitk::SceneReaderV1::LoadBaseDataFromDataTag(TiXmlElemen
   return node;
 }
 
+mitk::DataNode::Pointer mitk::SceneReaderV1::CreateNodeFromBaseData(const std::vector<BaseData::Pointer> &baseData,
+                                                                    const std::string &filename)
+{
+  if (baseData.empty())
+    return nullptr;
+
+  if (baseData.size() > 1)
+  {
+    MITK_WARN << "Discarding multiple base data results from " << filename << " except the first one.";
+  }
+  DataNode::Pointer node = DataNode::New();
+  node->SetData(baseData.front());
+  return node;
+}
+
 void mitk::SceneReaderV1::ClearNodePropertyListWithExceptions(DataNode &node, PropertyList &propertyList)
 {
   // Basically call propertyList.Clear(), but implement exceptions (see bug 19354)
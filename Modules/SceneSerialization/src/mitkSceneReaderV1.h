@@ -36,6 +36,11 @@ namespace mitk
                                               const std::string &workingDirectory,
                                               bool &error);
 
+    /**
+      \brief creates a DataNode for the first BaseData read from the given file, nullptr if nothing was read
+    */
+    DataNode::Pointer CreateNodeFromBaseData(const std::vector<BaseData::Pointer> &baseData, const std::string &filename);
+
     /**
       \brief reads all the properties from the XML document and recreates them in node
     */
@@ -22,6 +22,11 @@ See LICENSE.txt or http://www.mitk.org for details.
 #include "mitkIOUtil.h"
 #include "mitkSceneIO.h"
 #include "mitkSceneIOTestScenarioProvider.h"
+#include "mitkStandaloneDataStorage.h"
+
+#include <Poco/Zip/ZipArchive.h>
+
+#include <fstream>
 
 /**
   \brief Test cases for SceneIO.
@@ -82,6 +87,7 @@ class mitkSceneIOTest2Suite : public mitk::TestFixture
   CPPUNIT_TEST_SUITE(mitkSceneIOTest2Suite);
   MITK_TEST(Test_SceneIOInterfaces);
   MITK_TEST(Test_ReconstructionOfScenes);
+  MITK_TEST(Test_CompressedFilesAreStored);
   CPPUNIT_TEST_SUITE_END();
 
   mitk::SceneIOTestScenarioProvider m_TestCaseProvider;
@@ -129,6 +135,50 @@ public:
     }
   }
 
+  void Test_CompressedFilesAreStored()
+  {
+    std::string tempDir = mitk::IOUtil::CreateTemporaryDirectory("SceneIOTest_XXXXXX");
+    std::string archiveFilename = mitk::IOUtil::CreateTemporaryFile("scene_XXXXXX.mitk", tempDir);
+
+    mitk::DataStorage::Pointer storage = mitk::StandaloneDataStorage::New().GetPointer();
+    mitk::DataNode::Pointer node = mitk::DataNode::New();
+    node->SetName("image");
+    node->SetData(mitk::IOUtil::Load<mitk::Image>(GetTestDataFilePath("Pic3D.nrrd")));
+    storage->Add(node);
+
+    mitk::SceneIO::Pointer writer = mitk::SceneIO::New();
+    CPPUNIT_ASSERT(writer->SaveScene(storage->GetAll(), storage, archiveFilename));
+
+    std::ifstream file(archiveFilename.c_str(), std::ios::binary);
+    Poco::Zip::ZipArchive archive(file);
+
+    bool hasIndex = false;
+    bool hasImage = false;
+    for (auto iter = archive.headerBegin(); iter != archive.headerEnd(); ++iter)
+    {
+      if (iter->first == "index.xml")
+      {
+        hasIndex = true;
+        CPPUNIT_ASSERT_EQUAL(Poco::Zip::ZipCommon::CM_DEFLATE, iter->second.getCompressionMethod());
+      }
+      else if (iter->first.find(".nrrd") != std::string::npos)
+      {
+        hasImage = true;
+        CPPUNIT_ASSERT_EQUAL_MESSAGE("Compressed nrrd files should be stored as they are",
+                                     Poco::Zip::ZipCommon::CM_STORE,
+                                     iter->second.getCompressionMethod());
+      }
+    }
+    CPPUNIT_ASSERT(hasIndex);
+    CPPUNIT_ASSERT(hasImage);
+    file.close();
+
+    mitk::SceneIO::Pointer reader = mitk::SceneIO::New();
+    mitk::DataStorage::Pointer restoredStorage = reader->LoadScene(archiveFilename);
+    CPPUNIT_ASSERT_EQUAL(1u, restoredStorage->GetAll()->Size());
+    CPPUNIT_ASSERT(dynamic_cast<mitk::Image *>(restoredStorage->GetAll()->front()->GetData()) != nullptr);
+  }
+
 }; // class
 
 int mitkSceneIOTest2(int /*argc*/, char * /*argv*/ [])
@@ -53,6 +53,7 @@ mitk::DiffSliceOperation::DiffSliceOperation(mitk::Image *imageVolume,
   m_TimeStep = timestep;
 
   m_zlibSliceContainer = CompressedImageContainer::New();
+  m_zlibSliceContainer->SetCompressionMethod(CompressedImageContainer::RunLength);
   m_zlibSliceContainer->SetImage(slice);
 
   m_Image = imageVolume;
@@ -336,7 +336,7 @@ void QmitkLabelSetWidget::OnEraseLabel(bool /*value*/)
   if (answerButton == QMessageBox::Yes)
   {
     this->WaitCursorOn();
-    GetWorkingImage()->EraseLabel(pixelValue);
+    GetWorkingImage()->EraseLabel(pixelValue, GetWorkingImage()->GetActiveLayer());
     this->WaitCursorOff();
     mitk::RenderingManager::GetInstance()->RequestUpdateAll();
   }
@@ -357,7 +357,7 @@ void QmitkLabelSetWidget::OnRemoveLabel(bool /*value*/)
   {
     this->WaitCursorOn();
     GetWorkingImage()->GetActiveLabelSet()->RemoveLabel(pixelValue);
-    GetWorkingImage()->EraseLabel(pixelValue);
+    GetWorkingImage()->EraseLabel(pixelValue, GetWorkingImage()->GetActiveLayer());
     this->WaitCursorOff();
   }
 
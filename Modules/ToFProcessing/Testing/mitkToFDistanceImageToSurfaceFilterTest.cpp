@@ -29,6 +29,9 @@ See LICENSE.txt or http://www.mitk.org for details.
 #include <vtkPoints.h>
 #include <vtkPolyData.h>
 #include <vtkSmartPointer.h>
+#include <vtkIdList.h>
+
+#include <cmath>
 
 /**
  *  @brief Test for the class "ToFDistanceImageToSurfaceFilter".
@@ -379,6 +382,67 @@ int mitkToFDistanceImageToSurfaceFilterTest(int /* argc */, char* /*argv*/[])
   }
   MITK_TEST_CONDITION_REQUIRED(compareToInput,"Testing backward transformation compared to original image with interpixeldistance");
 
+  //Streaming mode has to produce the same surface as the default mode
+  filter->SetGenerateTriangularMesh(true);
+  filter->SetTriangulationThreshold(0.0);
+  filter->StreamingModeOff();
+  filter->Modified();
+  filter->Update();
+  vtkSmartPointer<vtkPolyData> defaultResult = filter->GetOutput()->GetVtkPolyData();
+
+  filter->StreamingModeOn();
+  filter->Modified();
+  filter->Update();
+  vtkSmartPointer<vtkPolyData> streamingResult = filter->GetOutput()->GetVtkPolyData();
+  MITK_TEST_CONDITION_REQUIRED(streamingResult != defaultResult, "Testing if streaming mode created a new surface");
+  MITK_TEST_CONDITION_REQUIRED(streamingResult->GetNumberOfPoints() == defaultResult->GetNumberOfPoints(), "Testing number of points in streaming mode");
+  MITK_TEST_CONDITION_REQUIRED(streamingResult->GetNumberOfPolys() == defaultResult->GetNumberOfPolys(), "Testing number of triangles in streaming mode");
+  MITK_TEST_CONDITION_REQUIRED(streamingResult->GetNumberOfVerts() == defaultResult->GetNumberOfVerts(), "Testing number of vertices in streaming mode");
+  bool streamingPointsEqual = true;
+  for (vtkIdType i = 0; i < defaultResult->GetNumberOfPoints(); ++i)
+  {
+    double* defaultPoint = defaultResult->GetPoint(i);
+    double* streamingPoint = streamingResult->GetPoint(i);
+    for (int k = 0; k < 3; ++k)
+    {
+      if (std::abs(defaultPoint[k] - streamingPoint[k]) > 1e-6)
+      {
+        streamingPointsEqual = false;
+      }
+    }
+  }
+  MITK_TEST_CONDITION_REQUIRED(streamingPointsEqual, "Testing points in streaming mode");
+  vtkSmartPointer<vtkIdList> defaultCell = vtkSmartPointer<vtkIdList>::New();
+  vtkSmartPointer<vtkIdList> streamingCell = vtkSmartPointer<vtkIdList>::New();
+  bool streamingCellsEqual = true;
+  for (vtkIdType i = 0; i < defaultResult->GetNumberOfCells(); ++i)
+  {
+    defaultResult->GetCellPoints(i, defaultCell);
+    streamingResult->GetCellPoints(i, streamingCell);
+    if (defaultCell->GetNumberOfIds() != streamingCell->GetNumberOfIds())
+    {
+      streamingCellsEqual = false;
+      continue;
+    }
+    for (vtkIdType k = 0; k < defaultCell->GetNumberOfIds(); ++k)
+    {
+      streamingCellsEqual = streamingCellsEqual && (defaultCell->GetId(k) == streamingCell->GetId(k));
+    }
+  }
+  MITK_TEST_CONDITION_REQUIRED(streamingCellsEqual, "Testing cells in streaming mode");
+
+  //The topology of the last frame is reused as long as the valid pixels stay the same
+  unsigned long topologyUpdates = filter->GetNumberOfTopologyUpdates();
+  filter->Modified();
+  filter->Update();
+  MITK_TEST_CONDITION_REQUIRED(filter->GetNumberOfTopologyUpdates() == topologyUpdates, "Testing if topology is reused in streaming mode");
+  filter->SetGenerateTriangularMesh(false);
+  filter->Modified();
+  filter->Update();
+  MITK_TEST_CONDITION_REQUIRED(filter->GetNumberOfTopologyUpdates() == topologyUpdates + 1, "Testing if topology is rebuilt after switching off triangulation");
+  MITK_TEST_CONDITION_REQUIRED(filter->GetOutput()->GetVtkPolyData()->GetNumberOfVerts() == defaultResult->GetNumberOfPoints(), "Testing one vertex per point without triangulation");
+  filter->StreamingModeOff();
+
   //clean up
   delete[] point;
   //  expectedResult->Delete();
@@ -17,27 +17,28 @@ See LICENSE.txt or http://www.mitk.org for details.
 #include <mitkToFCompositeFilter.h>
 #include <mitkInstantiateAccessFunctions.h>
 #include "mitkImageReadAccessor.h"
+#include "mitkImageWriteAccessor.h"
 
 #include <itkImage.h>
+#include <itkMath.h>
 
 #include "opencv2/imgproc.hpp"
 
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <memory>
+
 mitk::ToFCompositeFilter::ToFCompositeFilter() : m_SegmentationMask(nullptr), m_ImageWidth(0), m_ImageHeight(0), m_ImageSize(0),
-m_IplDistanceImage(nullptr), m_IplOutputImage(nullptr), m_ItkInputImage(nullptr), m_ApplyTemporalMedianFilter(false), m_ApplyAverageFilter(false),
-  m_ApplyMedianFilter(false), m_ApplyThresholdFilter(false), m_ApplyMaskSegmentation(false), m_ApplyBilateralFilter(false), m_DataBuffer(nullptr),
-m_DataBufferCurrentIndex(0), m_DataBufferMaxSize(0), m_TemporalMedianFilterNumOfFrames(10), m_ThresholdFilterMin(1),
+  m_ApplyTemporalMedianFilter(false), m_ApplyAverageFilter(false),
+  m_ApplyMedianFilter(false), m_ApplyThresholdFilter(false), m_ApplyMaskSegmentation(false), m_ApplyBilateralFilter(false),
+m_DataBufferCurrentIndex(0), m_DataBufferMaxSize(0), m_DataBufferSize(0), m_DataBufferNumberOfPixels(0), m_TemporalMedianFilterNumOfFrames(10), m_ThresholdFilterMin(1),
 m_ThresholdFilterMax(7000), m_BilateralFilterDomainSigma(2), m_BilateralFilterRangeSigma(60), m_BilateralFilterKernelRadius(0)
 {
 }
 
 mitk::ToFCompositeFilter::~ToFCompositeFilter()
 {
-  cvReleaseImage(&(this->m_IplDistanceImage));
-  cvReleaseImage(&(this->m_IplOutputImage));
-  if (m_DataBuffer!=nullptr)
-  {
-    delete [] m_DataBuffer;
-  }
 }
 
 void mitk::ToFCompositeFilter::SetInput(  const InputImageType* distanceImage )
@@ -53,30 +54,14 @@ void mitk::ToFCompositeFilter::SetInput( unsigned int idx,  const InputImageType
   }
   else
   {
-    if (idx==0) //create IPL image holding distance data
+    if (idx==0) // allocate the intermediate buffers for the distance data
     {
       if (!distanceImage->IsEmpty())
       {
         this->m_ImageWidth = distanceImage->GetDimension(0);
         this->m_ImageHeight = distanceImage->GetDimension(1);
         this->m_ImageSize = this->m_ImageWidth * this->m_ImageHeight * sizeof(float);
-
-        if (this->m_IplDistanceImage != nullptr)
-        {
-          cvReleaseImage(&(this->m_IplDistanceImage));
-        }
-        ImageReadAccessor distImgAcc(distanceImage, distanceImage->GetSliceData(0,0,0));
-        float* distanceFloatData = (float*) distImgAcc.GetData();
-        this->m_IplDistanceImage = cvCreateImage(cvSize(this->m_ImageWidth, this->m_ImageHeight), IPL_DEPTH_32F, 1);
-        memcpy(this->m_IplDistanceImage->imageData, (void*)distanceFloatData, this->m_ImageSize);
-
-        if (this->m_IplOutputImage != nullptr)
-        {
-          cvReleaseImage(&(this->m_IplOutputImage));
-        }
-        this->m_IplOutputImage = cvCreateImage(cvSize(this->m_ImageWidth, this->m_ImageHeight), IPL_DEPTH_32F, 1);
-
-        CreateItkImage(this->m_ItkInputImage);
+        this->m_ScratchBuffer.resize(this->m_ImageWidth * this->m_ImageHeight);
       }
     }
     this->ProcessObject::SetNthInput(idx, const_cast<InputImageType*>(distanceImage));   // Process object is not const-correct so the const_cast is required here
@@ -112,40 +97,41 @@ void mitk::ToFCompositeFilter::GenerateData()
       outputImage->SetSlice(inputAcc.GetData());
     }
   }
-  //mitk::Image::Pointer outputDistanceImage = this->GetOutput();
-  ImageReadAccessor outputAcc(this->GetOutput(), this->GetOutput()->GetSliceData(0, 0, 0) );
-  float* outputDistanceFloatData = (float*) outputAcc.GetData();
 
-  //mitk::Image::Pointer inputDistanceImage = this->GetInput();
-  ImageReadAccessor inputAcc(this->GetInput(), this->GetInput()->GetSliceData(0, 0, 0) );
+  // all filters work in place on the output buffer, which already holds a copy of the distance image
+  ImageWriteAccessor outputAcc(this->GetOutput(), this->GetOutput()->GetSliceData(0, 0, 0) );
+  float* outputDistanceFloatData = (float*) outputAcc.GetData();
+  const unsigned int numberOfPixels = this->m_ImageWidth * this->m_ImageHeight;
+  if (m_ScratchBuffer.size() != numberOfPixels)
+  {
+    m_ScratchBuffer.resize(numberOfPixels);
+  }
 
-  // copy initial distance image to ipl image
-  float* distanceFloatData = (float*)inputAcc.GetData();
-  memcpy(this->m_IplDistanceImage->imageData, (void*)distanceFloatData, this->m_ImageSize);
   if (m_ApplyThresholdFilter||m_ApplyMaskSegmentation)
   {
-    ProcessSegmentation(this->m_IplDistanceImage);
+    ProcessSegmentation(outputDistanceFloatData);
   }
   if (this->m_ApplyTemporalMedianFilter||this->m_ApplyAverageFilter)
   {
-    ProcessStreamedQuickSelectMedianImageFilter(this->m_IplDistanceImage);
+    ProcessStreamedTemporalFilter(outputDistanceFloatData);
   }
-  if (this->m_ApplyMedianFilter)
+  if (this->m_ApplyMedianFilter && this->m_ApplyBilateralFilter)
   {
-    ProcessCVMedianFilter(this->m_IplDistanceImage, this->m_IplOutputImage);
-    memcpy( this->m_IplDistanceImage->imageData, this->m_IplOutputImage->imageData, this->m_ImageSize );
+    ProcessMedianFilter(outputDistanceFloatData, m_ScratchBuffer.data());
+    ProcessBilateralFilter(m_ScratchBuffer.data(), outputDistanceFloatData);
   }
-  if (this->m_ApplyBilateralFilter)
+  else if (this->m_ApplyMedianFilter || this->m_ApplyBilateralFilter)
   {
-      float* itkFloatData = this->m_ItkInputImage->GetBufferPointer();
-      memcpy(itkFloatData, this->m_IplDistanceImage->imageData, this->m_ImageSize );
-      ItkImageType2D::Pointer itkOutputImage = ProcessItkBilateralFilter(this->m_ItkInputImage);
-      memcpy( this->m_IplDistanceImage->imageData, itkOutputImage->GetBufferPointer(), this->m_ImageSize );
-
-    //ProcessCVBilateralFilter(this->m_IplDistanceImage, this->m_OutputIplImage, domainSigma, rangeSigma, kernelRadius);
-    //memcpy( distanceFloatData, this->m_OutputIplImage->imageData, distanceImageSize );
+    memcpy(m_ScratchBuffer.data(), outputDistanceFloatData, this->m_ImageSize);
+    if (this->m_ApplyMedianFilter)
+    {
+      ProcessMedianFilter(m_ScratchBuffer.data(), outputDistanceFloatData);
+    }
+    else
+    {
+      ProcessBilateralFilter(m_ScratchBuffer.data(), outputDistanceFloatData);
+    }
   }
-  memcpy( outputDistanceFloatData, this->m_IplDistanceImage->imageData, this->m_ImageSize );
 }
 
 void mitk::ToFCompositeFilter::CreateOutputsForAllInputs()
@@ -176,192 +162,225 @@ void mitk::ToFCompositeFilter::GenerateOutputInformation()
   output->SetPropertyList(input->GetPropertyList()->Clone());
 }
 
-void mitk::ToFCompositeFilter::ProcessSegmentation(IplImage* inputIplImage)
+void mitk::ToFCompositeFilter::ProcessSegmentation(float* data)
 {
-  char* segmentationMask;
+  // keeps the mask locked while it is read
+  std::unique_ptr<ImageReadAccessor> segMaskAcc;
+  char* segmentationMask = nullptr;
   if (m_SegmentationMask.IsNotNull())
   {
-    ImageReadAccessor segMaskAcc(m_SegmentationMask, m_SegmentationMask->GetSliceData(0,0,0));
-    segmentationMask = (char*)segMaskAcc.GetData();
-  }
-  else
-  {
-    segmentationMask = nullptr;
+    segMaskAcc.reset(new ImageReadAccessor(m_SegmentationMask, m_SegmentationMask->GetSliceData(0,0,0)));
+    segmentationMask = (char*)segMaskAcc->GetData();
   }
-  float *f = (float*)inputIplImage->imageData;
-  for(int i=0; i<this->m_ImageWidth*this->m_ImageHeight; i++)
+  const float thresholdMin = m_ThresholdFilterMin;
+  const float thresholdMax = m_ThresholdFilterMax;
+  const int numberOfPixels = this->m_ImageWidth*this->m_ImageHeight;
+  if (this->m_ApplyThresholdFilter)
   {
-    if (this->m_ApplyThresholdFilter)
+    for(int i=0; i<numberOfPixels; i++)
     {
-      if (f[i]<=m_ThresholdFilterMin)
+      if ((data[i]<=thresholdMin) || (data[i]>=thresholdMax))
       {
-        f[i] = 0.0;
+        data[i] = 0.0;
       }
-      else if (f[i]>=m_ThresholdFilterMax)
+    }
+  }
+  if (this->m_ApplyMaskSegmentation && segmentationMask)
+  {
+    for(int i=0; i<numberOfPixels; i++)
+    {
+      if (segmentationMask[i]==0)
       {
-        f[i] = 0.0;
+        data[i] = 0.0;
       }
     }
-    if (this->m_ApplyMaskSegmentation)
+  }
+}
+
+void mitk::ToFCompositeFilter::ProcessBilateralFilter(const float* inputData, float* outputData)
+{
+  const int width = this->m_ImageWidth;
+  const int height = this->m_ImageHeight;
+  const mitk::Vector3D spacing = this->GetInput()->GetGeometry()->GetSpacing();
+
+  // domain gaussian, normalized to one (same kernel size as itk::BilateralImageFilter with automatic kernel size)
+  const double domainMu = 2.5;
+  const int radiusX = static_cast<int>(std::ceil(domainMu * m_BilateralFilterDomainSigma / spacing[0]));
+  const int radiusY = static_cast<int>(std::ceil(domainMu * m_BilateralFilterDomainSigma / spacing[1]));
+  const int kernelWidth = 2*radiusX+1;
+  std::vector<double> domainKernel(kernelWidth*(2*radiusY+1));
+  double kernelSum = 0.0;
+  for (int ky=-radiusY; ky<=radiusY; ky++)
+  {
+    for (int kx=-radiusX; kx<=radiusX; kx++)
+    {
+      const double dx = kx*spacing[0];
+      const double dy = ky*spacing[1];
+      const double value = std::exp(-(dx*dx+dy*dy) / (2.0*m_BilateralFilterDomainSigma*m_BilateralFilterDomainSigma));
+      domainKernel[(ky+radiusY)*kernelWidth+kx+radiusX] = value;
+      kernelSum += value;
+    }
+  }
+  for (double& value : domainKernel)
+  {
+    value /= kernelSum;
+  }
+
+  // range gaussian as lookup table for distances up to rangeMu * sigma
+  const double rangeMu = 4.0;
+  const unsigned int numberOfRangeGaussianSamples = 100;
+  const double dynamicRangeUsed = rangeMu * m_BilateralFilterRangeSigma;
+  const double tableDelta = dynamicRangeUsed / numberOfRangeGaussianSamples;
+  const double distanceToTableIndex = numberOfRangeGaussianSamples / dynamicRangeUsed;
+  const double rangeGaussianDenom = m_BilateralFilterRangeSigma * std::sqrt(2.0 * itk::Math::pi);
+  std::vector<double> rangeGaussianTable(numberOfRangeGaussianSamples);
+  for (unsigned int i = 0; i < numberOfRangeGaussianSamples; i++)
+  {
+    const double v = i * tableDelta;
+    rangeGaussianTable[i] = std::exp(-0.5 * v * v / (m_BilateralFilterRangeSigma * m_BilateralFilterRangeSigma)) / rangeGaussianDenom;
+  }
+
+  // copy the input once into a buffer with replicated borders, so the kernel loop needs no boundary checks
+  const int paddedWidth = width + 2*radiusX;
+  const int paddedHeight = height + 2*radiusY;
+  m_PaddedBuffer.resize(paddedWidth*paddedHeight);
+  for (int y=0; y<paddedHeight; y++)
+  {
+    const float* sourceRow = inputData + std::min(std::max(y-radiusY, 0), height-1)*width;
+    float* targetRow = m_PaddedBuffer.data() + y*paddedWidth;
+    std::fill(targetRow, targetRow+radiusX, sourceRow[0]);
+    memcpy(targetRow+radiusX, sourceRow, width*sizeof(float));
+    std::fill(targetRow+radiusX+width, targetRow+paddedWidth, sourceRow[width-1]);
+  }
+  const float* padded = m_PaddedBuffer.data();
+  const double* table = rangeGaussianTable.data();
+
+#pragma omp parallel
+  {
+    std::vector<double> values(width);
+    std::vector<double> normFactors(width);
+#pragma omp for
+    for (int y=0; y<height; y++)
     {
-      if (segmentationMask)
+      std::fill(values.begin(), values.end(), 0.0);
+      std::fill(normFactors.begin(), normFactors.end(), 0.0);
+      const float* centerRow = padded + (y+radiusY)*paddedWidth + radiusX;
+      // same order of kernel elements per pixel as the ITK neighborhood iterator
+      for (int ky=-radiusY; ky<=radiusY; ky++)
       {
-        if (segmentationMask[i]==0)
+        for (int kx=-radiusX; kx<=radiusX; kx++)
         {
-          f[i] = 0.0;
+          const double weight = domainKernel[(ky+radiusY)*kernelWidth+kx+radiusX];
+          const float* neighborRow = centerRow + ky*paddedWidth + kx;
+          for (int x=0; x<width; x++)
+          {
+            const double pixel = neighborRow[x];
+            const double rangeDistance = std::fabs(pixel - centerRow[x]);
+            if (rangeDistance < dynamicRangeUsed)
+            {
+              const double gaussianProduct = weight * table[static_cast<unsigned int>(rangeDistance * distanceToTableIndex)];
+              normFactors[x] += gaussianProduct;
+              values[x] += pixel * gaussianProduct;
+            }
+          }
         }
       }
+      float* outputRow = outputData + y*width;
+      for (int x=0; x<width; x++)
+      {
+        outputRow[x] = normFactors[x] > 0.0 ? static_cast<float>(values[x] / normFactors[x]) : centerRow[x];
+      }
     }
   }
 }
 
-ItkImageType2D::Pointer mitk::ToFCompositeFilter::ProcessItkBilateralFilter(ItkImageType2D::Pointer inputItkImage)
+void mitk::ToFCompositeFilter::ProcessMedianFilter(const float* inputData, float* outputData, int radius)
 {
-  ItkImageType2D::Pointer outputItkImage;
-  BilateralFilterType::Pointer bilateralFilter = BilateralFilterType::New();
-  bilateralFilter->SetInput(inputItkImage);
-  bilateralFilter->SetDomainSigma(m_BilateralFilterDomainSigma);
-  bilateralFilter->SetRangeSigma(m_BilateralFilterRangeSigma);
-  //bilateralFilter->SetRadius(m_BilateralFilterKernelRadius);
-  outputItkImage = bilateralFilter->GetOutput();
-  outputItkImage->Update();
-  return outputItkImage;
+  // wrap the buffers, OpenCV works on them without copying
+  const cv::Mat input(this->m_ImageHeight, this->m_ImageWidth, CV_32FC1, const_cast<float*>(inputData));
+  cv::Mat output(this->m_ImageHeight, this->m_ImageWidth, CV_32FC1, outputData);
+  cv::medianBlur(input, output, radius);
 }
 
-void mitk::ToFCompositeFilter::ProcessCVBilateralFilter(IplImage* inputIplImage, IplImage* outputIplImage)
+void mitk::ToFCompositeFilter::ResetTemporalFilter(int numberOfFrames, int numberOfPixels)
 {
-  int diameter = m_BilateralFilterKernelRadius;
-  double sigmaColor = m_BilateralFilterRangeSigma;
-  double sigmaSpace = m_BilateralFilterDomainSigma;
-  cvSmooth(inputIplImage, outputIplImage, CV_BILATERAL, diameter, 0, sigmaColor, sigmaSpace);
+  this->m_DataBufferMaxSize = numberOfFrames;
+  this->m_DataBufferNumberOfPixels = numberOfPixels;
+  this->m_DataBufferCurrentIndex = 0;
+  this->m_DataBufferSize = 0;
+  this->m_DataBuffer.assign(static_cast<size_t>(numberOfFrames)*numberOfPixels, 0.0f);
+  this->m_SortedWindows.assign(static_cast<size_t>(numberOfFrames)*numberOfPixels, 0.0f);
+  this->m_RunningSums.assign(numberOfPixels, 0.0);
 }
 
-void mitk::ToFCompositeFilter::ProcessCVMedianFilter(IplImage* inputIplImage, IplImage* outputIplImage, int radius)
+void mitk::ToFCompositeFilter::ProcessStreamedTemporalFilter(float* data)
 {
-  cvSmooth(inputIplImage, outputIplImage, CV_MEDIAN, radius, 0, 0, 0);
-}
-
-void mitk::ToFCompositeFilter::ProcessStreamedQuickSelectMedianImageFilter(IplImage* inputIplImage)
-{
-  float* data = (float*)inputIplImage->imageData;
-
-  int imageSize = inputIplImage->width * inputIplImage->height;
-  float* tmpArray;
-
-  if (this->m_TemporalMedianFilterNumOfFrames == 0)
+  if (this->m_TemporalMedianFilterNumOfFrames <= 0)
   {
     return;
   }
 
-  if (m_TemporalMedianFilterNumOfFrames != this->m_DataBufferMaxSize) // reset
+  const int numberOfPixels = this->m_ImageWidth * this->m_ImageHeight;
+  if (this->m_TemporalMedianFilterNumOfFrames != this->m_DataBufferMaxSize || numberOfPixels != this->m_DataBufferNumberOfPixels) // reset
   {
-    //delete current buffer
-    for( int i=0; i<this->m_DataBufferMaxSize; i++ ) {
-      delete[] this->m_DataBuffer[i];
+    this->ResetTemporalFilter(this->m_TemporalMedianFilterNumOfFrames, numberOfPixels);
+  }
+
+  const int windowSize = this->m_DataBufferMaxSize;
+  const bool bufferFull = (this->m_DataBufferSize == windowSize);
+  const int currentBufferSize = bufferFull ? windowSize : this->m_DataBufferSize + 1;
+  float* frame = this->m_DataBuffer.data() + static_cast<size_t>(this->m_DataBufferCurrentIndex)*numberOfPixels;
+  float* sortedWindows = this->m_SortedWindows.data();
+  double* runningSums = this->m_RunningSums.data();
+  const bool average = this->m_ApplyAverageFilter;
+
+#pragma omp parallel for
+  for (int i=0; i<numberOfPixels; i++)
+  {
+    const float newValue = data[i];
+    float* window = sortedWindows + static_cast<size_t>(i)*windowSize;
+    int position;
+    if (bufferFull)
+    {
+      // replace the oldest value of this pixel by the new one
+      const float oldValue = frame[i];
+      runningSums[i] -= oldValue;
+      position = static_cast<int>(std::lower_bound(window, window+windowSize, oldValue) - window);
     }
-    if (this->m_DataBuffer != nullptr)
+    else
     {
-      delete[] this->m_DataBuffer;
+      position = currentBufferSize-1;
     }
-
-    this->m_DataBufferMaxSize = m_TemporalMedianFilterNumOfFrames;
-
-    // create new buffer with current size
-    this->m_DataBuffer = new float*[this->m_DataBufferMaxSize];
-    for(int i=0; i<this->m_DataBufferMaxSize; i++)
+    // move the new value to its sorted position
+    while (position > 0 && window[position-1] > newValue)
     {
-      this->m_DataBuffer[i] = nullptr;
+      window[position] = window[position-1];
+      --position;
     }
-    this->m_DataBufferCurrentIndex = 0;
-  }
-
-  int currentBufferSize = this->m_DataBufferMaxSize;
-  tmpArray = new float[this->m_DataBufferMaxSize];
-
-  // copy data to buffer
-  if (this->m_DataBuffer[this->m_DataBufferCurrentIndex] == nullptr)
-  {
-    this->m_DataBuffer[this->m_DataBufferCurrentIndex] = new float[imageSize];
-    currentBufferSize = this->m_DataBufferCurrentIndex + 1;
-  }
-
-  for(int j=0; j<imageSize; j++)
-  {
-    this->m_DataBuffer[this->m_DataBufferCurrentIndex][j] = data[j];
-  }
+    while (bufferFull && position < currentBufferSize-1 && window[position+1] < newValue)
+    {
+      window[position] = window[position+1];
+      ++position;
+    }
+    window[position] = newValue;
+    runningSums[i] += newValue;
+    frame[i] = newValue;
 
-  float tmpValue = 0.0f;
-  for(int i=0; i<imageSize; i++)
-  {
-    if (m_ApplyAverageFilter)
+    if (average)
     {
-      tmpValue = 0.0f;
-      for(int j=0; j<currentBufferSize; j++)
-      {
-          tmpValue+=this->m_DataBuffer[j][i];
-      }
-      data[i] = tmpValue/currentBufferSize;
+      data[i] = static_cast<float>(runningSums[i] / currentBufferSize);
     }
-    else if (m_ApplyTemporalMedianFilter)
+    else
     {
-      for(int j=0; j<currentBufferSize; j++)
-      {
-        tmpArray[j] = this->m_DataBuffer[j][i];
-      }
-      data[i] = quick_select(tmpArray, currentBufferSize);
+      // lower median for an even number of frames, as the former quickselect implementation
+      data[i] = window[(currentBufferSize-1)/2];
     }
   }
 
+  this->m_DataBufferSize = currentBufferSize;
   this->m_DataBufferCurrentIndex = (this->m_DataBufferCurrentIndex + 1) % this->m_DataBufferMaxSize;
-
-  delete[] tmpArray;
 }
 
-#define ELEM_SWAP(a,b) { register float t=(a);(a)=(b);(b)=t; }
-float mitk::ToFCompositeFilter::quick_select(float arr[], int n)
-{
-  int low = 0;
-  int high = n-1;
-  int median = (low + high)/2;
-  int middle = 0;
-  int ll = 0;
-  int hh = 0;
-  for (;;) {
-    if (high <= low) /* One element only */
-      return arr[median] ;
-    if (high == low + 1) { /* Two elements only */
-      if (arr[low] > arr[high])
-        ELEM_SWAP(arr[low], arr[high]) ;
-      return arr[median] ;
-    }
-    /* Find median of low, middle and high items; swap into position low */
-    middle = (low + high) / 2;
-    if (arr[middle] > arr[high]) ELEM_SWAP(arr[middle], arr[high]) ;
-    if (arr[low] > arr[high]) ELEM_SWAP(arr[low], arr[high]) ;
-    if (arr[middle] > arr[low]) ELEM_SWAP(arr[middle], arr[low]) ;
-    /* Swap low item (now in position middle) into position (low+1) */
-    ELEM_SWAP(arr[middle], arr[low+1]) ;
-    /* Nibble from each end towards middle, swapping items when stuck */
-    ll = low + 1;
-    hh = high;
-    for (;;) {
-      do ll++; while (arr[low] > arr[ll]) ;
-      do hh--; while (arr[hh] > arr[low]) ;
-      if (hh < ll)
-        break;
-      ELEM_SWAP(arr[ll], arr[hh]) ;
-    }
-    /* Swap middle item (in position low) back into correct position */
-    ELEM_SWAP(arr[low], arr[hh]) ;
-    /* Re-set active partition */
-    if (hh <= median)
-      low = ll;
-    if (hh >= median)
-      high = hh - 1;
-  }
-}
-#undef ELEM_SWAP
-
 void mitk::ToFCompositeFilter::SetTemporalMedianFilterParameter(int tmporalMedianFilterNumOfFrames)
 {
   this->m_TemporalMedianFilterNumOfFrames = tmporalMedianFilterNumOfFrames;
@@ -383,20 +402,3 @@ void mitk::ToFCompositeFilter::SetBilateralFilterParameter(double domainSigma, d
   this->m_BilateralFilterRangeSigma = rangeSigma;
   this->m_BilateralFilterKernelRadius = kernelRadius;
 }
-
-void mitk::ToFCompositeFilter::CreateItkImage(ItkImageType2D::Pointer &itkInputImage)
-{
-  itkInputImage = ItkImageType2D::New();
-  ItkImageType2D::IndexType startIndex;
-  startIndex[0] =   0;  // first index on X
-  startIndex[1] =   0;  // first index on Y
-  ItkImageType2D::SizeType  size;
-  size[0]  = this->m_ImageWidth;  // size along X
-  size[1]  = this->m_ImageHeight;  // size along Y
-  ItkImageType2D::RegionType region;
-  region.SetSize( size );
-  region.SetIndex( startIndex );
-  itkInputImage->SetRegions( region );
-  itkInputImage->Allocate();
-
-}
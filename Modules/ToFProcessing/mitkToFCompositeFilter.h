@@ -19,12 +19,13 @@ See LICENSE.txt or http://www.mitk.org for details.
 #include <mitkImage.h>
 #include "mitkImageToImageFilter.h"
 #include <MitkToFProcessingExports.h>
-#include <itkBilateralImageFilter.h>
+#include <itkImage.h>
 #include "opencv2/core.hpp"
 
+#include <vector>
+
 typedef itk::Image<float, 2> ItkImageType2D;
 typedef itk::Image<float, 3> ItkImageType3D;
-typedef itk::BilateralImageFilter<ItkImageType2D,ItkImageType2D> BilateralFilterType;
 
 namespace mitk
 {
@@ -39,6 +40,9 @@ namespace mitk
   * - spatial median filter
   * - bilateral filter
   *
+  * All filters work directly on the pixel buffer of the output image (plus one scratch buffer for the spatial
+  * filters), so a frame is copied once from the input and no conversion into OpenCV or ITK images takes place.
+  *
   * @ingroup ToFProcessing
   */
   class MITKTOFPROCESSING_EXPORT ToFCompositeFilter : public ImageToImageFilter
@@ -130,42 +134,34 @@ namespace mitk
     */
     void CreateOutputsForAllInputs();
     /*!
-    \brief Applies a mask and/or threshold segmentation to the input image.
+    \brief Applies a mask and/or threshold segmentation to the given distance data (in place).
     All pixels with values outside the mask, below the lower threshold (min) and above the upper threshold (max)
     are assigned the pixel value 0
     */
-    void ProcessSegmentation(IplImage* inputIplImage);
-    /*!
-    \brief Applies the ITK bilateral filter to the input image
-    See http://www.itk.org/Doxygen320/html/classitk_1_1BilateralImageFilter.html for more details.
-    */
-    ItkImageType2D::Pointer ProcessItkBilateralFilter(ItkImageType2D::Pointer inputItkImage);
+    void ProcessSegmentation(float* data);
     /*!
-    \brief Applies the OpenCV bilateral filter to the input image.
-    See http://opencv.willowgarage.com/documentation/c/image_filtering.html#smooth for more details
+    \brief Applies a bilateral filter to the input data.
+    The filter computes the same as itk::BilateralImageFilter with automatic kernel size (kernel radius 2.5 * domain sigma,
+    range gaussian from a lookup table of 100 samples up to 4 * range sigma, replicated image borders), see
+    http://www.itk.org/Doxygen/html/classitk_1_1BilateralImageFilter.html. The kernel is applied row-wise so that the
+    innermost loop runs over contiguous pixels.
     */
-    void ProcessCVBilateralFilter(IplImage* inputIplImage, IplImage* outputIplImage);
+    void ProcessBilateralFilter(const float* inputData, float* outputData);
     /*!
-    \brief Applies the OpenCV median filter to the input image.
-    See http://opencv.willowgarage.com/documentation/c/image_filtering.html#smooth for more details
+    \brief Applies the OpenCV median filter with the given aperture to the input data.
     */
-    void ProcessCVMedianFilter(IplImage* inputIplImage, IplImage* outputIplImage, int radius = 3);
+    void ProcessMedianFilter(const float* inputData, float* outputData, int radius = 3);
     /*!
-    \brief Performs temporal median filter on an image given the number of frames to be considered
+    \brief Performs the temporal median (or average) filter over the last m_TemporalMedianFilterNumOfFrames frames (in place).
+    Each pixel keeps a sorted window of its last values. For every new frame the oldest value is replaced by the new one
+    and the window is re-sorted by shifting the values between both positions, so the median is available without
+    selecting it from the whole history again. The average filter uses a running sum.
     */
-    void ProcessStreamedQuickSelectMedianImageFilter(IplImage* inputIplImage);
+    void ProcessStreamedTemporalFilter(float* data);
     /*!
-    \brief Quickselect algorithm
-    * This Quickselect routine is based on the algorithm described in
-    * "Numerical recipes in C", Second Edition,
-    * Cambridge University Press, 1992, Section 8.5, ISBN 0-521-43108-5
-    * This code by Nicolas Devillard - 1998. Public domain.
+    \brief Discards the history of the temporal filters, e.g. if the number of frames or the image size changed
     */
-    float quick_select(float arr[], int n);
-    /*!
-    \brief Initialize and allocate a 2D ITK image of dimension m_ImageWidth*m_ImageHeight
-    */
-    void CreateItkImage(ItkImageType2D::Pointer &itkInputImage);
+    void ResetTemporalFilter(int numberOfFrames, int numberOfPixels);
 
     mitk::Image::Pointer m_SegmentationMask; ///< mask image used for segmenting the image
 
@@ -173,10 +169,8 @@ namespace mitk
     int m_ImageHeight; ///< y-dimension of the image
     int m_ImageSize; ///< size of the image in bytes
 
-    IplImage* m_IplDistanceImage; ///< OpenCV-representation of the distance image
-    IplImage* m_IplOutputImage; ///< OpenCV-representation of the output image
-
-    ItkImageType2D::Pointer m_ItkInputImage; ///< ITK representation of the distance image
+    std::vector<float> m_ScratchBuffer; ///< Intermediate result of the spatial filters, allocated once per image size
+    std::vector<float> m_PaddedBuffer; ///< Input of the bilateral filter with replicated borders
 
     bool m_ApplyTemporalMedianFilter; ///< Flag indicating if the temporal median filter is currently active for processing the distance image
     bool m_ApplyAverageFilter; ///< Flag indicating if the average filter is currently active for processing the distance image
@@ -185,9 +179,13 @@ namespace mitk
     bool m_ApplyMaskSegmentation; ///< Flag indicating if a mask segmentation is performed
     bool m_ApplyBilateralFilter; ///< Flag indicating if the bilateral filter is currently active for processing the distance image
 
-    float** m_DataBuffer; ///< Buffer used for calculating the pixel-wise median over the last n (m_TemporalMedianFilterNumOfFrames) number of frames
+    std::vector<float> m_DataBuffer; ///< The last n (m_TemporalMedianFilterNumOfFrames) frames, used as ring buffer
+    std::vector<float> m_SortedWindows; ///< Per pixel the values of m_DataBuffer in ascending order (n consecutive values per pixel)
+    std::vector<double> m_RunningSums; ///< Per pixel the sum of the values in m_DataBuffer
     int m_DataBufferCurrentIndex; ///< Current index in the buffer of the temporal median filter
     int m_DataBufferMaxSize; ///< Maximal size for the buffer of the temporal median filter (m_DataBuffer)
+    int m_DataBufferSize; ///< Number of frames currently held in the buffer of the temporal median filter
+    int m_DataBufferNumberOfPixels; ///< Number of pixels per frame in the buffer of the temporal median filter
 
     int m_TemporalMedianFilterNumOfFrames; ///< Number of frames to be used in the calculation of the temporal median
     int m_ThresholdFilterMin; ///< Lower threshold of the threshold filter. Pixels with values below will be assigned value 0 when applying the threshold filter
@@ -28,13 +28,17 @@ See LICENSE.txt or http://www.mitk.org for details.
 #include <vtkFloatArray.h>
 #include <vtkSmartPointer.h>
 #include <vtkIdList.h>
+#include <vtkIdTypeArray.h>
 
+#include <algorithm>
 #include <cmath>
+#include <memory>
 #include <vtkMath.h>
 
 mitk::ToFDistanceImageToSurfaceFilter::ToFDistanceImageToSurfaceFilter() :
   m_IplScalarImage(nullptr), m_CameraIntrinsics(), m_TextureImageWidth(0), m_TextureImageHeight(0), m_InterPixelDistance(), m_TextureIndex(0),
-  m_GenerateTriangularMesh(true), m_TriangulationThreshold(0.0)
+  m_GenerateTriangularMesh(true), m_TriangulationThreshold(0.0), m_StreamingMode(false), m_CachedTopologyIsMesh(true),
+  m_NumberOfTopologyUpdates(0)
 {
   m_InterPixelDistance.Fill(0.045);
   m_CameraIntrinsics = mitk::CameraIntrinsics::New();
@@ -99,6 +103,30 @@ void mitk::ToFDistanceImageToSurfaceFilter::GenerateData()
   int xDimension = input->GetDimension(0);
   int yDimension = input->GetDimension(1);
   unsigned int size = xDimension*yDimension; //size of the image-array
+  float* scalarFloatData = nullptr;
+  // keeps the texture image locked as long as scalarFloatData is used
+  std::unique_ptr<ImageReadAccessor> textureAcc;
+
+  if (this->m_IplScalarImage) // if scalar image is defined use it for texturing
+  {
+    scalarFloatData = (float*)this->m_IplScalarImage->imageData;
+  }
+  else if (this->GetInput(m_TextureIndex)) // otherwise use intensity image (input(2))
+  {
+    textureAcc.reset(new ImageReadAccessor(this->GetInput(m_TextureIndex)));
+    scalarFloatData = (float*)textureAcc->GetData();
+  }
+
+  ImageReadAccessor inputAcc(input, input->GetSliceData(0,0,0));
+  float* inputFloatData = (float*)inputAcc.GetData();
+
+  if (m_StreamingMode)
+  {
+    this->UpdateRayDirections(xDimension, yDimension, input->GetGeometry()->GetOrigin(), input->GetGeometry()->GetSpacing());
+    this->GenerateDataStreaming(inputFloatData, scalarFloatData, xDimension, yDimension);
+    return;
+  }
+
   std::vector<bool> isPointValid;
   isPointValid.resize(size);
   vtkSmartPointer<vtkPoints> points = vtkSmartPointer<vtkPoints>::New();
@@ -122,20 +150,6 @@ void mitk::ToFDistanceImageToSurfaceFilter::GenerateData()
     m_VertexIdList->SetId(i, 0);
   }
 
-  float* scalarFloatData = nullptr;
-
-  if (this->m_IplScalarImage) // if scalar image is defined use it for texturing
-  {
-    scalarFloatData = (float*)this->m_IplScalarImage->imageData;
-  }
-  else if (this->GetInput(m_TextureIndex)) // otherwise use intensity image (input(2))
-  {
-    ImageReadAccessor inputAcc(this->GetInput(m_TextureIndex));
-    scalarFloatData = (float*)inputAcc.GetData();
-  }
-
-  ImageReadAccessor inputAcc(input, input->GetSliceData(0,0,0));
-  float* inputFloatData = (float*)inputAcc.GetData();
   //calculate world coordinates
   mitk::ToFProcessingCommon::ToFPoint2D focalLengthInPixelUnits;
   mitk::ToFProcessingCommon::ToFScalarType focalLengthInMm;
@@ -311,6 +325,253 @@ void mitk::ToFDistanceImageToSurfaceFilter::GenerateData()
   output->SetVtkPolyData(mesh);
 }
 
+void mitk::ToFDistanceImageToSurfaceFilter::UpdateRayDirections(int xDimension, int yDimension, const mitk::Point3D& origin, const mitk::Vector3D& spacing)
+{
+  std::vector<double> key = { double(xDimension), double(yDimension), origin[0], origin[1], spacing[0], spacing[1],
+    double(m_ReconstructionMode), m_CameraIntrinsics->GetFocalLengthX(), m_CameraIntrinsics->GetFocalLengthY(),
+    m_CameraIntrinsics->GetPrincipalPointX(), m_CameraIntrinsics->GetPrincipalPointY(),
+    m_InterPixelDistance[0], m_InterPixelDistance[1] };
+  if (key == m_RayDirectionsKey)
+  {
+    return;
+  }
+
+  mitk::ToFProcessingCommon::ToFPoint2D focalLengthInPixelUnits;
+  focalLengthInPixelUnits[0] = m_CameraIntrinsics->GetFocalLengthX();
+  focalLengthInPixelUnits[1] = m_CameraIntrinsics->GetFocalLengthY();
+  mitk::ToFProcessingCommon::ToFScalarType focalLengthInMm = (m_CameraIntrinsics->GetFocalLengthX()*m_InterPixelDistance[0]+m_CameraIntrinsics->GetFocalLengthY()*m_InterPixelDistance[1])/2.0;
+  mitk::ToFProcessingCommon::ToFPoint2D principalPoint;
+  principalPoint[0] = m_CameraIntrinsics->GetPrincipalPointX();
+  principalPoint[1] = m_CameraIntrinsics->GetPrincipalPointY();
+
+  // All reconstruction modes are linear in the distance, so the point of a
+  // pixel is its distance times the point computed for a distance of 1.
+  m_RayDirections.resize(3*xDimension*yDimension);
+#pragma omp parallel for
+  for (int j=0; j<yDimension; j++)
+  {
+    for (int i=0; i<xDimension; i++)
+    {
+      unsigned int completeIndexX = i*spacing[0]+origin[0];
+      unsigned int completeIndexY = j*spacing[1]+origin[1];
+
+      mitk::ToFProcessingCommon::ToFPoint3D ray;
+      ray.Fill(0.0);
+      switch (m_ReconstructionMode)
+      {
+      case WithOutInterPixelDistance:
+        ray = mitk::ToFProcessingCommon::IndexToCartesianCoordinates(completeIndexX,completeIndexY,1.0,focalLengthInPixelUnits,principalPoint);
+        break;
+      case WithInterPixelDistance:
+        ray = mitk::ToFProcessingCommon::IndexToCartesianCoordinatesWithInterpixdist(completeIndexX,completeIndexY,1.0,focalLengthInMm,m_InterPixelDistance,principalPoint);
+        break;
+      case Kinect:
+        ray = mitk::ToFProcessingCommon::KinectIndexToCartesianCoordinates(completeIndexX,completeIndexY,1.0,focalLengthInPixelUnits,principalPoint);
+        break;
+      default:
+        break;
+      }
+      double* target = &m_RayDirections[3*(i+j*xDimension)];
+      target[0] = ray[0];
+      target[1] = ray[1];
+      target[2] = ray[2];
+    }
+  }
+
+  if ((m_ReconstructionMode != WithOutInterPixelDistance) && (m_ReconstructionMode != WithInterPixelDistance) && (m_ReconstructionMode != Kinect))
+  {
+    MITK_ERROR << "Incorrect reconstruction mode!";
+  }
+
+  m_RayDirectionsKey = key;
+  // pixel positions changed, the cached topology is meaningless now
+  m_CachedPolys = nullptr;
+  m_CachedVertices = nullptr;
+}
+
+void mitk::ToFDistanceImageToSurfaceFilter::GenerateDataStreaming(const float* inputFloatData, const float* scalarFloatData, int xDimension, int yDimension)
+{
+  const unsigned int size = xDimension*yDimension;
+
+  // 1. valid pixels, counted per row so that the rows can be processed in parallel afterwards
+  bool maskChanged = (m_ValidPixelMask.size() != size);
+  m_ValidPixelMask.resize(size);
+  std::vector<vtkIdType> firstIdOfRow(yDimension+1, 0);
+#pragma omp parallel for reduction(||:maskChanged)
+  for (int j=0; j<yDimension; j++)
+  {
+    vtkIdType validInRow = 0;
+    for (int i=0; i<xDimension; i++)
+    {
+      unsigned int pixelID = i+j*xDimension;
+      //Epsilon here, because we may have small float values like 0.00000001 which in fact represents 0.
+      unsigned char isValid = ((double)inputFloatData[pixelID] > mitk::eps) ? 1 : 0;
+      maskChanged = maskChanged || (m_ValidPixelMask[pixelID] != isValid);
+      m_ValidPixelMask[pixelID] = isValid;
+      validInRow += isValid;
+    }
+    firstIdOfRow[j+1] = validInRow;
+  }
+  for (int j=0; j<yDimension; j++)
+  {
+    firstIdOfRow[j+1] += firstIdOfRow[j];
+  }
+  const vtkIdType numberOfPoints = firstIdOfRow[yDimension];
+
+  // 2. points, scalars and texture coordinates at the compact point ids
+  vtkSmartPointer<vtkPoints> points = vtkSmartPointer<vtkPoints>::New();
+  points->SetDataTypeToDouble();
+  points->SetNumberOfPoints(numberOfPoints);
+  double* pointData = static_cast<double*>(points->GetVoidPointer(0));
+
+  vtkSmartPointer<vtkFloatArray> scalarArray = vtkSmartPointer<vtkFloatArray>::New();
+  float* scalarData = nullptr;
+  if (scalarFloatData)
+  {
+    scalarArray->SetNumberOfTuples(numberOfPoints);
+    scalarData = scalarArray->GetPointer(0);
+  }
+  vtkSmartPointer<vtkFloatArray> textureCoords = vtkSmartPointer<vtkFloatArray>::New();
+  textureCoords->SetNumberOfComponents(2);
+  textureCoords->SetNumberOfTuples(numberOfPoints);
+  float* textureData = textureCoords->GetPointer(0);
+
+  if (m_VertexIdList == nullptr || m_VertexIdList->GetNumberOfIds() != static_cast<vtkIdType>(size))
+  {
+    m_VertexIdList = vtkSmartPointer<vtkIdList>::New();
+    m_VertexIdList->SetNumberOfIds(size);
+  }
+  vtkIdType* vertexIds = m_VertexIdList->GetPointer(0);
+
+#pragma omp parallel for
+  for (int j=0; j<yDimension; j++)
+  {
+    vtkIdType id = firstIdOfRow[j];
+    for (int i=0; i<xDimension; i++)
+    {
+      unsigned int pixelID = i+j*xDimension;
+      if (!m_ValidPixelMask[pixelID])
+      {
+        vertexIds[pixelID] = 0;
+        continue;
+      }
+      const double distance = inputFloatData[pixelID];
+      const double* ray = &m_RayDirections[3*pixelID];
+      pointData[3*id] = distance*ray[0];
+      pointData[3*id+1] = distance*ray[1];
+      pointData[3*id+2] = distance*ray[2];
+      if (scalarData)
+      {
+        scalarData[id] = scalarFloatData[pixelID];
+      }
+      textureData[2*id] = ((float)i)/xDimension;
+      textureData[2*id+1] = ((float)j)/yDimension;
+      vertexIds[pixelID] = id;
+      ++id;
+    }
+  }
+
+  // 3. topology, which only has to be rebuilt if it can differ from the last frame
+  const bool useThreshold = !mitk::Equal(m_TriangulationThreshold, 0.0);
+  if (maskChanged || useThreshold || m_CachedPolys.GetPointer() == nullptr || m_CachedTopologyIsMesh != m_GenerateTriangularMesh)
+  {
+    std::vector<std::vector<vtkIdType> > polysOfRow(yDimension);
+    std::vector<std::vector<vtkIdType> > verticesOfRow(yDimension);
+#pragma omp parallel for
+    for (int j=0; j<yDimension; j++)
+    {
+      std::vector<vtkIdType>& rowPolys = polysOfRow[j];
+      std::vector<vtkIdType>& rowVertices = verticesOfRow[j];
+      for (int i=0; i<xDimension; i++)
+      {
+        vtkIdType xy = i+j*xDimension;
+        if (!m_ValidPixelMask[xy])
+        {
+          continue;
+        }
+        if (!m_GenerateTriangularMesh)
+        {
+          //We dont want triangulation, we only want vertices
+          rowVertices.push_back(1);
+          rowVertices.push_back(vertexIds[xy]);
+          continue;
+        }
+        if ((i < 1) || (j < 1))
+        {
+          continue;
+        }
+        // same cell layout as in GenerateData()
+        vtkIdType x_1y = xy-1;
+        vtkIdType xy_1 = xy-xDimension;
+        vtkIdType x_1y_1 = xy_1-1;
+        if (!(m_ValidPixelMask[x_1y] && m_ValidPixelMask[xy_1] && m_ValidPixelMask[x_1y_1]))
+        {
+          continue;
+        }
+        vtkIdType xyV = vertexIds[xy];
+        vtkIdType x_1yV = vertexIds[x_1y];
+        vtkIdType xy_1V = vertexIds[xy_1];
+        vtkIdType x_1y_1V = vertexIds[x_1y_1];
+
+        const double* pointXY = &pointData[3*xyV];
+        const double* pointX_1Y = &pointData[3*x_1yV];
+        const double* pointXY_1 = &pointData[3*xy_1V];
+        const double* pointX_1Y_1 = &pointData[3*x_1y_1V];
+        if (!useThreshold || ((vtkMath::Distance2BetweenPoints(pointXY, pointX_1Y) <= m_TriangulationThreshold)
+                              && (vtkMath::Distance2BetweenPoints(pointXY, pointXY_1) <= m_TriangulationThreshold)
+                              && (vtkMath::Distance2BetweenPoints(pointX_1Y, pointX_1Y_1) <= m_TriangulationThreshold)
+                              && (vtkMath::Distance2BetweenPoints(pointXY_1, pointX_1Y_1) <= m_TriangulationThreshold)))
+        {
+          rowPolys.insert(rowPolys.end(), { 3, x_1yV, xyV, x_1y_1V, 3, x_1y_1V, xyV, xy_1V });
+        }
+        else
+        {
+          //We dont want triangulation, but we want to keep the vertex
+          rowVertices.push_back(1);
+          rowVertices.push_back(xyV);
+        }
+      }
+    }
+
+    m_CachedPolys = this->ConcatenateCells(polysOfRow, 4);
+    m_CachedVertices = this->ConcatenateCells(verticesOfRow, 2);
+    m_CachedTopologyIsMesh = m_GenerateTriangularMesh;
+    ++m_NumberOfTopologyUpdates;
+  }
+
+  vtkSmartPointer<vtkPolyData> mesh = vtkSmartPointer<vtkPolyData>::New();
+  mesh->SetPoints(points);
+  mesh->SetPolys(m_CachedPolys);
+  mesh->SetVerts(m_CachedVertices);
+  if (scalarData && numberOfPoints > 0)
+  {
+    mesh->GetPointData()->SetScalars(scalarArray);
+  }
+  mesh->GetPointData()->SetTCoords(textureCoords);
+  this->GetOutput()->SetVtkPolyData(mesh);
+}
+
+vtkSmartPointer<vtkCellArray> mitk::ToFDistanceImageToSurfaceFilter::ConcatenateCells(const std::vector<std::vector<vtkIdType> >& cellsOfRow, unsigned int entriesPerCell)
+{
+  vtkIdType numberOfEntries = 0;
+  for (const auto& row : cellsOfRow)
+  {
+    numberOfEntries += row.size();
+  }
+
+  vtkSmartPointer<vtkIdTypeArray> connectivity = vtkSmartPointer<vtkIdTypeArray>::New();
+  connectivity->SetNumberOfValues(numberOfEntries);
+  vtkIdType* target = connectivity->GetPointer(0);
+  for (const auto& row : cellsOfRow)
+  {
+    target = std::copy(row.begin(), row.end(), target);
+  }
+
+  vtkSmartPointer<vtkCellArray> cells = vtkSmartPointer<vtkCellArray>::New();
+  cells->SetCells(numberOfEntries/entriesPerCell, connectivity);
+  return cells;
+}
+
 void mitk::ToFDistanceImageToSurfaceFilter::CreateOutputsForAllInputs()
 {
   this->SetNumberOfIndexedOutputs(this->GetNumberOfInputs());  // create outputs for all inputs
@@ -27,6 +27,9 @@ See LICENSE.txt or http://www.mitk.org for details.
 
 #include <vtkSmartPointer.h>
 #include <vtkIdList.h>
+#include <vtkCellArray.h>
+
+#include <vector>
 
 namespace mitk
 {
@@ -81,6 +84,24 @@ namespace mitk
     itkSetMacro(GenerateTriangularMesh,bool);
     itkGetMacro(GenerateTriangularMesh,bool);
 
+    /**
+     * @brief SetStreamingMode Enables an optimized reconstruction for live streams.
+     * In streaming mode the viewing ray of every pixel is computed only once per
+     * camera intrinsics and image geometry, points are written in parallel (by row)
+     * into preallocated arrays and the topology (triangles and vertices) of the last
+     * frame is reused as long as the mask of valid pixels does not change and no
+     * triangulation threshold is set. The result is the same as in the default mode.
+     */
+    itkSetMacro(StreamingMode,bool);
+    itkGetMacro(StreamingMode,bool);
+    itkBooleanMacro(StreamingMode);
+
+    /**
+     * @brief Number of times the topology was (re)built in streaming mode. Useful to check
+     * how often the cached topology could be reused.
+     */
+    itkGetConstMacro(NumberOfTopologyUpdates, unsigned long);
+
 
     /**
      * @brief The ReconstructionModeType enum: Defines the reconstruction mode, if using no interpixeldistances and focal lenghts in pixel units  or interpixeldistances and focal length in mm. The Kinect option defines a special reconstruction mode for the kinect.
@@ -173,6 +194,21 @@ namespace mitk
     */
     void CreateOutputsForAllInputs();
 
+    /*!
+    \brief Implementation of GenerateData() for the streaming mode, see SetStreamingMode()
+    */
+    void GenerateDataStreaming(const float* inputFloatData, const float* scalarFloatData, int xDimension, int yDimension);
+
+    /*!
+    \brief Recomputes the viewing ray of every pixel if intrinsics, reconstruction mode or geometry changed
+    */
+    void UpdateRayDirections(int xDimension, int yDimension, const mitk::Point3D& origin, const mitk::Vector3D& spacing);
+
+    /*!
+    \brief Joins the per row connectivity lists (VTK legacy layout, i.e. number of points followed by the point ids) into one cell array
+    */
+    static vtkSmartPointer<vtkCellArray> ConcatenateCells(const std::vector<std::vector<vtkIdType> >& cellsOfRow, unsigned int entriesPerCell);
+
     IplImage* m_IplScalarImage; ///< Scalar image used for surface texturing
 
     mitk::CameraIntrinsics::Pointer m_CameraIntrinsics; ///< Specifies the intrinsic parameters
@@ -190,6 +226,15 @@ namespace mitk
 
     double m_TriangulationThreshold;
 
+    bool m_StreamingMode; ///< Use the optimized reconstruction for live streams
+    std::vector<double> m_RayDirections; ///< Point of every pixel for a distance of 1, i.e. the (scaled) viewing ray
+    std::vector<double> m_RayDirectionsKey; ///< Parameters m_RayDirections was computed for
+    std::vector<unsigned char> m_ValidPixelMask; ///< Valid pixels of the last frame in streaming mode
+    vtkSmartPointer<vtkCellArray> m_CachedPolys; ///< Triangles of the last frame in streaming mode
+    vtkSmartPointer<vtkCellArray> m_CachedVertices; ///< Vertices of the last frame in streaming mode
+    bool m_CachedTopologyIsMesh; ///< Value of m_GenerateTriangularMesh the cached topology was built with
+    unsigned long m_NumberOfTopologyUpdates;
+
   };
 } //END mitk namespace
 #endif
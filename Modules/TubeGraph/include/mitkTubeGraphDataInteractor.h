@@ -23,6 +23,7 @@ See LICENSE.txt or http://www.mitk.org for details.
 #include <mitkDataInteractor.h>
 
 #include "mitkTubeGraph.h"
+#include "mitkTubeGraphPicker.h"
 #include "mitkTubeGraphProperty.h"
 
 namespace mitk
@@ -121,6 +122,8 @@ namespace mitk
     ActivationMode m_ActivationMode;
     ActionMode m_ActionMode;
     mitk::TubeElement *m_LastPickedElement = nullptr;
+    // keeps the hierarchy of the tube elements between the picks
+    TubeGraphPicker m_Picker;
   };
 }
 #endif
@@ -23,8 +23,17 @@ See LICENSE.txt or http://www.mitk.org for details.
 #include "mitkTubeGraph.h"
 #include "mitkTubeGraphProperty.h"
 
+#include <vector>
+
 namespace mitk
 {
+  /**
+  * \brief Finds the tube element next to a picked position.
+  *
+  * The elements of all tubes are kept in a bounding volume hierarchy, which is built when the picker
+  * is used for the first time after the tube graph has been set or modified. A pick only visits the
+  * elements whose bounding sphere contains the picked position.
+  */
   class MITKTUBEGRAPH_EXPORT TubeGraphPicker
   {
   public:
@@ -39,9 +48,36 @@ namespace mitk
     virtual ~TubeGraphPicker();
 
   protected:
+    /** \brief A tube element with the sphere in which it can be picked. */
+    struct PickableElement
+    {
+      Point3D Center;
+      ScalarType Radius;
+      TubeGraph::TubeDescriptorType Tube;
+      TubeElement *Element;
+      // position in the order of the tube graph, decides between elements with the same distance
+      unsigned int Order;
+    };
+
+    /** \brief Node of the hierarchy; leaves have no children and contain the elements [Begin, End). */
+    struct Node
+    {
+      double Bounds[6];
+      unsigned int Begin;
+      unsigned int End;
+      int FirstChild;
+    };
+
+    void BuildHierarchy();
+    void BuildNode(unsigned int nodeIndex);
+
     Point3D m_WorldPosition;
     TubeGraph::ConstPointer m_TubeGraph;
     TubeGraphProperty::Pointer m_TubeGraphProperty;
+
+    std::vector<PickableElement> m_Elements;
+    std::vector<Node> m_Nodes;
+    unsigned long m_HierarchyMTime;
   };
 
 } // namespace
@@ -28,7 +28,9 @@ See LICENSE.txt or http://www.mitk.org for details.
 #include <vtkActor.h>
 #include <vtkAppendPolyData.h>
 #include <vtkAssembly.h>
+#include <vtkLookupTable.h>
 #include <vtkPolyData.h>
+#include <vtkPolyDataMapper.h>
 #include <vtkSmartPointer.h>
 
 namespace mitk
@@ -37,6 +39,10 @@ namespace mitk
   * 3D Mapper for mitk::Graph< TubeGraphVertex, TubeGraphEdge >. This mapper creates tubes
   * around each tubular structure by using vtkTubeFilter.
   *
+  * All visible tubes and spheres are merged into a single poly data, which is rendered by one actor.
+  * Each cell is labeled with the index of its tube or sphere in the cell array "StructureIds". The
+  * colors are taken from a lookup table with one entry per tube and sphere, so a change of the
+  * colors only updates the lookup table.
   */
 
   class MITKTUBEGRAPH_EXPORT TubeGraphVtkMapper3D : public VtkMapper
@@ -76,25 +82,27 @@ namespace mitk
     virtual void GenerateTubeGraphData(mitk::BaseRenderer *renderer);
 
     /**
-    * Render only the visual information like color or visibility new.
+    * Render only the visual information like color or visibility new. The merged poly data is
+    * only rebuilt if the set of visible tubes has changed.
     */
     virtual void RenderTubeGraphPropertyInformation(mitk::BaseRenderer *renderer);
 
     /**
-    * Converts a single tube into a vtkPolyData. Each point of the
-    * tube surface is labeled with the tube id.
+    * Adds the cells of the poly data to the merged poly data, labeled with the given structure id.
+    */
+    void AddToMergedPolyData(vtkAppendPolyData *appendPolyData, vtkPolyData *polyData, vtkIdType structureId);
+
+    /**
+    * Converts a single tube into a vtkPolyData. The tube is colored
+    * via its structure id, see AddToMergedPolyData().
     */
     void GeneratePolyDataForTube(TubeGraphEdge &edge,
                                  const TubeGraph::Pointer &graph,
-                                 const TubeGraphProperty::Pointer &graphProperty,
                                  mitk::BaseRenderer *renderer);
     void GeneratePolyDataForFurcation(TubeGraphVertex &vertex,
                                       const TubeGraph::Pointer &graph,
                                       mitk::BaseRenderer *renderer);
-    void ClipPolyData(TubeGraphVertex &vertex,
-                      const TubeGraph::Pointer &graph,
-                      const TubeGraphProperty::Pointer &graphProperty,
-                      mitk::BaseRenderer *renderer);
+    void ClipPolyData(TubeGraphVertex &vertex, const TubeGraph::Pointer &graph, mitk::BaseRenderer *renderer);
 
   private:
     bool ClipStructures();
@@ -103,13 +111,43 @@ namespace mitk
     {
     public:
       vtkSmartPointer<vtkAssembly> m_vtkTubeGraphAssembly;
-      std::map<TubeGraph::TubeDescriptorType, vtkSmartPointer<vtkActor>> m_vtkTubesActorMap;
-      std::map<TubeGraph::VertexDescriptorType, vtkSmartPointer<vtkActor>> m_vtkSpheresActorMap;
+      vtkSmartPointer<vtkActor> m_vtkTubeGraphActor;
+      vtkSmartPointer<vtkPolyDataMapper> m_vtkTubeGraphMapper;
+      vtkSmartPointer<vtkPolyData> m_vtkTubeGraphPolyData;
+      vtkSmartPointer<vtkLookupTable> m_LookupTable;
+
+      // (clipped) geometry of each tube and sphere
+      std::map<TubeGraph::TubeDescriptorType, vtkSmartPointer<vtkPolyData>> m_TubesPolyDataMap;
+      std::map<TubeGraph::VertexDescriptorType, vtkSmartPointer<vtkPolyData>> m_SpheresPolyDataMap;
+
+      // lookup table index of each tube and sphere
+      std::map<TubeGraph::TubeDescriptorType, vtkIdType> m_TubeIndices;
+      std::map<TubeGraph::VertexDescriptorType, vtkIdType> m_SphereIndices;
+
+      // tubes contained in the merged poly data
+      std::vector<TubeGraph::TubeDescriptorType> m_VisibleTubes;
 
       itk::TimeStamp m_lastGenerateDataTime;
       itk::TimeStamp m_lastRenderDataTime;
 
-      LocalStorage() { m_vtkTubeGraphAssembly = vtkSmartPointer<vtkAssembly>::New(); }
+      LocalStorage()
+      {
+        m_vtkTubeGraphAssembly = vtkSmartPointer<vtkAssembly>::New();
+        m_vtkTubeGraphActor = vtkSmartPointer<vtkActor>::New();
+        m_vtkTubeGraphMapper = vtkSmartPointer<vtkPolyDataMapper>::New();
+        m_vtkTubeGraphPolyData = vtkSmartPointer<vtkPolyData>::New();
+        m_LookupTable = vtkSmartPointer<vtkLookupTable>::New();
+
+        m_vtkTubeGraphMapper->SetInputData(m_vtkTubeGraphPolyData);
+        m_vtkTubeGraphMapper->SetLookupTable(m_LookupTable);
+        m_vtkTubeGraphMapper->UseLookupTableScalarRangeOn();
+        m_vtkTubeGraphMapper->SetScalarModeToUseCellFieldData();
+        m_vtkTubeGraphMapper->SelectColorArray("StructureIds");
+        m_vtkTubeGraphMapper->SetColorModeToMapScalars();
+        m_vtkTubeGraphMapper->ScalarVisibilityOn();
+        m_vtkTubeGraphActor->SetMapper(m_vtkTubeGraphMapper);
+        m_vtkTubeGraphAssembly->AddPart(m_vtkTubeGraphActor);
+      }
       ~LocalStorage() override {}
     };
 
@@ -60,6 +60,7 @@ void mitk::TubeGraphDataInteractor::DataNodeChanged()
         m_TubeGraph->GetProperty("Tube Graph.Visualization Information").GetPointer());
       if (m_TubeGraphProperty.IsNull())
         MITK_ERROR << "Something went wrong! No tube graph property!";
+      m_Picker.SetTubeGraph(m_TubeGraph);
     }
     else
       m_TubeGraph = nullptr;
@@ -74,10 +75,10 @@ bool mitk::TubeGraphDataInteractor::CheckOverTube(const InteractionEvent *intera
   if (positionEvent == nullptr)
     return false;
 
-  auto *picker = new mitk::TubeGraphPicker();
-  picker->SetTubeGraph(m_TubeGraph);
+  if (m_TubeGraph.IsNull())
+    return false;
 
-  auto pickedTube = picker->GetPickedTube(positionEvent->GetPositionInWorld());
+  auto pickedTube = m_Picker.GetPickedTube(positionEvent->GetPositionInWorld());
 
   TubeGraph::TubeDescriptorType tubeDescriptor = pickedTube.first;
 
@@ -16,7 +16,17 @@ See LICENSE.txt or http://www.mitk.org for details.
 
 #include "mitkTubeGraphPicker.h"
 
-mitk::TubeGraphPicker::TubeGraphPicker()
+#include <algorithm>
+#include <limits>
+
+namespace
+{
+  // elements can be picked up to this distance (in index coordinates) outside of their radius
+  const double PickingTolerance = 1.0;
+  const unsigned int MaximumElementsPerLeaf = 4;
+}
+
+mitk::TubeGraphPicker::TubeGraphPicker() : m_HierarchyMTime(0)
 {
   m_WorldPosition.Fill(0.0);
 }
@@ -28,6 +38,107 @@ void mitk::TubeGraphPicker::SetTubeGraph(const mitk::TubeGraph *tubeGraph)
   m_TubeGraph = tubeGraph;
   m_TubeGraphProperty =
     dynamic_cast<TubeGraphProperty *>(m_TubeGraph->GetProperty("Tube Graph.Visualization Information").GetPointer());
+  m_Elements.clear();
+  m_Nodes.clear();
+  m_HierarchyMTime = 0;
+}
+
+void mitk::TubeGraphPicker::BuildHierarchy()
+{
+  m_Elements.clear();
+  m_Nodes.clear();
+
+  std::vector<mitk::TubeGraphEdge> allEdges = m_TubeGraph->GetVectorOfAllEdges();
+  for (auto edge = allEdges.begin(); edge != allEdges.end(); ++edge)
+  {
+    std::pair<mitk::TubeGraphVertex, mitk::TubeGraphVertex> soureTargetPair =
+      m_TubeGraph->GetVerticesOfAnEdge(m_TubeGraph->GetEdgeDescriptor(*edge));
+
+    TubeGraph::TubeDescriptorType tubeId(m_TubeGraph->GetVertexDescriptor(soureTargetPair.first),
+                                         m_TubeGraph->GetVertexDescriptor(soureTargetPair.second));
+
+    std::vector<mitk::TubeElement *> allElements = edge->GetElementVector();
+    for (unsigned int index = 0; index < edge->GetNumberOfElements(); index++)
+    {
+      PickableElement element;
+      element.Center = allElements[index]->GetCoordinates();
+      if (dynamic_cast<mitk::CircularProfileTubeElement *>(allElements[index]))
+        element.Radius = ((dynamic_cast<mitk::CircularProfileTubeElement *>(allElements[index]))->GetDiameter()) / 2;
+      else
+        element.Radius = 0;
+      element.Tube = tubeId;
+      element.Element = allElements[index];
+      element.Order = static_cast<unsigned int>(m_Elements.size());
+      m_Elements.push_back(element);
+    }
+  }
+
+  if (!m_Elements.empty())
+  {
+    Node root;
+    root.Begin = 0;
+    root.End = static_cast<unsigned int>(m_Elements.size());
+    m_Nodes.push_back(root);
+    this->BuildNode(0);
+  }
+  m_HierarchyMTime = m_TubeGraph->GetMTime();
+}
+
+void mitk::TubeGraphPicker::BuildNode(unsigned int nodeIndex)
+{
+  const unsigned int begin = m_Nodes[nodeIndex].Begin;
+  const unsigned int end = m_Nodes[nodeIndex].End;
+
+  // bounds of the picking spheres and of the centers of all elements of the node
+  double bounds[6];
+  double centerBounds[6];
+  for (unsigned int d = 0; d < 3; ++d)
+  {
+    bounds[2 * d] = centerBounds[2 * d] = std::numeric_limits<double>::max();
+    bounds[2 * d + 1] = centerBounds[2 * d + 1] = std::numeric_limits<double>::lowest();
+  }
+  for (unsigned int i = begin; i < end; ++i)
+  {
+    const double reach = m_Elements[i].Radius + PickingTolerance;
+    for (unsigned int d = 0; d < 3; ++d)
+    {
+      bounds[2 * d] = std::min(bounds[2 * d], m_Elements[i].Center[d] - reach);
+      bounds[2 * d + 1] = std::max(bounds[2 * d + 1], m_Elements[i].Center[d] + reach);
+      centerBounds[2 * d] = std::min(centerBounds[2 * d], m_Elements[i].Center[d]);
+      centerBounds[2 * d + 1] = std::max(centerBounds[2 * d + 1], m_Elements[i].Center[d]);
+    }
+  }
+  std::copy(bounds, bounds + 6, m_Nodes[nodeIndex].Bounds);
+  m_Nodes[nodeIndex].FirstChild = -1;
+
+  if (end - begin <= MaximumElementsPerLeaf)
+    return;
+
+  // split the elements at the median of the longest axis
+  unsigned int axis = 0;
+  for (unsigned int d = 1; d < 3; ++d)
+  {
+    if (centerBounds[2 * d + 1] - centerBounds[2 * d] > centerBounds[2 * axis + 1] - centerBounds[2 * axis])
+      axis = d;
+  }
+  const unsigned int middle = (begin + end) / 2;
+  std::nth_element(m_Elements.begin() + begin,
+                   m_Elements.begin() + middle,
+                   m_Elements.begin() + end,
+                   [axis](const PickableElement &a, const PickableElement &b) { return a.Center[axis] < b.Center[axis]; });
+
+  const auto firstChild = static_cast<int>(m_Nodes.size());
+  m_Nodes[nodeIndex].FirstChild = firstChild;
+  Node lower;
+  lower.Begin = begin;
+  lower.End = middle;
+  Node upper;
+  upper.Begin = middle;
+  upper.End = end;
+  m_Nodes.push_back(lower);
+  m_Nodes.push_back(upper);
+  this->BuildNode(firstChild);
+  this->BuildNode(firstChild + 1);
 }
 
 /**
@@ -42,56 +153,61 @@ std::pair<mitk::TubeGraph::TubeDescriptorType, mitk::TubeElement *> mitk::TubeGr
     mitk::TubeElement *nullPointer = nullptr;
     return std::pair<mitk::TubeGraph::TubeDescriptorType, mitk::TubeElement *>(TubeGraph::ErrorId, nullPointer);
   }
-  m_WorldPosition = pickedPosition;
 
-  Point3D currentPosition;
-  ScalarType closestDistance = itk::NumericTraits<ScalarType>::max();
-  ScalarType currentDistance = itk::NumericTraits<ScalarType>::max();
-  float currentRadius = 0;
+  if (m_HierarchyMTime != m_TubeGraph->GetMTime())
+    this->BuildHierarchy();
 
-  TubeGraph::TubeDescriptorType currentTubeId(TubeGraph::ErrorId);
-  TubeGraph::TubeDescriptorType tubeId(TubeGraph::ErrorId);
-  TubeElement *tubeElement;
+  // calculate point->point distance in index coordinates
+  itk::Index<3> worldIndex;
+  m_TubeGraph->GetGeometry()->WorldToIndex(pickedPosition, worldIndex);
 
-  // iterate over all edges and find the edge, which element is near by the clicked point
-  std::vector<mitk::TubeGraphEdge> allEdges = m_TubeGraph->GetVectorOfAllEdges();
-  for (auto edge = allEdges.begin(); edge != allEdges.end(); ++edge)
+  m_WorldPosition[0] = worldIndex[0];
+  m_WorldPosition[1] = worldIndex[1];
+  m_WorldPosition[2] = worldIndex[2];
+
+  ScalarType closestDistance = itk::NumericTraits<ScalarType>::max();
+  const PickableElement *closestElement = nullptr;
+
+  // find the element, which is near by the clicked point
+  std::vector<int> nodeStack;
+  if (!m_Nodes.empty())
+    nodeStack.push_back(0);
+  while (!nodeStack.empty())
   {
-    std::pair<mitk::TubeGraphVertex, mitk::TubeGraphVertex> soureTargetPair =
-      m_TubeGraph->GetVerticesOfAnEdge(m_TubeGraph->GetEdgeDescriptor(*edge));
+    const Node &node = m_Nodes[nodeStack.back()];
+    nodeStack.pop_back();
+
+    bool isInside = true;
+    for (unsigned int d = 0; d < 3 && isInside; ++d)
+      isInside = m_WorldPosition[d] >= node.Bounds[2 * d] && m_WorldPosition[d] <= node.Bounds[2 * d + 1];
+    if (!isInside)
+      continue;
+
+    if (node.FirstChild >= 0)
+    {
+      nodeStack.push_back(node.FirstChild);
+      nodeStack.push_back(node.FirstChild + 1);
+      continue;
+    }
 
-    currentTubeId = TubeGraph::TubeDescriptorType(m_TubeGraph->GetVertexDescriptor(soureTargetPair.first),
-                                                  m_TubeGraph->GetVertexDescriptor(soureTargetPair.second));
-    // check if the tube is visible, if not pass this tube. User can not choose a tube, which he can't see
-    if (m_TubeGraphProperty->IsTubeVisible(currentTubeId))
+    for (unsigned int i = node.Begin; i < node.End; ++i)
     {
-      std::vector<mitk::TubeElement *> allElements = edge->GetElementVector();
-      for (unsigned int index = 0; index < edge->GetNumberOfElements(); index++)
+      const PickableElement &element = m_Elements[i];
+      const ScalarType currentDistance = m_WorldPosition.EuclideanDistanceTo(element.Center);
+      if ((currentDistance - element.Radius) < PickingTolerance &&
+          (currentDistance < closestDistance ||
+           (currentDistance == closestDistance && closestElement != nullptr && element.Order < closestElement->Order)) &&
+          // check if the tube is visible, if not pass this tube. User can not choose a tube, which he can't see
+          m_TubeGraphProperty->IsTubeVisible(element.Tube))
       {
-        currentPosition = allElements[index]->GetCoordinates();
-        if (dynamic_cast<mitk::CircularProfileTubeElement *>(allElements[index]))
-          currentRadius = ((dynamic_cast<mitk::CircularProfileTubeElement *>(allElements[index]))->GetDiameter()) / 2;
-        else
-          currentRadius = 0;
-
-        // calculate point->point distance
-        itk::Index<3> worldIndex;
-        m_TubeGraph->GetGeometry()->WorldToIndex(pickedPosition, worldIndex);
-
-        m_WorldPosition[0] = worldIndex[0];
-        m_WorldPosition[1] = worldIndex[1];
-        m_WorldPosition[2] = worldIndex[2];
-
-        currentDistance = m_WorldPosition.EuclideanDistanceTo(currentPosition);
-        if (currentDistance < closestDistance && (currentDistance - currentRadius) < 1.0)
-        {
-          closestDistance = currentDistance;
-          tubeId = currentTubeId;
-          tubeElement = allElements[index];
-        }
+        closestDistance = currentDistance;
+        closestElement = &element;
       }
     }
   }
 
-  return std::make_pair(tubeId, tubeElement);
+  if (closestElement == nullptr)
+    return std::pair<mitk::TubeGraph::TubeDescriptorType, mitk::TubeElement *>(TubeGraph::ErrorId, nullptr);
+
+  return std::make_pair(closestElement->Tube, closestElement->Element);
 }
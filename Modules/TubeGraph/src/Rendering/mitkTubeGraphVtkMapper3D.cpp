@@ -19,17 +19,21 @@ See LICENSE.txt or http://www.mitk.org for details.
 #include <mitkColorProperty.h>
 
 #include <vtkCellArray.h>
+#include <vtkCellData.h>
 #include <vtkClipPolyData.h>
 #include <vtkContourFilter.h>
 #include <vtkCylinder.h>
 #include <vtkFloatArray.h>
 #include <vtkGeneralTransform.h>
+#include <vtkIdTypeArray.h>
 #include <vtkImplicitBoolean.h>
 #include <vtkImplicitModeller.h>
+#include <vtkLookupTable.h>
 #include <vtkPlane.h>
 #include <vtkPointData.h>
 #include <vtkPoints.h>
 #include <vtkPolyDataMapper.h>
+#include <vtkPolyDataNormals.h>
 #include <vtkProperty.h>
 #include <vtkRenderer.h>
 #include <vtkSampleFunction.h>
@@ -37,6 +41,9 @@ See LICENSE.txt or http://www.mitk.org for details.
 #include <vtkTubeFilter.h>
 #include <vtkUnsignedIntArray.h>
 
+#include <algorithm>
+#include <set>
+
 mitk::TubeGraphVtkMapper3D::TubeGraphVtkMapper3D()
 {
 }
@@ -57,14 +64,18 @@ vtkProp *mitk::TubeGraphVtkMapper3D::GetVtkProp(mitk::BaseRenderer *renderer)
 
 void mitk::TubeGraphVtkMapper3D::GenerateDataForRenderer(mitk::BaseRenderer *renderer)
 {
-  bool renderTubeGraph(false);
   LocalStorage *ls = m_LSH.GetLocalStorage(renderer);
 
   TubeGraph::Pointer tubeGraph = const_cast<mitk::TubeGraph *>(this->GetInput());
+  if (tubeGraph.IsNull())
+  {
+    itkWarningMacro(<< "Input of tube graph mapper is nullptr!");
+    return;
+  }
   TubeGraphProperty::Pointer tubeGraphProperty =
     dynamic_cast<TubeGraphProperty *>(tubeGraph->GetProperty("Tube Graph.Visualization Information").GetPointer());
 
-  if (tubeGraph.IsNull() || tubeGraphProperty.IsNull())
+  if (tubeGraphProperty.IsNull())
   {
     itkWarningMacro(<< "Input of tube graph mapper is nullptr!");
     return;
@@ -73,7 +84,6 @@ void mitk::TubeGraphVtkMapper3D::GenerateDataForRenderer(mitk::BaseRenderer *ren
   if (tubeGraph->GetMTime() > ls->m_lastGenerateDataTime)
   {
     this->GenerateTubeGraphData(renderer);
-    renderTubeGraph = true;
   }
   else
   {
@@ -82,48 +92,6 @@ void mitk::TubeGraphVtkMapper3D::GenerateDataForRenderer(mitk::BaseRenderer *ren
     if (tubeGraphProperty->GetMTime() > ls->m_lastRenderDataTime)
     {
       this->RenderTubeGraphPropertyInformation(renderer);
-      renderTubeGraph = true;
-    }
-  }
-
-  if (renderTubeGraph)
-  {
-    std::vector<TubeGraph::VertexDescriptorType> alreadyRenderedVertexList;
-    // don't render the sphere which is the root of the graph; so add it to the list before;
-    // TODO check both spheres
-    TubeGraph::VertexDescriptorType root = tubeGraph->GetRootVertex();
-    alreadyRenderedVertexList.push_back(root);
-
-    for (auto itTubes =
-           ls->m_vtkTubesActorMap.begin();
-         itTubes != ls->m_vtkTubesActorMap.end();
-         itTubes++)
-    {
-      if (tubeGraphProperty->IsTubeVisible(itTubes->first))
-      {
-        // add tube actor to assembly
-        ls->m_vtkTubeGraphAssembly->AddPart(itTubes->second);
-
-        // render the clipped spheres as end-cups of a tube and connections between tubes
-        if (std::find(alreadyRenderedVertexList.begin(), alreadyRenderedVertexList.end(), itTubes->first.first) ==
-            alreadyRenderedVertexList.end())
-        {
-          auto itSourceSphere =
-            ls->m_vtkSpheresActorMap.find(itTubes->first.first);
-          if (itSourceSphere != ls->m_vtkSpheresActorMap.end())
-            ls->m_vtkTubeGraphAssembly->AddPart(itSourceSphere->second);
-          alreadyRenderedVertexList.push_back(itSourceSphere->first);
-        }
-        if (std::find(alreadyRenderedVertexList.begin(), alreadyRenderedVertexList.end(), itTubes->first.second) ==
-            alreadyRenderedVertexList.end())
-        {
-          auto itTargetSphere =
-            ls->m_vtkSpheresActorMap.find(itTubes->first.second);
-          if (itTargetSphere != ls->m_vtkSpheresActorMap.end())
-            ls->m_vtkTubeGraphAssembly->AddPart(itTargetSphere->second);
-          alreadyRenderedVertexList.push_back(itTargetSphere->first);
-        }
-      }
     }
   }
 
@@ -131,13 +99,12 @@ void mitk::TubeGraphVtkMapper3D::GenerateDataForRenderer(mitk::BaseRenderer *ren
   //{
   //  float opacity = 1.0f;
   //  if( this->GetDataNode()->GetOpacity(opacity,renderer) )
-  //    ls->m_vtkTubesActor->GetProperty()->SetOpacity( opacity );
+  //    ls->m_vtkTubeGraphActor->GetProperty()->SetOpacity( opacity );
   //}
 }
 
 void mitk::TubeGraphVtkMapper3D::RenderTubeGraphPropertyInformation(mitk::BaseRenderer *renderer)
 {
-  MITK_INFO << "Render tube graph property information!";
   LocalStorage *ls = m_LSH.GetLocalStorage(renderer);
   TubeGraph::ConstPointer tubeGraph = this->GetInput();
   TubeGraphProperty::Pointer tubeGraphProperty =
@@ -146,96 +113,151 @@ void mitk::TubeGraphVtkMapper3D::RenderTubeGraphPropertyInformation(mitk::BaseRe
   if (tubeGraphProperty.IsNull())
   {
     MITK_INFO << "No tube graph property!! So no special render information...";
-    return;
   }
 
-  std::vector<TubeGraphVertex> allVertices = tubeGraph->GetVectorOfAllVertices();
-  for (auto vertex = allVertices.begin(); vertex != allVertices.end(); ++vertex)
+  // Colors of the tubes; visible tubes are part of the merged poly data
+  std::vector<TubeGraph::TubeDescriptorType> visibleTubes;
+  std::map<TubeGraph::VertexDescriptorType, std::pair<mitk::Color, int>> sphereColors;
+  for (auto itTubes = ls->m_TubeIndices.begin(); itTubes != ls->m_TubeIndices.end(); ++itTubes)
   {
-    TubeGraph::VertexDescriptorType vertexDesc = tubeGraph->GetVertexDescriptor(*vertex);
-
-    double sphereColorR = 0;
-    double sphereColorG = 0;
-    double sphereColorB = 0;
+    const TubeGraph::TubeDescriptorType &tube = itTubes->first;
+    mitk::Color tubeColor;
+    tubeColor.Fill(150);
+    bool isVisible = true;
+    if (tubeGraphProperty.IsNotNull())
+    {
+      tubeColor = tubeGraphProperty->GetColorOfTube(tube);
+      isVisible = tubeGraphProperty->IsTubeVisible(tube);
+    }
+    ls->m_LookupTable->SetTableValue(itTubes->second, tubeColor[0] / 255, tubeColor[1] / 255, tubeColor[2] / 255, 1.0);
 
-    int numberOfVisibleEdges = 0;
-    std::vector<TubeGraphEdge> allEdgesOfVertex = tubeGraph->GetAllEdgesOfAVertex(vertexDesc);
-    for (auto edge = allEdgesOfVertex.begin(); edge != allEdgesOfVertex.end(); ++edge)
+    if (isVisible)
     {
-      // get edge descriptor
-      EdgeDescriptorType edgeDesc = tubeGraph->GetEdgeDescriptor(*edge);
+      visibleTubes.push_back(tube);
 
-      // get source and target vertex descriptor
-      std::pair<TubeGraphVertex, TubeGraphVertex> soureTargetPair = tubeGraph->GetVerticesOfAnEdge(edgeDesc);
-      TubeGraphVertex source = soureTargetPair.first;
-      TubeGraphVertex target = soureTargetPair.second;
+      // the color of a sphere is the mean color of all visible tubes connected to it
+      for (const auto &vertexDesc : {tube.first, tube.second})
+      {
+        auto &sphereColor = sphereColors[vertexDesc];
+        if (sphereColor.second == 0)
+          sphereColor.first.Fill(0);
+        sphereColor.first += tubeColor;
+        ++sphereColor.second;
+      }
+    }
+  }
+
+  for (auto itSpheres = ls->m_SphereIndices.begin(); itSpheres != ls->m_SphereIndices.end(); ++itSpheres)
+  {
+    auto sphereColor = sphereColors.find(itSpheres->first);
+    if (sphereColor != sphereColors.end())
+    {
+      const double factor = 255.0 * sphereColor->second.second;
+      ls->m_LookupTable->SetTableValue(itSpheres->second,
+                                       sphereColor->second.first[0] / factor,
+                                       sphereColor->second.first[1] / factor,
+                                       sphereColor->second.first[2] / factor,
+                                       1.0);
+    }
+  }
+  ls->m_LookupTable->Modified();
 
-      // build tube descriptor [sourceId,targetId]
-      TubeGraph::TubeDescriptorType tube;
-      tube.first = tubeGraph->GetVertexDescriptor(source);
-      tube.second = tubeGraph->GetVertexDescriptor(target);
+  // the geometry only has to be merged again, if other tubes are visible now
+  if (visibleTubes != ls->m_VisibleTubes)
+  {
+    ls->m_VisibleTubes = visibleTubes;
 
-      if (tubeGraphProperty->IsTubeVisible(tube))
-      {
-        mitk::Color tubeColor = tubeGraphProperty->GetColorOfTube(tube);
+    // don't render the sphere which is the root of the graph; so add it to the list before;
+    // TODO check both spheres
+    std::set<TubeGraph::VertexDescriptorType> alreadyRenderedVertices;
+    alreadyRenderedVertices.insert(tubeGraph->GetRootVertex());
 
-        vtkSmartPointer<vtkDataArray> scalars =
-          ls->m_vtkTubesActorMap[tube]->GetMapper()->GetInput()->GetPointData()->GetScalars();
-        double color[3];
-        scalars->GetTuple(0, color);
+    vtkSmartPointer<vtkAppendPolyData> appendPolyData = vtkSmartPointer<vtkAppendPolyData>::New();
+    for (const auto &tube : visibleTubes)
+    {
+      this->AddToMergedPolyData(appendPolyData, ls->m_TubesPolyDataMap[tube], ls->m_TubeIndices[tube]);
 
-        if (color[0] != tubeColor[0] || color[1] != tubeColor[1] || color[2] != tubeColor[2])
+      // render the clipped spheres as end-cups of a tube and connections between tubes
+      for (const auto &vertexDesc : {tube.first, tube.second})
+      {
+        if (alreadyRenderedVertices.insert(vertexDesc).second)
         {
-          int numberOfPoints = scalars->GetSize();
-
-          vtkSmartPointer<vtkUnsignedCharArray> colorScalars = vtkSmartPointer<vtkUnsignedCharArray>::New();
-          colorScalars->SetName("colorScalars");
-          colorScalars->SetNumberOfComponents(3);
-          colorScalars->SetNumberOfTuples(numberOfPoints);
-          for (int i = 0; i < numberOfPoints; i++)
-          {
-            scalars->InsertTuple3(i, tubeColor[0], tubeColor[1], tubeColor[2]);
-          }
-          ls->m_vtkTubesActorMap[tube]->GetMapper()->GetInput()->GetPointData()->SetActiveScalars("colorScalars");
+          auto itSphere = ls->m_SpheresPolyDataMap.find(vertexDesc);
+          if (itSphere != ls->m_SpheresPolyDataMap.end())
+            this->AddToMergedPolyData(appendPolyData, itSphere->second, ls->m_SphereIndices[vertexDesc]);
         }
-
-        sphereColorR += tubeColor[0];
-        sphereColorG += tubeColor[1];
-        sphereColorB += tubeColor[2];
-        numberOfVisibleEdges++;
       }
     }
-    if (numberOfVisibleEdges > 0)
+
+    if (appendPolyData->GetNumberOfInputConnections(0) > 0)
     {
-      sphereColorR /= 255 * numberOfVisibleEdges;
-      sphereColorG /= 255 * numberOfVisibleEdges;
-      sphereColorB /= 255 * numberOfVisibleEdges;
+      appendPolyData->Update();
+      ls->m_vtkTubeGraphPolyData = appendPolyData->GetOutput();
     }
-
-    ls->m_vtkSpheresActorMap[vertexDesc]->GetProperty()->SetColor(sphereColorR, sphereColorG, sphereColorB);
+    else
+    {
+      ls->m_vtkTubeGraphPolyData = vtkSmartPointer<vtkPolyData>::New();
+    }
+    ls->m_vtkTubeGraphMapper->SetInputData(ls->m_vtkTubeGraphPolyData);
   }
+
   ls->m_lastRenderDataTime.Modified();
 }
 
+void mitk::TubeGraphVtkMapper3D::AddToMergedPolyData(vtkAppendPolyData *appendPolyData,
+                                                     vtkPolyData *polyData,
+                                                     vtkIdType structureId)
+{
+  // label every cell with the lookup table index of its tube or sphere. Only the normals are kept of the point
+  // data, since vtkAppendPolyData drops every array that is missing in one of its inputs.
+  vtkSmartPointer<vtkPolyData> labeledPolyData = vtkSmartPointer<vtkPolyData>::New();
+  labeledPolyData->ShallowCopy(polyData);
+  labeledPolyData->GetPointData()->Initialize();
+  labeledPolyData->GetCellData()->Initialize();
+
+  vtkDataArray *normals = polyData->GetPointData()->GetNormals();
+  if (normals != nullptr)
+  {
+    labeledPolyData->GetPointData()->SetNormals(normals);
+  }
+  else
+  {
+    vtkSmartPointer<vtkPolyDataNormals> normalsFilter = vtkSmartPointer<vtkPolyDataNormals>::New();
+    normalsFilter->SetInputData(labeledPolyData);
+    normalsFilter->SplittingOff();
+    normalsFilter->ConsistencyOff();
+    normalsFilter->ComputeCellNormalsOff();
+    normalsFilter->Update();
+    labeledPolyData->GetPointData()->SetNormals(normalsFilter->GetOutput()->GetPointData()->GetNormals());
+  }
+
+  vtkSmartPointer<vtkIdTypeArray> structureIds = vtkSmartPointer<vtkIdTypeArray>::New();
+  structureIds->SetName("StructureIds");
+  structureIds->SetNumberOfTuples(labeledPolyData->GetNumberOfCells());
+  structureIds->FillComponent(0, structureId);
+  labeledPolyData->GetCellData()->AddArray(structureIds);
+
+  appendPolyData->AddInputData(labeledPolyData);
+}
+
 void mitk::TubeGraphVtkMapper3D::GenerateTubeGraphData(mitk::BaseRenderer *renderer)
 {
   MITK_INFO << "Render tube graph!";
   LocalStorage *ls = m_LSH.GetLocalStorage(renderer);
 
-  ls->m_vtkTubesActorMap.clear();
-  ls->m_vtkSpheresActorMap.clear();
+  ls->m_TubesPolyDataMap.clear();
+  ls->m_SpheresPolyDataMap.clear();
+  ls->m_TubeIndices.clear();
+  ls->m_SphereIndices.clear();
+  ls->m_VisibleTubes.clear();
 
   TubeGraph::Pointer tubeGraph = const_cast<mitk::TubeGraph *>(this->GetInput());
-  TubeGraphProperty::Pointer tubeGraphProperty =
-    dynamic_cast<TubeGraphProperty *>(tubeGraph->GetProperty("Tube Graph.Visualization Information").GetPointer());
-  if (tubeGraphProperty.IsNull())
-    MITK_INFO << "No tube graph property!! So no special render information...";
 
   // render all edges as tubular structures using the vtkTubeFilter
   std::vector<TubeGraphEdge> allEdges = tubeGraph->GetVectorOfAllEdges();
   for (auto edge = allEdges.begin(); edge != allEdges.end(); ++edge)
   {
-    this->GeneratePolyDataForTube(*edge, tubeGraph, tubeGraphProperty, renderer);
+    this->GeneratePolyDataForTube(*edge, tubeGraph, renderer);
   }
 
   // Generate all vertices as spheres
@@ -245,11 +267,24 @@ void mitk::TubeGraphVtkMapper3D::GenerateTubeGraphData(mitk::BaseRenderer *rende
     this->GeneratePolyDataForFurcation(*vertex, tubeGraph, renderer);
     if (this->ClipStructures())
     {
-      this->ClipPolyData(*vertex, tubeGraph, tubeGraphProperty, renderer);
+      this->ClipPolyData(*vertex, tubeGraph, renderer);
     }
-
-    ls->m_lastGenerateDataTime.Modified();
   }
+
+  // one lookup table entry for each tube and each sphere
+  vtkIdType structureId = 0;
+  for (auto itTubes = ls->m_TubesPolyDataMap.begin(); itTubes != ls->m_TubesPolyDataMap.end(); ++itTubes)
+    ls->m_TubeIndices[itTubes->first] = structureId++;
+  for (auto itSpheres = ls->m_SpheresPolyDataMap.begin(); itSpheres != ls->m_SpheresPolyDataMap.end(); ++itSpheres)
+    ls->m_SphereIndices[itSpheres->first] = structureId++;
+
+  const vtkIdType numberOfStructures = std::max<vtkIdType>(structureId, 1);
+  ls->m_LookupTable->SetNumberOfTableValues(numberOfStructures);
+  ls->m_LookupTable->SetTableRange(-0.5, numberOfStructures - 0.5);
+  ls->m_LookupTable->Build();
+
+  this->RenderTubeGraphPropertyInformation(renderer);
+  ls->m_lastGenerateDataTime.Modified();
 }
 
 void mitk::TubeGraphVtkMapper3D::GeneratePolyDataForFurcation(mitk::TubeGraphVertex &vertex,
@@ -273,19 +308,11 @@ void mitk::TubeGraphVtkMapper3D::GeneratePolyDataForFurcation(mitk::TubeGraphVer
   sphereSource->SetPhiResolution(12);
   sphereSource->Update();
 
-  // generate a actor with a mapper for the sphere
-  vtkSmartPointer<vtkPolyDataMapper> sphereMapper = vtkSmartPointer<vtkPolyDataMapper>::New();
-  vtkSmartPointer<vtkActor> sphereActor = vtkSmartPointer<vtkActor>::New();
-
-  sphereMapper->SetInputConnection(sphereSource->GetOutputPort());
-  sphereActor->SetMapper(sphereMapper);
-
-  ls->m_vtkSpheresActorMap.insert(std::make_pair(graph->GetVertexDescriptor(vertex), sphereActor));
+  ls->m_SpheresPolyDataMap.insert(std::make_pair(graph->GetVertexDescriptor(vertex), sphereSource->GetOutput()));
 }
 
 void mitk::TubeGraphVtkMapper3D::GeneratePolyDataForTube(mitk::TubeGraphEdge &edge,
                                                          const mitk::TubeGraph::Pointer &graph,
-                                                         const mitk::TubeGraphProperty::Pointer &graphProperty,
                                                          mitk::BaseRenderer *renderer)
 {
   LocalStorage *ls = this->m_LSH.GetLocalStorage(renderer);
@@ -303,18 +330,6 @@ void mitk::TubeGraphVtkMapper3D::GeneratePolyDataForTube(mitk::TubeGraphEdge &ed
   tube.first = graph->GetVertexDescriptor(source);
   tube.second = graph->GetVertexDescriptor(target);
 
-  Color color;
-  if (graphProperty.IsNotNull())
-  {
-    color = graphProperty->GetColorOfTube(tube);
-  }
-  else
-  {
-    color[0] = 150;
-    color[1] = 150;
-    color[2] = 150;
-  }
-
   // add 2 points for the source and target vertices.
   unsigned int numberOfPoints = edge.GetNumberOfElements() + 2;
 
@@ -329,13 +344,8 @@ void mitk::TubeGraphVtkMapper3D::GeneratePolyDataForTube(mitk::TubeGraphEdge &ed
 
   vtkSmartPointer<vtkCellArray> lines = vtkSmartPointer<vtkCellArray>::New();
 
-  vtkSmartPointer<vtkUnsignedCharArray> colorScalars = vtkSmartPointer<vtkUnsignedCharArray>::New();
-  colorScalars->SetName("colorScalars");
-  colorScalars->SetNumberOfComponents(3);
-
   // resize the data-arrays
   radii->SetNumberOfTuples(numberOfPoints);
-  colorScalars->SetNumberOfTuples(numberOfPoints);
   lines->InsertNextCell(numberOfPoints);
 
   // Add the positions of the source node, the elements along the edge and
@@ -353,8 +363,6 @@ void mitk::TubeGraphVtkMapper3D::GeneratePolyDataForTube(mitk::TubeGraphEdge &ed
   }
   points->InsertPoint(id, coordinates[0], coordinates[1], coordinates[2]);
   radii->InsertTuple1(id, diameter / 2.0f);
-
-  colorScalars->InsertTuple3(id, color[0], color[1], color[2]);
   lines->InsertCellPoint(id);
   ++id;
 
@@ -369,7 +377,6 @@ void mitk::TubeGraphVtkMapper3D::GeneratePolyDataForTube(mitk::TubeGraphEdge &ed
     }
     points->InsertPoint(id, coordinates[0], coordinates[1], coordinates[2]);
     radii->InsertTuple1(id, diameter / 2.0f);
-    colorScalars->InsertTuple3(id, color[0], color[1], color[2]);
     lines->InsertCellPoint(id);
     ++id;
   }
@@ -382,7 +389,6 @@ void mitk::TubeGraphVtkMapper3D::GeneratePolyDataForTube(mitk::TubeGraphEdge &ed
   }
   points->InsertPoint(id, coordinates[0], coordinates[1], coordinates[2]);
   radii->InsertTuple1(id, diameter / 2.0f);
-  colorScalars->InsertTuple3(id, color[0], color[1], color[2]);
   lines->InsertCellPoint(id);
   ++id;
 
@@ -392,7 +398,6 @@ void mitk::TubeGraphVtkMapper3D::GeneratePolyDataForTube(mitk::TubeGraphEdge &ed
   polyData->SetPoints(points);
   polyData->SetLines(lines);
   polyData->GetPointData()->AddArray(radii);
-  polyData->GetPointData()->AddArray(colorScalars);
   polyData->GetPointData()->SetActiveScalars(radii->GetName());
 
   // Generate a tube  for all lines in the polydata object
@@ -413,22 +418,11 @@ void mitk::TubeGraphVtkMapper3D::GeneratePolyDataForTube(mitk::TubeGraphEdge &ed
   tubeFilter->CappingOff();
   tubeFilter->Update();
 
-  tubeFilter->GetOutput()->GetPointData()->SetActiveScalars("colorScalars");
-
-  // generate a actor with a mapper for the
-  vtkSmartPointer<vtkPolyDataMapper> tubeMapper = vtkSmartPointer<vtkPolyDataMapper>::New();
-  vtkSmartPointer<vtkActor> tubeActor = vtkSmartPointer<vtkActor>::New();
-
-  tubeMapper->SetInputConnection(tubeFilter->GetOutputPort());
-  tubeActor->SetMapper(tubeMapper);
-  tubeActor->GetProperty()->SetColor(color[0], color[1], color[2]);
-
-  ls->m_vtkTubesActorMap.insert(std::pair<TubeGraph::TubeDescriptorType, vtkSmartPointer<vtkActor>>(tube, tubeActor));
+  ls->m_TubesPolyDataMap.insert(std::make_pair(tube, tubeFilter->GetOutput()));
 }
 
 void mitk::TubeGraphVtkMapper3D::ClipPolyData(mitk::TubeGraphVertex &vertex,
                                               const mitk::TubeGraph::Pointer &graph,
-                                              const mitk::TubeGraphProperty::Pointer &graphProperty,
                                               mitk::BaseRenderer *renderer)
 {
   LocalStorage *ls = this->m_LSH.GetLocalStorage(renderer);
@@ -672,36 +666,24 @@ void mitk::TubeGraphVtkMapper3D::ClipPolyData(mitk::TubeGraphVertex &vertex,
     // ls->m_vtkTubeGraphAssembly->AddPart(impActor);
   }
 
-  double sphereColorR = 0;
-  double sphereColorG = 0;
-  double sphereColorB = 0;
-
   for (auto itClipStructure =
          cylinderForClipping.begin();
        itClipStructure != cylinderForClipping.end();
        itClipStructure++)
   {
-    vtkSmartPointer<vtkPolyDataMapper> sphereMapper =
-      dynamic_cast<vtkPolyDataMapper *>(ls->m_vtkSpheresActorMap[vertexDesc]->GetMapper());
-
-    if (sphereMapper != nullptr)
+    auto itSphere = ls->m_SpheresPolyDataMap.find(vertexDesc);
+    if (itSphere != ls->m_SpheresPolyDataMap.end())
     {
       // first clip the sphere with the cylinder
       vtkSmartPointer<vtkClipPolyData> clipperSphere = vtkSmartPointer<vtkClipPolyData>::New();
-      clipperSphere->SetInputData(sphereMapper->GetInput());
+      clipperSphere->SetInputData(itSphere->second);
       clipperSphere->SetClipFunction(itClipStructure->second);
       clipperSphere->GenerateClippedOutputOn();
       clipperSphere->Update();
 
-      sphereMapper->SetInputConnection(clipperSphere->GetOutputPort());
-      sphereMapper->Update();
+      itSphere->second = clipperSphere->GetOutput();
     }
 
-    mitk::Color tubeColor = graphProperty->GetColorOfTube(itClipStructure->first);
-    sphereColorR += tubeColor[0];
-    sphereColorG += tubeColor[1];
-    sphereColorB += tubeColor[2];
-
     // than clip with all other tubes
     for (auto itTobBeClipped =
            cylinderForClipping.begin();
@@ -712,33 +694,21 @@ void mitk::TubeGraphVtkMapper3D::ClipPolyData(mitk::TubeGraphVertex &vertex,
 
       if (itClipStructure->first != toBeClippedTube)
       {
-        vtkSmartPointer<vtkPolyDataMapper> tubeMapper =
-          dynamic_cast<vtkPolyDataMapper *>(ls->m_vtkTubesActorMap[toBeClippedTube]->GetMapper());
-
-        if (tubeMapper != nullptr)
+        auto itTube = ls->m_TubesPolyDataMap.find(toBeClippedTube);
+        if (itTube != ls->m_TubesPolyDataMap.end())
         {
           // first clip the sphere with the cylinder
           vtkSmartPointer<vtkClipPolyData> clipperTube = vtkSmartPointer<vtkClipPolyData>::New();
-          tubeMapper->Update();
-          clipperTube->SetInputData(tubeMapper->GetInput());
+          clipperTube->SetInputData(itTube->second);
           clipperTube->SetClipFunction(itClipStructure->second);
           clipperTube->GenerateClippedOutputOn();
           clipperTube->Update();
 
-          tubeMapper->SetInputConnection(clipperTube->GetOutputPort());
-          tubeMapper->Update();
+          itTube->second = clipperTube->GetOutput();
         }
       }
     }
   }
-  if (cylinderForClipping.size() != 0)
-  {
-    sphereColorR /= 255 * cylinderForClipping.size();
-    sphereColorG /= 255 * cylinderForClipping.size();
-    sphereColorB /= 255 * cylinderForClipping.size();
-  }
-
-  ls->m_vtkSpheresActorMap[vertexDesc]->GetProperty()->SetColor(sphereColorR, sphereColorG, sphereColorB);
 }
 
 bool mitk::TubeGraphVtkMapper3D::ClipStructures()
@@ -0,0 +1,3 @@
+set(MODULE_TESTS
+    mitkTubeGraphPickerTest.cpp
+)
@@ -0,0 +1,170 @@
+/*===================================================================
+
+The Medical Imaging Interaction Toolkit (MITK)
+
+Copyright (c) German Cancer Research Center,
+Division of Medical and Biological Informatics.
+All rights reserved.
+
+This software is distributed WITHOUT ANY WARRANTY; without
+even the implied warranty of MERCHANTABILITY or FITNESS FOR
+A PARTICULAR PURPOSE.
+
+See LICENSE.txt or http://www.mitk.org for details.
+
+===================================================================*/
+
+#include <mitkCircularProfileTubeElement.h>
+#include <mitkTestFixture.h>
+#include <mitkTestingMacros.h>
+#include <mitkTubeGraph.h>
+#include <mitkTubeGraphPicker.h>
+#include <mitkTubeGraphProperty.h>
+
+#include <vector>
+
+class mitkTubeGraphPickerTestSuite : public mitk::TestFixture
+{
+  CPPUNIT_TEST_SUITE(mitkTubeGraphPickerTestSuite);
+  MITK_TEST(TestPickMatchesExhaustiveSearch);
+  MITK_TEST(TestPickOutsideOfTubes);
+  MITK_TEST(TestHierarchyIsRebuiltAfterModification);
+  CPPUNIT_TEST_SUITE_END();
+
+private:
+  typedef std::pair<mitk::TubeGraph::TubeDescriptorType, mitk::TubeElement *> PickResultType;
+
+  mitk::TubeGraph::Pointer m_TubeGraph;
+  mitk::TubeGraphProperty::Pointer m_TubeGraphProperty;
+
+  // adds a straight tube along x with the given elements
+  void AddTube(double y, double z, unsigned int numberOfElements, float diameter)
+  {
+    mitk::TubeGraphVertex start(new mitk::CircularProfileTubeElement(-1.0f, y, z, diameter));
+    mitk::TubeGraphVertex end(new mitk::CircularProfileTubeElement(numberOfElements, y, z, diameter));
+    auto startDescriptor = m_TubeGraph->AddVertex(start);
+    auto endDescriptor = m_TubeGraph->AddVertex(end);
+
+    mitk::TubeGraphEdge edge;
+    for (unsigned int x = 0; x < numberOfElements; ++x)
+      edge.AddTubeElement(new mitk::CircularProfileTubeElement(x, y, z, diameter));
+    m_TubeGraph->AddEdge(startDescriptor, endDescriptor, edge);
+    m_TubeGraph->Modified();
+  }
+
+  // the search over all elements of all visible tubes, which the hierarchy must reproduce
+  PickResultType PickExhaustively(const mitk::Point3D &position)
+  {
+    itk::Index<3> index;
+    m_TubeGraph->GetGeometry()->WorldToIndex(position, index);
+    mitk::Point3D indexPosition;
+    for (unsigned int d = 0; d < 3; ++d)
+      indexPosition[d] = index[d];
+
+    PickResultType result(mitk::TubeGraph::ErrorId, nullptr);
+    mitk::ScalarType closestDistance = itk::NumericTraits<mitk::ScalarType>::max();
+
+    std::vector<mitk::TubeGraphEdge> allEdges = m_TubeGraph->GetVectorOfAllEdges();
+    for (auto edge = allEdges.begin(); edge != allEdges.end(); ++edge)
+    {
+      auto vertices = m_TubeGraph->GetVerticesOfAnEdge(m_TubeGraph->GetEdgeDescriptor(*edge));
+      mitk::TubeGraph::TubeDescriptorType tube(m_TubeGraph->GetVertexDescriptor(vertices.first),
+                                               m_TubeGraph->GetVertexDescriptor(vertices.second));
+      if (!m_TubeGraphProperty->IsTubeVisible(tube))
+        continue;
+
+      for (auto element : edge->GetElementVector())
+      {
+        const mitk::ScalarType radius = dynamic_cast<mitk::CircularProfileTubeElement *>(element)->GetDiameter() / 2;
+        const mitk::ScalarType distance = indexPosition.EuclideanDistanceTo(element->GetCoordinates());
+        if (distance < closestDistance && distance - radius < 1.0)
+        {
+          closestDistance = distance;
+          result = PickResultType(tube, element);
+        }
+      }
+    }
+    return result;
+  }
+
+public:
+  void setUp() override
+  {
+    m_TubeGraph = mitk::TubeGraph::New();
+    m_TubeGraphProperty = mitk::TubeGraphProperty::New();
+    m_TubeGraph->SetProperty("Tube Graph.Visualization Information", m_TubeGraphProperty);
+
+    // a stack of parallel tubes, close enough that neighbouring tubes compete for picks
+    for (unsigned int i = 0; i < 8; ++i)
+      for (unsigned int j = 0; j < 4; ++j)
+        this->AddTube(3.0 * i, 5.0 * j, 24, 2.0f);
+  }
+
+  void tearDown() override
+  {
+    m_TubeGraph = nullptr;
+    m_TubeGraphProperty = nullptr;
+  }
+
+  void TestPickMatchesExhaustiveSearch()
+  {
+    mitk::TubeGraphPicker picker;
+    picker.SetTubeGraph(m_TubeGraph);
+
+    unsigned int numberOfHits = 0;
+    for (int x = -2; x <= 25; ++x)
+      for (int y = -2; y <= 23; ++y)
+        for (int z = -2; z <= 17; ++z)
+        {
+          mitk::Point3D position;
+          position[0] = x;
+          position[1] = y;
+          position[2] = z;
+
+          const PickResultType expected = this->PickExhaustively(position);
+          const PickResultType picked = picker.GetPickedTube(position);
+          CPPUNIT_ASSERT_MESSAGE("Picked tube differs from exhaustive search", picked.first == expected.first);
+          CPPUNIT_ASSERT_MESSAGE("Picked element differs from exhaustive search", picked.second == expected.second);
+
+          if (expected.second != nullptr)
+            ++numberOfHits;
+        }
+
+    CPPUNIT_ASSERT_MESSAGE("Test positions did not hit any tube", numberOfHits > 0);
+  }
+
+  void TestPickOutsideOfTubes()
+  {
+    mitk::TubeGraphPicker picker;
+    picker.SetTubeGraph(m_TubeGraph);
+
+    mitk::Point3D position;
+    position[0] = 100.0;
+    position[1] = 100.0;
+    position[2] = 100.0;
+    const PickResultType picked = picker.GetPickedTube(position);
+    CPPUNIT_ASSERT_MESSAGE("Position far away from all tubes picked a tube", picked.first == mitk::TubeGraph::ErrorId);
+    CPPUNIT_ASSERT_MESSAGE("Position far away from all tubes picked an element", picked.second == nullptr);
+  }
+
+  void TestHierarchyIsRebuiltAfterModification()
+  {
+    mitk::TubeGraphPicker picker;
+    picker.SetTubeGraph(m_TubeGraph);
+
+    mitk::Point3D position;
+    position[0] = 5.0;
+    position[1] = 60.0;
+    position[2] = 0.0;
+    CPPUNIT_ASSERT_MESSAGE("Position outside of all tubes picked an element",
+                           picker.GetPickedTube(position).second == nullptr);
+
+    this->AddTube(60.0, 0.0, 10, 2.0f);
+    const PickResultType picked = picker.GetPickedTube(position);
+    CPPUNIT_ASSERT_MESSAGE("Tube added after the first pick was not found", picked.second != nullptr);
+    CPPUNIT_ASSERT_MESSAGE("Picked element differs from exhaustive search",
+                           picked.second == this->PickExhaustively(position).second);
+  }
+};
+
+MITK_TEST_SUITE_REGISTRATION(mitkTubeGraphPicker)
@@ -0,0 +1,146 @@
+/*===================================================================
+
+The Medical Imaging Interaction Toolkit (MITK)
+
+Copyright (c) German Cancer Research Center,
+Division of Medical and Biological Informatics.
+All rights reserved.
+
+This software is distributed WITHOUT ANY WARRANTY; without
+even the implied warranty of MERCHANTABILITY or FITNESS FOR
+A PARTICULAR PURPOSE.
+
+See LICENSE.txt or http://www.mitk.org for details.
+
+===================================================================*/
+
+#include "mitkUSImageFramePool.h"
+#include "mitkTestingMacros.h"
+#include "mitkImageReadAccessor.h"
+
+#include <itkRGBPixel.h>
+
+class mitkUSImageFramePoolTestClass
+{
+public:
+
+  static void TestFramesAreRecycled()
+  {
+    mitk::USImageFramePool::Pointer pool = mitk::USImageFramePool::New();
+    cv::Mat mat(240, 320, CV_8UC1, cv::Scalar(7));
+
+    mitk::Image::Pointer first = pool->ConvertOpenCVMat(mat);
+    MITK_TEST_CONDITION_REQUIRED(first.IsNotNull(), "Grey value frame should be converted");
+    void* firstData = mitk::ImageReadAccessor(first).GetData();
+
+    mitk::Image::Pointer second = pool->ConvertOpenCVMat(mat);
+    MITK_TEST_CONDITION(first != second, "A frame that is still referenced must not be handed out again");
+
+    second = nullptr;
+    mitk::Image::Pointer third = pool->ConvertOpenCVMat(mat);
+    MITK_TEST_CONDITION(first != third, "The first frame is still referenced");
+    MITK_TEST_CONDITION(pool->GetNumberOfFrames() == 2, "A released frame should be reused instead of allocating a new one");
+
+    first = nullptr;
+    mitk::Image::Pointer fourth = pool->ConvertOpenCVMat(mat);
+    MITK_TEST_CONDITION(mitk::ImageReadAccessor(fourth).GetData() == firstData, "The memory of the released first frame should be reused");
+    MITK_TEST_CONDITION(static_cast<const unsigned char*>(mitk::ImageReadAccessor(fourth).GetData())[0] == 7, "Pixel data should be copied into the frame");
+  }
+
+  static void TestGraftedFrameIsNotCopied()
+  {
+    mitk::USImageFramePool::Pointer pool = mitk::USImageFramePool::New();
+    cv::Mat mat(240, 320, CV_8UC1, cv::Scalar(3));
+
+    // this is what mitk::USDevice::GenerateData() does with its outputs
+    mitk::Image::Pointer output = mitk::Image::New();
+    mitk::Image::Pointer frame = pool->ConvertOpenCVMat(mat);
+    output->Graft(frame);
+    MITK_TEST_CONDITION(mitk::ImageReadAccessor(output).GetData() == mitk::ImageReadAccessor(frame).GetData(), "The output should share the pixel data of the frame");
+
+    mitk::Image::Pointer nextFrame = pool->ConvertOpenCVMat(mat);
+    MITK_TEST_CONDITION(nextFrame != frame, "A frame shared with an output must not be handed out again");
+
+    output->Graft(nextFrame);
+    frame = nextFrame;
+    nextFrame = pool->ConvertOpenCVMat(mat);
+    MITK_TEST_CONDITION(pool->GetNumberOfFrames() == 2, "The frame released by the output should be reused");
+    MITK_TEST_CONDITION(mitk::ImageReadAccessor(output).GetData() != mitk::ImageReadAccessor(nextFrame).GetData(), "The reused frame must not be shared with the output");
+  }
+
+  static void TestGeometryIsReset()
+  {
+    mitk::USImageFramePool::Pointer pool = mitk::USImageFramePool::New();
+    cv::Mat mat(10, 20, CV_8UC1, cv::Scalar(0));
+
+    mitk::Image::Pointer frame = pool->ConvertOpenCVMat(mat);
+    mitk::Vector3D spacing;
+    spacing.Fill(0.5);
+    frame->SetSpacing(spacing);
+    mitk::Point3D origin;
+    origin.Fill(10.0);
+    frame->SetOrigin(origin);
+    frame = nullptr;
+
+    frame = pool->ConvertOpenCVMat(mat);
+    MITK_TEST_CONDITION(pool->GetNumberOfFrames() == 1, "Released frame should be reused");
+    MITK_TEST_CONDITION(frame->GetGeometry()->GetSpacing()[0] == 1.0, "Spacing of a reused frame should be reset");
+    MITK_TEST_CONDITION(frame->GetGeometry()->GetOrigin()[0] == 0.0, "Origin of a reused frame should be reset");
+  }
+
+  static void TestLayoutChange()
+  {
+    mitk::USImageFramePool::Pointer pool = mitk::USImageFramePool::New();
+    pool->ConvertOpenCVMat(cv::Mat(240, 320, CV_8UC1, cv::Scalar(0)));
+    mitk::Image::Pointer frame = pool->ConvertOpenCVMat(cv::Mat(100, 200, CV_8UC1, cv::Scalar(0)));
+
+    MITK_TEST_CONDITION(frame->GetDimension(0) == 200 && frame->GetDimension(1) == 100, "Frame should have the new layout");
+    MITK_TEST_CONDITION(pool->GetNumberOfFrames() == 1, "Unused frames with the old layout should be dropped");
+  }
+
+  static void TestColourConversion()
+  {
+    mitk::USImageFramePool::Pointer pool = mitk::USImageFramePool::New();
+    cv::Mat mat(10, 10, CV_8UC3, cv::Scalar(1, 2, 3)); // BGR
+
+    mitk::Image::Pointer frame = pool->ConvertOpenCVMat(mat);
+    MITK_TEST_CONDITION_REQUIRED(frame.IsNotNull(), "Colour frame should be converted");
+    MITK_TEST_CONDITION(frame->GetPixelType() == mitk::MakePixelType<itk::Image<itk::RGBPixel<unsigned char>, 2> >(), "Frame should have RGB pixel type");
+
+    const unsigned char* data = static_cast<const unsigned char*>(mitk::ImageReadAccessor(frame).GetData());
+    MITK_TEST_CONDITION(data[0] == 3 && data[1] == 2 && data[2] == 1, "Channels should be converted from BGR to RGB");
+  }
+
+  static void TestPoolMisses()
+  {
+    mitk::USImageFramePool::Pointer pool = mitk::USImageFramePool::New();
+    pool->SetMaximumNumberOfFrames(2);
+    cv::Mat mat(10, 10, CV_8UC1, cv::Scalar(0));
+
+    std::vector<mitk::Image::Pointer> frames;
+    for (int i = 0; i < 3; ++i)
+    {
+      frames.push_back(pool->ConvertOpenCVMat(mat));
+    }
+
+    MITK_TEST_CONDITION(pool->GetNumberOfFrames() == 2, "Pool should not grow beyond its maximum size");
+    MITK_TEST_CONDITION(pool->GetNumberOfPoolMisses() == 1, "Frames allocated outside of the pool should be counted");
+  }
+};
+
+/**
+* This function is testing methods of the class USImageFramePool.
+*/
+int mitkUSImageFramePoolTest(int /* argc */, char* /*argv*/[])
+{
+  MITK_TEST_BEGIN("mitkUSImageFramePoolTest");
+
+  mitkUSImageFramePoolTestClass::TestFramesAreRecycled();
+  mitkUSImageFramePoolTestClass::TestGraftedFrameIsNotCopied();
+  mitkUSImageFramePoolTestClass::TestGeometryIsReset();
+  mitkUSImageFramePoolTestClass::TestLayoutChange();
+  mitkUSImageFramePoolTestClass::TestColourConversion();
+  mitkUSImageFramePoolTestClass::TestPoolMisses();
+
+  MITK_TEST_END();
+}
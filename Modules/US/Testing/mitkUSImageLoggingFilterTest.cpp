@@ -40,6 +40,8 @@ class mitkUSImageLoggingFilterTestSuite : public mitk::TestFixture
   MITK_TEST(TestSavingAfterMupltipleUpdateCalls);
   MITK_TEST(TestFilterWithEmptyImages);
   MITK_TEST(TestFilterWithInvalidPath);
+  MITK_TEST(TestStreamingToSequenceFile);
+  MITK_TEST(TestStreamingDropsImagesIfQueueIsFull);
   //MITK_TEST(TestJpgFileExtension); //bug 19614
   CPPUNIT_TEST_SUITE_END();
 
@@ -162,6 +164,58 @@ public:
                                mitk::Exception);
   }
 
+  void TestStreamingToSequenceFile()
+  {
+  m_TestFilter->SetInput(m_RandomSingleSliceImage);
+  std::string sequenceFileName = m_TestFilter->StartStreaming(m_TemporaryTestDirectory);
+  CPPUNIT_ASSERT_MESSAGE("Testing if filter is in streaming mode", m_TestFilter->GetIsStreaming());
+
+  for(int i=0; i<5; i++)
+    {
+    m_RandomSingleSliceImage->Modified();
+    m_TestFilter->Update();
+    std::stringstream testmessage;
+    testmessage << "testmessage" << i;
+    m_TestFilter->AddMessageToCurrentImage(testmessage.str());
+    }
+  m_TestFilter->StopStreaming();
+
+  CPPUNIT_ASSERT_MESSAGE("Testing if sequence file exists", Poco::File(sequenceFileName.c_str()).exists());
+  CPPUNIT_ASSERT_MESSAGE("Testing if all images were streamed", m_TestFilter->GetNumberOfStreamedImages() == 5);
+
+  std::vector<mitk::Image::Pointer> images;
+  std::vector<double> timestamps;
+  std::map<int, std::string> messages;
+  mitk::USImageLoggingFilter::LoadImageSequence(sequenceFileName, images, timestamps, messages);
+  CPPUNIT_ASSERT_MESSAGE("Testing if all images were read", images.size() == 5 && timestamps.size() == 5);
+  CPPUNIT_ASSERT_MESSAGE("Testing if messages were read", messages.size() == 5 && messages[4] == "testmessage4");
+  CPPUNIT_ASSERT_MESSAGE("Testing if streamed image equals input image",
+                         mitk::Equal(*m_RandomSingleSliceImage, *images.at(0), mitk::eps, true));
+
+  //clean up
+  std::remove(sequenceFileName.c_str());
+  }
+
+  void TestStreamingDropsImagesIfQueueIsFull()
+  {
+  m_TestFilter->SetInput(m_RandomRestImage1);
+  m_TestFilter->SetMaximumQueueSize(1);
+  std::string sequenceFileName = m_TestFilter->StartStreaming(m_TemporaryTestDirectory);
+
+  for(int i=0; i<20; i++)
+    {
+    m_RandomRestImage1->Modified();
+    m_TestFilter->Update();
+    }
+  m_TestFilter->StopStreaming();
+
+  CPPUNIT_ASSERT_MESSAGE("Testing if every image was either streamed or dropped",
+                         m_TestFilter->GetNumberOfStreamedImages() + m_TestFilter->GetNumberOfDroppedImages() == 20);
+
+  //clean up
+  std::remove(sequenceFileName.c_str());
+  }
+
   void TestJpgFileExtension()
   {
   CPPUNIT_ASSERT_MESSAGE("Testing setting of jpg extension.",m_TestFilter->SetImageFilesExtension(".jpg"));
@@ -0,0 +1,179 @@
+/*===================================================================
+
+The Medical Imaging Interaction Toolkit (MITK)
+
+Copyright (c) German Cancer Research Center,
+Division of Medical and Biological Informatics.
+All rights reserved.
+
+This software is distributed WITHOUT ANY WARRANTY; without
+even the implied warranty of MERCHANTABILITY or FITNESS FOR
+A PARTICULAR PURPOSE.
+
+See LICENSE.txt or http://www.mitk.org for details.
+
+===================================================================*/
+
+#include "mitkUSImageFramePool.h"
+
+#include <mitkImageWriteAccessor.h>
+#include <mitkProportionalTimeGeometry.h>
+#include <itkMutexLockHolder.h>
+#include <itkRGBPixel.h>
+
+#include <opencv2/imgproc.hpp>
+
+typedef itk::MutexLockHolder<itk::FastMutexLock> MutexLockHolder;
+
+mitk::USImageFramePool::USImageFramePool()
+  : m_MaximumNumberOfFrames(4),
+  m_NumberOfPoolMisses(0),
+  m_Mutex(itk::FastMutexLock::New())
+{
+}
+
+mitk::USImageFramePool::~USImageFramePool()
+{
+}
+
+void mitk::USImageFramePool::ResetGeometry(mitk::Image* frame)
+{
+  // same geometry as set up by mitk::Image::Initialize(); new objects are
+  // created, since the old ones may still be shared with a previous user
+  mitk::PlaneGeometry::Pointer planeGeometry = mitk::PlaneGeometry::New();
+  planeGeometry->InitializeStandardPlane(frame->GetDimension(0), frame->GetDimension(1));
+
+  mitk::SlicedGeometry3D::Pointer slicedGeometry = mitk::SlicedGeometry3D::New();
+  slicedGeometry->InitializeEvenlySpaced(planeGeometry, frame->GetDimension(2));
+
+  mitk::ProportionalTimeGeometry::Pointer timeGeometry = mitk::ProportionalTimeGeometry::New();
+  timeGeometry->Initialize(slicedGeometry, frame->GetDimension(3));
+  for (mitk::TimeStepType step = 0; step < timeGeometry->CountTimeSteps(); ++step)
+  {
+    timeGeometry->GetGeometryForTimeStep(step)->ImageGeometryOn();
+  }
+
+  frame->SetTimeGeometry(timeGeometry);
+}
+
+bool mitk::USImageFramePool::HasLayout(mitk::Image* image, const mitk::PixelType& pixelType, unsigned int dimension, const unsigned int* dimensions)
+{
+  if (!image->IsInitialized() || image->GetDimension() != dimension || image->GetPixelType() != pixelType)
+  {
+    return false;
+  }
+
+  for (unsigned int i = 0; i < dimension; ++i)
+  {
+    if (image->GetDimension(i) != dimensions[i])
+    {
+      return false;
+    }
+  }
+
+  return true;
+}
+
+mitk::Image::Pointer mitk::USImageFramePool::GetFrame(const mitk::PixelType& pixelType, unsigned int dimension, const unsigned int* dimensions)
+{
+  MutexLockHolder lock(*m_Mutex);
+
+  // a reference count of one means that only the pool holds the frame
+  for (auto iter = m_Frames.begin(); iter != m_Frames.end();)
+  {
+    if ((*iter)->GetReferenceCount() == 1)
+    {
+      if (HasLayout(*iter, pixelType, dimension, dimensions))
+      {
+        ResetGeometry(*iter);
+        return *iter;
+      }
+
+      // layout changed (e.g. other depth or cropping), drop the unused frame
+      iter = m_Frames.erase(iter);
+    }
+    else
+    {
+      ++iter;
+    }
+  }
+
+  mitk::Image::Pointer frame = mitk::Image::New();
+  frame->Initialize(pixelType, dimension, dimensions);
+
+  if (m_Frames.size() < m_MaximumNumberOfFrames)
+  {
+    m_Frames.push_back(frame);
+  }
+  else
+  {
+    ++m_NumberOfPoolMisses;
+  }
+
+  return frame;
+}
+
+mitk::Image::Pointer mitk::USImageFramePool::ConvertOpenCVMat(const cv::Mat& mat)
+{
+  if (mat.empty() || mat.dims != 2)
+  {
+    return nullptr;
+  }
+
+  mitk::PixelType pixelType = mitk::MakeScalarPixelType<unsigned char>();
+  switch (mat.type())
+  {
+  case CV_8UC1:
+    break;
+  case CV_8UC3:
+    pixelType = mitk::MakePixelType<itk::Image<itk::RGBPixel<unsigned char>, 2> >();
+    break;
+  case CV_16UC1:
+    pixelType = mitk::MakeScalarPixelType<unsigned short>();
+    break;
+  case CV_32FC1:
+    pixelType = mitk::MakeScalarPixelType<float>();
+    break;
+  default:
+    return nullptr;
+  }
+
+  unsigned int dimensions[2] = { static_cast<unsigned int>(mat.cols), static_cast<unsigned int>(mat.rows) };
+  mitk::Image::Pointer frame = this->GetFrame(pixelType, 2, dimensions);
+
+  {
+    mitk::ImageWriteAccessor writeAccess(frame);
+
+    // wrap the frame buffer, so that OpenCV writes directly into it
+    cv::Mat target(mat.rows, mat.cols, mat.type(), writeAccess.GetData());
+    if (mat.type() == CV_8UC3)
+    {
+      cv::cvtColor(mat, target, cv::COLOR_BGR2RGB);
+    }
+    else
+    {
+      mat.copyTo(target);
+    }
+  }
+
+  frame->Modified();
+  return frame;
+}
+
+unsigned int mitk::USImageFramePool::GetNumberOfFrames()
+{
+  MutexLockHolder lock(*m_Mutex);
+  return static_cast<unsigned int>(m_Frames.size());
+}
+
+unsigned long mitk::USImageFramePool::GetNumberOfPoolMisses()
+{
+  MutexLockHolder lock(*m_Mutex);
+  return m_NumberOfPoolMisses;
+}
+
+void mitk::USImageFramePool::Clear()
+{
+  MutexLockHolder lock(*m_Mutex);
+  m_Frames.clear();
+}
@@ -0,0 +1,104 @@
+/*===================================================================
+
+The Medical Imaging Interaction Toolkit (MITK)
+
+Copyright (c) German Cancer Research Center,
+Division of Medical and Biological Informatics.
+All rights reserved.
+
+This software is distributed WITHOUT ANY WARRANTY; without
+even the implied warranty of MERCHANTABILITY or FITNESS FOR
+A PARTICULAR PURPOSE.
+
+See LICENSE.txt or http://www.mitk.org for details.
+
+===================================================================*/
+
+#ifndef MITKUSImageFramePool_H_HEADER_INCLUDED_
+#define MITKUSImageFramePool_H_HEADER_INCLUDED_
+
+// ITK
+#include <itkObject.h>
+#include <itkFastMutexLock.h>
+
+// MITK
+#include <MitkUSExports.h>
+#include <mitkCommon.h>
+#include <mitkImage.h>
+
+// OpenCV
+#include <opencv2/core.hpp>
+
+namespace mitk {
+  /**
+  * \brief Pool of reusable frame images for ultrasound image sources.
+  *
+  * A frame handed out by GetFrame() stays reserved as long as anybody else
+  * holds a smart pointer to it. As soon as the last external reference is
+  * released (e.g. the outputs of mitk::USDevice share a newer frame), the
+  * frame is handed out again for the next acquisition. Frames with the same layout are thus
+  * allocated once and then cycled between acquisition thread and pipeline,
+  * which avoids allocating a new mitk::Image for every frame.
+  *
+  * If all pooled frames are in use, a frame outside of the pool is allocated
+  * and the number of such misses can be queried with GetNumberOfPoolMisses().
+  *
+  * \ingroup US
+  */
+  class MITKUS_EXPORT USImageFramePool : public itk::Object
+  {
+  public:
+    mitkClassMacroItkParent(USImageFramePool, itk::Object);
+    itkFactorylessNewMacro(Self);
+
+    /**
+    * \brief Maximum number of frames kept in the pool. Defaults to 4, which
+    * covers the acquired and the displayed frame of mitk::USDevice plus the
+    * frame currently written, with one frame to spare.
+    */
+    itkSetMacro(MaximumNumberOfFrames, unsigned int);
+    itkGetConstMacro(MaximumNumberOfFrames, unsigned int);
+
+    /**
+    * \brief Returns an initialized frame with the given layout that is not
+    * referenced from anywhere else. Reused frames get a new default geometry,
+    * so spacing or origin set by a previous user do not carry over.
+    */
+    mitk::Image::Pointer GetFrame(const mitk::PixelType& pixelType, unsigned int dimension, const unsigned int* dimensions);
+
+    /**
+    * \brief Writes the given OpenCV image into a pooled frame.
+    *
+    * Colour images are converted from BGR to RGB on the way. Returns nullptr
+    * for OpenCV types which are not supported by the pool (supported are
+    * 8 bit grey and colour, 16 bit unsigned grey and 32 bit float grey
+    * images); the caller should fall back to mitk::OpenCVToMitkImageFilter
+    * then.
+    */
+    mitk::Image::Pointer ConvertOpenCVMat(const cv::Mat& mat);
+
+    unsigned int GetNumberOfFrames();
+    unsigned long GetNumberOfPoolMisses();
+
+    /**
+    * \brief Releases all frames of the pool. Frames still referenced elsewhere
+    * stay valid for their users.
+    */
+    void Clear();
+
+  protected:
+    USImageFramePool();
+    ~USImageFramePool() override;
+
+    static void ResetGeometry(mitk::Image* frame);
+
+    static bool HasLayout(mitk::Image* image, const mitk::PixelType& pixelType, unsigned int dimension, const unsigned int* dimensions);
+
+    std::vector<mitk::Image::Pointer> m_Frames;
+    unsigned int m_MaximumNumberOfFrames;
+    unsigned long m_NumberOfPoolMisses;
+
+    itk::FastMutexLock::Pointer m_Mutex;
+  };
+} // namespace mitk
+#endif /* MITKUSImageFramePool_H_HEADER_INCLUDED_ */
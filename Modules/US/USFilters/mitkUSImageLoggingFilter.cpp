@@ -23,15 +23,97 @@ See LICENSE.txt or http://www.mitk.org for details.
 #include <mitkIOMimeTypes.h>
 #include <mitkCoreServices.h>
 #include <mitkIMimeTypeProvider.h>
+#include <mitkImageReadAccessor.h>
+#include <mitkImageWriteAccessor.h>
+
+#include <Poco/DeflatingStream.h>
+#include <Poco/InflatingStream.h>
+
+#include <itkRGBPixel.h>
+#include <itkRGBAPixel.h>
+
+#include <cstring>
+
+namespace
+{
+  // Layout of an image sequence file: the magic string, followed by chunks. Every chunk starts with its type and
+  // the index of the image it belongs to. Image chunks continue with timestamp, pixel type, geometry and the zlib
+  // compressed pixel data, message chunks with the length and the characters of the message.
+  const char SequenceFileMagic[8] = { 'M', 'I', 'T', 'K', 'U', 'S', 'Q', '1' };
+  const unsigned int ImageChunkType = 1;
+  const unsigned int MessageChunkType = 2;
+
+  template <typename T>
+  void WriteValue(std::ostream& stream, const T& value)
+  {
+    stream.write(reinterpret_cast<const char*>(&value), sizeof(T));
+  }
+
+  template <typename T>
+  T ReadValue(std::istream& stream)
+  {
+    T value = T();
+    stream.read(reinterpret_cast<char*>(&value), sizeof(T));
+    if (!stream)
+    {
+      mitkThrow() << "Unexpected end of image sequence file.";
+    }
+    return value;
+  }
+
+  bool IsStreamablePixelType(const mitk::PixelType& pixelType)
+  {
+    return pixelType.GetNumberOfComponents() == 1 ||
+           (pixelType.GetComponentType() == itk::ImageIOBase::UCHAR &&
+            (pixelType.GetNumberOfComponents() == 3 || pixelType.GetNumberOfComponents() == 4));
+  }
+
+  mitk::PixelType MakeStreamedPixelType(int componentType, unsigned int numberOfComponents)
+  {
+    if (numberOfComponents == 1)
+    {
+      switch (componentType)
+      {
+      case itk::ImageIOBase::CHAR: return mitk::MakeScalarPixelType<char>();
+      case itk::ImageIOBase::UCHAR: return mitk::MakeScalarPixelType<unsigned char>();
+      case itk::ImageIOBase::SHORT: return mitk::MakeScalarPixelType<short>();
+      case itk::ImageIOBase::USHORT: return mitk::MakeScalarPixelType<unsigned short>();
+      case itk::ImageIOBase::INT: return mitk::MakeScalarPixelType<int>();
+      case itk::ImageIOBase::UINT: return mitk::MakeScalarPixelType<unsigned int>();
+      case itk::ImageIOBase::FLOAT: return mitk::MakeScalarPixelType<float>();
+      case itk::ImageIOBase::DOUBLE: return mitk::MakeScalarPixelType<double>();
+      default: break;
+      }
+    }
+    else if (componentType == itk::ImageIOBase::UCHAR && numberOfComponents == 3)
+    {
+      return mitk::MakePixelType<itk::Image<itk::RGBPixel<unsigned char>, 2> >();
+    }
+    else if (componentType == itk::ImageIOBase::UCHAR && numberOfComponents == 4)
+    {
+      return mitk::MakePixelType<itk::Image<itk::RGBAPixel<unsigned char>, 2> >();
+    }
+
+    mitkThrow() << "Unsupported pixel type in image sequence file.";
+  }
+}
 
 
 mitk::USImageLoggingFilter::USImageLoggingFilter() : m_SystemTimeClock(RealTimeClock::New()),
-                                                     m_ImageExtension(".nrrd")
+                                                     m_ImageExtension(".nrrd"),
+                                                     m_StopWriter(false),
+                                                     m_IsStreaming(false),
+                                                     m_MaximumQueueSize(32),
+                                                     m_CompressionLevel(1),
+                                                     m_NumberOfQueuedImages(0),
+                                                     m_NumberOfStreamedImages(0),
+                                                     m_NumberOfDroppedImages(0)
 {
 }
 
 mitk::USImageLoggingFilter::~USImageLoggingFilter()
 {
+  this->StopStreaming();
 }
 
 void mitk::USImageLoggingFilter::GenerateData()
@@ -45,6 +127,44 @@ void mitk::USImageLoggingFilter::GenerateData()
     return;
     }
 
+  if (m_IsStreaming)
+  {
+    if (!IsStreamablePixelType(inputImage->GetPixelType()))
+    {
+      MITK_WARN << "Pixel type " << inputImage->GetPixelType().GetPixelTypeAsString() << " cannot be streamed. Dropping image!";
+      ++m_NumberOfDroppedImages;
+      return;
+    }
+
+    // only the raw pixel data of the first time step is copied, the clone of the whole image is not needed
+    StreamChunk chunk;
+    chunk.IsMessage = false;
+    chunk.Timestamp = m_SystemTimeClock->GetCurrentStamp();
+    chunk.ComponentType = inputImage->GetPixelType().GetComponentType();
+    chunk.NumberOfComponents = static_cast<unsigned int>(inputImage->GetPixelType().GetNumberOfComponents());
+
+    std::size_t numberOfBytes = inputImage->GetPixelType().GetSize();
+    for (unsigned int i = 0; i < std::min(inputImage->GetDimension(), 3u); ++i)
+    {
+      chunk.Dimensions.push_back(inputImage->GetDimension(i));
+      numberOfBytes *= inputImage->GetDimension(i);
+    }
+
+    const mitk::BaseGeometry* geometry = inputImage->GetGeometry();
+    for (unsigned int i = 0; i < 3; ++i)
+    {
+      chunk.Spacing[i] = geometry->GetSpacing()[i];
+      chunk.Origin[i] = geometry->GetOrigin()[i];
+    }
+
+    mitk::ImageReadAccessor inputAccessor(inputImage, inputImage->GetVolumeData(0));
+    const char* data = static_cast<const char*>(inputAccessor.GetData());
+    chunk.Data.assign(data, data + numberOfBytes);
+
+    this->EnqueueChunk(std::move(chunk));
+    return;
+  }
+
   //a clone is needed for a output and to store it.
   mitk::Image::Pointer inputClone = inputImage->Clone();
 
@@ -83,6 +203,15 @@ void mitk::USImageLoggingFilter::GenerateData()
 
 void mitk::USImageLoggingFilter::AddMessageToCurrentImage(std::string message)
 {
+  if (m_IsStreaming)
+  {
+    StreamChunk chunk;
+    chunk.IsMessage = true;
+    chunk.Message = message;
+    this->EnqueueChunk(std::move(chunk));
+    return;
+  }
+
   m_LoggedMessages.insert(std::make_pair(static_cast<int>(m_LoggedImages.size()-1),message));
 }
 
@@ -163,3 +292,232 @@ bool mitk::USImageLoggingFilter::SetImageFilesExtension(std::string extension)
   }
   return false;
  }
+
+std::string mitk::USImageLoggingFilter::StartStreaming(std::string path)
+{
+  this->StopStreaming();
+
+  Poco::Path testPath(path);
+  if(!testPath.isDirectory())
+    {
+    mitkThrow() << "Attemting to write to directory " << path << " which is not valid! Aborting!";
+    }
+
+  mitk::UIDGenerator myGen = mitk::UIDGenerator("",5);
+  std::stringstream filename;
+  filename << path << myGen.GetUID() << "_ImageSequence.usseq";
+
+  m_SequenceFile.open(filename.str().c_str(), std::ios::out | std::ios::binary | std::ios::trunc);
+  if (!m_SequenceFile.is_open())
+    {
+    mitkThrow() << "Cannot open image sequence file " << filename.str() << "! Aborting!";
+    }
+  m_SequenceFile.write(SequenceFileMagic, sizeof(SequenceFileMagic));
+
+  m_NumberOfQueuedImages = 0;
+  m_NumberOfStreamedImages = 0;
+  m_NumberOfDroppedImages = 0;
+  m_StopWriter = false;
+  m_IsStreaming = true;
+  m_WriterThread = std::thread(&USImageLoggingFilter::WriterThreadFunction, this);
+
+  return filename.str();
+}
+
+void mitk::USImageLoggingFilter::StopStreaming()
+{
+  if (!m_IsStreaming)
+    return;
+
+  {
+    std::lock_guard<std::mutex> lock(m_QueueMutex);
+    m_StopWriter = true;
+  }
+  m_QueueCondition.notify_all();
+  m_WriterThread.join();
+
+  m_SequenceFile.close();
+  m_IsStreaming = false;
+
+  if (m_NumberOfDroppedImages > 0)
+    {
+    MITK_WARN << m_NumberOfDroppedImages.load() << " images were dropped while streaming.";
+    }
+}
+
+bool mitk::USImageLoggingFilter::GetIsStreaming() const
+{
+  return m_IsStreaming;
+}
+
+unsigned long mitk::USImageLoggingFilter::GetNumberOfStreamedImages() const
+{
+  return m_NumberOfStreamedImages;
+}
+
+unsigned long mitk::USImageLoggingFilter::GetNumberOfDroppedImages() const
+{
+  return m_NumberOfDroppedImages;
+}
+
+void mitk::USImageLoggingFilter::EnqueueChunk(StreamChunk&& chunk)
+{
+  {
+    std::lock_guard<std::mutex> lock(m_QueueMutex);
+    if (chunk.IsMessage)
+    {
+      // messages belong to the last image which made it into the sequence
+      if (m_NumberOfQueuedImages == 0)
+        return;
+      chunk.Index = m_NumberOfQueuedImages - 1;
+    }
+    else
+    {
+      if (m_Queue.size() >= m_MaximumQueueSize)
+      {
+        ++m_NumberOfDroppedImages;
+        return;
+      }
+      chunk.Index = m_NumberOfQueuedImages++;
+    }
+    m_Queue.push_back(std::move(chunk));
+  }
+  m_QueueCondition.notify_one();
+}
+
+void mitk::USImageLoggingFilter::WriterThreadFunction()
+{
+  for (;;)
+  {
+    StreamChunk chunk;
+    {
+      std::unique_lock<std::mutex> lock(m_QueueMutex);
+      m_QueueCondition.wait(lock, [this] { return m_StopWriter || !m_Queue.empty(); });
+      if (m_Queue.empty())
+        return; // stop requested and everything written
+      chunk = std::move(m_Queue.front());
+      m_Queue.pop_front();
+    }
+
+    this->WriteChunk(chunk);
+  }
+}
+
+void mitk::USImageLoggingFilter::WriteChunk(const StreamChunk& chunk)
+{
+  if (chunk.IsMessage)
+  {
+    WriteValue(m_SequenceFile, MessageChunkType);
+    WriteValue(m_SequenceFile, chunk.Index);
+    WriteValue(m_SequenceFile, static_cast<unsigned int>(chunk.Message.size()));
+    m_SequenceFile.write(chunk.Message.data(), chunk.Message.size());
+    m_SequenceFile.flush();
+    return;
+  }
+
+  // compress on this thread, so the pipeline only pays for copying the pixel data
+  std::ostringstream compressed(std::ios::out | std::ios::binary);
+  {
+    Poco::DeflatingOutputStream deflater(compressed, Poco::DeflatingStreamBuf::STREAM_ZLIB, m_CompressionLevel);
+    deflater.write(chunk.Data.data(), chunk.Data.size());
+    deflater.close();
+  }
+  const std::string compressedData = compressed.str();
+
+  WriteValue(m_SequenceFile, ImageChunkType);
+  WriteValue(m_SequenceFile, chunk.Index);
+  WriteValue(m_SequenceFile, chunk.Timestamp);
+  WriteValue(m_SequenceFile, chunk.ComponentType);
+  WriteValue(m_SequenceFile, chunk.NumberOfComponents);
+  WriteValue(m_SequenceFile, static_cast<unsigned int>(chunk.Dimensions.size()));
+  for (auto dimension : chunk.Dimensions)
+    WriteValue(m_SequenceFile, dimension);
+  for (unsigned int i = 0; i < 3; ++i)
+    WriteValue(m_SequenceFile, chunk.Spacing[i]);
+  for (unsigned int i = 0; i < 3; ++i)
+    WriteValue(m_SequenceFile, chunk.Origin[i]);
+  WriteValue(m_SequenceFile, static_cast<unsigned long long>(chunk.Data.size()));
+  WriteValue(m_SequenceFile, static_cast<unsigned long long>(compressedData.size()));
+  m_SequenceFile.write(compressedData.data(), compressedData.size());
+  m_SequenceFile.flush();
+
+  if (!m_SequenceFile)
+  {
+    MITK_ERROR << "Writing to the image sequence file failed!";
+    ++m_NumberOfDroppedImages;
+    return;
+  }
+
+  ++m_NumberOfStreamedImages;
+}
+
+void mitk::USImageLoggingFilter::LoadImageSequence(std::string filename,
+                                                   std::vector<mitk::Image::Pointer>& images,
+                                                   std::vector<double>& timestamps,
+                                                   std::map<int, std::string>& messages)
+{
+  images.clear();
+  timestamps.clear();
+  messages.clear();
+
+  std::ifstream file(filename.c_str(), std::ios::in | std::ios::binary);
+  char magic[sizeof(SequenceFileMagic)];
+  if (!file.read(magic, sizeof(magic)) || std::memcmp(magic, SequenceFileMagic, sizeof(magic)) != 0)
+  {
+    mitkThrow() << filename << " is not an image sequence file.";
+  }
+
+  while (file.peek() != std::char_traits<char>::eof())
+  {
+    const unsigned int chunkType = ReadValue<unsigned int>(file);
+    const int index = ReadValue<int>(file);
+
+    if (chunkType == MessageChunkType)
+    {
+      std::string message(ReadValue<unsigned int>(file), '\0');
+      file.read(&message[0], message.size());
+      messages[index] += message;
+      continue;
+    }
+    else if (chunkType != ImageChunkType)
+    {
+      mitkThrow() << "Unknown chunk in image sequence file " << filename;
+    }
+
+    timestamps.push_back(ReadValue<double>(file));
+    const int componentType = ReadValue<int>(file);
+    const unsigned int numberOfComponents = ReadValue<unsigned int>(file);
+    std::vector<unsigned int> dimensions(ReadValue<unsigned int>(file));
+    for (auto& dimension : dimensions)
+      dimension = ReadValue<unsigned int>(file);
+    mitk::Vector3D spacing;
+    for (unsigned int i = 0; i < 3; ++i)
+      spacing[i] = ReadValue<double>(file);
+    mitk::Point3D origin;
+    for (unsigned int i = 0; i < 3; ++i)
+      origin[i] = ReadValue<double>(file);
+    const unsigned long long rawSize = ReadValue<unsigned long long>(file);
+    std::string compressedData(ReadValue<unsigned long long>(file), '\0');
+    if (!file.read(&compressedData[0], compressedData.size()))
+    {
+      mitkThrow() << "Unexpected end of image sequence file " << filename;
+    }
+
+    mitk::Image::Pointer image = mitk::Image::New();
+    image->Initialize(MakeStreamedPixelType(componentType, numberOfComponents),
+                      static_cast<unsigned int>(dimensions.size()), dimensions.data());
+    image->SetSpacing(spacing);
+    image->SetOrigin(origin);
+    {
+      mitk::ImageWriteAccessor imageAccessor(image);
+      std::istringstream compressedStream(compressedData, std::ios::in | std::ios::binary);
+      Poco::InflatingInputStream inflater(compressedStream, Poco::InflatingStreamBuf::STREAM_ZLIB);
+      inflater.read(static_cast<char*>(imageAccessor.GetData()), rawSize);
+      if (static_cast<unsigned long long>(inflater.gcount()) != rawSize)
+      {
+        mitkThrow() << "Corrupt image data in image sequence file " << filename;
+      }
+    }
+    images.push_back(image);
+  }
+}
@@ -22,6 +22,13 @@ See LICENSE.txt or http://www.mitk.org for details.
 #include <mitkImageToImageFilter.h>
 #include <mitkRealTimeClock.h>
 
+// STL
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <fstream>
+#include <mutex>
+#include <thread>
 
 namespace mitk {
   /** An object of this class is a filter which saves/logs a clone of the current image whenever
@@ -29,6 +36,12 @@ namespace mitk {
    *  add messages. All data (images, timestamps and messages) is written to the harddisc when
    *  the method SaveImages(...) is called.
    *
+   *  For long acquisitions the filter can be switched to streaming mode with StartStreaming(...). Then the
+   *  images are not kept in memory but handed to a background thread which appends them zlib compressed to a
+   *  single image sequence file, together with their timestamps and messages. The queue between pipeline and
+   *  writer thread is bounded (see SetMaximumQueueSize()); images arriving while the queue is full are dropped
+   *  and counted (see GetNumberOfDroppedImages()). Sequence files can be read with LoadImageSequence(...).
+   *
    *  Caution: only supports logging of one input at the moment, multiple inputs are ignored!
    *
    *  \ingroup US
@@ -76,6 +89,48 @@ namespace mitk {
      */
     bool SetImageFilesExtension(std::string extension);
 
+    /** Switches the filter to streaming mode. All images logged from now on are appended to an image sequence
+     *  file in the given directory by a background thread instead of being stored in memory. Images logged
+     *  before are not affected and can still be written by SaveImages(...).
+     *  @param[in]     path            Should contain a valid path were the sequence file will be stored.
+     *  @return        The filename of the image sequence file.
+     *  @throw         mitk::Exception Throws an exception if the path is not valid or the file cannot be opened.
+     */
+    std::string StartStreaming(std::string path);
+
+    /** Writes all queued images to the sequence file, closes it and leaves streaming mode. */
+    void StopStreaming();
+
+    bool GetIsStreaming() const;
+
+    /** Maximum number of images waiting for the writer thread in streaming mode. Default is 32. */
+    itkSetMacro(MaximumQueueSize, unsigned int);
+    itkGetConstMacro(MaximumQueueSize, unsigned int);
+
+    /** zlib compression level (0-9) for the image sequence file. Default is 1 (fastest). */
+    itkSetClampMacro(CompressionLevel, int, 0, 9);
+    itkGetConstMacro(CompressionLevel, int);
+
+    /** @return Number of images written to the sequence file since StartStreaming(...) was called. */
+    unsigned long GetNumberOfStreamedImages() const;
+
+    /** @return Number of images which were dropped since StartStreaming(...) was called, because the writer
+     *          thread could not keep up or the image type is not supported by the sequence file.
+     */
+    unsigned long GetNumberOfDroppedImages() const;
+
+    /** Reads an image sequence file written in streaming mode.
+     *  @param[in]     filename        The image sequence file.
+     *  @param[out]    images          The logged images.
+     *  @param[out]    timestamps      The MITK system timestamp of every image.
+     *  @param[out]    messages        The messages added to the images, keyed by image index.
+     *  @throw         mitk::Exception Throws an exception if the file cannot be read.
+     */
+    static void LoadImageSequence(std::string filename,
+                                  std::vector<mitk::Image::Pointer>& images,
+                                  std::vector<double>& timestamps,
+                                  std::map<int, std::string>& messages);
+
 
   protected:
     USImageLoggingFilter();
@@ -89,6 +144,39 @@ namespace mitk {
     std::vector<double> m_LoggedMITKSystemTimes; ///< Logged system times for every logged image
     std::string m_ImageExtension; ///< stores the image extension, default is ".nrrd"
 
+    /** A logged image or message waiting for the writer thread of the streaming mode. */
+    struct StreamChunk
+    {
+      bool IsMessage;
+      int Index;
+      double Timestamp;
+      std::string Message;
+      int ComponentType;
+      unsigned int NumberOfComponents;
+      std::vector<unsigned int> Dimensions;
+      double Spacing[3];
+      double Origin[3];
+      std::vector<char> Data;
+    };
+
+    void WriterThreadFunction();
+    void WriteChunk(const StreamChunk& chunk);
+    void EnqueueChunk(StreamChunk&& chunk);
+
+    //members for streaming
+    std::ofstream m_SequenceFile;           ///< the image sequence file while streaming
+    std::thread m_WriterThread;             ///< writes the queued chunks to m_SequenceFile
+    std::mutex m_QueueMutex;
+    std::condition_variable m_QueueCondition;
+    std::deque<StreamChunk> m_Queue;        ///< images and messages waiting to be written
+    bool m_StopWriter;
+    bool m_IsStreaming;
+    unsigned int m_MaximumQueueSize;
+    int m_CompressionLevel;
+    int m_NumberOfQueuedImages;             ///< index of the next image in the sequence file
+    std::atomic<unsigned long> m_NumberOfStreamedImages;
+    std::atomic<unsigned long> m_NumberOfDroppedImages;
+
   };
 } // namespace mitk
 #endif /* MITKUSImageSource_H_HEADER_INCLUDED_ */
@@ -22,6 +22,7 @@ const char* mitk::USImageSource::IMAGE_PROPERTY_IDENTIFIER = "id_nummer";
 mitk::USImageSource::USImageSource()
   : m_OpenCVToMitkFilter(mitk::OpenCVToMitkImageFilter::New()),
   m_MitkToOpenCVFilter(nullptr),
+  m_FramePool(mitk::USImageFramePool::New()),
   m_ImageFilter(mitk::BasicCombinationOpenCVImageFilter::New()),
   m_CurrentImageId(0),
   m_ImageFilterMutex(itk::FastMutexLock::New())
@@ -67,12 +68,16 @@ std::vector<mitk::Image::Pointer> mitk::USImageSource::GetNextImage()
         m_ImageFilter->FilterImage(imageVector[i], m_CurrentImageId);
         m_ImageFilterMutex->Unlock();
 
-        // convert to MITK image
-        this->m_OpenCVToMitkFilter->SetOpenCVMat(imageVector[i]);
-        this->m_OpenCVToMitkFilter->Update();
+        // convert to MITK image, reusing a frame of the pool if possible
+        result[i] = m_FramePool->ConvertOpenCVMat(imageVector[i]);
+        if (result[i].IsNull())
+        {
+          this->m_OpenCVToMitkFilter->SetOpenCVMat(imageVector[i]);
+          this->m_OpenCVToMitkFilter->Update();
 
-        // OpenCVToMitkImageFilter returns a standard mitk::image.
-        result[i] = this->m_OpenCVToMitkFilter->GetOutput();
+          // OpenCVToMitkImageFilter returns a standard mitk::image.
+          result[i] = this->m_OpenCVToMitkFilter->GetOutput();
+        }
       }
     }
   }
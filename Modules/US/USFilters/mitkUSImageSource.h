@@ -27,6 +27,7 @@ See LICENSE.txt or http://www.mitk.org for details.
 #include "mitkBasicCombinationOpenCVImageFilter.h"
 #include "mitkOpenCVToMitkImageFilter.h"
 #include "mitkImageToOpenCVImageFilter.h"
+#include "mitkUSImageFramePool.h"
 
 namespace mitk {
   /**
@@ -60,6 +61,12 @@ namespace mitk {
     */
     std::vector<mitk::Image::Pointer> GetNextImage();
 
+    /**
+    * \brief Pool the frames returned by GetNextImage() are taken from.
+    * Frames are recycled as soon as nobody references them anymore.
+    */
+    itkGetMacro(FramePool, mitk::USImageFramePool::Pointer);
+
   protected:
     USImageSource();
     ~USImageSource() override;
@@ -87,6 +94,10 @@ namespace mitk {
     * \brief Used to convert from MITK Images to OpenCV Images.
     */
     mitk::ImageToOpenCVImageFilter::Pointer m_MitkToOpenCVFilter;
+    /**
+    * \brief Reusable frames for OpenCV to MITK conversions.
+    */
+    mitk::USImageFramePool::Pointer m_FramePool;
 
   private:
     /**
@@ -200,21 +200,24 @@ void mitk::USImageVideoSource::GetNextRawImage(std::vector<mitk::Image::Pointer>
   if (image.size() != 1)
     image.resize(1);
 
-  std::vector<cv::Mat> cv_img;
+  // the capture buffer is kept between frames so that the decoder can reuse it
+  std::vector<cv::Mat>& cv_img = m_CaptureBuffer;
 
   this->GetNextRawImage(cv_img);
 
-  // convert to MITK-Image
-  IplImage ipl_img = cv_img[0];
+  // convert to MITK-Image, writing into a recycled frame if possible
+  image[0] = m_FramePool->ConvertOpenCVMat(cv_img[0]);
 
-  this->m_OpenCVToMitkFilter->SetOpenCVImage(&ipl_img);
-  this->m_OpenCVToMitkFilter->Update();
+  if (image[0].IsNull())
+  {
+    IplImage ipl_img = cv_img[0];
 
-  // OpenCVToMitkImageFilter returns a standard mitk::image. We then transform it into an USImage
-  image[0] = this->m_OpenCVToMitkFilter->GetOutput();
+    this->m_OpenCVToMitkFilter->SetOpenCVImage(&ipl_img);
+    this->m_OpenCVToMitkFilter->Update();
 
-  // clean up
-  cv_img[0].release();
+    // OpenCVToMitkImageFilter returns a standard mitk::image. We then transform it into an USImage
+    image[0] = this->m_OpenCVToMitkFilter->GetOutput();
+  }
 }
 
 void mitk::USImageVideoSource::OverrideResolution(int width, int height)
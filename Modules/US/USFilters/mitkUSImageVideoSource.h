@@ -192,6 +192,11 @@ namespace mitk {
       */
     cv::VideoCapture* m_VideoCapture;
 
+    /**
+    * \brief OpenCV frame the video capture decodes into, reused for every frame.
+    */
+    std::vector<cv::Mat> m_CaptureBuffer;
+
     /**
       * \brief If true, a frame can be grabbed anytime.
       */
@@ -15,7 +15,8 @@ See LICENSE.txt or http://www.mitk.org for details.
 ===================================================================*/
 
 #include "mitkUSDevice.h"
-#include "mitkImageReadAccessor.h"
+#include "mitkIGTTimeStamp.h"
+#include <itkMutexLockHolder.h>
 
 // US Control Interfaces
 #include "mitkUSControlInterfaceProbes.h"
@@ -28,6 +29,8 @@ See LICENSE.txt or http://www.mitk.org for details.
 #include <usServiceProperties.h>
 #include <usModuleContext.h>
 
+typedef itk::MutexLockHolder<itk::FastMutexLock> MutexLockHolder;
+
 mitk::USDevice::PropertyKeys mitk::USDevice::GetPropertyKeys()
 {
   static mitk::USDevice::PropertyKeys propertyKeys;
@@ -55,6 +58,13 @@ mitk::USDevice::USDevice(std::string manufacturer, std::string model)
   m_ImageMutex(itk::FastMutexLock::New()),
   m_ThreadID(-1),
   m_ImageVector(),
+  m_AcquiredImageVector(),
+  m_OutputFrames(),
+  m_NewImageVectorAvailable(false),
+  m_AcquisitionTimeStamp(0.0),
+  m_LastFrameLatency(0.0),
+  m_FrameLatencySum(0.0),
+  m_NumberOfDeliveredFrames(0),
   m_Spacing(),
   m_IGTLServer(nullptr),
   m_IGTLMessageProvider(nullptr),
@@ -93,6 +103,13 @@ mitk::USDevice::USDevice(mitk::USImageMetadata::Pointer metadata)
   m_ImageMutex(itk::FastMutexLock::New()),
   m_ThreadID(-1),
   m_ImageVector(),
+  m_AcquiredImageVector(),
+  m_OutputFrames(),
+  m_NewImageVectorAvailable(false),
+  m_AcquisitionTimeStamp(0.0),
+  m_LastFrameLatency(0.0),
+  m_FrameLatencySum(0.0),
+  m_NumberOfDeliveredFrames(0),
   m_Spacing(),
   m_IGTLServer(nullptr),
   m_IGTLMessageProvider(nullptr),
@@ -288,6 +305,8 @@ bool mitk::USDevice::Connect()
   // Update state
   m_DeviceState = State_Connected;
 
+  mitk::IGTTimeStamp::GetInstance()->Stop(this);
+
   this->UpdateServiceProperty(
     mitk::USDevice::GetPropertyKeys().US_PROPKEY_ISCONNECTED, true);
   return true;
@@ -334,6 +353,14 @@ bool mitk::USDevice::Activate()
 
     m_FreezeBarrier = itk::ConditionVariable::New();
 
+    // frame latencies are measured relative to the activation of the device
+    m_ImageMutex->Lock();
+    m_LastFrameLatency = 0.0;
+    m_FrameLatencySum = 0.0;
+    m_NumberOfDeliveredFrames = 0;
+    m_ImageMutex->Unlock();
+    mitk::IGTTimeStamp::GetInstance()->Start(this);
+
     // spawn thread for aquire images if us device is active
     if (m_SpawnAcquireThread)
     {
@@ -573,9 +600,29 @@ output->Graft( graft );
 void mitk::USDevice::GrabImage()
 {
   std::vector<mitk::Image::Pointer> image = this->GetUSImageSource()->GetNextImage();
+  double timeStamp = mitk::IGTTimeStamp::GetInstance()->GetElapsed(this);
+
   m_ImageMutex->Lock();
-  this->SetImageVector(image);
+  // frames that were acquired but never delivered are released here and go
+  // back to the frame pool of the image source
+  m_AcquiredImageVector.swap(image);
+  m_NewImageVectorAvailable = true;
+  m_AcquisitionTimeStamp = timeStamp;
   m_ImageMutex->Unlock();
+
+  this->Modified();
+}
+
+double mitk::USDevice::GetLastFrameLatency()
+{
+  MutexLockHolder lock(*m_ImageMutex);
+  return m_LastFrameLatency;
+}
+
+double mitk::USDevice::GetMeanFrameLatency()
+{
+  MutexLockHolder lock(*m_ImageMutex);
+  return m_NumberOfDeliveredFrames > 0 ? m_FrameLatencySum / m_NumberOfDeliveredFrames : 0.0;
 }
 
 //########### GETTER & SETTER ##################//
@@ -624,6 +671,26 @@ void mitk::USDevice::GenerateData()
 {
   m_ImageMutex->Lock();
 
+  if (m_NewImageVectorAvailable)
+  {
+    m_ImageVector.swap(m_AcquiredImageVector);
+    m_AcquiredImageVector.clear();
+    m_NewImageVectorAvailable = false;
+
+    double timeStamp = mitk::IGTTimeStamp::GetInstance()->GetElapsed(this);
+    if (timeStamp >= 0 && m_AcquisitionTimeStamp >= 0)
+    {
+      m_LastFrameLatency = timeStamp - m_AcquisitionTimeStamp;
+      m_FrameLatencySum += m_LastFrameLatency;
+      ++m_NumberOfDeliveredFrames;
+    }
+  }
+
+  if (m_OutputFrames.size() < this->GetNumberOfIndexedOutputs())
+  {
+    m_OutputFrames.resize(this->GetNumberOfIndexedOutputs());
+  }
+
   for (unsigned int i = 0; i < m_ImageVector.size() && i < this->GetNumberOfIndexedOutputs(); ++i)
   {
     auto& image = m_ImageVector[i];
@@ -633,24 +700,13 @@ void mitk::USDevice::GenerateData()
     }
     else
     {
-      mitk::Image::Pointer output = this->GetOutput(i);
-
-      if (!output->IsInitialized() ||
-        output->GetDimension(0) != image->GetDimension(0) ||
-        output->GetDimension(1) != image->GetDimension(1) ||
-        output->GetDimension(2) != image->GetDimension(2) ||
-        output->GetPixelType() != image->GetPixelType())
-      {
-        output->Initialize(image->GetPixelType(), image->GetDimension(),
-          image->GetDimensions());
-      }
-
-      // copy contents of the given image into the member variable
-      mitk::ImageReadAccessor inputReadAccessor(image);
-      output->SetImportVolume(inputReadAccessor.GetData());
-      output->SetGeometry(image->GetGeometry());
+      // the output shares the pixel data of the frame instead of copying it;
+      // the frame is kept in m_OutputFrames until the output shares a newer
+      // one, only then it can go back to the frame pool of the image source
+      this->GetOutput(i)->Graft(image);
+      m_OutputFrames[i] = image;
     }
-  }  
+  }
   m_ImageMutex->Unlock();
 };
 
@@ -315,8 +315,25 @@ namespace mitk {
     itkGetMacro(DeviceState, DeviceStates)
     itkGetMacro(ServiceProperties, us::ServiceProperties)
 
+    /**
+    * \brief Fetches the next frames from the image source and hands them over
+    * to the pipeline. Only smart pointers are swapped here, GenerateData()
+    * lets the outputs share the pixel data of the frames.
+    */
     void GrabImage();
 
+    /**
+    * \brief Time in ms between grabbing the most recently delivered frame and
+    * delivering it to the outputs, measured with mitk::IGTTimeStamp.
+    */
+    double GetLastFrameLatency();
+
+    /**
+    * \brief Mean of GetLastFrameLatency() over all frames delivered since
+    * the device was activated.
+    */
+    double GetMeanFrameLatency();
+
     /**
     * \brief Returns all probes for this device or an empty vector it no probes were set
     * Returns a std::vector of all probes that exist for this device if there were probes set while creating or modifying this USVideoDevice.
@@ -374,19 +391,48 @@ namespace mitk {
     itk::FastMutexLock::Pointer m_ImageMutex; ///< mutex for images provided by the image source
     int m_ThreadID; ///< ID of the started thread
 
-    virtual void SetImageVector(std::vector<mitk::Image::Pointer> vec)
+    /**
+    * \deprecatedSince{2018_04} Frames are handed over by GrabImage(), which
+    * keeps the latest frames for GenerateData() without copying them.
+    */
+    DEPRECATED(virtual void SetImageVector(std::vector<mitk::Image::Pointer> vec))
     {
-      if (this->m_ImageVector != vec)                   
-      {                                             
+      m_ImageMutex->Lock();
+      bool changed = this->m_ImageVector != vec;
       this->m_ImageVector = vec;
-      this->Modified();                             
-      } 
+      m_ImageMutex->Unlock();
+      if (changed)
+      {
+        this->Modified();
+      }
     }
 
     static ITK_THREAD_RETURN_TYPE Acquire(void* pInfoStruct);
     static ITK_THREAD_RETURN_TYPE ConnectThread(void* pInfoStruct);
 
+    /**
+    * \brief Frames most recently delivered to the outputs of this device.
+    *
+    * The acquisition thread puts new frames into m_AcquiredImageVector and
+    * GenerateData() swaps them into m_ImageVector.
+    */
     std::vector<mitk::Image::Pointer> m_ImageVector;
+    std::vector<mitk::Image::Pointer> m_AcquiredImageVector;
+
+    /**
+    * \brief Frame whose pixel data each output currently shares (see
+    * mitk::Image::Graft()). A frame goes back to the frame pool of the image
+    * source only once it is released here, i.e. after its output shares a
+    * newer frame, so the acquisition thread never overwrites pixels the
+    * outputs still show.
+    */
+    std::vector<mitk::Image::Pointer> m_OutputFrames;
+    bool m_NewImageVectorAvailable;
+
+    double m_AcquisitionTimeStamp;
+    double m_LastFrameLatency;
+    double m_FrameLatencySum;
+    unsigned long m_NumberOfDeliveredFrames;
 
     // Variables to determine if spacing was calibrated and needs to be applied to the incoming images
     mitk::Vector3D m_Spacing;
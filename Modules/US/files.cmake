@@ -18,6 +18,7 @@ USModel/mitkUSDeviceWriterXML.cpp
 ## Filters and Sources
 USFilters/mitkUSImageLoggingFilter.cpp
 USFilters/mitkUSImageSource.cpp
+USFilters/mitkUSImageFramePool.cpp
 USFilters/mitkUSImageVideoSource.cpp
 USFilters/mitkIGTLMessageToUSImageFilter.cpp
 
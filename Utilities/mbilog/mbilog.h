@@ -209,17 +209,38 @@ namespace mbilog
  * generated
   *        by the compiler.
   */
+/** \brief Macro for disabled messages. The stream operators bind to the second NullStream, which is never evaluated.
+ */
+#define MBI_NULL_STREAM true ? mbilog::NullStream() : mbilog::NullStream() // this is magic by markus
+
+/** \brief Messages below the level set by the cmake variable MBILOG_MINIMUM_LEVEL are disabled at compile time.
+ */
+#if MBILOG_MINIMUM_LEVEL <= 0
 #define MBI_INFO mbilog::PseudoStream(mbilog::Info, __FILE__, __LINE__, __FUNCTION__)
+#else
+#define MBI_INFO MBI_NULL_STREAM
+#endif
+
+#if MBILOG_MINIMUM_LEVEL <= 1
 #define MBI_WARN mbilog::PseudoStream(mbilog::Warn, __FILE__, __LINE__, __FUNCTION__)
+#else
+#define MBI_WARN MBI_NULL_STREAM
+#endif
+
+#if MBILOG_MINIMUM_LEVEL <= 2
 #define MBI_ERROR mbilog::PseudoStream(mbilog::Error, __FILE__, __LINE__, __FUNCTION__)
+#else
+#define MBI_ERROR MBI_NULL_STREAM
+#endif
+
 #define MBI_FATAL mbilog::PseudoStream(mbilog::Fatal, __FILE__, __LINE__, __FUNCTION__)
 
 /** \brief Macro for the debug messages. The messages are disabled if the cmake variable MBILOG_ENABLE_DEBUG is false.
  */
-#ifdef MBILOG_ENABLE_DEBUG
+#if defined(MBILOG_ENABLE_DEBUG) && MBILOG_MINIMUM_LEVEL <= 0
 #define MBI_DEBUG mbilog::PseudoStream(mbilog::Debug, __FILE__, __LINE__, __FUNCTION__)
 #else
-#define MBI_DEBUG true ? mbilog::NullStream() : mbilog::NullStream() // this is magic by markus
+#define MBI_DEBUG MBI_NULL_STREAM
 #endif
 
 #endif